@@ -137,6 +137,17 @@ namespace client {
       _simulator->SetReplayerIgnoreHero(ignore_hero);
     }
 
+    /// Counters of every sensor stream of the server.
+    std::vector<streaming::StreamStatistics> GetStreamingStatistics() const {
+      return _simulator->GetStreamingStatistics();
+    }
+
+    /// Bounds and policy of the queue of messages each sensor stream keeps
+    /// for each client.
+    void SetStreamingSendQueue(const streaming::SendQueueSettings &settings) {
+      _simulator->SetStreamingSendQueue(settings);
+    }
+
     void ApplyBatch(
         std::vector<rpc::Command> commands,
         bool do_tick_cue = false) const {
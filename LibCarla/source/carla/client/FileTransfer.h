@@ -28,6 +28,9 @@ namespace client {
 
     static bool FileExists(std::string file);
 
+    /// Returns where the file is stored in the cache folder.
+    static std::string GetFullPath(const std::string &path);
+
     static bool WriteFile(std::string path, std::vector<uint8_t> content);
 
     static std::vector<uint8_t> ReadFile(std::string path);
@@ -21,6 +21,8 @@ namespace client {
 
     using ClientSideSensor::ClientSideSensor;
 
+    using ClientSideSensor::Listen;
+
     ~LaneInvasionSensor();
 
     /// Register a @a callback to be executed each time a new measurement is
@@ -25,6 +25,13 @@ namespace client {
     /// received.
     virtual void Listen(CallbackFunctionType callback) = 0;
 
+    /// Same as Listen, receiving at most @a max_rate measurements per second.
+    /// Only sensors streaming from the server drop the others before sending
+    /// them, the rest ignore the limit.
+    virtual void Listen(CallbackFunctionType callback, double /*max_rate*/) {
+      Listen(std::move(callback));
+    }
+
     /// Stop listening for new measurements.
     virtual void Stop() = 0;
 
@@ -31,8 +31,12 @@ namespace client {
   }
 
   void ServerSideSensor::Listen(CallbackFunctionType callback) {
+    Listen(std::move(callback), 0.0);
+  }
+
+  void ServerSideSensor::Listen(CallbackFunctionType callback, double max_rate) {
     log_debug(GetDisplayId(), ": subscribing to stream");
-    GetEpisode().Lock()->SubscribeToSensor(*this, std::move(callback));
+    GetEpisode().Lock()->SubscribeToSensor(*this, std::move(callback), max_rate);
     _is_listening = true;
   }
 
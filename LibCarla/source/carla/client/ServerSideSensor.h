@@ -27,6 +27,8 @@ namespace client {
     /// the same sensor in the simulator.
     void Listen(CallbackFunctionType callback) override;
 
+    void Listen(CallbackFunctionType callback, double max_rate) override;
+
     /// Stop listening for new measurements.
     void Stop() override;
 
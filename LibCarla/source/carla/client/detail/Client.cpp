@@ -559,14 +559,24 @@ namespace detail {
 
   void Client::SubscribeToStream(
       const streaming::Token &token,
-      std::function<void(Buffer)> callback) {
-    _pimpl->streaming_client.Subscribe(token, std::move(callback));
+      std::function<void(Buffer)> callback,
+      const double max_rate) {
+    _pimpl->streaming_client.Subscribe(token, std::move(callback), max_rate);
   }
 
   void Client::UnSubscribeFromStream(const streaming::Token &token) {
     _pimpl->streaming_client.UnSubscribe(token);
   }
 
+  std::vector<streaming::StreamStatistics> Client::GetStreamingStatistics() {
+    using return_t = std::vector<streaming::StreamStatistics>;
+    return _pimpl->CallAndWait<return_t>("get_streaming_statistics");
+  }
+
+  void Client::SetStreamingSendQueue(const streaming::SendQueueSettings &settings) {
+    _pimpl->CallAndWait<void>("set_streaming_send_queue", settings);
+  }
+
   void Client::DrawDebugShape(const rpc::DebugShape &shape) {
     _pimpl->AsyncCall("draw_debug_shape", shape);
   }
@@ -33,6 +33,7 @@
 #include "carla/rpc/WeatherParameters.h"
 #include "carla/rpc/Texture.h"
 #include "carla/rpc/MaterialParameter.h"
+#include "carla/streaming/SendQueue.h"
 
 #include <functional>
 #include <memory>
@@ -354,10 +355,15 @@ namespace detail {
 
     void SubscribeToStream(
         const streaming::Token &token,
-        std::function<void(Buffer)> callback);
+        std::function<void(Buffer)> callback,
+        double max_rate = 0.0);
 
     void UnSubscribeFromStream(const streaming::Token &token);
 
+    std::vector<streaming::StreamStatistics> GetStreamingStatistics();
+
+    void SetStreamingSendQueue(const streaming::SendQueueSettings &settings);
+
     void DrawDebugShape(const rpc::DebugShape &shape);
 
     void ApplyBatch(
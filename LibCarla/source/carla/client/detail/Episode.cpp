@@ -20,9 +20,9 @@ namespace detail {
 
 using namespace std::chrono_literals;
 
-  static auto &CastData(const sensor::SensorData &data) {
+  static auto CastData(SharedPtr<sensor::SensorData> data) {
     using target_t = const sensor::data::RawEpisodeState;
-    return static_cast<target_t &>(data);
+    return boost::static_pointer_cast<target_t>(std::move(data));
   }
 
   template <typename RangeT>
@@ -56,8 +56,12 @@ using namespace std::chrono_literals;
       auto self = weak.lock();
       if (self != nullptr) {
 
-        auto data = sensor::Deserializer::Deserialize(std::move(buffer));
-        auto next = std::make_shared<const EpisodeState>(CastData(*data));
+        auto data = self->_decoder.Decode(CastData(sensor::Deserializer::Deserialize(std::move(buffer))));
+        if (data == nullptr) {
+          // A delta without its keyframe, dropped until the next keyframe.
+          return;
+        }
+        auto next = std::make_shared<const EpisodeState>(std::move(data));
         auto prev = self->GetState();
 
         // TODO: Update how the map change is detected
@@ -81,7 +85,11 @@ using namespace std::chrono_literals;
 
           do {
             if (prev->GetFrame() >= next->GetFrame() && !episode_changed) {
-              self->_on_tick_callbacks.Call(next);
+              // The server sends a frame again in full for the clients that
+              // subscribed while it was being sent, this one already has it.
+              if (prev->GetFrame() != next->GetFrame()) {
+                self->_on_tick_callbacks.Call(next);
+              }
               return;
             }
           } while (!self->_state.compare_exchange(&prev, next));
@@ -16,6 +16,7 @@
 #include "carla/client/detail/EpisodeState.h"
 #include "carla/client/detail/WalkerNavigation.h"
 #include "carla/rpc/EpisodeInfo.h"
+#include "carla/sensor/s11n/EpisodeStateDecoder.h"
 
 #include <vector>
 
@@ -126,6 +127,10 @@ namespace detail {
 
     AtomicSharedPtr<const EpisodeState> _state;
 
+    /// Rebuilds the delta ticks from the last keyframe. Only used by the
+    /// stream callback.
+    sensor::s11n::EpisodeStateDecoder _decoder;
+
     AtomicSharedPtr<WalkerNavigation> _navigation;
 
     std::string _pending_exceptions_msg;
@@ -6,33 +6,83 @@
 
 #include "carla/client/detail/EpisodeState.h"
 
+#include <algorithm>
+#include <utility>
+
 namespace carla {
 namespace client {
 namespace detail {
 
-  EpisodeState::EpisodeState(const sensor::data::RawEpisodeState &state)
-    : _episode_id(state.GetEpisodeId()),
+  constexpr uint32_t EpisodeState::NOT_PRESENT;
+
+  EpisodeState::EpisodeState(SharedPtr<const sensor::data::RawEpisodeState> state)
+    : _episode_id(state->GetEpisodeId()),
       _timestamp(
-          state.GetFrame(),
-          state.GetGameTimeStamp(),
-          state.GetDeltaSeconds(),
-          state.GetPlatformTimeStamp()),
-      _map_origin(state.GetMapOrigin()),
-      _simulation_state(state.GetSimulationState()) {
-    _actors.reserve(state.size());
-    for (auto &&actor : state) {
-      DEBUG_ONLY(auto result = )
-      _actors.emplace(
-          actor.id,
-          ActorSnapshot{
-              actor.id,
-              actor.actor_state,
-              actor.transform,
-              actor.velocity,
-              actor.angular_velocity,
-              actor.acceleration,
-              actor.state});
-      DEBUG_ASSERT(result.second);
+          state->GetFrame(),
+          state->GetGameTimeStamp(),
+          state->GetDeltaSeconds(),
+          state->GetPlatformTimeStamp()),
+      _map_origin(state->GetMapOrigin()),
+      _simulation_state(state->GetSimulationState()),
+      _data(std::move(state)),
+      _actors(_data->begin(), _data->end()) {}
+
+  const sensor::data::ActorDynamicState *EpisodeState::Find(ActorId id) const {
+    std::call_once(_index_flag, [this]() { BuildIndex(); });
+    if (!_positions.empty()) {
+      const auto offset = static_cast<size_t>(id - _min_id);
+      if ((id < _min_id) || (offset >= _positions.size()) || (_positions[offset] == NOT_PRESENT)) {
+        return nullptr;
+      }
+      return _actors.begin() + _positions[offset];
+    }
+    if (!_index.empty()) {
+      auto it = std::lower_bound(_index.begin(), _index.end(), id, [](const auto &entry, ActorId id) {
+        return entry.first < id;
+      });
+      return ((it != _index.end()) && (it->first == id)) ? (_actors.begin() + it->second) : nullptr;
+    }
+    auto it = std::lower_bound(_actors.begin(), _actors.end(), id, [](const auto &actor, ActorId id) {
+      return actor.id < id;
+    });
+    return ((it != _actors.end()) && (it->id == id)) ? it : nullptr;
+  }
+
+  void EpisodeState::BuildIndex() const {
+    if ((_simulation_state & SimulationState::ActorsSortedById) != SimulationState::None) {
+      DEBUG_ASSERT(std::is_sorted(_actors.begin(), _actors.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.id < rhs.id;
+      }));
+      return;
+    }
+    if (_actors.empty()) {
+      return;
+    }
+    bool is_sorted = true;
+    ActorId min_id = _actors.begin()->id;
+    ActorId max_id = min_id;
+    for (auto &&actor : _actors) {
+      is_sorted = is_sorted && (max_id <= actor.id);
+      min_id = std::min(min_id, actor.id);
+      max_id = std::max(max_id, actor.id);
+    }
+    if (is_sorted) {
+      return;
+    }
+    uint32_t position = 0u;
+    if ((max_id - min_id) / 4u < _actors.size()) {
+      // Ids are dense enough for a direct table.
+      _min_id = min_id;
+      _positions.assign(max_id - min_id + 1u, NOT_PRESENT);
+      for (auto &&actor : _actors) {
+        _positions[actor.id - min_id] = position++;
+      }
+    } else {
+      _index.reserve(_actors.size());
+      for (auto &&actor : _actors) {
+        _index.emplace_back(actor.id, position++);
+      }
+      std::sort(_index.begin(), _index.end());
     }
   }
 
@@ -6,35 +6,68 @@
 
 #pragma once
 
-#include "carla/Iterator.h"
 #include "carla/ListView.h"
+#include "carla/Memory.h"
 #include "carla/NonCopyable.h"
 #include "carla/client/ActorSnapshot.h"
 #include "carla/client/Timestamp.h"
 #include "carla/geom/Vector3DInt.h"
 #include "carla/sensor/data/RawEpisodeState.h"
 
+#include <boost/iterator/transform_iterator.hpp>
 #include <boost/optional.hpp>
 
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace carla {
 namespace client {
 namespace detail {
 
   /// Represents the state of all the actors of an episode at a given frame.
+  ///
+  /// The actors are read in place from the data received from the simulator,
+  /// nothing is copied per tick. Lookups by id do a binary search, directly on
+  /// the received array if the simulator sent it sorted by id. Otherwise the
+  /// first lookup builds an index of their positions.
   class EpisodeState
     : public std::enable_shared_from_this<EpisodeState>,
       private NonCopyable {
 
       using SimulationState = sensor::s11n::EpisodeStateSerializer::SimulationState;
 
+      using ActorDynamicState = sensor::data::ActorDynamicState;
+
+      struct MakeActorSnapshot {
+        ActorSnapshot operator()(const ActorDynamicState &actor) const {
+          return {
+              actor.id,
+              actor.actor_state,
+              actor.transform,
+              actor.velocity,
+              actor.angular_velocity,
+              actor.acceleration,
+              actor.state};
+        }
+      };
+
+      struct GetActorId {
+        ActorId operator()(const ActorDynamicState &actor) const {
+          return actor.id;
+        }
+      };
+
   public:
 
-    explicit EpisodeState(uint64_t episode_id) : _episode_id(episode_id) {}
+    explicit EpisodeState(uint64_t episode_id)
+      : _episode_id(episode_id),
+        _simulation_state(SimulationState::None),
+        _actors(nullptr, nullptr) {}
 
-    explicit EpisodeState(const sensor::data::RawEpisodeState &state);
+    explicit EpisodeState(SharedPtr<const sensor::data::RawEpisodeState> state);
 
     auto GetEpisodeId() const {
       return _episode_id;
@@ -61,7 +94,7 @@ namespace detail {
     }
 
     bool ContainsActorSnapshot(ActorId actor_id) const {
-      return _actors.find(actor_id) != _actors.end();
+      return Find(actor_id) != nullptr;
     }
 
     ActorSnapshot GetActorSnapshot(ActorId id) const {
@@ -78,29 +111,36 @@ namespace detail {
 
     auto GetActorIds() const {
       return MakeListView(
-          iterator::make_map_keys_const_iterator(_actors.begin()),
-          iterator::make_map_keys_const_iterator(_actors.end()));
+          boost::make_transform_iterator(_actors.begin(), GetActorId{}),
+          boost::make_transform_iterator(_actors.end(), GetActorId{}));
     }
 
     size_t size() const {
       return _actors.size();
     }
 
+    /// Iterates the actors in the order they were received, the snapshots are
+    /// made on the fly.
     auto begin() const {
-      return iterator::make_map_values_const_iterator(_actors.begin());
+      return boost::make_transform_iterator(_actors.begin(), MakeActorSnapshot{});
     }
 
     auto end() const {
-      return iterator::make_map_values_const_iterator(_actors.end());
+      return boost::make_transform_iterator(_actors.end(), MakeActorSnapshot{});
     }
 
   private:
 
+    /// Returns nullptr if the actor is not present.
+    const ActorDynamicState *Find(ActorId id) const;
+
+    void BuildIndex() const;
+
     template <typename T>
     void CopyActorSnapshotIfPresent(ActorId id, T &value) const {
-      auto it = _actors.find(id);
-      if (it != _actors.end()) {
-        value = it->second;
+      auto actor = Find(id);
+      if (actor != nullptr) {
+        value = MakeActorSnapshot{}(*actor);
       }
     }
 
@@ -112,7 +152,23 @@ namespace detail {
 
     SimulationState _simulation_state;
 
-    std::unordered_map<ActorId, ActorSnapshot> _actors;
+    /// Keeps the received buffer alive, @a _actors points into it.
+    const SharedPtr<const sensor::data::RawEpisodeState> _data;
+
+    const ListView<const ActorDynamicState *> _actors;
+
+    mutable std::once_flag _index_flag;
+
+    /// If the actors were not received sorted by id, the first lookup indexes
+    /// them: by id in @a _positions if the ids are dense, otherwise in
+    /// @a _index as pairs of id and position sorted by id.
+    static constexpr uint32_t NOT_PRESENT = 0xFFFFFFFFu;
+
+    mutable ActorId _min_id = 0u;
+
+    mutable std::vector<uint32_t> _positions;
+
+    mutable std::vector<std::pair<ActorId, uint32_t>> _index;
   };
 
 } // namespace detail
@@ -368,7 +368,8 @@ namespace detail {
 
   void Simulator::SubscribeToSensor(
       const Sensor &sensor,
-      std::function<void(SharedPtr<sensor::SensorData>)> callback) {
+      std::function<void(SharedPtr<sensor::SensorData>)> callback,
+      const double max_rate) {
     DEBUG_ASSERT(_episode != nullptr);
     _client.SubscribeToStream(
         sensor.GetActorDescription().GetStreamToken(),
@@ -376,7 +377,8 @@ namespace detail {
           auto data = sensor::Deserializer::Deserialize(std::move(buffer));
           data->_episode = ep.TryLock();
           cb(std::move(data));
-        });
+        },
+        max_rate);
   }
 
   void Simulator::UnSubscribeFromSensor(const Sensor &sensor) {
@@ -568,6 +568,20 @@ namespace detail {
       _client.StopReplayer(keep_actors);
   }
 
+    /// @}
+    // =========================================================================
+    /// @name Sensor streaming
+    // =========================================================================
+    /// @{
+
+    std::vector<streaming::StreamStatistics> GetStreamingStatistics() {
+      return _client.GetStreamingStatistics();
+    }
+
+    void SetStreamingSendQueue(const streaming::SendQueueSettings &settings) {
+      _client.SetStreamingSendQueue(settings);
+    }
+
     /// @}
     // =========================================================================
     /// @name Operations with sensors
@@ -576,7 +590,8 @@ namespace detail {
 
     void SubscribeToSensor(
         const Sensor &sensor,
-        std::function<void(SharedPtr<sensor::SensorData>)> callback);
+        std::function<void(SharedPtr<sensor::SensorData>)> callback,
+        double max_rate = 0.0);
 
     void UnSubscribeFromSensor(const Sensor &sensor);
 
@@ -20,6 +20,8 @@
 #include <recast/DetourNavMeshQuery.h>
 #include <recast/DetourCommon.h>
 
+#include <unordered_map>
+
 namespace carla {
 namespace nav {
 
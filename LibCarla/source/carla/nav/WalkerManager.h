@@ -12,6 +12,8 @@
 #include "carla/nav/WalkerEvent.h"
 #include "carla/rpc/ActorId.h"
 
+#include <unordered_map>
+
 namespace carla {
 namespace nav {
 
@@ -45,9 +45,16 @@ namespace rpc {
 
     float actor_active_distance = 2000.f; // 2km
 
+    /// Ticks between world states sent in full, the ticks in between only
+    /// send the actors that changed. 0 or 1 sends every tick in full.
+    ///
+    /// @warning A client drops the ticks in between until it gets a full
+    /// one, the server sends one on the tick after any dropped message.
+    uint32_t world_state_keyframe_interval = 0u;
+
     MSGPACK_DEFINE_ARRAY(synchronous_mode, no_rendering_mode, fixed_delta_seconds, substepping,
         max_substep_delta_time, max_substeps, max_culling_distance, deterministic_ragdolls,
-        tile_stream_distance, actor_active_distance);
+        tile_stream_distance, actor_active_distance, world_state_keyframe_interval);
 
     // =========================================================================
     // -- Constructors ---------------------------------------------------------
@@ -65,7 +72,8 @@ namespace rpc {
         float max_culling_distance = 0.0f,
         bool deterministic_ragdolls = true,
         float tile_stream_distance = 3000.f,
-        float actor_active_distance = 2000.f)
+        float actor_active_distance = 2000.f,
+        uint32_t world_state_keyframe_interval = 0u)
       : synchronous_mode(synchronous_mode),
         no_rendering_mode(no_rendering_mode),
         fixed_delta_seconds(
@@ -76,7 +84,8 @@ namespace rpc {
         max_culling_distance(max_culling_distance),
         deterministic_ragdolls(deterministic_ragdolls),
         tile_stream_distance(tile_stream_distance),
-        actor_active_distance(actor_active_distance) {}
+        actor_active_distance(actor_active_distance),
+        world_state_keyframe_interval(world_state_keyframe_interval) {}
 
     // =========================================================================
     // -- Comparison operators -------------------------------------------------
@@ -93,7 +102,8 @@ namespace rpc {
           (max_culling_distance == rhs.max_culling_distance) &&
           (deterministic_ragdolls == rhs.deterministic_ragdolls) &&
           (tile_stream_distance == tile_stream_distance) &&
-          (actor_active_distance == actor_active_distance);
+          (actor_active_distance == actor_active_distance) &&
+          (world_state_keyframe_interval == rhs.world_state_keyframe_interval);
     }
 
     bool operator!=(const EpisodeSettings &rhs) const {
@@ -117,7 +127,8 @@ namespace rpc {
             Settings.MaxCullingDistance,
             Settings.bDeterministicRagdolls,
             Settings.TileStreamingDistance,
-            Settings.ActorActiveDistance) {
+            Settings.ActorActiveDistance,
+            Settings.WorldStateKeyframeInterval) {
       constexpr float CMTOM = 1.f/100.f;
       tile_stream_distance = CMTOM * Settings.TileStreamingDistance;
       actor_active_distance = CMTOM * Settings.ActorActiveDistance;
@@ -138,6 +149,7 @@ namespace rpc {
       Settings.bDeterministicRagdolls = deterministic_ragdolls;
       Settings.TileStreamingDistance = MTOCM * tile_stream_distance;
       Settings.ActorActiveDistance = MTOCM * actor_active_distance;
+      Settings.WorldStateKeyframeInterval = world_state_keyframe_interval;
 
       return Settings;
     }
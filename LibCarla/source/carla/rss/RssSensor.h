@@ -46,6 +46,8 @@ class RssSensor : public Sensor {
 public:
   using Sensor::Sensor;
 
+  using Sensor::Listen;
+
   using ActorConstellationCallbackFunctionType =
       std::function<::carla::rss::ActorConstellationResult(carla::SharedPtr<::carla::rss::ActorConstellationData>)>;
 
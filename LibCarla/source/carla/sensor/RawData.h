@@ -15,6 +15,12 @@
 namespace carla {
 namespace sensor {
 
+namespace s11n {
+
+  class EpisodeStateSerializer;
+
+} // namespace s11n
+
   /// Wrapper around the raw data generated by a sensor plus some useful
   /// meta-information.
   class RawData {
@@ -89,6 +95,8 @@ namespace sensor {
     template <typename... Items>
     friend class CompositeSerializer;
 
+    friend class s11n::EpisodeStateSerializer;
+
     RawData(Buffer &&buffer) : _buffer(std::move(buffer)) {}
 
     Buffer _buffer;
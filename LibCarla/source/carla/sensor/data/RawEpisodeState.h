@@ -24,8 +24,13 @@ namespace data {
 
     friend Serializer;
 
+    /// The actors of a delta tick are not an array of ActorDynamicState, it
+    /// looks empty until its keyframe is applied.
     explicit RawEpisodeState(RawData &&data)
-      : Super(Serializer::header_offset, std::move(data)) {}
+      : Super(std::move(data), [](const RawData &d) {
+          const bool is_delta = (Serializer::DeserializeHeader(d).simulation_state & Serializer::Delta) != 0;
+          return is_delta ? d.size() : Serializer::header_offset;
+        }) {}
 
   private:
 
@@ -66,6 +71,12 @@ namespace data {
       return GetHeader().simulation_state;
     }
 
+    /// Whether this tick only holds the changes since a keyframe, see
+    /// EpisodeStateSerializer::ApplyDelta.
+    bool IsDelta() const {
+      return (GetSimulationState() & Serializer::Delta) != 0;
+    }
+
   };
 
 } // namespace data
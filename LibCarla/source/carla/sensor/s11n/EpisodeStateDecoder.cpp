@@ -0,0 +1,35 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/sensor/s11n/EpisodeStateDecoder.h"
+
+#include "carla/Debug.h"
+#include "carla/sensor/s11n/EpisodeStateSerializer.h"
+
+namespace carla {
+namespace sensor {
+namespace s11n {
+
+  SharedPtr<const data::RawEpisodeState> EpisodeStateDecoder::Decode(
+      SharedPtr<const data::RawEpisodeState> data) {
+    DEBUG_ASSERT(data != nullptr);
+    if (!data->IsDelta()) {
+      _keyframe = data;
+      return data;
+    }
+    if (_keyframe == nullptr) {
+      return nullptr;
+    }
+    SharedPtr<const data::RawEpisodeState> full = EpisodeStateSerializer::ApplyDelta(*_keyframe, *data);
+    if (full == nullptr) {
+      _keyframe = nullptr;
+    }
+    return full;
+  }
+
+} // namespace s11n
+} // namespace sensor
+} // namespace carla
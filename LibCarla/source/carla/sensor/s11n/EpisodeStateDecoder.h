@@ -0,0 +1,41 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/sensor/data/RawEpisodeState.h"
+
+namespace carla {
+namespace sensor {
+namespace s11n {
+
+  /// Rebuilds the full episode state of each tick written by an
+  /// EpisodeStateEncoder, used by the client.
+  ///
+  /// Keeps the last keyframe received. A delta of another keyframe, or one
+  /// that does not apply, is dropped with the ticks after it until the next
+  /// keyframe arrives.
+  class EpisodeStateDecoder : private NonCopyable {
+  public:
+
+    /// Returns the full state of the tick @a data, or nullptr if it has to be
+    /// dropped.
+    SharedPtr<const data::RawEpisodeState> Decode(SharedPtr<const data::RawEpisodeState> data);
+
+    bool HasKeyframe() const {
+      return _keyframe != nullptr;
+    }
+
+  private:
+
+    SharedPtr<const data::RawEpisodeState> _keyframe;
+  };
+
+} // namespace s11n
+} // namespace sensor
+} // namespace carla
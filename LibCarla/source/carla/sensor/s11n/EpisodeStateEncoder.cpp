@@ -0,0 +1,125 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/sensor/s11n/EpisodeStateEncoder.h"
+
+#include "carla/Debug.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace carla {
+namespace sensor {
+namespace s11n {
+
+  using Serializer = EpisodeStateSerializer;
+
+  void EpisodeStateEncoder::SetKeyframeInterval(uint32_t interval) {
+    if (interval != _keyframe_interval) {
+      _keyframe_interval = interval;
+      _has_keyframe = false;
+      if (interval <= 1u) {
+        _keyframe.clear();
+        _keyframe.shrink_to_fit();
+      }
+    }
+  }
+
+  void EpisodeStateEncoder::Encode(
+      const uint64_t frame,
+      Header header,
+      const std::vector<data::ActorDynamicState> &actors,
+      Buffer &buffer) {
+    DEBUG_ASSERT(std::is_sorted(actors.begin(), actors.end(), [](const auto &lhs, const auto &rhs) {
+      return lhs.id < rhs.id;
+    }));
+    const size_t full_size = sizeof(data::ActorDynamicState) * actors.size();
+
+    const bool is_keyframe_due =
+        (_keyframe_interval <= 1u) ||
+        !_has_keyframe ||
+        (_keyframe_episode_id != header.episode_id) ||
+        (_ticks_since_keyframe + 1u >= _keyframe_interval);
+    if (!is_keyframe_due) {
+      Diff(actors);
+      const size_t delta_size =
+          sizeof(Serializer::DeltaHeader) +
+          sizeof(ActorId) * _removed.size() +
+          sizeof(DeltaActorState) * _changed.size();
+      // Most actors changed, a keyframe is no bigger.
+      if (delta_size < full_size) {
+        header.simulation_state = static_cast<Serializer::SimulationState>(
+            header.simulation_state | Serializer::Delta);
+        const Serializer::DeltaHeader delta_header{
+            _keyframe_frame,
+            static_cast<uint32_t>(_removed.size()),
+            static_cast<uint32_t>(_changed.size())};
+        buffer.reset(sizeof(header) + delta_size);
+        auto *destination = buffer.data();
+        std::memcpy(destination, &header, sizeof(header));
+        destination += sizeof(header);
+        std::memcpy(destination, &delta_header, sizeof(delta_header));
+        destination += sizeof(delta_header);
+        if (!_removed.empty()) {
+          std::memcpy(destination, _removed.data(), sizeof(ActorId) * _removed.size());
+          destination += sizeof(ActorId) * _removed.size();
+        }
+        if (!_changed.empty()) {
+          std::memcpy(destination, _changed.data(), sizeof(DeltaActorState) * _changed.size());
+        }
+        ++_ticks_since_keyframe;
+        return;
+      }
+    }
+
+    header.simulation_state = static_cast<Serializer::SimulationState>(
+        header.simulation_state | Serializer::ActorsSortedById);
+    buffer.reset(sizeof(header) + full_size);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    if (!actors.empty()) {
+      std::memcpy(buffer.data() + sizeof(header), actors.data(), full_size);
+    }
+
+    if (_keyframe_interval > 1u) {
+      _has_keyframe = true;
+      _ticks_since_keyframe = 0u;
+      _keyframe_frame = frame;
+      _keyframe_episode_id = header.episode_id;
+      _keyframe.clear();
+      _keyframe.reserve(actors.size());
+      for (auto &&actor : actors) {
+        _keyframe.emplace_back(Serializer::MakeDeltaActorState(actor));
+      }
+    }
+  }
+
+  void EpisodeStateEncoder::Diff(const std::vector<data::ActorDynamicState> &actors) {
+    _removed.clear();
+    _changed.clear();
+    auto keyframe = _keyframe.begin();
+    for (auto &&actor : actors) {
+      while ((keyframe != _keyframe.end()) && (keyframe->id < actor.id)) {
+        _removed.emplace_back(keyframe->id);
+        ++keyframe;
+      }
+      const DeltaActorState current = Serializer::MakeDeltaActorState(actor);
+      if ((keyframe != _keyframe.end()) && (keyframe->id == actor.id)) {
+        if (std::memcmp(&current, &*keyframe, sizeof(current)) != 0) {
+          _changed.emplace_back(current);
+        }
+        ++keyframe;
+      } else {
+        _changed.emplace_back(current);
+      }
+    }
+    for (; keyframe != _keyframe.end(); ++keyframe) {
+      _removed.emplace_back(keyframe->id);
+    }
+  }
+
+} // namespace s11n
+} // namespace sensor
+} // namespace carla
@@ -0,0 +1,82 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+#include "carla/NonCopyable.h"
+#include "carla/sensor/data/ActorDynamicState.h"
+#include "carla/sensor/s11n/EpisodeStateSerializer.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace carla {
+namespace sensor {
+namespace s11n {
+
+  /// Writes the episode state of each tick, used by the server.
+  ///
+  /// In delta mode every few ticks is sent in full as a keyframe, and the
+  /// ticks in between only hold the actors removed, added or changed since
+  /// that keyframe, with their transforms quantized. The changes are relative
+  /// to the keyframe and not to the previous tick, so a client that misses
+  /// ticks still rebuilds the next one it receives.
+  class EpisodeStateEncoder : private NonCopyable {
+  public:
+
+    using Header = EpisodeStateSerializer::Header;
+
+    /// Ticks from one keyframe to the next, 0 or 1 sends every tick in full.
+    void SetKeyframeInterval(uint32_t interval);
+
+    uint32_t GetKeyframeInterval() const {
+      return _keyframe_interval;
+    }
+
+    /// Sends the next tick in full, so a client that just subscribed does not
+    /// wait for the next keyframe.
+    void ForceKeyframe() {
+      _has_keyframe = false;
+    }
+
+    /// Writes @a header followed by @a actors, which must be sorted by id, or
+    /// by their changes since the keyframe. @a frame is the frame the message
+    /// is sent with.
+    void Encode(
+        uint64_t frame,
+        Header header,
+        const std::vector<data::ActorDynamicState> &actors,
+        Buffer &buffer);
+
+  private:
+
+    using DeltaActorState = EpisodeStateSerializer::DeltaActorState;
+
+    /// Fills @a _removed and @a _changed.
+    void Diff(const std::vector<data::ActorDynamicState> &actors);
+
+    uint32_t _keyframe_interval = 0u;
+
+    bool _has_keyframe = false;
+
+    uint32_t _ticks_since_keyframe = 0u;
+
+    uint64_t _keyframe_frame = 0u;
+
+    uint64_t _keyframe_episode_id = 0u;
+
+    /// Quantized so unchanged actors compare equal.
+    std::vector<DeltaActorState> _keyframe;
+
+    std::vector<ActorId> _removed;
+
+    std::vector<DeltaActorState> _changed;
+  };
+
+} // namespace s11n
+} // namespace sensor
+} // namespace carla
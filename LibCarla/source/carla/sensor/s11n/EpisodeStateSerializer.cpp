@@ -6,7 +6,11 @@
 
 #include "carla/sensor/s11n/EpisodeStateSerializer.h"
 
+#include "carla/Logging.h"
 #include "carla/sensor/data/RawEpisodeState.h"
+#include "carla/sensor/s11n/SensorHeaderSerializer.h"
+
+#include <cstring>
 
 namespace carla {
 namespace sensor {
@@ -16,6 +20,90 @@ namespace s11n {
     return SharedPtr<data::RawEpisodeState>(new data::RawEpisodeState{std::move(data)});
   }
 
+  SharedPtr<data::RawEpisodeState> EpisodeStateSerializer::ApplyDelta(
+      const data::RawEpisodeState &keyframe,
+      const data::RawEpisodeState &delta) {
+    DEBUG_ASSERT(!keyframe.IsDelta());
+    DEBUG_ASSERT(delta.IsDelta());
+    const RawData &message = delta.GetRawData();
+    const auto *payload = message.begin() + header_offset;
+    if (message.size() < header_offset + sizeof(DeltaHeader)) {
+      log_warning("episode state: truncated delta for frame", message.GetFrame());
+      return nullptr;
+    }
+    DeltaHeader delta_header;
+    std::memcpy(&delta_header, payload, sizeof(delta_header));
+    if (delta_header.keyframe != keyframe.GetFrame()) {
+      return nullptr;
+    }
+    // Nothing below is read before the sizes are known to match the message.
+    const size_t expected_size =
+        header_offset +
+        sizeof(DeltaHeader) +
+        sizeof(ActorId) * static_cast<size_t>(delta_header.number_of_removed_actors) +
+        sizeof(DeltaActorState) * static_cast<size_t>(delta_header.number_of_changed_actors);
+    if ((message.size() != expected_size) ||
+        (delta_header.number_of_removed_actors > keyframe.size())) {
+      log_warning("episode state: malformed delta for frame", message.GetFrame());
+      return nullptr;
+    }
+    // The ids are not aligned, they are copied out one by one.
+    const auto *removed = payload + sizeof(DeltaHeader);
+    const auto *removed_end = removed + sizeof(ActorId) * delta_header.number_of_removed_actors;
+    const auto next_removed = [&]() {
+      ActorId id;
+      std::memcpy(&id, removed, sizeof(id));
+      return id;
+    };
+    const auto *changed = reinterpret_cast<const DeltaActorState *>(removed_end);
+    const auto *changed_end = changed + delta_header.number_of_changed_actors;
+    DEBUG_ASSERT(reinterpret_cast<const unsigned char *>(changed_end) == message.end());
+
+    // At most, every changed actor was added, and a removed id missing from
+    // the keyframe removes nothing. The buffer shrinks to the actual size once
+    // merged.
+    const size_t max_number_of_actors = keyframe.size() + delta_header.number_of_changed_actors;
+    Buffer buffer(
+        SensorHeaderSerializer::header_offset +
+        header_offset +
+        sizeof(data::ActorDynamicState) * max_number_of_actors);
+
+    const SensorHeaderSerializer::Header sensor_header{
+        message.GetSensorTypeId(),
+        message.GetFrame(),
+        message.GetTimestamp(),
+        message.GetSensorTransform()};
+    std::memcpy(buffer.data(), &sensor_header, sizeof(sensor_header));
+
+    Header header = DeserializeHeader(message);
+    header.simulation_state = static_cast<SimulationState>(
+        (header.simulation_state & ~Delta) | ActorsSortedById);
+    std::memcpy(buffer.data() + SensorHeaderSerializer::header_offset, &header, sizeof(header));
+
+    // Merge the keyframe with the changes, all sorted by id.
+    auto *output = reinterpret_cast<data::ActorDynamicState *>(
+        buffer.data() + SensorHeaderSerializer::header_offset + header_offset);
+    auto it = keyframe.begin();
+    while ((it != keyframe.end()) || (changed != changed_end)) {
+      if ((changed != changed_end) && ((it == keyframe.end()) || (changed->id <= it->id))) {
+        if ((it != keyframe.end()) && (it->id == changed->id)) {
+          ++it;
+        }
+        *output++ = MakeActorDynamicState(*changed++);
+      } else if ((removed != removed_end) && (next_removed() == it->id)) {
+        removed += sizeof(ActorId);
+        ++it;
+      } else {
+        *output++ = *it++;
+      }
+    }
+    DEBUG_ASSERT(removed == removed_end);
+    buffer.resize(static_cast<uint64_t>(reinterpret_cast<unsigned char *>(output) - buffer.data()));
+
+    return SharedPtr<data::RawEpisodeState>(
+        new data::RawEpisodeState{RawData{std::move(buffer)}});
+  }
+
 } // namespace s11n
 } // namespace sensor
 } // namespace carla
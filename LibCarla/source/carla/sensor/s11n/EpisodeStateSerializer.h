@@ -14,23 +14,40 @@
 #include "carla/sensor/RawData.h"
 #include "carla/sensor/data/ActorDynamicState.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <limits>
 
 namespace carla {
 namespace sensor {
 
   class SensorData;
 
+namespace data {
+
+  class RawEpisodeState;
+
+} // namespace data
+
 namespace s11n {
 
   /// Serializes the current state of the whole episode.
+  ///
+  /// The header is followed either by every actor, sorted by id in the
+  /// current servers, or, if the Delta flag is set, by the changes since the
+  /// last tick sent in full (the keyframe), see EpisodeStateEncoder.
   class EpisodeStateSerializer {
   public:
 
     enum SimulationState {
       None               = (0x0 << 0),
       MapChange          = (0x1 << 0),
-      PendingLightUpdate = (0x1 << 1)
+      PendingLightUpdate = (0x1 << 1),
+      /// The actors follow the header sorted by id.
+      ActorsSortedById   = (0x1 << 2),
+      /// A DeltaHeader and the changes since the keyframe follow the header.
+      Delta              = (0x1 << 3)
     };
 
 #pragma pack(push, 1)
@@ -41,10 +58,87 @@ namespace s11n {
       geom::Vector3DInt map_origin;
       SimulationState simulation_state = SimulationState::None;
     };
+
+    /// Follows the header in the ticks flagged as Delta. The ids of the
+    /// actors removed since the keyframe follow, then the actors added or
+    /// changed, both sorted by id.
+    struct DeltaHeader {
+      /// Frame of the keyframe the changes apply to.
+      uint64_t keyframe;
+      uint32_t number_of_removed_actors;
+      uint32_t number_of_changed_actors;
+    };
+
+    /// Location in millimetres and rotation in 1/65536 of a turn.
+    struct QuantizedTransform {
+      int32_t x;
+      int32_t y;
+      int32_t z;
+      int16_t pitch;
+      int16_t yaw;
+      int16_t roll;
+    };
+
+    /// Actor added or changed since the keyframe.
+    struct DeltaActorState {
+      ActorId id;
+      rpc::ActorState actor_state;
+      QuantizedTransform transform;
+      geom::Vector3D velocity;
+      geom::Vector3D angular_velocity;
+      geom::Vector3D acceleration;
+      data::ActorDynamicState::TypeDependentState state;
+    };
 #pragma pack(pop)
 
     constexpr static auto header_offset = sizeof(Header);
 
+    static QuantizedTransform Quantize(const geom::Transform &transform) {
+      return {
+          QuantizeLength(transform.location.x),
+          QuantizeLength(transform.location.y),
+          QuantizeLength(transform.location.z),
+          QuantizeAngle(transform.rotation.pitch),
+          QuantizeAngle(transform.rotation.yaw),
+          QuantizeAngle(transform.rotation.roll)};
+    }
+
+    static geom::Transform Dequantize(const QuantizedTransform &transform) {
+      return {
+          geom::Location{
+              DequantizeLength(transform.x),
+              DequantizeLength(transform.y),
+              DequantizeLength(transform.z)},
+          geom::Rotation{
+              DequantizeAngle(transform.pitch),
+              DequantizeAngle(transform.yaw),
+              DequantizeAngle(transform.roll)}};
+    }
+
+    static DeltaActorState MakeDeltaActorState(const data::ActorDynamicState &actor) {
+      DeltaActorState result;
+      result.id = actor.id;
+      result.actor_state = actor.actor_state;
+      result.transform = Quantize(actor.transform);
+      result.velocity = actor.velocity;
+      result.angular_velocity = actor.angular_velocity;
+      result.acceleration = actor.acceleration;
+      result.state = actor.state;
+      return result;
+    }
+
+    static data::ActorDynamicState MakeActorDynamicState(const DeltaActorState &actor) {
+      data::ActorDynamicState result;
+      result.id = actor.id;
+      result.actor_state = actor.actor_state;
+      result.transform = Dequantize(actor.transform);
+      result.velocity = actor.velocity;
+      result.angular_velocity = actor.angular_velocity;
+      result.acceleration = actor.acceleration;
+      result.state = actor.state;
+      return result;
+    }
+
     static const Header &DeserializeHeader(const RawData &message) {
       return *reinterpret_cast<const Header *>(message.begin());
     }
@@ -55,6 +149,33 @@ namespace s11n {
     }
 
     static SharedPtr<SensorData> Deserialize(RawData &&data);
+
+    /// Rebuilds the full state of the tick @a delta from its @a keyframe.
+    /// Returns nullptr if @a delta applies to another keyframe or its sizes
+    /// do not match the message.
+    static SharedPtr<data::RawEpisodeState> ApplyDelta(
+        const data::RawEpisodeState &keyframe,
+        const data::RawEpisodeState &delta);
+
+  private:
+
+    static int32_t QuantizeLength(float meters) {
+      constexpr double max = std::numeric_limits<int32_t>::max();
+      return static_cast<int32_t>(std::llround(std::max(-max, std::min(max, 1e3 * meters))));
+    }
+
+    static float DequantizeLength(int32_t millimeters) {
+      return 1e-3f * static_cast<float>(millimeters);
+    }
+
+    static int16_t QuantizeAngle(float degrees) {
+      const auto turns = std::llround(static_cast<double>(degrees) * (65536.0 / 360.0));
+      return static_cast<int16_t>(static_cast<uint16_t>(turns & 0xFFFF));
+    }
+
+    static float DequantizeAngle(int16_t angle) {
+      return static_cast<float>(angle) * (360.0f / 65536.0f);
+    }
   };
 
 } // namespace s11n
@@ -33,17 +33,24 @@ namespace streaming {
       _service.Stop();
     }
 
+    /// If @a max_rate is positive, the server sends at most that many messages
+    /// per second to this client.
+    ///
     /// @warning cannot subscribe twice to the same stream (even if it's a
     /// MultiStream).
     template <typename Functor>
-    void Subscribe(const Token &token, Functor &&callback) {
-      _client.Subscribe(_service.io_context(), token, std::forward<Functor>(callback));
+    void Subscribe(const Token &token, Functor &&callback, double max_rate = 0.0) {
+      _client.Subscribe(_service.io_context(), token, std::forward<Functor>(callback), max_rate);
     }
 
     void UnSubscribe(const Token &token) {
       _client.UnSubscribe(token);
     }
 
+    void SetSharedMemory(bool enable) {
+      _client.SetSharedMemory(enable);
+    }
+
     void Run() {
       _service.Run();
     }
@@ -0,0 +1,90 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/MsgPack.h"
+
+#include <cstdint>
+
+namespace carla {
+namespace streaming {
+
+  /// What a server session does with a new message when its send queue is
+  /// full.
+  enum class SendPolicy : uint8_t {
+    /// Waits up to the block timeout for the client to catch up, then drops
+    /// the new message.
+    Block,
+    /// Drops the oldest queued messages to make room.
+    DropOldest,
+    /// Drops the new message.
+    DropNewest,
+    /// Keeps only the latest message queued, whatever the capacity.
+    KeepLatest
+  };
+
+  /// Bounds of the queue of messages waiting to be sent to each client. A
+  /// message is always accepted into an empty queue, whatever its size. In
+  /// synchronous mode the policy is always Block.
+  struct SendQueueSettings {
+    SendPolicy policy = SendPolicy::DropNewest;
+
+    uint32_t max_messages = 4u;
+
+    uint64_t max_bytes = 64u * 1024u * 1024u;
+
+    /// In seconds.
+    double block_timeout = 1.0;
+
+    MSGPACK_DEFINE_ARRAY(policy, max_messages, max_bytes, block_timeout);
+  };
+
+  /// Counters of the messages sent by a stream, summed over all the clients
+  /// subscribed to it since it was created.
+  struct StreamStatistics {
+    uint32_t stream_id = 0u;
+
+    /// Clients currently subscribed.
+    uint32_t sessions = 0u;
+
+    /// Messages waiting to be sent right now.
+    uint64_t queued_messages = 0u;
+
+    uint64_t queued_bytes = 0u;
+
+    uint64_t sent_messages = 0u;
+
+    uint64_t sent_bytes = 0u;
+
+    uint64_t dropped_messages = 0u;
+
+    uint64_t dropped_bytes = 0u;
+
+    /// Time from a message being written to the stream until it is sent
+    /// through the socket or copied to the shared memory ring, in
+    /// milliseconds.
+    double mean_write_latency = 0.0;
+
+    double max_write_latency = 0.0;
+
+    MSGPACK_DEFINE_ARRAY(
+        stream_id,
+        sessions,
+        queued_messages,
+        queued_bytes,
+        sent_messages,
+        sent_bytes,
+        dropped_messages,
+        dropped_bytes,
+        mean_write_latency,
+        max_write_latency);
+  };
+
+} // namespace streaming
+} // namespace carla
+
+MSGPACK_ADD_ENUM(carla::streaming::SendPolicy);
@@ -64,6 +64,18 @@ namespace streaming {
       _server.SetSynchronousMode(is_synchro);
     }
 
+    void SetSharedMemory(bool enable) {
+      _server.SetSharedMemory(enable);
+    }
+
+    void SetSendQueue(const SendQueueSettings &settings) {
+      _server.SetSendQueue(settings);
+    }
+
+    std::vector<StreamStatistics> GetStreamStatistics() {
+      return _server.GetStreamStatistics();
+    }
+
   private:
 
     // The order of these two arguments is very important.
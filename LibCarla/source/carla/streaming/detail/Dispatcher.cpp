@@ -10,6 +10,7 @@
 #include "carla/Logging.h"
 #include "carla/streaming/detail/MultiStreamState.h"
 
+#include <algorithm>
 #include <exception>
 
 namespace carla {
@@ -53,6 +54,11 @@ namespace detail {
     return MakeStreamState<MultiStreamState>(_cached_token, _stream_map);
   }
 
+  void Dispatcher::SetSharedMemory(const bool enable) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cached_token.set_shared_memory(enable);
+  }
+
   bool Dispatcher::RegisterSession(std::shared_ptr<Session> session) {
     DEBUG_ASSERT(session != nullptr);
     std::lock_guard<std::mutex> lock(_mutex);
@@ -83,6 +89,22 @@ namespace detail {
     }
   }
 
+  std::vector<StreamStatistics> Dispatcher::GetStatistics() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<StreamStatistics> result;
+    result.reserve(_stream_map.size());
+    for (auto &pair : _stream_map) {
+      auto stream_state = pair.second.lock();
+      if (stream_state != nullptr) {
+        result.emplace_back(stream_state->GetStatistics());
+      }
+    }
+    std::sort(result.begin(), result.end(), [](const auto &lhs, const auto &rhs) {
+      return lhs.stream_id < rhs.stream_id;
+    });
+    return result;
+  }
+
   void Dispatcher::ClearExpiredStreams() {
     for (auto it = _stream_map.begin(); it != _stream_map.end(); ) {
       if (it->second.expired()) {
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "carla/streaming/EndPoint.h"
+#include "carla/streaming/SendQueue.h"
 #include "carla/streaming/Stream.h"
 #include "carla/streaming/detail/Session.h"
 #include "carla/streaming/detail/Token.h"
@@ -14,6 +15,7 @@
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace streaming {
@@ -33,10 +35,17 @@ namespace detail {
 
     carla::streaming::Stream MakeStream();
 
+    /// Whether the tokens of the streams created from now on offer streaming
+    /// through shared memory.
+    void SetSharedMemory(bool enable);
+
     bool RegisterSession(std::shared_ptr<Session> session);
 
     void DeregisterSession(std::shared_ptr<Session> session);
 
+    /// Counters of every stream still alive.
+    std::vector<StreamStatistics> GetStatistics();
+
   private:
 
     void ClearExpiredStreams();
@@ -11,9 +11,10 @@
 #include "carla/streaming/detail/StreamStateBase.h"
 #include "carla/streaming/detail/tcp/Message.h"
 
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <vector>
-#include <atomic>
 
 namespace carla {
 namespace streaming {
@@ -21,89 +22,87 @@ namespace detail {
 
   /// A stream state that can hold any number of sessions.
   ///
-  /// @todo Lacking some optimization.
+  /// The list of sessions is copy-on-write: connecting or disconnecting a
+  /// session publishes a new list, so writing a message takes no lock and
+  /// only walks a snapshot of the sessions. The message is serialized once
+  /// and shared by all of them.
   class MultiStreamState final : public StreamStateBase {
   public:
 
     using StreamStateBase::StreamStateBase;
 
-    MultiStreamState(const token_type &token) : 
-      StreamStateBase(token), 
-      _session(nullptr)
+    MultiStreamState(const token_type &token) :
+      StreamStateBase(token),
+      _sessions(std::make_shared<const SessionList>())
       {};
 
     template <typename... Buffers>
     void Write(Buffers &&... buffers) {
-      auto message = Session::MakeMessage(std::move(buffers)...);
-
-      // try write single stream
-      auto session = _session.load();
-      if (session != nullptr) {
-        session->Write(std::move(message));
-        // Return here, _session is only valid if we have a 
-        // single session.
-        return; 
+      const auto sessions = _sessions.load();
+      if (sessions->empty()) {
+        return;
       }
-
-      // try write multiple stream
-      std::lock_guard<std::mutex> lock(_mutex);
-      for (auto &s : _sessions) {
-        if (s != nullptr) {
-          s->Write(message);
-        }
+      const auto message = Session::MakeMessage(std::move(buffers)...);
+      for (auto &session : *sessions) {
+        session->Write(message);
       }
     }
 
+    /// Number of sessions connected since the stream was created, it changes
+    /// whenever a client subscribes.
+    uint64_t GetNumberOfConnections() const {
+      return _connections;
+    }
+
   private:
 
+    using SessionList = std::vector<std::shared_ptr<Session>>;
+
     void ConnectSession(std::shared_ptr<Session> session) final {
       DEBUG_ASSERT(session != nullptr);
+      session->SetStatistics(send_statistics());
       std::lock_guard<std::mutex> lock(_mutex);
-      _sessions.emplace_back(std::move(session));
-      log_debug("Connecting multistream sessions:", _sessions.size());
-      if (_sessions.size() == 1) {
-        _session.store(_sessions[0]);
-      }
-      else if (_sessions.size() > 1) {
-        _session.store(nullptr);
-      }
+      auto sessions = std::make_shared<SessionList>(*_sessions.load());
+      sessions->emplace_back(std::move(session));
+      log_debug("Connecting multistream sessions:", sessions->size());
+      _sessions.store(std::move(sessions));
+      ++_connections;
     }
 
     void DisconnectSession(std::shared_ptr<Session> session) final {
       DEBUG_ASSERT(session != nullptr);
       std::lock_guard<std::mutex> lock(_mutex);
-      if (_sessions.size() == 0) return;
-      if (_sessions.size() == 1) {
-        DEBUG_ASSERT(session == _session.load());
-        _session.store(nullptr);
-        _sessions.clear();
-      } else {
-        _sessions.erase(
-            std::remove(_sessions.begin(), _sessions.end(), session),
-            _sessions.end());
-        
-        // set single session if only one
-        if (_sessions.size() == 1)
-          _session.store(_sessions[0]);
-        else
-          _session.store(nullptr);
+      const auto current = _sessions.load();
+      if (std::find(current->begin(), current->end(), session) == current->end()) {
+        return;
+      }
+      auto sessions = std::make_shared<SessionList>();
+      sessions->reserve(current->size() - 1u);
+      for (auto &s : *current) {
+        if (s != session) {
+          sessions->emplace_back(s);
+        }
       }
-      log_debug("Disconnecting multistream sessions:", _sessions.size());
+      log_debug("Disconnecting multistream sessions:", sessions->size());
+      _sessions.store(std::move(sessions));
     }
 
     void ClearSessions() final {
       std::lock_guard<std::mutex> lock(_mutex);
-      _sessions.clear();
-      _session.store(nullptr);
+      _sessions.store(std::make_shared<const SessionList>());
       log_debug("Disconnecting all multistream sessions");
     }
 
+    size_t GetNumberOfSessions() final {
+      return _sessions.load()->size();
+    }
+
+    /// Serializes the changes to the list, writers do not take it.
     std::mutex _mutex;
 
-    // if there is only one session, then we use atomic
-    AtomicSharedPtr<Session> _session;
-    // if there are more than one session, we use vector of sessions with mutex
-    std::vector<std::shared_ptr<Session>> _sessions;
+    AtomicSharedPtr<const SessionList> _sessions;
+
+    std::atomic<uint64_t> _connections{0u};
   };
 
 } // namespace detail
@@ -0,0 +1,94 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/streaming/SendQueue.h"
+#include "carla/streaming/detail/Types.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+
+  /// Counters of the messages sent by a stream, shared by all its sessions.
+  /// Thread safe and lock free.
+  class SendStatistics : private NonCopyable {
+  public:
+
+    using clock = std::chrono::steady_clock;
+
+    void Queued(size_t bytes) {
+      ++_queued_messages;
+      _queued_bytes += bytes;
+    }
+
+    /// The message left the queue, either to be sent or dropped.
+    void Dequeued(size_t bytes) {
+      --_queued_messages;
+      _queued_bytes -= bytes;
+    }
+
+    void Dropped(size_t bytes) {
+      ++_dropped_messages;
+      _dropped_bytes += bytes;
+    }
+
+    void Sent(size_t bytes, clock::time_point written) {
+      const auto latency = static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - written).count());
+      ++_sent_messages;
+      _sent_bytes += bytes;
+      _latency_total += latency;
+      uint64_t max = _latency_max.load(std::memory_order_relaxed);
+      while (latency > max && !_latency_max.compare_exchange_weak(max, latency));
+    }
+
+    StreamStatistics GetStatistics(stream_id_type stream_id, size_t sessions) const {
+      StreamStatistics result;
+      result.stream_id = stream_id;
+      result.sessions = static_cast<uint32_t>(sessions);
+      result.queued_messages = _queued_messages;
+      result.queued_bytes = _queued_bytes;
+      result.sent_messages = _sent_messages;
+      result.sent_bytes = _sent_bytes;
+      result.dropped_messages = _dropped_messages;
+      result.dropped_bytes = _dropped_bytes;
+      if (result.sent_messages > 0u) {
+        result.mean_write_latency =
+            1e-6 * static_cast<double>(_latency_total) / static_cast<double>(result.sent_messages);
+      }
+      result.max_write_latency = 1e-6 * static_cast<double>(_latency_max);
+      return result;
+    }
+
+  private:
+
+    std::atomic<uint64_t> _queued_messages{0u};
+
+    std::atomic<uint64_t> _queued_bytes{0u};
+
+    std::atomic<uint64_t> _sent_messages{0u};
+
+    std::atomic<uint64_t> _sent_bytes{0u};
+
+    std::atomic<uint64_t> _dropped_messages{0u};
+
+    std::atomic<uint64_t> _dropped_bytes{0u};
+
+    /// In nanoseconds.
+    std::atomic<uint64_t> _latency_total{0u};
+
+    std::atomic<uint64_t> _latency_max{0u};
+  };
+
+} // namespace detail
+} // namespace streaming
+} // namespace carla
@@ -0,0 +1,386 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/streaming/detail/SharedMemoryRing.h"
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+
+#ifdef __linux__
+#  include <fcntl.h>
+#  include <linux/futex.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <sys/syscall.h>
+#  include <time.h>
+#  include <unistd.h>
+#endif // __linux__
+
+namespace carla {
+namespace streaming {
+namespace detail {
+
+  constexpr size_t SharedMemoryRing::SLOT_SIZE;
+  constexpr size_t SharedMemoryRing::DEFAULT_CAPACITY;
+  constexpr size_t SharedMemoryRing::MAX_CAPACITY;
+  constexpr size_t SharedMemoryRing::MAX_MESSAGE_SIZE;
+  constexpr size_t SharedMemoryRing::MAX_NAME_LENGTH;
+
+  static_assert(ATOMIC_INT_LOCK_FREE == 2, "Shared memory atomics must be lock free.");
+
+  /// Beginning of the segment. Positions count slots and wrap around, the
+  /// number of slots is a power of two so they stay consistent when they do.
+  struct SharedMemoryRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_size;
+    uint32_t slot_count;
+    /// Slots published by the writer.
+    alignas(64) std::atomic<uint32_t> head;
+    std::atomic<uint32_t> reader_waiting;
+    /// Slots released by the reader.
+    alignas(64) std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> writer_waiting;
+    alignas(64) std::atomic<uint32_t> closed;
+  };
+
+  namespace {
+
+    struct RecordHeader {
+      uint32_t kind;
+      uint32_t size;
+    };
+
+    constexpr uint32_t MAGIC = 0x52534c43u;
+    constexpr uint32_t VERSION = 1u;
+
+    static_assert(sizeof(RecordHeader) == 8u, "Unexpected padding in the record header.");
+
+    /// The header takes the first slot.
+    constexpr size_t HEADER_SIZE = SharedMemoryRing::SLOT_SIZE;
+
+    uint32_t SlotsFor(const size_t size) {
+      return static_cast<uint32_t>(
+          (sizeof(RecordHeader) + size + SharedMemoryRing::SLOT_SIZE - 1u) / SharedMemoryRing::SLOT_SIZE);
+    }
+
+#ifdef __linux__
+
+    std::string MakePath(const std::string &name) {
+      return "/dev/shm" + name;
+    }
+
+    /// Sleeps while @a word holds @a expected, up to @a timeout.
+    void FutexWait(std::atomic<uint32_t> &word, const uint32_t expected, const time_duration timeout) {
+      const size_t ms = timeout.milliseconds();
+      struct timespec relative;
+      relative.tv_sec = static_cast<time_t>(ms / 1000u);
+      relative.tv_nsec = static_cast<long>((ms % 1000u) * 1000000u);
+      ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+    }
+
+    void FutexWake(std::atomic<uint32_t> &word) {
+      ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+    }
+
+#endif // __linux__
+
+  } // namespace
+
+  bool SharedMemoryRing::IsSupported() {
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif // __linux__
+  }
+
+#ifdef __linux__
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(const size_t capacity) {
+    static std::atomic<uint32_t> counter{0u};
+    if (capacity > MAX_CAPACITY) {
+      return nullptr;
+    }
+    uint32_t slot_count = 2u;
+    while (static_cast<size_t>(slot_count) * SLOT_SIZE < capacity) {
+      slot_count <<= 1u;
+    }
+    const size_t size = HEADER_SIZE + static_cast<size_t>(slot_count) * SLOT_SIZE;
+
+    std::random_device random;
+    const std::string name =
+        "/carla-stream-" + std::to_string(::getpid()) +
+        "-" + std::to_string(counter++) +
+        "-" + std::to_string(random());
+    DEBUG_ASSERT(name.size() < MAX_NAME_LENGTH);
+    const std::string path = MakePath(name);
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0) {
+      log_debug("shared memory: cannot create", path);
+      return nullptr;
+    }
+    // Unlike ftruncate, this fails if /dev/shm cannot hold the ring, instead
+    // of a SIGBUS when a page is touched later.
+    void *memory = MAP_FAILED;
+    const int error = ::posix_fallocate(fd, 0, static_cast<off_t>(size));
+    if (error == 0) {
+      memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (error != 0) {
+      log_debug("shared memory: cannot allocate", size, "bytes for", path);
+      ::unlink(path.c_str());
+      return nullptr;
+    }
+    if (memory == MAP_FAILED) {
+      log_debug("shared memory: cannot map", path);
+      ::unlink(path.c_str());
+      return nullptr;
+    }
+
+    Header *header = new (memory) Header();
+    header->magic = MAGIC;
+    header->version = VERSION;
+    header->slot_size = static_cast<uint32_t>(SLOT_SIZE);
+    header->slot_count = slot_count;
+    header->head.store(0u);
+    header->reader_waiting.store(0u);
+    header->tail.store(0u);
+    header->writer_waiting.store(0u);
+    header->closed.store(0u);
+    return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(name, memory, size));
+  }
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Open(const std::string &name) {
+    if (name.empty() || name.size() >= MAX_NAME_LENGTH || name[0u] != '/' ||
+        name.find('/', 1u) != std::string::npos) {
+      return nullptr;
+    }
+    const std::string path = MakePath(name);
+    const int fd = ::open(path.c_str(), O_RDWR | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+      log_debug("shared memory: cannot open", path);
+      return nullptr;
+    }
+    struct stat status;
+    void *memory = MAP_FAILED;
+    size_t size = 0u;
+    if (::fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) > HEADER_SIZE) {
+      size = static_cast<size_t>(status.st_size);
+      memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+      log_debug("shared memory: cannot map", path);
+      return nullptr;
+    }
+
+    const Header &header = *static_cast<const Header *>(memory);
+    if (header.magic != MAGIC || header.version != VERSION || header.slot_size != SLOT_SIZE ||
+        HEADER_SIZE + static_cast<size_t>(header.slot_count) * SLOT_SIZE != size) {
+      log_debug("shared memory: invalid ring", path);
+      ::munmap(memory, size);
+      return nullptr;
+    }
+    return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(name, memory, size));
+  }
+
+  SharedMemoryRing::~SharedMemoryRing() {
+    Close();
+    Unlink();
+    ::munmap(_memory, _size);
+  }
+
+  void SharedMemoryRing::Unlink() {
+    if (_linked) {
+      ::unlink(MakePath(_name).c_str());
+      _linked = false;
+    }
+  }
+
+#else
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(size_t) {
+    return nullptr;
+  }
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Open(const std::string &) {
+    return nullptr;
+  }
+
+  SharedMemoryRing::~SharedMemoryRing() = default;
+
+  void SharedMemoryRing::Unlink() {}
+
+#endif // __linux__
+
+  SharedMemoryRing::SharedMemoryRing(std::string name, void *memory, const size_t size)
+    : _name(std::move(name)),
+      _memory(memory),
+      _size(size),
+      _linked(true),
+      _header(*static_cast<Header *>(memory)),
+      _slots(static_cast<unsigned char *>(memory) + HEADER_SIZE) {
+    static_assert(sizeof(Header) <= HEADER_SIZE, "The ring header does not fit in a slot.");
+  }
+
+  size_t SharedMemoryRing::GetMaxMessageSize() const {
+    return (_header.slot_count / 2u) * SLOT_SIZE - sizeof(RecordHeader);
+  }
+
+  SharedMemoryRing::WriteResult SharedMemoryRing::Reserve(
+      const RecordKind kind,
+      const size_t size,
+      const time_duration timeout,
+      unsigned char *&destination) {
+    if (size > GetMaxMessageSize()) {
+      return WriteResult::TooLarge;
+    }
+    const uint32_t slot_count = _header.slot_count;
+    const uint32_t slots = SlotsFor(size);
+    const uint32_t head = _header.head.load(std::memory_order_relaxed);
+    const uint32_t position = head & (slot_count - 1u);
+    // A message never wraps around, the slots left at the end are skipped.
+    const uint32_t skipped = position + slots > slot_count ? slot_count - position : 0u;
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout.to_chrono();
+    for (;;) {
+      if (_header.closed.load()) {
+        return WriteResult::Closed;
+      }
+      const uint32_t tail = _header.tail.load();
+      if (slot_count - (head - tail) >= skipped + slots) {
+        break;
+      }
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        return WriteResult::Full;
+      }
+#ifdef __linux__
+      _header.writer_waiting.store(1u);
+      if (_header.tail.load() == tail) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+        FutexWait(_header.tail, tail, time_duration(std::max(remaining, std::chrono::milliseconds(1))));
+      }
+      _header.writer_waiting.store(0u);
+#endif // __linux__
+    }
+
+    if (skipped > 0u) {
+      RecordHeader padding{static_cast<uint32_t>(RecordKind::Padding), 0u};
+      std::memcpy(_slots + static_cast<size_t>(position) * SLOT_SIZE, &padding, sizeof(padding));
+    }
+    const uint32_t start = head + skipped;
+    unsigned char *record = _slots + static_cast<size_t>(start & (slot_count - 1u)) * SLOT_SIZE;
+    RecordHeader record_header{static_cast<uint32_t>(kind), static_cast<uint32_t>(size)};
+    std::memcpy(record, &record_header, sizeof(record_header));
+    destination = record + sizeof(RecordHeader);
+    _pending_head = start + slots;
+    return WriteResult::Written;
+  }
+
+  void SharedMemoryRing::Publish() {
+    _header.head.store(_pending_head);
+#ifdef __linux__
+    if (_header.reader_waiting.load()) {
+      FutexWake(_header.head);
+    }
+#endif // __linux__
+  }
+
+  SharedMemoryRing::WriteResult SharedMemoryRing::WriteSwitch(const std::string &name, const time_duration timeout) {
+    unsigned char *destination = nullptr;
+    const WriteResult result = Reserve(RecordKind::Switch, name.size(), timeout, destination);
+    if (result == WriteResult::Written) {
+      std::memcpy(destination, name.data(), name.size());
+      Publish();
+    }
+    return result;
+  }
+
+  SharedMemoryRing::ReadResult SharedMemoryRing::Read(Buffer &buffer, const time_duration timeout) {
+    const uint32_t slot_count = _header.slot_count;
+    const auto deadline = std::chrono::steady_clock::now() + timeout.to_chrono();
+    for (;;) {
+      const uint32_t tail = _header.tail.load(std::memory_order_relaxed);
+      const uint32_t head = _header.head.load();
+      if (head != tail) {
+        const uint32_t position = tail & (slot_count - 1u);
+        const unsigned char *record = _slots + static_cast<size_t>(position) * SLOT_SIZE;
+        RecordHeader record_header;
+        std::memcpy(&record_header, record, sizeof(record_header));
+
+        uint32_t slots = slot_count - position;
+        const auto kind = static_cast<RecordKind>(record_header.kind);
+        if (kind != RecordKind::Padding) {
+          // Trust nothing the other process wrote.
+          if (record_header.size > GetMaxMessageSize() ||
+              SlotsFor(record_header.size) > head - tail ||
+              SlotsFor(record_header.size) > slot_count - position) {
+            log_error("shared memory: corrupted ring", _name);
+            Close();
+            return ReadResult::Closed;
+          }
+          slots = SlotsFor(record_header.size);
+          buffer.copy_from(record + sizeof(RecordHeader), static_cast<Buffer::size_type>(record_header.size));
+        }
+        _header.tail.store(tail + slots);
+#ifdef __linux__
+        if (_header.writer_waiting.load()) {
+          FutexWake(_header.tail);
+        }
+#endif // __linux__
+        if (kind == RecordKind::Message) {
+          return ReadResult::Message;
+        } else if (kind == RecordKind::Switch) {
+          return ReadResult::Switch;
+        }
+        continue;
+      }
+
+      if (_header.closed.load()) {
+        return ReadResult::Closed;
+      }
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        return ReadResult::Timeout;
+      }
+#ifdef __linux__
+      _header.reader_waiting.store(1u);
+      if (_header.head.load() == head && !_header.closed.load()) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+        FutexWait(_header.head, head, time_duration(std::max(remaining, std::chrono::milliseconds(1))));
+      }
+      _header.reader_waiting.store(0u);
+#endif // __linux__
+    }
+  }
+
+  void SharedMemoryRing::Close() {
+    _header.closed.store(1u);
+#ifdef __linux__
+    FutexWake(_header.head);
+    FutexWake(_header.tail);
+#endif // __linux__
+  }
+
+  bool SharedMemoryRing::IsClosed() const {
+    return _header.closed.load() != 0u;
+  }
+
+  bool SharedMemoryRing::HasBeenRead() const {
+    return _header.tail.load() != 0u;
+  }
+
+} // namespace detail
+} // namespace streaming
+} // namespace carla
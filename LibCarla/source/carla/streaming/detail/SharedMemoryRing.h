@@ -0,0 +1,167 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+
+#include <boost/asio/buffer.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+
+  /// A single producer, single consumer queue of messages in a POSIX shared
+  /// memory segment, used to stream to the clients running on the same host as
+  /// the server without going through the loopback socket.
+  ///
+  /// The segment is split in fixed size slots, each message takes the
+  /// contiguous slots its size needs, preceded by a small record header. A
+  /// side that has to wait sleeps on a futex in the segment and is only woken
+  /// up if it said so, so a busy stream takes no system call per message.
+  ///
+  /// Only available on Linux, elsewhere Create and Open always fail and the
+  /// streams fall back to TCP.
+  class SharedMemoryRing : private NonCopyable {
+  public:
+
+    enum class WriteResult {
+      Written,
+      /// Timed out waiting for the reader to release space.
+      Full,
+      /// The message is larger than half the ring, it needs a bigger one.
+      TooLarge,
+      Closed
+    };
+
+    enum class ReadResult {
+      Message,
+      /// The writer moved to a new ring, the buffer holds its name.
+      Switch,
+      Timeout,
+      Closed
+    };
+
+    /// Size of the slots the ring is split in.
+    static constexpr size_t SLOT_SIZE = 1024u;
+
+    /// Default capacity of a ring in bytes.
+    static constexpr size_t DEFAULT_CAPACITY = 8u * 1024u * 1024u;
+
+    /// Largest capacity a ring may be created with.
+    static constexpr size_t MAX_CAPACITY = 256u * 1024u * 1024u;
+
+    /// Size in bytes of the largest message a ring of MAX_CAPACITY accepts.
+    static constexpr size_t MAX_MESSAGE_SIZE = MAX_CAPACITY / 2u - SLOT_SIZE;
+
+    /// Maximum length of a ring name, including the terminating null.
+    static constexpr size_t MAX_NAME_LENGTH = 64u;
+
+    static bool IsSupported();
+
+    /// Creates a ring with a unique name that holds at least @a capacity
+    /// bytes, rounded up to a power of two number of slots. The pages are
+    /// reserved up front, so a full /dev/shm fails here instead of faulting
+    /// on the first write. Returns nullptr on failure or if @a capacity is
+    /// above MAX_CAPACITY.
+    static std::unique_ptr<SharedMemoryRing> Create(size_t capacity = DEFAULT_CAPACITY);
+
+    /// Maps the ring created by another process with the given name. Returns
+    /// nullptr on failure.
+    static std::unique_ptr<SharedMemoryRing> Open(const std::string &name);
+
+    /// Closes the ring, unlinks it if this side did not do it yet and unmaps
+    /// it.
+    ~SharedMemoryRing();
+
+    const std::string &GetName() const {
+      return _name;
+    }
+
+    /// Size in bytes of the largest message the ring accepts.
+    size_t GetMaxMessageSize() const;
+
+    /// Removes the name of the ring, the memory is released once both sides
+    /// unmap it. Either side may do it, the reader does it as soon as it maps
+    /// the ring so it does not outlive both processes.
+    void Unlink();
+
+    /// Writes a message made of the given buffers, waiting up to @a timeout
+    /// for the reader to release space if the ring is full. Only one thread
+    /// may write.
+    template <typename ConstBufferSequence>
+    WriteResult Write(const ConstBufferSequence &buffers, time_duration timeout) {
+      const size_t size = boost::asio::buffer_size(buffers);
+      unsigned char *destination = nullptr;
+      const WriteResult result = Reserve(RecordKind::Message, size, timeout, destination);
+      if (result == WriteResult::Written) {
+        for (const auto &buffer : buffers) {
+          std::memcpy(destination, buffer.data(), buffer.size());
+          destination += buffer.size();
+        }
+        Publish();
+      }
+      return result;
+    }
+
+    /// Tells the reader to continue with the ring named @a name, the writer
+    /// must not write to this ring afterwards.
+    WriteResult WriteSwitch(const std::string &name, time_duration timeout);
+
+    /// Copies the next message into @a buffer, waiting up to @a timeout for
+    /// one. Only one thread may read.
+    ReadResult Read(Buffer &buffer, time_duration timeout);
+
+    /// Closes the ring for both sides, waking any of them that waits.
+    void Close();
+
+    bool IsClosed() const;
+
+    /// Whether the reader took anything out of the ring yet.
+    bool HasBeenRead() const;
+
+  private:
+
+    enum class RecordKind : uint32_t {
+      Message = 1u,
+      Padding,
+      Switch
+    };
+
+    struct Header;
+
+    SharedMemoryRing(std::string name, void *memory, size_t size);
+
+    WriteResult Reserve(RecordKind kind, size_t size, time_duration timeout, unsigned char *&destination);
+
+    void Publish();
+
+    const std::string _name;
+
+    void *_memory;
+
+    const size_t _size;
+
+    bool _linked;
+
+    Header &_header;
+
+    unsigned char *_slots;
+
+    /// Head of the message being written, published by Publish.
+    uint32_t _pending_head = 0u;
+  };
+
+} // namespace detail
+} // namespace streaming
+} // namespace carla
@@ -8,8 +8,10 @@
 
 #include "carla/Buffer.h"
 #include "carla/Debug.h"
+#include "carla/streaming/SendQueue.h"
 #include "carla/streaming/Token.h"
 
+#include <cstdint>
 #include <memory>
 
 namespace carla {
@@ -36,6 +38,16 @@ namespace detail {
       return _shared_state->token();
     }
 
+    /// Number of clients that subscribed to this stream since it was created.
+    uint64_t GetNumberOfConnections() const {
+      return _shared_state->GetNumberOfConnections();
+    }
+
+    /// Messages queued, sent and dropped by the clients of this stream.
+    StreamStatistics GetStatistics() const {
+      return _shared_state->GetStatistics();
+    }
+
     /// Pull a buffer from the buffer pool associated to this stream. Discarded
     /// buffers are re-used to avoid memory allocations.
     ///
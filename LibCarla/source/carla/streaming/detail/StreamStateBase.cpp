@@ -14,7 +14,8 @@ namespace detail {
 
   StreamStateBase::StreamStateBase(const token_type &token)
     : _token(token),
-      _buffer_pool(std::make_shared<BufferPool>()) {}
+      _buffer_pool(std::make_shared<BufferPool>()),
+      _statistics(std::make_shared<SendStatistics>()) {}
 
   StreamStateBase::~StreamStateBase() = default;
 
@@ -22,6 +23,10 @@ namespace detail {
     return _buffer_pool->Pop();
   }
 
+  StreamStatistics StreamStateBase::GetStatistics() {
+    return _statistics->GetStatistics(_token.get_stream_id(), GetNumberOfSessions());
+  }
+
 } // namespace detail
 } // namespace streaming
 } // namespace carla
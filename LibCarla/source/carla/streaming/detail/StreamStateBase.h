@@ -7,6 +7,8 @@
 #pragma once
 
 #include "carla/NonCopyable.h"
+#include "carla/streaming/SendQueue.h"
+#include "carla/streaming/detail/SendStatistics.h"
 #include "carla/streaming/detail/Session.h"
 #include "carla/streaming/detail/Token.h"
 
@@ -34,17 +36,30 @@ namespace detail {
 
     Buffer MakeBuffer();
 
+    StreamStatistics GetStatistics();
+
     virtual void ConnectSession(std::shared_ptr<Session> session) = 0;
 
     virtual void DisconnectSession(std::shared_ptr<Session> session) = 0;
 
     virtual void ClearSessions() = 0;
 
+    virtual size_t GetNumberOfSessions() = 0;
+
+  protected:
+
+    /// Counters shared by all the sessions of the stream.
+    const std::shared_ptr<SendStatistics> &send_statistics() const {
+      return _statistics;
+    }
+
   private:
 
     const token_type _token;
 
     const std::shared_ptr<BufferPool> _buffer_pool;
+
+    const std::shared_ptr<SendStatistics> _statistics;
   };
 
 } // namespace detail
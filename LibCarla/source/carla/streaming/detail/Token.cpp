@@ -15,6 +15,9 @@ namespace carla {
 namespace streaming {
 namespace detail {
 
+  constexpr uint32_t token_type::SHARED_MEMORY_OFFER;
+  constexpr size_t token_type::SHARED_MEMORY_OFFER_POSITION;
+
   void token_type::set_address(const boost::asio::ip::address &addr) {
     if (addr.is_v4()) {
       _token.address_type = token_data::address::ip_v4;
@@ -15,6 +15,8 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ip/udp.hpp>
 
+#include <cstring>
+
 namespace carla {
 namespace streaming {
 namespace detail {
@@ -78,6 +80,21 @@ namespace detail {
       return {get_address(), _token.port};
     }
 
+    /// Written at the end of the address field when the server offers shared
+    /// memory. Only IPv4 and unset addresses leave those bytes free. Older
+    /// clients never read them. Older servers may leave them uninitialized,
+    /// so the offer is a value rather than a flag.
+    static constexpr uint32_t SHARED_MEMORY_OFFER = 0x4d485343u; // "CSHM"
+
+    static constexpr size_t SHARED_MEMORY_OFFER_POSITION =
+        sizeof(boost::asio::ip::address_v6::bytes_type) - sizeof(uint32_t);
+
+    uint32_t get_shared_memory_offer() const {
+      uint32_t offer = 0u;
+      std::memcpy(&offer, &_token.address.v6[SHARED_MEMORY_OFFER_POSITION], sizeof(offer));
+      return offer;
+    }
+
     template <typename Protocol>
     explicit token_type(
         stream_id_type stream_id,
@@ -146,6 +163,23 @@ namespace detail {
       return _token.protocol == token_data::protocol::tcp;
     }
 
+    /// Whether the server of the stream accepts streaming through shared
+    /// memory to the clients on its host.
+    bool has_shared_memory() const {
+      return protocol_is_tcp() &&
+             !address_is_v6() &&
+             (get_shared_memory_offer() == SHARED_MEMORY_OFFER);
+    }
+
+    /// Only applies to TCP tokens without an IPv6 address. Setting an IPv6
+    /// address afterwards withdraws the offer.
+    void set_shared_memory(bool enable) {
+      if (protocol_is_tcp() && !address_is_v6()) {
+        const uint32_t offer = enable ? SHARED_MEMORY_OFFER : 0u;
+        std::memcpy(&_token.address.v6[SHARED_MEMORY_OFFER_POSITION], &offer, sizeof(offer));
+      }
+    }
+
     template <typename Protocol>
     bool has_same_protocol(const boost::asio::ip::basic_endpoint<Protocol> &) const {
       return _token.protocol == get_protocol<Protocol>();
@@ -19,6 +19,19 @@ namespace detail {
 
   using message_size_type = uint32_t;
 
+  /// Set on the stream id a client subscribes with to ask the server to
+  /// stream through shared memory, see SharedMemoryRing. Stream ids never get
+  /// this high in practice.
+  constexpr stream_id_type SHARED_MEMORY_REQUEST = 1u << 31u;
+
+  /// Set on the stream id a client subscribes with when it wants at most one
+  /// message every so many microseconds, sent as a uint32_t right after it.
+  constexpr stream_id_type RATE_LIMIT_REQUEST = 1u << 30u;
+
+  /// Sent by a shared memory client through the socket once it stopped
+  /// reading the ring, the session goes on through TCP from then on.
+  constexpr uint8_t TCP_FALLBACK_REQUEST = 2u;
+
   static_assert(
       std::is_same<message_size_type, Buffer::size_type>::value,
       "uint type mismatch!");
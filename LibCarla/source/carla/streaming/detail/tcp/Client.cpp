@@ -18,7 +18,9 @@
 #include <boost/asio/post.hpp>
 #include <boost/asio/bind_executor.hpp>
 
+#include <algorithm>
 #include <exception>
+#include <string>
 
 namespace carla {
 namespace streaming {
@@ -68,7 +70,8 @@ namespace tcp {
   Client::Client(
       boost::asio::io_context &io_context,
       const token_type &token,
-      callback_function_type callback)
+      callback_function_type callback,
+      const double max_rate)
     : LIBCARLA_INITIALIZE_LIFETIME_PROFILER(
           std::string("tcp client ") + std::to_string(token.get_stream_id())),
       _token(token),
@@ -76,13 +79,16 @@ namespace tcp {
       _socket(io_context),
       _strand(io_context),
       _connection_timer(io_context),
-      _buffer_pool(std::make_shared<BufferPool>()) {
+      _buffer_pool(std::make_shared<BufferPool>()),
+      _min_interval(max_rate > 0.0 ? static_cast<uint32_t>(std::min(1e6 / max_rate, 4e9)) : 0u) {
     if (!_token.protocol_is_tcp()) {
       throw_exception(std::invalid_argument("invalid token, only TCP tokens supported"));
     }
   }
 
-  Client::~Client() = default;
+  Client::~Client() {
+    StopReader();
+  }
 
   void Client::Connect() {
     auto self = shared_from_this();
@@ -93,6 +99,7 @@ namespace tcp {
 
       using boost::system::error_code;
 
+      StopReader();
       if (_socket.is_open()) {
         _socket.close();
       }
@@ -110,21 +117,35 @@ namespace tcp {
           // Improves the sync mode velocity on Linux by a factor of ~3.
           _socket.set_option(boost::asio::ip::tcp::no_delay(true));
           log_debug("streaming client: connected to", ep);
-          // Send the stream id to subscribe to the stream.
-          const auto &stream_id = _token.get_stream_id();
-          log_debug("streaming client: sending stream id", stream_id);
+          // Send the stream id to subscribe to the stream, asking for shared
+          // memory if the server offers it and runs on this host.
+          _subscription[0u] = _token.get_stream_id();
+          _subscription[1u] = _min_interval;
+          const bool shared_memory = _token.has_shared_memory() && IsLocalPeer();
+          if (shared_memory) {
+            _subscription[0u] |= SHARED_MEMORY_REQUEST;
+          }
+          if (_min_interval > 0u) {
+            _subscription[0u] |= RATE_LIMIT_REQUEST;
+          }
+          const size_t subscription_size = (_min_interval > 0u ? 2u : 1u) * sizeof(stream_id_type);
+          log_debug("streaming client: sending stream id", _token.get_stream_id());
           boost::asio::async_write(
               _socket,
-              boost::asio::buffer(&stream_id, sizeof(stream_id)),
+              boost::asio::buffer(_subscription.data(), subscription_size),
               boost::asio::bind_executor(_strand, [=](error_code ec, size_t DEBUG_ONLY(bytes)) {
                 // Ensures to stop the execution once the connection has been stopped.
                 if (_done) {
                   return;
                 }
                 if (!ec) {
-                  DEBUG_ASSERT_EQ(bytes, sizeof(stream_id));
+                  DEBUG_ASSERT_EQ(bytes, subscription_size);
                   // If succeeded start reading data.
-                  ReadData();
+                  if (shared_memory) {
+                    ReadSharedMemoryOffer();
+                  } else {
+                    ReadData();
+                  }
                 } else {
                   // Else try again.
                   log_debug("streaming client: failed to send stream id:", ec.message());
@@ -147,6 +168,7 @@ namespace tcp {
     auto self = shared_from_this();
     boost::asio::post(_strand, [this, self]() {
       _done = true;
+      StopReader();
       if (_socket.is_open()) {
         _socket.close();
       }
@@ -163,6 +185,177 @@ namespace tcp {
     });
   }
 
+  bool Client::IsLocalPeer() const {
+    boost::system::error_code ec;
+    const auto local = _socket.local_endpoint(ec);
+    if (ec) {
+      return false;
+    }
+    const auto remote = _socket.remote_endpoint(ec);
+    if (ec) {
+      return false;
+    }
+    return remote.address().is_loopback() || remote.address() == local.address();
+  }
+
+  void Client::ReadSharedMemoryOffer() {
+    using boost::system::error_code;
+    auto self = shared_from_this();
+
+    auto handle_answer = [this, self](std::shared_ptr<SharedMemoryRing> ring) {
+      _ring_answer = (ring != nullptr) ? 1u : 0u;
+      boost::asio::async_write(
+          _socket,
+          boost::asio::buffer(&_ring_answer, sizeof(_ring_answer)),
+          boost::asio::bind_executor(_strand, [this, self, ring](error_code ec, size_t) {
+            if (_done) {
+              return;
+            }
+            if (ec) {
+              log_debug("streaming client: failed to answer shared memory offer:", ec.message());
+              Connect();
+            } else if (ring == nullptr) {
+              ReadData();
+            } else {
+              StartReader(ring);
+            }
+          }));
+    };
+
+    auto handle_offer = [this, self, handle_answer](error_code ec, size_t) {
+      if (_done) {
+        return;
+      }
+      if (ec) {
+        log_debug("streaming client: failed to read shared memory offer:", ec.message());
+        Connect();
+        return;
+      }
+      _ring_name.back() = '\0';
+      const std::string name(_ring_name.data());
+      if (name.empty()) {
+        // The server declined, stay on TCP.
+        ReadData();
+        return;
+      }
+      std::shared_ptr<SharedMemoryRing> ring = SharedMemoryRing::Open(name);
+      if (ring != nullptr) {
+        ring->Unlink();
+        log_debug("streaming client: streaming through shared memory", name);
+      } else {
+        log_warning("streaming client: cannot open shared memory", name, ", falling back to TCP");
+      }
+      handle_answer(std::move(ring));
+    };
+
+    boost::asio::async_read(
+        _socket,
+        boost::asio::buffer(_ring_name),
+        boost::asio::bind_executor(_strand, handle_offer));
+  }
+
+  void Client::StartReader(std::shared_ptr<SharedMemoryRing> ring) {
+    DEBUG_ASSERT(!_reader.joinable());
+    auto stop = std::make_shared<std::atomic_bool>(false);
+    _stop_reader = stop;
+    std::weak_ptr<Client> weak = shared_from_this();
+    auto buffer_pool = _buffer_pool;
+    // The thread keeps only a weak reference, the client may be destroyed by
+    // the last callback it posts.
+    _reader = std::thread([weak, stop, buffer_pool, ring]() mutable {
+      while (!*stop) {
+        Buffer buffer = buffer_pool->Pop();
+        const auto result = ring->Read(buffer, time_duration::milliseconds(10u));
+        if (result == SharedMemoryRing::ReadResult::Message) {
+          auto self = weak.lock();
+          if (self == nullptr) {
+            return;
+          }
+          auto message = std::make_shared<Buffer>(std::move(buffer));
+          boost::asio::post(self->_strand, [self, message]() { self->_callback(std::move(*message)); });
+        } else if (result == SharedMemoryRing::ReadResult::Switch) {
+          // An empty name means the server cannot go on through shared
+          // memory either.
+          const std::string name(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+          ring = name.empty() ? nullptr : SharedMemoryRing::Open(name);
+          if (ring == nullptr) {
+            if (!name.empty()) {
+              log_warning("streaming client: cannot open shared memory", name, ", falling back to TCP");
+            }
+            auto self = weak.lock();
+            if (self != nullptr) {
+              // Unless the client reconnected meanwhile.
+              boost::asio::post(self->_strand, [self, stop]() {
+                if (!*stop) {
+                  self->RevertToTcp();
+                }
+              });
+            }
+            return;
+          }
+          ring->Unlink();
+        } else if (result == SharedMemoryRing::ReadResult::Closed) {
+          return;
+        }
+      }
+    });
+
+    // Nothing else comes through the socket, reading only tells when the
+    // server goes away. Cancelled when moving to TCP.
+    auto self = shared_from_this();
+    boost::asio::async_read(
+        _socket,
+        boost::asio::buffer(&_ring_answer, sizeof(_ring_answer)),
+        boost::asio::bind_executor(_strand, [this, self](boost::system::error_code ec, size_t) {
+          if (!_done && (ec != boost::asio::error::operation_aborted)) {
+            log_debug("streaming client: shared memory session closed:", ec.message());
+            Connect();
+          }
+        }));
+  }
+
+  void Client::RevertToTcp() {
+    if (_done || !_socket.is_open()) {
+      return;
+    }
+    StopReader();
+    // The server sends nothing through the socket until it reads the request,
+    // so the data read from now on is all TCP messages.
+    boost::system::error_code ec;
+    _socket.cancel(ec);
+    log_debug("streaming client: moving from shared memory to TCP");
+    auto self = shared_from_this();
+    boost::asio::async_write(
+        _socket,
+        boost::asio::buffer(&TCP_FALLBACK_REQUEST, sizeof(TCP_FALLBACK_REQUEST)),
+        boost::asio::bind_executor(_strand, [this, self](boost::system::error_code ec_request, size_t) {
+          if (_done) {
+            return;
+          }
+          if (ec_request) {
+            log_debug("streaming client: failed to ask for TCP:", ec_request.message());
+            Connect();
+          } else {
+            ReadData();
+          }
+        }));
+  }
+
+  void Client::StopReader() {
+    if (_stop_reader != nullptr) {
+      *_stop_reader = true;
+      _stop_reader = nullptr;
+    }
+    if (_reader.joinable()) {
+      if (_reader.get_id() == std::this_thread::get_id()) {
+        // Destroyed by the reader itself, it exits right after.
+        _reader.detach();
+      } else {
+        _reader.join();
+      }
+    }
+  }
+
   void Client::ReadData() {
     auto self = shared_from_this();
     boost::asio::post(_strand, [this, self]() {
@@ -9,6 +9,7 @@
 #include "carla/Buffer.h"
 #include "carla/NonCopyable.h"
 #include "carla/profiler/LifetimeProfiled.h"
+#include "carla/streaming/detail/SharedMemoryRing.h"
 #include "carla/streaming/detail/Token.h"
 #include "carla/streaming/detail/Types.h"
 
@@ -17,9 +18,11 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
 
+#include <array>
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <thread>
 
 namespace carla {
 
@@ -31,6 +34,10 @@ namespace tcp {
 
   /// A client that connects to a single stream.
   ///
+  /// If the token allows it and the server runs on the same host, the
+  /// messages are read from a SharedMemoryRing by a dedicated thread, the
+  /// socket is then only kept open to tell the server we are still there.
+  ///
   /// @warning This client should be stopped before releasing the shared pointer
   /// or won't be destroyed.
   class Client
@@ -43,10 +50,13 @@ namespace tcp {
     using protocol_type = endpoint::protocol_type;
     using callback_function_type = std::function<void (Buffer)>;
 
+    /// If @a max_rate is positive the server sends at most that many messages
+    /// per second, skipping the rest.
     Client(
         boost::asio::io_context &io_context,
         const token_type &token,
-        callback_function_type callback);
+        callback_function_type callback,
+        double max_rate = 0.0);
 
     ~Client();
 
@@ -64,6 +74,21 @@ namespace tcp {
 
     void ReadData();
 
+    /// Whether the socket is connected to a server on this host.
+    bool IsLocalPeer() const;
+
+    /// Reads the name of the ring offered by the server, falls back to TCP if
+    /// there is none or it cannot be opened.
+    void ReadSharedMemoryOffer();
+
+    void StartReader(std::shared_ptr<SharedMemoryRing> ring);
+
+    /// Called by the reader when it cannot go on with shared memory, asks the
+    /// server to continue the session through the socket.
+    void RevertToTcp();
+
+    void StopReader();
+
     const token_type _token;
 
     callback_function_type _callback;
@@ -77,6 +102,21 @@ namespace tcp {
     std::shared_ptr<BufferPool> _buffer_pool;
 
     std::atomic_bool _done{false};
+
+    /// Minimum interval between messages in microseconds, zero for no limit.
+    const uint32_t _min_interval;
+
+    /// Stream id as sent to the server, with the request flags if any, and the
+    /// minimum interval if rate limited.
+    std::array<stream_id_type, 2u> _subscription;
+
+    std::array<char, SharedMemoryRing::MAX_NAME_LENGTH> _ring_name;
+
+    uint8_t _ring_answer = 0u;
+
+    std::thread _reader;
+
+    std::shared_ptr<std::atomic_bool> _stop_reader;
   };
 
 } // namespace tcp
@@ -75,6 +75,12 @@ namespace tcp {
       return MakeListView(begin, begin + _number_of_buffers + 1u);
     }
 
+    /// The buffers without the size header.
+    auto GetBodyBufferSequence() const {
+      auto begin = _buffer_views.begin();
+      return MakeListView(begin + 1u, begin + _number_of_buffers + 1u);
+    }
+
   private:
 
     message_size_type _number_of_buffers = 0u;
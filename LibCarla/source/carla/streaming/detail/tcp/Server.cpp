@@ -21,7 +21,9 @@ namespace tcp {
     : _io_context(io_context),
       _acceptor(_io_context, std::move(ep)),
       _timeout(time_duration::seconds(10u)),
-      _synchronous(false) {}
+      _synchronous(false),
+      _shared_memory(SharedMemoryRing::IsSupported()),
+      _send_queue(std::make_shared<const SendQueueSettings>()) {}
 
   void Server::OpenSession(
       time_duration timeout,
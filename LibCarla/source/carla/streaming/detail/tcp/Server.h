@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include "carla/AtomicSharedPtr.h"
 #include "carla/NonCopyable.h"
 #include "carla/Time.h"
+#include "carla/streaming/SendQueue.h"
+#include "carla/streaming/detail/SharedMemoryRing.h"
 #include "carla/streaming/detail/tcp/ServerSession.h"
 
 #include <boost/asio/io_context.hpp>
@@ -62,6 +65,26 @@ namespace tcp {
       return _synchronous;
     }
 
+    /// Whether sessions of clients on this host may stream through shared
+    /// memory when they ask for it. Enabled by default where supported.
+    void SetSharedMemory(bool enable) {
+      _shared_memory = enable && SharedMemoryRing::IsSupported();
+    }
+
+    bool IsSharedMemoryEnabled() const {
+      return _shared_memory;
+    }
+
+    /// Bounds and policy of the send queue of every session, applies to the
+    /// messages written from now on.
+    void SetSendQueue(const SendQueueSettings &settings) {
+      _send_queue = std::make_shared<const SendQueueSettings>(settings);
+    }
+
+    std::shared_ptr<const SendQueueSettings> GetSendQueue() const {
+      return _send_queue.load();
+    }
+
   private:
 
     void OpenSession(
@@ -76,6 +99,10 @@ namespace tcp {
     std::atomic<time_duration> _timeout;
 
     bool _synchronous;
+
+    std::atomic_bool _shared_memory;
+
+    AtomicSharedPtr<const SendQueueSettings> _send_queue;
   };
 
 } // namespace tcp
@@ -15,8 +15,8 @@
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/post.hpp>
 
+#include <algorithm>
 #include <atomic>
-#include <thread>
 
 namespace carla {
 namespace streaming {
@@ -25,6 +25,15 @@ namespace tcp {
 
   static std::atomic_size_t SESSION_COUNTER{0u};
 
+  /// Smallest ring a session moves to for its messages.
+  static constexpr size_t MIN_RING_CAPACITY = 64u * SharedMemoryRing::SLOT_SIZE;
+
+  /// Capacity of a ring for messages of @a size bytes, with room for a few
+  /// more like it up to the largest ring allowed.
+  static size_t RingCapacityFor(const size_t size) {
+    return std::min(std::max(4u * size, MIN_RING_CAPACITY), SharedMemoryRing::MAX_CAPACITY);
+  }
+
   ServerSession::ServerSession(
       boost::asio::io_context &io_context,
       const time_duration timeout,
@@ -36,7 +45,14 @@ namespace tcp {
       _socket(io_context),
       _timeout(timeout),
       _deadline(io_context),
-      _strand(io_context) {}
+      _strand(io_context),
+      _statistics(std::make_shared<SendStatistics>()),
+      _ring_retry(io_context) {}
+
+  void ServerSession::SetStatistics(std::shared_ptr<SendStatistics> statistics) {
+    DEBUG_ASSERT(statistics != nullptr);
+    _statistics = std::move(statistics);
+  }
 
   void ServerSession::Open(
       callback_function_type on_opened,
@@ -58,8 +74,25 @@ namespace tcp {
           size_t DEBUG_ONLY(bytes_received)) {
         if (!ec) {
           DEBUG_ASSERT_EQ(bytes_received, sizeof(_stream_id));
-          log_debug("session", _session_id, "for stream", _stream_id, " started");
-          boost::asio::post(_strand.context(), [=]() { callback(self); });
+          if ((_stream_id & RATE_LIMIT_REQUEST) != 0u) {
+            // Read the minimum interval between messages first.
+            _stream_id &= ~RATE_LIMIT_REQUEST;
+            boost::asio::async_read(
+                _socket,
+                boost::asio::buffer(&_min_interval, sizeof(_min_interval)),
+                boost::asio::bind_executor(_strand, [this, self, callback](
+                    const boost::system::error_code &ec_interval,
+                    size_t) {
+                  if (!ec_interval) {
+                    StartSession(callback);
+                  } else {
+                    log_error("session", _session_id, ": error retrieving rate limit :", ec_interval.message());
+                    CloseNow();
+                  }
+                }));
+          } else {
+            StartSession(callback);
+          }
         } else {
           log_error("session", _session_id, ": error retrieving stream id :", ec.message());
           CloseNow();
@@ -75,47 +108,386 @@ namespace tcp {
     });
   }
 
+  void ServerSession::StartSession(callback_function_type on_opened) {
+    const bool shared_memory = (_stream_id & SHARED_MEMORY_REQUEST) != 0u;
+    _stream_id &= ~SHARED_MEMORY_REQUEST;
+    log_debug("session", _session_id, "for stream", _stream_id, " started");
+    if (shared_memory) {
+      NegotiateSharedMemory(std::move(on_opened));
+    } else {
+      auto self = shared_from_this();
+      boost::asio::post(_strand.context(), [=]() { on_opened(self); });
+    }
+  }
+
+  bool ServerSession::IsRateLimited(const SendStatistics::clock::time_point now) {
+    if (_min_interval == 0u) {
+      return false;
+    }
+    // Spaces the messages by the interval on average; after a pause the next
+    // one is still at least half an interval away.
+    using namespace std::chrono;
+    const int64_t interval = duration_cast<nanoseconds>(microseconds(_min_interval)).count();
+    const int64_t time = duration_cast<nanoseconds>(now.time_since_epoch()).count();
+    int64_t next = _next_write.load(std::memory_order_relaxed);
+    do {
+      if (time < next) {
+        return true;
+      }
+    } while (!_next_write.compare_exchange_weak(next, std::max(next + interval, time + interval / 2)));
+    return false;
+  }
+
+  void ServerSession::NegotiateSharedMemory(callback_function_type on_opened) {
+    // The offered ring only has to hold the switch to the ring sized for the
+    // first message.
+    std::shared_ptr<SharedMemoryRing> ring;
+    if (_server.IsSharedMemoryEnabled() && IsLocalPeer()) {
+      ring = SharedMemoryRing::Create(0u);
+    }
+    _ring_name.fill('\0');
+    if (ring != nullptr) {
+      std::copy(ring->GetName().begin(), ring->GetName().end(), _ring_name.begin());
+    }
+
+    auto self = shared_from_this();
+    auto handle_answer = [this, self, ring, on_opened](
+        const boost::system::error_code &ec,
+        size_t) {
+      if (ec) {
+        log_error("session", _session_id, ": error negotiating shared memory :", ec.message());
+        CloseNow();
+        return;
+      }
+      if (_ring_answer == 1u) {
+        log_debug("session", _session_id, ": streaming through shared memory", ring->GetName());
+        _ring = ring;
+        _is_shared_memory = true;
+        // Nothing else comes through the socket but the request to go on
+        // through TCP, reading otherwise tells when the client goes away.
+        boost::asio::async_read(
+            _socket,
+            boost::asio::buffer(&_ring_answer, sizeof(_ring_answer)),
+            boost::asio::bind_executor(_strand, [this, self](const boost::system::error_code &ec_request, size_t) {
+              if (!ec_request && (_ring_answer == TCP_FALLBACK_REQUEST) && _is_shared_memory) {
+                RevertToTcp();
+              } else {
+                CloseNow();
+              }
+            }));
+      }
+      boost::asio::post(_strand.context(), [=]() { on_opened(self); });
+    };
+
+    auto handle_offer = [this, self, ring, on_opened, handle_answer](
+        const boost::system::error_code &ec,
+        size_t) {
+      if (ec) {
+        log_error("session", _session_id, ": error negotiating shared memory :", ec.message());
+        CloseNow();
+      } else if (ring == nullptr) {
+        // Declined, the client goes on with TCP.
+        boost::asio::post(_strand.context(), [=]() { on_opened(self); });
+      } else {
+        boost::asio::async_read(
+            _socket,
+            boost::asio::buffer(&_ring_answer, sizeof(_ring_answer)),
+            boost::asio::bind_executor(_strand, handle_answer));
+      }
+    };
+
+    boost::asio::async_write(
+        _socket,
+        boost::asio::buffer(_ring_name),
+        boost::asio::bind_executor(_strand, handle_offer));
+  }
+
+  bool ServerSession::IsLocalPeer() const {
+    boost::system::error_code ec;
+    const auto local = _socket.local_endpoint(ec);
+    if (ec) {
+      return false;
+    }
+    const auto remote = _socket.remote_endpoint(ec);
+    if (ec) {
+      return false;
+    }
+    return remote.address().is_loopback() || remote.address() == local.address();
+  }
+
+  bool ServerSession::WriteToSharedMemory(const QueuedMessage &queued) {
+    // Runs in the strand, so it never waits for the client; the queue in
+    // front of the ring applies the send policy instead.
+    const auto &message = queued.message;
+    const auto no_wait = time_duration::milliseconds(0u);
+    auto result = SharedMemoryRing::WriteResult::TooLarge;
+    if (!_previous_rings.empty() && _ring->HasBeenRead()) {
+      // The client opened every ring up to this one.
+      _previous_rings.clear();
+    }
+    if (!_is_tcp_fallback && (_next_ring == nullptr)) {
+      // The offered ring is always too small, the first message picks the
+      // size of the next one.
+      if (_is_ring_sized) {
+        result = _ring->Write(message->GetBodyBufferSequence(), no_wait);
+      }
+      if (result == SharedMemoryRing::WriteResult::TooLarge) {
+        if (message->size() <= SharedMemoryRing::MAX_MESSAGE_SIZE) {
+          _next_ring = SharedMemoryRing::Create(RingCapacityFor(message->size()));
+        }
+        if (_next_ring == nullptr) {
+          // Not retried for every message, a full /dev/shm stays full.
+          log_warning("session", _session_id, ": cannot create a shared memory ring for",
+              message->size(), "bytes, falling back to TCP");
+          _is_tcp_fallback = true;
+        }
+      }
+    }
+    if (_is_tcp_fallback) {
+      // An empty switch tells the client to stop reading the ring, it asks
+      // for TCP through the socket once it did.
+      result = _ring->WriteSwitch(std::string(), no_wait);
+      if (result == SharedMemoryRing::WriteResult::Written) {
+        _is_reverting = true;
+        return false;
+      }
+    } else if (_next_ring != nullptr) {
+      result = _ring->WriteSwitch(_next_ring->GetName(), no_wait);
+      if (result == SharedMemoryRing::WriteResult::Written) {
+        log_debug("session", _session_id, ": moved to shared memory", _next_ring->GetName());
+        _previous_rings.emplace_back(std::move(_ring));
+        _ring = std::move(_next_ring);
+        _is_ring_sized = true;
+        result = _ring->Write(message->GetBodyBufferSequence(), no_wait);
+      }
+    }
+
+    switch (result) {
+      case SharedMemoryRing::WriteResult::Written:
+        _statistics->Sent(message->size(), queued.written);
+        _deadline.expires_from_now(_timeout);
+        return true;
+      case SharedMemoryRing::WriteResult::Full:
+        return false;
+      case SharedMemoryRing::WriteResult::Closed:
+        _statistics->Dropped(message->size());
+        CloseNow();
+        return true;
+      default:
+        log_debug("session", _session_id, ": message too large for shared memory: message discarded");
+        _statistics->Dropped(message->size());
+        return true;
+    }
+  }
+
   void ServerSession::Write(std::shared_ptr<const Message> message) {
     DEBUG_ASSERT(message != nullptr);
     DEBUG_ASSERT(!message->empty());
+    const auto written = SendStatistics::clock::now();
+    if (IsRateLimited(written)) {
+      return;
+    }
+    if (Enqueue(std::move(message), written)) {
+      auto self = shared_from_this();
+      boost::asio::post(_strand, [this, self]() { WriteNext(); });
+    }
+  }
+
+  void ServerSession::WriteNext() {
+    if (_is_shared_memory) {
+      WriteQueuedToSharedMemory();
+    } else {
+      WriteQueued();
+    }
+  }
+
+  bool ServerSession::Enqueue(
+      std::shared_ptr<const Message> message,
+      const SendStatistics::clock::time_point written) {
+    const auto settings = _server.GetSendQueue();
+    const auto policy = _server.IsSynchronousMode() ? SendPolicy::Block : settings->policy;
+    const size_t size = message->size();
+
+    std::unique_lock<std::mutex> lock(_queue_mutex);
+    if (_is_closed) {
+      return false;
+    }
+    auto is_full = [&]() {
+      return !_queue.empty() &&
+          ((_queue.size() >= settings->max_messages) || (_queued_bytes + size > settings->max_bytes));
+    };
+    if (policy == SendPolicy::KeepLatest) {
+      while (!_queue.empty()) {
+        DropOldest();
+      }
+    } else if (policy == SendPolicy::DropOldest) {
+      while (is_full()) {
+        DropOldest();
+      }
+    } else if (is_full()) {
+      if (policy == SendPolicy::Block) {
+        _queue_space.wait_for(
+            lock,
+            std::chrono::duration<double>(settings->block_timeout),
+            [&]() { return _is_closed || !is_full(); });
+      }
+      if (_is_closed || is_full()) {
+        log_debug("session", _session_id, ": connection too slow: message discarded");
+        _statistics->Dropped(size);
+        return false;
+      }
+    }
+
+    _queue.push_back(QueuedMessage{std::move(message), written});
+    _queued_bytes += size;
+    _statistics->Queued(size);
+    if (_is_writing) {
+      return false;
+    }
+    _is_writing = true;
+    return true;
+  }
+
+  void ServerSession::DropOldest() {
+    const size_t size = _queue.front().message->size();
+    _queued_bytes -= size;
+    _statistics->Dequeued(size);
+    _statistics->Dropped(size);
+    _queue.pop_front();
+  }
+
+  void ServerSession::WriteQueued() {
+    DEBUG_ASSERT(_in_flight.empty());
+    {
+      std::lock_guard<std::mutex> lock(_queue_mutex);
+      if (_is_closed || _queue.empty()) {
+        _is_writing = false;
+        return;
+      }
+      while (!_queue.empty()) {
+        const size_t size = _queue.front().message->size();
+        _queued_bytes -= size;
+        _statistics->Dequeued(size);
+        _in_flight.emplace_back(std::move(_queue.front()));
+        _queue.pop_front();
+      }
+    }
+    _queue_space.notify_all();
+
+    // Send everything queued in a single gathered write.
+    _write_buffers.clear();
+    size_t total_size = 0u;
+    for (const auto &queued : _in_flight) {
+      for (const auto &buffer : queued.message->GetBufferSequence()) {
+        _write_buffers.emplace_back(buffer);
+      }
+      total_size += sizeof(message_size_type) + queued.message->size();
+    }
+
     auto self = shared_from_this();
-    boost::asio::post(_strand, [=]() {
-      if (!_socket.is_open()) {
+    auto handle_sent = [this, self, total_size](const boost::system::error_code &ec, size_t DEBUG_ONLY(bytes)) {
+      if (ec) {
+        log_info("session", _session_id, ": error sending data :", ec.message());
+        for (const auto &queued : _in_flight) {
+          _statistics->Dropped(queued.message->size());
+        }
+        _in_flight.clear();
+        CloseNow();
         return;
       }
-      if (_is_writing) {
-        if (_server.IsSynchronousMode()) {
-          // wait until previous message has been sent
-          while (_is_writing) {
-            std::this_thread::yield();
-          }
-        } else {
-          // ignore this message
-          log_debug("session", _session_id, ": connection too slow: message discarded");
-          return;
-        }      
+      DEBUG_ONLY(log_debug("session", _session_id, ": successfully sent", bytes, "bytes"));
+      DEBUG_ASSERT_EQ(bytes, total_size);
+      for (const auto &queued : _in_flight) {
+        _statistics->Sent(queued.message->size(), queued.written);
       }
-      _is_writing = true;
+      _in_flight.clear();
+      WriteQueued();
+    };
+
+    log_debug("session", _session_id, ": sending", _in_flight.size(), "messages of", total_size, "bytes");
 
-      auto handle_sent = [this, self, message](const boost::system::error_code &ec, size_t DEBUG_ONLY(bytes)) {
+    _deadline.expires_from_now(_timeout);
+    boost::asio::async_write(
+        _socket,
+        _write_buffers,
+        boost::asio::bind_executor(_strand, handle_sent));
+  }
+
+  void ServerSession::WriteQueuedToSharedMemory() {
+    for (;;) {
+      if (_is_reverting) {
+        // The client is moving to TCP, RevertToTcp goes on with the queue.
+        std::lock_guard<std::mutex> lock(_queue_mutex);
         _is_writing = false;
-        if (ec) {
-          log_info("session", _session_id, ": error sending data :", ec.message());
-          CloseNow();
-        } else {
-          DEBUG_ONLY(log_debug("session", _session_id, ": successfully sent", bytes, "bytes"));
-          DEBUG_ASSERT_EQ(bytes, sizeof(message_size_type) + message->size());
+        return;
+      }
+      if (_in_flight.empty()) {
+        {
+          std::lock_guard<std::mutex> lock(_queue_mutex);
+          if (_is_closed || _queue.empty()) {
+            _is_writing = false;
+            return;
+          }
+          const size_t size = _queue.front().message->size();
+          _queued_bytes -= size;
+          _statistics->Dequeued(size);
+          _in_flight.emplace_back(std::move(_queue.front()));
+          _queue.pop_front();
         }
-      };
+        _queue_space.notify_all();
+      } else if (_ring == nullptr) {
+        // Closed while waiting for the ring.
+        _statistics->Dropped(_in_flight.front().message->size());
+        _in_flight.clear();
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+        _is_writing = false;
+        return;
+      }
 
-      log_debug("session", _session_id, ": sending message of", message->size(), "bytes");
+      if (!WriteToSharedMemory(_in_flight.front())) {
+        if (_is_reverting) {
+          continue;
+        }
+        // The ring is full, try again once the client had time to read.
+        _ring_retry.expires_from_now(boost::posix_time::milliseconds(1));
+        _ring_retry.async_wait(boost::asio::bind_executor(_strand, [this, self=shared_from_this()](
+            const boost::system::error_code &) {
+          WriteNext();
+        }));
+        return;
+      }
+      _in_flight.clear();
+    }
+  }
 
-      _deadline.expires_from_now(_timeout);
-      boost::asio::async_write(
-          _socket,
-          message->GetBufferSequence(),
-          handle_sent);
-    });
+  void ServerSession::RevertToTcp() {
+    log_info("session", _session_id, ": shared memory client moved to TCP");
+    _is_shared_memory = false;
+    _is_reverting = false;
+    _ring_retry.cancel();
+    _ring.reset();
+    _next_ring.reset();
+    _previous_rings.clear();
+    bool start_writing = false;
+    {
+      // The message waiting for the ring goes first, if there was one. A
+      // pending write or retry goes on through TCP by itself.
+      std::lock_guard<std::mutex> lock(_queue_mutex);
+      for (auto it = _in_flight.rbegin(); it != _in_flight.rend(); ++it) {
+        const size_t size = it->message->size();
+        _queued_bytes += size;
+        _statistics->Queued(size);
+        _queue.push_front(std::move(*it));
+      }
+      _in_flight.clear();
+      if (!_is_closed && !_is_writing && !_queue.empty()) {
+        _is_writing = true;
+        start_writing = true;
+      }
+    }
+    if (start_writing) {
+      WriteQueued();
+    }
   }
 
   void ServerSession::Close() {
@@ -139,6 +511,18 @@ namespace tcp {
 
   void ServerSession::CloseNow() {
     _deadline.cancel();
+    _ring_retry.cancel();
+    _ring.reset();
+    _next_ring.reset();
+    _previous_rings.clear();
+    {
+      std::lock_guard<std::mutex> lock(_queue_mutex);
+      _is_closed = true;
+      while (!_queue.empty()) {
+        DropOldest();
+      }
+    }
+    _queue_space.notify_all();
     if (_socket.is_open()) {
       _socket.close();
     }
@@ -10,6 +10,8 @@
 #include "carla/Time.h"
 #include "carla/TypeTraits.h"
 #include "carla/profiler/LifetimeProfiled.h"
+#include "carla/streaming/detail/SendStatistics.h"
+#include "carla/streaming/detail/SharedMemoryRing.h"
 #include "carla/streaming/detail/Types.h"
 #include "carla/streaming/detail/tcp/Message.h"
 
@@ -18,8 +20,14 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace carla {
 namespace streaming {
@@ -31,6 +39,17 @@ namespace tcp {
   /// A TCP server session. When a session opens, it reads from the socket a
   /// stream id object and passes itself to the callback functor. The session
   /// closes itself after @a timeout of inactivity is met.
+  ///
+  /// Messages wait in a queue bounded as the server's SendQueueSettings say,
+  /// everything queued while a write is in progress goes in the next one. A
+  /// client may also ask for at most one message every so often, the others
+  /// are skipped before being queued.
+  ///
+  /// If the client asks for it and runs on the same host, the queued messages
+  /// go through a SharedMemoryRing instead and the socket only tells when
+  /// either side goes away. A full ring is retried shortly after, never waited
+  /// on in the io threads. If a ring large enough for a message cannot be
+  /// created, or the client cannot open it, the session goes on through TCP.
   class ServerSession
     : public std::enable_shared_from_this<ServerSession>,
       private profiler::LifetimeProfiled,
@@ -65,7 +84,12 @@ namespace tcp {
       return std::make_shared<const Message>(std::move(buffers)...);
     }
 
-    /// Writes some data to the socket.
+    /// Counters of the stream this session belongs to, set before the
+    /// session is connected to it.
+    void SetStatistics(std::shared_ptr<SendStatistics> statistics);
+
+    /// Queues some data to be written to the socket. May block, up to the
+    /// block timeout, if the queue is full and the policy is Block.
     void Write(std::shared_ptr<const Message> message);
 
     /// Writes some data to the socket.
@@ -81,6 +105,52 @@ namespace tcp {
 
     void StartTimer();
 
+    /// Called once the subscription is read, negotiates the transport before
+    /// calling @a on_opened.
+    void StartSession(callback_function_type on_opened);
+
+    /// Whether the message written at @a now is skipped because the client
+    /// asked for a lower rate.
+    bool IsRateLimited(SendStatistics::clock::time_point now);
+
+    /// Offers the client a shared memory ring, if possible, and calls @a
+    /// on_opened once the client answered.
+    void NegotiateSharedMemory(callback_function_type on_opened);
+
+    /// Whether the client connected from this host.
+    bool IsLocalPeer() const;
+
+    struct QueuedMessage;
+
+    /// Writes a message to the ring, moving to a larger one if needed.
+    /// Returns false if the ring is full and the message has to be retried,
+    /// or if the session is moving to TCP.
+    bool WriteToSharedMemory(const QueuedMessage &queued);
+
+    /// Adds a message to the queue as the policy says, returns whether the
+    /// caller has to start writing.
+    bool Enqueue(
+        std::shared_ptr<const Message> message,
+        SendStatistics::clock::time_point written);
+
+    /// Requires the queue lock.
+    void DropOldest();
+
+    /// Writes everything in the queue at once, and again when done until the
+    /// queue is empty.
+    void WriteQueued();
+
+    /// Writes the queue to the ring one message at a time, and schedules
+    /// itself again if the ring is full.
+    void WriteQueuedToSharedMemory();
+
+    /// Calls the write function of the current transport.
+    void WriteNext();
+
+    /// Called once the client stopped reading the ring, writes the rest of
+    /// the session to the socket.
+    void RevertToTcp();
+
     void CloseNow();
 
     friend class Server;
@@ -91,6 +161,13 @@ namespace tcp {
 
     stream_id_type _stream_id = 0u;
 
+    /// Minimum interval between messages in microseconds, zero if the client
+    /// did not ask for a rate limit.
+    uint32_t _min_interval = 0u;
+
+    /// Earliest time for the next message, in nanoseconds of the clock.
+    std::atomic<int64_t> _next_write{0};
+
     socket_type _socket;
 
     time_duration _timeout;
@@ -101,7 +178,59 @@ namespace tcp {
 
     callback_function_type _on_closed;
 
+    struct QueuedMessage {
+      std::shared_ptr<const Message> message;
+      SendStatistics::clock::time_point written;
+    };
+
+    std::mutex _queue_mutex;
+
+    std::condition_variable _queue_space;
+
+    std::deque<QueuedMessage> _queue;
+
+    size_t _queued_bytes = 0u;
+
     bool _is_writing = false;
+
+    bool _is_closed = false;
+
+    /// Only accessed in the strand, as the buffers being written.
+    std::vector<QueuedMessage> _in_flight;
+
+    std::vector<boost::asio::const_buffer> _write_buffers;
+
+    std::shared_ptr<SendStatistics> _statistics;
+
+    std::atomic_bool _is_shared_memory{false};
+
+    std::shared_ptr<SharedMemoryRing> _ring;
+
+    /// Larger ring created for a message too large for the current one, not
+    /// switched to yet.
+    std::shared_ptr<SharedMemoryRing> _next_ring;
+
+    /// Rings switched away from, kept linked until the client reads from the
+    /// current one, so it can still open them if it lags behind.
+    std::vector<std::shared_ptr<SharedMemoryRing>> _previous_rings;
+
+    /// Whether the session moved past the offered ring, which only holds the
+    /// switch to the first ring sized for the messages.
+    bool _is_ring_sized = false;
+
+    /// Set when a large enough ring cannot be created, the client is told to
+    /// move to TCP instead.
+    bool _is_tcp_fallback = false;
+
+    /// Set once the client was told, nothing is written until it answers.
+    bool _is_reverting = false;
+
+    boost::asio::deadline_timer _ring_retry;
+
+    /// Name of the offered ring, empty if none.
+    std::array<char, SharedMemoryRing::MAX_NAME_LENGTH> _ring_name;
+
+    uint8_t _ring_answer = 0u;
   };
 
 } // namespace tcp
@@ -46,21 +46,29 @@ namespace low_level {
       }
     }
 
+    /// If @a max_rate is positive, the server sends at most that many messages
+    /// per second to this client.
+    ///
     /// @warning cannot subscribe twice to the same stream (even if it's a
     /// MultiStream).
     template <typename Functor>
     void Subscribe(
         boost::asio::io_context &io_context,
         token_type token,
-        Functor &&callback) {
+        Functor &&callback,
+        double max_rate = 0.0) {
       DEBUG_ASSERT_EQ(_clients.find(token.get_stream_id()), _clients.end());
       if (!token.has_address()) {
         token.set_address(_fallback_address);
       }
+      if (!_shared_memory) {
+        token.set_shared_memory(false);
+      }
       auto client = std::make_shared<underlying_client>(
           io_context,
           token,
-          std::forward<Functor>(callback));
+          std::forward<Functor>(callback),
+          max_rate);
       client->Connect();
       _clients.emplace(token.get_stream_id(), std::move(client));
     }
@@ -73,10 +81,18 @@ namespace low_level {
       }
     }
 
+    /// Whether the streams subscribed from now on may read through shared
+    /// memory if their server offers it.
+    void SetSharedMemory(bool enable) {
+      _shared_memory = enable;
+    }
+
   private:
 
     boost::asio::ip::address _fallback_address;
 
+    bool _shared_memory = true;
+
     std::unordered_map<
         detail::stream_id_type,
         std::shared_ptr<underlying_client>> _clients;
@@ -7,10 +7,13 @@
 #pragma once
 
 #include "carla/streaming/detail/Dispatcher.h"
+#include "carla/streaming/SendQueue.h"
 #include "carla/streaming/Stream.h"
 
 #include <boost/asio/io_context.hpp>
 
+#include <vector>
+
 namespace carla {
 namespace streaming {
 namespace low_level {
@@ -68,9 +71,25 @@ namespace low_level {
       _server.SetSynchronousMode(is_synchro);
     }
 
+    /// Whether the streams created from now on may stream through shared
+    /// memory to the clients on this host.
+    void SetSharedMemory(bool enable) {
+      _server.SetSharedMemory(enable);
+      _dispatcher.SetSharedMemory(_server.IsSharedMemoryEnabled());
+    }
+
+    void SetSendQueue(const SendQueueSettings &settings) {
+      _server.SetSendQueue(settings);
+    }
+
+    std::vector<StreamStatistics> GetStreamStatistics() {
+      return _dispatcher.GetStatistics();
+    }
+
   private:
 
     void StartServer() {
+      _dispatcher.SetSharedMemory(_server.IsSharedMemoryEnabled());
       auto on_session_opened = [this](auto session) {
         if (!_dispatcher.RegisterSession(session)) {
           session->Close();
@@ -55,11 +55,13 @@ namespace carla
       std::set<ActorId> world_pedestrian_ids;
       std::vector<ActorId> unregistered_list_to_be_deleted;
 
-      current_timestamp = world.GetSnapshot().GetTimestamp();
-      ActorList world_actors = world.GetActors();
+      // All the actor states of the cycle are read from this snapshot.
+      const cc::WorldSnapshot world_snapshot = world.GetSnapshot();
+      current_timestamp = world_snapshot.GetTimestamp();
+      physics_toggles.clear();
 
       // Find destroyed actors and perform clean up.
-      const ALSM::DestroyeddActors destroyed_actors = IdentifyDestroyedActors(world_actors);
+      const ALSM::DestroyeddActors destroyed_actors = IdentifyDestroyedActors(world_snapshot);
 
       const ActorIdSet &destroyed_registered = destroyed_actors.first;
       for (const auto &deletion_id : destroyed_registered)
@@ -96,11 +98,11 @@ namespace carla
       }
 
       // Scan for new unregistered actors.
-      IdentifyNewActors(world_actors);
+      IdentifyNewActors(world_snapshot);
 
       // Update dynamic state and static attributes for all registered vehicles.
       ALSM::IdleInfo max_idle_time = std::make_pair(0u, current_timestamp.elapsed_seconds);
-      UpdateRegisteredActorsData(hybrid_physics_mode, max_idle_time);
+      UpdateRegisteredActorsData(world_snapshot, hybrid_physics_mode, max_idle_time);
 
       // Destroy registered vehicle if stuck at a location for too long.
       if (IsVehicleStuck(max_idle_time.first) && (current_timestamp.elapsed_seconds - elapsed_last_actor_destruction) > DELTA_TIME_BETWEEN_DESTRUCTIONS && hero_actors.find(max_idle_time.first) == hero_actors.end())
@@ -122,29 +124,46 @@ namespace carla
       }
 
       // Update dynamic state and static attributes for unregistered actors.
-      UpdateUnregisteredActorsData();
+      UpdateUnregisteredActorsData(world_snapshot);
     }
 
-    void ALSM::IdentifyNewActors(const ActorList &actor_list)
+    void ALSM::IdentifyNewActors(const cc::WorldSnapshot &world_snapshot)
     {
-      for (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter)
+      // Only actors not seen before, and actors unregistered from the traffic manager
+      // since, are fetched from the episode.
+      std::vector<ActorId> new_actor_ids;
+      for (const cc::ActorSnapshot &actor_snapshot : world_snapshot)
+      {
+        const ActorId actor_id = actor_snapshot.id;
+        const bool is_known = known_actors.find(actor_id) != known_actors.end();
+        if (!is_known
+            || (unregistered_actors.find(actor_id) == unregistered_actors.end() && !registered_vehicles.Contains(actor_id)))
+        {
+          new_actor_ids.push_back(actor_id);
+        }
+      }
+      if (new_actor_ids.empty())
+      {
+        return;
+      }
+
+      ActorList new_actors = world.GetActors(new_actor_ids);
+      for (auto iter = new_actors->begin(); iter != new_actors->end(); ++iter)
       {
         ActorPtr actor = *iter;
         ActorId actor_id = actor->GetId();
         // Identify any new hero vehicle
-        if (actor->GetTypeId().rfind("vehicle") != -1)
+        if (known_actors.find(actor_id) == known_actors.end() && actor->GetTypeId().rfind("vehicle") != -1)
         {
-          if (hero_actors.size() == 0u || hero_actors.find(actor_id) == hero_actors.end())
+          for (auto &&attribute : actor->GetAttributes())
           {
-            for (auto &&attribute : actor->GetAttributes())
+            if (attribute.GetId() == "role_name" && attribute.GetValue() == "hero")
             {
-              if (attribute.GetId() == "role_name" && attribute.GetValue() == "hero")
-              {
-                hero_actors.insert({actor_id, actor});
-              }
+              hero_actors.insert({actor_id, actor});
             }
           }
         }
+        known_actors.insert(actor_id);
         if (!registered_vehicles.Contains(actor_id) && unregistered_actors.find(actor_id) == unregistered_actors.end())
         {
 
@@ -153,25 +172,31 @@ namespace carla
       }
     }
 
-    ALSM::DestroyeddActors ALSM::IdentifyDestroyedActors(const ActorList &actor_list)
+    ALSM::DestroyeddActors ALSM::IdentifyDestroyedActors(const cc::WorldSnapshot &world_snapshot)
     {
 
       ALSM::DestroyeddActors destroyed_actors;
       ActorIdSet &deleted_registered = destroyed_actors.first;
       ActorIdSet &deleted_unregistered = destroyed_actors.second;
 
-      // Building hash set of actors present in current frame.
-      ActorIdSet current_actors;
-      for (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter)
+      // Forgetting actors missing from the current frame.
+      for (auto iter = known_actors.begin(); iter != known_actors.end();)
       {
-        current_actors.insert((*iter)->GetId());
+        if (world_snapshot.Contains(*iter))
+        {
+          ++iter;
+        }
+        else
+        {
+          iter = known_actors.erase(iter);
+        }
       }
 
       // Searching for destroyed registered actors.
       std::vector<ActorId> registered_ids = registered_vehicles.GetIDList();
       for (const ActorId &actor_id : registered_ids)
       {
-        if (current_actors.find(actor_id) == current_actors.end())
+        if (!world_snapshot.Contains(actor_id))
         {
           deleted_registered.insert(actor_id);
         }
@@ -181,7 +206,7 @@ namespace carla
       for (const auto &actor_info : unregistered_actors)
       {
         const ActorId &actor_id = actor_info.first;
-        if (current_actors.find(actor_id) == current_actors.end() || registered_vehicles.Contains(actor_id))
+        if (!world_snapshot.Contains(actor_id) || registered_vehicles.Contains(actor_id))
         {
           deleted_unregistered.insert(actor_id);
         }
@@ -190,7 +215,8 @@ namespace carla
       return destroyed_actors;
     }
 
-    void ALSM::UpdateRegisteredActorsData(const bool hybrid_physics_mode, ALSM::IdleInfo &max_idle_time)
+    void ALSM::UpdateRegisteredActorsData(const cc::WorldSnapshot &world_snapshot,
+                                          const bool hybrid_physics_mode, ALSM::IdleInfo &max_idle_time)
     {
 
       std::vector<ActorPtr> vehicle_list = registered_vehicles.GetList();
@@ -207,9 +233,13 @@ namespace carla
       {
         if (is_respawn_vehicles)
         {
-          track_traffic.SetHeroLocation(hero_actor_info.second->GetTransform().location);
+          const auto hero_snapshot = world_snapshot.Find(hero_actor_info.first);
+          if (hero_snapshot)
+          {
+            track_traffic.SetHeroLocation(hero_snapshot->transform.location);
+          }
         }
-        UpdateData(hybrid_physics_mode, max_idle_time, hero_actor_info.second, hero_actor_present, physics_radius_square);
+        UpdateData(world_snapshot, hybrid_physics_mode, max_idle_time, hero_actor_info.second, hero_actor_present, physics_radius_square);
       }
       // Update information for all other registered vehicles.
       for (const Actor &vehicle : vehicle_list)
@@ -217,21 +247,27 @@ namespace carla
         ActorId actor_id = vehicle->GetId();
         if (hero_actors.find(actor_id) == hero_actors.end())
         {
-          UpdateData(hybrid_physics_mode, max_idle_time, vehicle, hero_actor_present, physics_radius_square);
+          UpdateData(world_snapshot, hybrid_physics_mode, max_idle_time, vehicle, hero_actor_present, physics_radius_square);
         }
       }
     }
 
-    void ALSM::UpdateData(const bool hybrid_physics_mode,
+    void ALSM::UpdateData(const cc::WorldSnapshot &world_snapshot, const bool hybrid_physics_mode,
                           ALSM::IdleInfo &max_idle_time, const Actor &vehicle,
                           const bool hero_actor_present, const float physics_radius_square)
     {
 
       ActorId actor_id = vehicle->GetId();
-      cg::Transform vehicle_transform = vehicle->GetTransform();
-      cg::Location vehicle_location = vehicle_transform.location;
-      cg::Rotation vehicle_rotation = vehicle_transform.rotation;
-      cg::Vector3D vehicle_velocity = vehicle->GetVelocity();
+      // Actors missing from the snapshot were removed by IdentifyDestroyedActors.
+      const boost::optional<cc::ActorSnapshot> actor_snapshot = world_snapshot.Find(actor_id);
+      if (!actor_snapshot)
+      {
+        return;
+      }
+      cg::Location vehicle_location = actor_snapshot->transform.location;
+      cg::Rotation vehicle_rotation = actor_snapshot->transform.rotation;
+      cg::Vector3D vehicle_velocity = actor_snapshot->velocity;
+      const auto &vehicle_data = actor_snapshot->state.vehicle_data;
 
       // Initializing idle times.
       if (idle_time.find(actor_id) == idle_time.end() && current_timestamp.elapsed_seconds != 0.0)
@@ -263,12 +299,14 @@ namespace carla
       {
         if (hero_actors.find(actor_id) == hero_actors.end())
         {
-          vehicle->SetSimulatePhysics(enable_physics);
           has_physics_enabled[actor_id] = enable_physics;
+          PhysicsToggle toggle{actor_id, enable_physics, false, cg::Vector3D()};
           if (enable_physics == true && simulation_state.ContainsActor(actor_id))
           {
-            vehicle->SetTargetVelocity(simulation_state.GetVelocity(actor_id));
+            toggle.set_target_velocity = true;
+            toggle.target_velocity = simulation_state.GetVelocity(actor_id);
           }
+          physics_toggles.push_back(toggle);
         }
       }
 
@@ -290,13 +328,12 @@ namespace carla
       }
 
       // Updated kinematic state object.
-      auto vehicle_ptr = boost::static_pointer_cast<cc::Vehicle>(vehicle);
       KinematicState kinematic_state{vehicle_location, vehicle_rotation,
-                                     vehicle_velocity, vehicle_ptr->GetSpeedLimit(),
-                                     enable_physics, vehicle->IsDormant()};
+                                     vehicle_velocity, vehicle_data.speed_limit,
+                                     enable_physics, actor_snapshot->actor_state == rpc::ActorState::Dormant};
 
       // Updated traffic light state object.
-      TrafficLightState tl_state = {vehicle_ptr->GetTrafficLightState(), vehicle_ptr->IsAtTrafficLight()};
+      TrafficLightState tl_state = {vehicle_data.traffic_light_state, vehicle_data.has_traffic_light};
 
       // Update simulation state.
       if (state_entry_present)
@@ -306,6 +343,7 @@ namespace carla
       }
       else
       {
+        auto vehicle_ptr = boost::static_pointer_cast<cc::Vehicle>(vehicle);
         cg::Vector3D dimensions = vehicle_ptr->GetBoundingBox().extent;
         StaticAttributes attributes{ActorType::Vehicle, dimensions.x, dimensions.y, dimensions.z};
 
@@ -316,20 +354,25 @@ namespace carla
       UpdateIdleTime(max_idle_time, actor_id);
     }
 
-    void ALSM::UpdateUnregisteredActorsData()
+    void ALSM::UpdateUnregisteredActorsData(const cc::WorldSnapshot &world_snapshot)
     {
       for (auto &actor_info : unregistered_actors)
       {
 
         const ActorId actor_id = actor_info.first;
         const ActorPtr actor_ptr = actor_info.second;
-        const std::string type_id = actor_ptr->GetTypeId();
+        const boost::optional<cc::ActorSnapshot> actor_snapshot = world_snapshot.Find(actor_id);
+        if (!actor_snapshot)
+        {
+          continue;
+        }
+        const std::string &type_id = actor_ptr->GetTypeId();
 
-        const cg::Transform actor_transform = actor_ptr->GetTransform();
+        const cg::Transform &actor_transform = actor_snapshot->transform;
         const cg::Location actor_location = actor_transform.location;
         const cg::Rotation actor_rotation = actor_transform.rotation;
-        const cg::Vector3D actor_velocity = actor_ptr->GetVelocity();
-        const bool actor_is_dormant = actor_ptr->IsDormant();
+        const cg::Vector3D actor_velocity = actor_snapshot->velocity;
+        const bool actor_is_dormant = actor_snapshot->actor_state == rpc::ActorState::Dormant;
         KinematicState kinematic_state{actor_location, actor_rotation, actor_velocity, -1.0f, true, actor_is_dormant};
 
         TrafficLightState tl_state;
@@ -341,13 +384,14 @@ namespace carla
         if (type_id.rfind("vehicle") != -1)
         { // include DReyeVR vehicle
           auto vehicle_ptr = boost::static_pointer_cast<cc::Vehicle>(actor_ptr);
-          kinematic_state.speed_limit = vehicle_ptr->GetSpeedLimit();
+          const auto &vehicle_data = actor_snapshot->state.vehicle_data;
+          kinematic_state.speed_limit = vehicle_data.speed_limit;
 
-          tl_state = {vehicle_ptr->GetTrafficLightState(), vehicle_ptr->IsAtTrafficLight()};
+          tl_state = {vehicle_data.traffic_light_state, vehicle_data.has_traffic_light};
 
+          dimensions = vehicle_ptr->GetBoundingBox().extent;
           if (state_entry_not_present)
           {
-            dimensions = vehicle_ptr->GetBoundingBox().extent;
             actor_type = ActorType::Vehicle;
             StaticAttributes attributes{actor_type, dimensions.x, dimensions.y, dimensions.z};
 
@@ -360,11 +404,10 @@ namespace carla
           }
 
           // Identify occupied waypoints.
-          cg::Vector3D extent = vehicle_ptr->GetBoundingBox().extent;
-          cg::Vector3D heading_vector = vehicle_ptr->GetTransform().GetForwardVector();
-          std::vector<cg::Location> corners = {actor_location + cg::Location(extent.x * heading_vector),
+          cg::Vector3D heading_vector = actor_transform.GetForwardVector();
+          std::vector<cg::Location> corners = {actor_location + cg::Location(dimensions.x * heading_vector),
                                                actor_location,
-                                               actor_location + cg::Location(-extent.x * heading_vector)};
+                                               actor_location + cg::Location(-dimensions.x * heading_vector)};
           for (cg::Location &vertex : corners)
           {
             SimpleWaypointPtr nearest_waypoint = local_map->GetWaypoint(vertex);
@@ -397,6 +440,30 @@ namespace carla
       }
     }
 
+    void ALSM::AddPhysicsCommands(ControlFrame &control_frame)
+    {
+      if (physics_toggles.empty())
+      {
+        return;
+      }
+      std::vector<carla::rpc::Command> physics_commands;
+      physics_commands.reserve(2u * physics_toggles.size());
+      for (const PhysicsToggle &toggle : physics_toggles)
+      {
+        // Skip vehicles removed later in the update.
+        if (registered_vehicles.Contains(toggle.actor_id))
+        {
+          physics_commands.emplace_back(carla::rpc::Command::SetSimulatePhysics(toggle.actor_id, toggle.enable_physics));
+          if (toggle.set_target_velocity)
+          {
+            physics_commands.emplace_back(carla::rpc::Command::ApplyTargetVelocity(toggle.actor_id, toggle.target_velocity));
+          }
+        }
+      }
+      control_frame.insert(control_frame.begin(), physics_commands.begin(), physics_commands.end());
+      physics_toggles.clear();
+    }
+
     void ALSM::UpdateIdleTime(std::pair<ActorId, double> &max_idle_time, const ActorId &actor_id)
     {
       if (idle_time.find(actor_id) != idle_time.end())
@@ -449,6 +516,8 @@ namespace carla
         hero_actors.erase(actor_id);
       }
 
+      // Looked up again if still alive, as when it moves between registered and unregistered.
+      known_actors.erase(actor_id);
       track_traffic.DeleteActor(actor_id);
       simulation_state.RemoveActor(actor_id);
     }
@@ -456,6 +525,8 @@ namespace carla
     void ALSM::Reset()
     {
       unregistered_actors.clear();
+      known_actors.clear();
+      physics_toggles.clear();
       idle_time.clear();
       hero_actors.clear();
       elapsed_last_actor_destruction = 0.0;
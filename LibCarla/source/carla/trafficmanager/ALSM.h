@@ -6,6 +6,7 @@
 #include "carla/client/ActorList.h"
 #include "carla/client/Timestamp.h"
 #include "carla/client/World.h"
+#include "carla/client/WorldSnapshot.h"
 #include "carla/Memory.h"
 
 #include "carla/trafficmanager/AtomicActorSet.h"
@@ -67,6 +68,16 @@ private:
   // Random devices.
   RandomGeneratorMap &random_devices;
   std::unordered_map<ActorId, bool> has_physics_enabled;
+  // Physics changes of hybrid mode, sent with the commands of the cycle.
+  struct PhysicsToggle {
+    ActorId actor_id;
+    bool enable_physics;
+    bool set_target_velocity;
+    cg::Vector3D target_velocity;
+  };
+  std::vector<PhysicsToggle> physics_toggles;
+  // Actors present in the last world snapshot.
+  ActorIdSet known_actors;
 
   // Updates the duration for which a registered vehicle is stuck at a location.
   void UpdateIdleTime(std::pair<ActorId, double>& max_idle_time, const ActorId& actor_id);
@@ -74,22 +85,24 @@ private:
   // Method to determine if a vehicle is stuck at a place for too long.
   bool IsVehicleStuck(const ActorId& actor_id);
 
-  // Method to identify actors newly spawned in the simulation since last tick.
-  void IdentifyNewActors(const ActorList &actor_list);
+  // Method to identify actors newly spawned in the simulation since last tick,
+  // and actors no longer registered with the traffic manager.
+  void IdentifyNewActors(const cc::WorldSnapshot &world_snapshot);
 
   using DestroyeddActors = std::pair<ActorIdSet, ActorIdSet>;
   // Method to identify actors deleted in the last frame.
   // Arrays of registered and unregistered actors are returned separately.
-  DestroyeddActors IdentifyDestroyedActors(const ActorList &actor_list);
+  DestroyeddActors IdentifyDestroyedActors(const cc::WorldSnapshot &world_snapshot);
 
   using IdleInfo = std::pair<ActorId, double>;
-  void UpdateRegisteredActorsData(const bool hybrid_physics_mode, IdleInfo &max_idle_time);
+  void UpdateRegisteredActorsData(const cc::WorldSnapshot &world_snapshot,
+                                  const bool hybrid_physics_mode, IdleInfo &max_idle_time);
 
-  void UpdateData(const bool hybrid_physics_mode,
+  void UpdateData(const cc::WorldSnapshot &world_snapshot, const bool hybrid_physics_mode,
                   ALSM::IdleInfo &max_idle_time, const Actor &vehicle,
                   const bool hero_actor_present, const float physics_radius_square);
 
-  void UpdateUnregisteredActorsData();
+  void UpdateUnregisteredActorsData(const cc::WorldSnapshot &world_snapshot);
 
 public:
   ALSM(AtomicActorSet &registered_vehicles,
@@ -109,6 +122,11 @@ public:
 
   void Update();
 
+  // Inserts the physics changes of hybrid mode decided in the last Update at the
+  // front of the command batch, so the commands of the cycle find the vehicles
+  // in their new mode.
+  void AddPhysicsCommands(ControlFrame &control_frame);
+
   // Removes an actor from traffic manager and performs clean up of associated data
   // from various stages tracking the said vehicle.
   void RemoveActor(const ActorId actor_id, const bool registered_actor);
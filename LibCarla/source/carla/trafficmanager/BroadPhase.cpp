@@ -0,0 +1,134 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <algorithm>
+#include <cmath>
+
+#include "carla/trafficmanager/BroadPhase.h"
+
+namespace carla {
+namespace traffic_manager {
+
+void BroadPhaseBounds::Extend(const cg::Location &location) {
+  min.x = std::min(min.x, location.x);
+  min.y = std::min(min.y, location.y);
+  min.z = std::min(min.z, location.z);
+  max.x = std::max(max.x, location.x);
+  max.y = std::max(max.y, location.y);
+  max.z = std::max(max.z, location.z);
+}
+
+void BroadPhaseBounds::Inflate(const float margin) {
+  if (!IsEmpty()) {
+    min -= cg::Location(margin, margin, margin);
+    max += cg::Location(margin, margin, margin);
+  }
+}
+
+bool BroadPhaseBounds::Overlaps(const BroadPhaseBounds &other) const {
+  return min.x <= other.max.x && other.min.x <= max.x
+      && min.y <= other.max.y && other.min.y <= max.y
+      && min.z <= other.max.z && other.min.z <= max.z;
+}
+
+BroadPhase::BroadPhase(const float cell_size)
+  : inv_cell_size(1.0f / cell_size) {}
+
+BroadPhase::CellRange BroadPhase::GetCellRange(const BroadPhaseBounds &bounds) const {
+  CellRange range;
+  if (!bounds.IsEmpty()) {
+    range.min_x = static_cast<int32_t>(std::floor(bounds.min.x * inv_cell_size));
+    range.min_y = static_cast<int32_t>(std::floor(bounds.min.y * inv_cell_size));
+    range.max_x = static_cast<int32_t>(std::floor(bounds.max.x * inv_cell_size));
+    range.max_y = static_cast<int32_t>(std::floor(bounds.max.y * inv_cell_size));
+  }
+  return range;
+}
+
+void BroadPhase::AddToCells(const ActorId actor_id, const CellRange &range) {
+  for (int32_t x = range.min_x; x <= range.max_x; ++x) {
+    for (int32_t y = range.min_y; y <= range.max_y; ++y) {
+      cells[GetCellKey(x, y)].push_back(actor_id);
+    }
+  }
+}
+
+void BroadPhase::RemoveFromCells(const ActorId actor_id, const CellRange &range) {
+  for (int32_t x = range.min_x; x <= range.max_x; ++x) {
+    for (int32_t y = range.min_y; y <= range.max_y; ++y) {
+      auto cell = cells.find(GetCellKey(x, y));
+      if (cell != cells.end()) {
+        std::vector<ActorId> &actors = cell->second;
+        auto actor = std::find(actors.begin(), actors.end(), actor_id);
+        if (actor != actors.end()) {
+          *actor = actors.back();
+          actors.pop_back();
+        }
+      }
+    }
+  }
+}
+
+void BroadPhase::Update(const ActorId actor_id, const BroadPhaseBounds &bounds) {
+  const CellRange range = GetCellRange(bounds);
+  auto entry = entries.find(actor_id);
+  if (entry == entries.end()) {
+    entries.insert({actor_id, {bounds, range}});
+    AddToCells(actor_id, range);
+  } else {
+    if (!(entry->second.cells == range)) {
+      RemoveFromCells(actor_id, entry->second.cells);
+      AddToCells(actor_id, range);
+      entry->second.cells = range;
+    }
+    entry->second.bounds = bounds;
+  }
+}
+
+void BroadPhase::Remove(const ActorId actor_id) {
+  auto entry = entries.find(actor_id);
+  if (entry != entries.end()) {
+    RemoveFromCells(actor_id, entry->second.cells);
+    entries.erase(entry);
+  }
+}
+
+void BroadPhase::Clear() {
+  entries.clear();
+  cells.clear();
+}
+
+void BroadPhase::Query(const ActorId actor_id, std::vector<ActorId> &result) const {
+  auto entry = entries.find(actor_id);
+  if (entry == entries.end()) {
+    result.clear();
+    return;
+  }
+  Query(entry->second.bounds, result);
+}
+
+void BroadPhase::Query(const BroadPhaseBounds &bounds, std::vector<ActorId> &result) const {
+  result.clear();
+  const CellRange range = GetCellRange(bounds);
+  for (int32_t x = range.min_x; x <= range.max_x; ++x) {
+    for (int32_t y = range.min_y; y <= range.max_y; ++y) {
+      auto cell = cells.find(GetCellKey(x, y));
+      if (cell != cells.end()) {
+        for (const ActorId other_id : cell->second) {
+          if (entries.at(other_id).bounds.Overlaps(bounds)) {
+            result.push_back(other_id);
+          }
+        }
+      }
+    }
+  }
+  // Actors spanning several of the cells are found once per cell.
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,113 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "carla/geom/Location.h"
+#include "carla/rpc/ActorId.h"
+
+namespace carla {
+namespace traffic_manager {
+
+namespace cg = carla::geom;
+
+/// Axis aligned box around the path of an actor.
+struct BroadPhaseBounds {
+  cg::Location min {
+    std::numeric_limits<float>::max(),
+    std::numeric_limits<float>::max(),
+    std::numeric_limits<float>::max()};
+  cg::Location max {
+    std::numeric_limits<float>::lowest(),
+    std::numeric_limits<float>::lowest(),
+    std::numeric_limits<float>::lowest()};
+
+  bool IsEmpty() const {
+    return min.x > max.x;
+  }
+
+  void Extend(const cg::Location &location);
+
+  void Inflate(float margin);
+
+  bool Overlaps(const BroadPhaseBounds &other) const;
+};
+
+/// Uniform grid over the world's x-y plane holding the path bounds of the
+/// tracked actors. Updates only touch the cells of an actor whose bounds moved
+/// to other cells, so a cycle where vehicles advance less than a cell costs
+/// one comparison per vehicle.
+class BroadPhase {
+public:
+  using ActorId = carla::rpc::ActorId;
+
+  explicit BroadPhase(float cell_size);
+
+  /// Inserts the actor or moves it to the new bounds.
+  void Update(ActorId actor_id, const BroadPhaseBounds &bounds);
+
+  void Remove(ActorId actor_id);
+
+  void Clear();
+
+  bool Contains(ActorId actor_id) const {
+    return entries.find(actor_id) != entries.end();
+  }
+
+  size_t Size() const {
+    return entries.size();
+  }
+
+  /// Fills result (cleared first) with the actors whose bounds overlap the
+  /// bounds of actor_id, including actor_id itself, sorted by id. Empty if
+  /// the actor is not tracked.
+  void Query(ActorId actor_id, std::vector<ActorId> &result) const;
+
+  /// Fills result (cleared first) with the actors whose bounds overlap the
+  /// given bounds, sorted by id.
+  void Query(const BroadPhaseBounds &bounds, std::vector<ActorId> &result) const;
+
+private:
+  struct CellRange {
+    int32_t min_x = 0;
+    int32_t min_y = 0;
+    int32_t max_x = -1;
+    int32_t max_y = -1;
+
+    bool operator==(const CellRange &rhs) const {
+      return min_x == rhs.min_x && min_y == rhs.min_y && max_x == rhs.max_x && max_y == rhs.max_y;
+    }
+  };
+
+  struct Entry {
+    BroadPhaseBounds bounds;
+    CellRange cells;
+  };
+
+  CellRange GetCellRange(const BroadPhaseBounds &bounds) const;
+
+  static uint64_t GetCellKey(int32_t x, int32_t y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32u) | static_cast<uint32_t>(y);
+  }
+
+  void AddToCells(ActorId actor_id, const CellRange &range);
+
+  void RemoveFromCells(ActorId actor_id, const CellRange &range);
+
+  const float inv_cell_size;
+  std::unordered_map<ActorId, Entry> entries;
+  /// Actors whose bounds touch each cell. Emptied cells keep their storage.
+  std::unordered_map<uint64_t, std::vector<ActorId>> cells;
+};
+
+} // namespace traffic_manager
+} // namespace carla
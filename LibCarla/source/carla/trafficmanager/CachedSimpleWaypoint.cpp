@@ -9,8 +9,6 @@
 namespace carla {
 namespace traffic_manager {
 
-  using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-
   CachedSimpleWaypoint::CachedSimpleWaypoint(const SimpleWaypointPtr& simple_waypoint) {
     this->waypoint_id = simple_waypoint->GetId();
 
@@ -19,10 +17,10 @@ namespace traffic_manager {
     this->lane_id = simple_waypoint->GetWaypoint()->GetLaneId();
     this->s = static_cast<float>(simple_waypoint->GetWaypoint()->GetDistance());
 
-    for (auto &wp : simple_waypoint->GetNextWaypoint()) {
+    for (auto wp : simple_waypoint->GetNextWaypoint()) {
       this->next_waypoints.push_back(wp->GetId());
     }
-    for (auto &wp : simple_waypoint->GetPreviousWaypoint()) {
+    for (auto wp : simple_waypoint->GetPreviousWaypoint()) {
       this->previous_waypoints.push_back(wp->GetId());
     }
 
@@ -118,7 +116,7 @@ namespace traffic_manager {
     ReadValue<uint8_t>(in_file, this->road_option);
   }
 
-  void CachedSimpleWaypoint::Read(const std::vector<uint8_t>& content, unsigned long& start) {
+  void CachedSimpleWaypoint::Read(const uint8_t *content, unsigned long& start) {
     ReadValue<uint64_t>(content, start, this->waypoint_id);
 
     // road_id, section_id, lane_id, s
@@ -13,8 +13,6 @@
 namespace carla {
 namespace traffic_manager {
 
-  using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-
   class CachedSimpleWaypoint {
   public:
     uint64_t waypoint_id;
@@ -33,7 +31,7 @@ namespace traffic_manager {
     CachedSimpleWaypoint() = default;
     CachedSimpleWaypoint(const SimpleWaypointPtr& simple_waypoint);
 
-    void Read(const std::vector<uint8_t>& content, unsigned long& start);
+    void Read(const uint8_t *content, unsigned long& start);
 
     void Read(std::ifstream &in_file);
     void Write(std::ofstream &out_file);
@@ -48,7 +46,7 @@ namespace traffic_manager {
       in_file.read(reinterpret_cast<char *>(&out_obj), sizeof(T));
     }
     template <typename T>
-    void ReadValue(const std::vector<uint8_t>& content, unsigned long& start, T &out_obj) {
+    void ReadValue(const uint8_t *content, unsigned long& start, T &out_obj) {
       memcpy(&out_obj, &content[start], sizeof(T));
       start += sizeof(T);
     }
@@ -0,0 +1,282 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "boost/geometry.hpp"
+#include "boost/geometry/geometries/geometries.hpp"
+#include "boost/geometry/geometries/point_xy.hpp"
+#include "boost/geometry/geometries/polygon.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define LIBCARLA_TM_COLLISION_GEOMETRY_SSE2
+#  include <emmintrin.h>
+#endif
+
+#include "carla/trafficmanager/CollisionGeometry.h"
+
+namespace carla {
+namespace traffic_manager {
+
+namespace bg = boost::geometry;
+
+using Point2D = bg::model::point<double, 2, bg::cs::cartesian>;
+using Polygon = bg::model::polygon<bg::model::d2::point_xy<double>>;
+
+constexpr size_t BoundaryPolygon::MAX_VERTICES;
+constexpr size_t BoundaryPolygon::LANES;
+constexpr size_t BoundaryPolygon::CAPACITY;
+
+bool BoundaryPolygon::Assign(const LocationVector &boundary) {
+  if (boundary.empty() || boundary.size() > MAX_VERTICES) {
+    size = 0u;
+    return false;
+  }
+  size = boundary.size();
+  for (size_t i = 0u; i < size; ++i) {
+    x[i] = boundary[i].x;
+    y[i] = boundary[i].y;
+  }
+  std::fill(x + size, x + CAPACITY, boundary.front().x);
+  std::fill(y + size, y + CAPACITY, boundary.front().y);
+  return true;
+}
+
+bool BoundaryPolygon::Contains(const float px, const float py) const {
+  bool inside = false;
+  for (size_t i = 0u; i < size; ++i) {
+    const float x0 = x[i];
+    const float y0 = y[i];
+    const float x1 = x[i + 1u];
+    const float y1 = y[i + 1u];
+    if ((y0 > py) != (y1 > py) && px < x0 + (py - y0) * (x1 - x0) / (y1 - y0)) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+namespace {
+
+  /// Closest approach found between the edges of two polygons.
+  struct EdgeAccumulator {
+    float distance_squared = std::numeric_limits<float>::max();
+    bool intersects = false;
+  };
+
+#ifdef LIBCARLA_TM_COLLISION_GEOMETRY_SSE2
+
+  inline __m128 PointSegmentDistanceSquared(
+      const __m128 px, const __m128 py,
+      const __m128 sx, const __m128 sy,
+      const __m128 vx, const __m128 vy,
+      const __m128 inv_length_squared) {
+    const __m128 wx = _mm_sub_ps(px, sx);
+    const __m128 wy = _mm_sub_ps(py, sy);
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(wx, vx), _mm_mul_ps(wy, vy)), inv_length_squared);
+    t = _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    const __m128 dx = _mm_sub_ps(wx, _mm_mul_ps(t, vx));
+    const __m128 dy = _mm_sub_ps(wy, _mm_mul_ps(t, vy));
+    return _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+  }
+
+  /// Compares the edge (a, b) with all the edges of the polygon, four at a time.
+  void AccumulateEdges(const float ax, const float ay, const float bx, const float by,
+                       const BoundaryPolygon &polygon, EdgeAccumulator &accumulator) {
+    const __m128 tiny = _mm_set1_ps(std::numeric_limits<float>::min());
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 ax4 = _mm_set1_ps(ax);
+    const __m128 ay4 = _mm_set1_ps(ay);
+    const __m128 bx4 = _mm_set1_ps(bx);
+    const __m128 by4 = _mm_set1_ps(by);
+    const __m128 abx = _mm_sub_ps(bx4, ax4);
+    const __m128 aby = _mm_sub_ps(by4, ay4);
+    const __m128 inv_ab = _mm_div_ps(_mm_set1_ps(1.0f),
+        _mm_max_ps(_mm_add_ps(_mm_mul_ps(abx, abx), _mm_mul_ps(aby, aby)), tiny));
+
+    __m128 minimum = _mm_set1_ps(accumulator.distance_squared);
+    __m128 intersects = zero;
+    const float *xs = polygon.X();
+    const float *ys = polygon.Y();
+    for (size_t i = 0u; i < polygon.PaddedSize(); i += BoundaryPolygon::LANES) {
+      const __m128 cx = _mm_loadu_ps(xs + i);
+      const __m128 cy = _mm_loadu_ps(ys + i);
+      const __m128 cdx = _mm_sub_ps(_mm_loadu_ps(xs + i + 1u), cx);
+      const __m128 cdy = _mm_sub_ps(_mm_loadu_ps(ys + i + 1u), cy);
+      const __m128 dx = _mm_add_ps(cx, cdx);
+      const __m128 dy = _mm_add_ps(cy, cdy);
+
+      // Proper crossing: each segment has the ends of the other strictly on both sides.
+      // Touching segments are left to the distances below, which are then zero.
+      const __m128 o1 = _mm_sub_ps(_mm_mul_ps(abx, _mm_sub_ps(cy, ay4)), _mm_mul_ps(aby, _mm_sub_ps(cx, ax4)));
+      const __m128 o2 = _mm_sub_ps(_mm_mul_ps(abx, _mm_sub_ps(dy, ay4)), _mm_mul_ps(aby, _mm_sub_ps(dx, ax4)));
+      const __m128 o3 = _mm_sub_ps(_mm_mul_ps(cdx, _mm_sub_ps(ay4, cy)), _mm_mul_ps(cdy, _mm_sub_ps(ax4, cx)));
+      const __m128 o4 = _mm_sub_ps(_mm_mul_ps(cdx, _mm_sub_ps(by4, cy)), _mm_mul_ps(cdy, _mm_sub_ps(bx4, cx)));
+      intersects = _mm_or_ps(intersects, _mm_and_ps(
+          _mm_cmplt_ps(_mm_mul_ps(o1, o2), zero),
+          _mm_cmplt_ps(_mm_mul_ps(o3, o4), zero)));
+
+      const __m128 inv_cd = _mm_div_ps(_mm_set1_ps(1.0f),
+          _mm_max_ps(_mm_add_ps(_mm_mul_ps(cdx, cdx), _mm_mul_ps(cdy, cdy)), tiny));
+      minimum = _mm_min_ps(minimum, PointSegmentDistanceSquared(ax4, ay4, cx, cy, cdx, cdy, inv_cd));
+      minimum = _mm_min_ps(minimum, PointSegmentDistanceSquared(bx4, by4, cx, cy, cdx, cdy, inv_cd));
+      minimum = _mm_min_ps(minimum, PointSegmentDistanceSquared(cx, cy, ax4, ay4, abx, aby, inv_ab));
+      minimum = _mm_min_ps(minimum, PointSegmentDistanceSquared(dx, dy, ax4, ay4, abx, aby, inv_ab));
+    }
+
+    alignas(16) float lanes[BoundaryPolygon::LANES];
+    _mm_store_ps(lanes, minimum);
+    accumulator.distance_squared = *std::min_element(lanes, lanes + BoundaryPolygon::LANES);
+    accumulator.intersects = accumulator.intersects || _mm_movemask_ps(intersects) != 0;
+  }
+
+#else
+
+  inline float PointSegmentDistanceSquared(
+      const float px, const float py,
+      const float sx, const float sy,
+      const float vx, const float vy,
+      const float inv_length_squared) {
+    const float wx = px - sx;
+    const float wy = py - sy;
+    const float t = std::min(std::max((wx * vx + wy * vy) * inv_length_squared, 0.0f), 1.0f);
+    const float dx = wx - t * vx;
+    const float dy = wy - t * vy;
+    return dx * dx + dy * dy;
+  }
+
+  /// Compares the edge (a, b) with all the edges of the polygon.
+  void AccumulateEdges(const float ax, const float ay, const float bx, const float by,
+                       const BoundaryPolygon &polygon, EdgeAccumulator &accumulator) {
+    const float tiny = std::numeric_limits<float>::min();
+    const float abx = bx - ax;
+    const float aby = by - ay;
+    const float inv_ab = 1.0f / std::max(abx * abx + aby * aby, tiny);
+
+    float minimum = accumulator.distance_squared;
+    bool intersects = accumulator.intersects;
+    const float *xs = polygon.X();
+    const float *ys = polygon.Y();
+    for (size_t i = 0u; i < polygon.Size(); ++i) {
+      const float cx = xs[i];
+      const float cy = ys[i];
+      const float cdx = xs[i + 1u] - cx;
+      const float cdy = ys[i + 1u] - cy;
+      const float dx = cx + cdx;
+      const float dy = cy + cdy;
+
+      // Proper crossing: each segment has the ends of the other strictly on both sides.
+      // Touching segments are left to the distances below, which are then zero.
+      const float o1 = abx * (cy - ay) - aby * (cx - ax);
+      const float o2 = abx * (dy - ay) - aby * (dx - ax);
+      const float o3 = cdx * (ay - cy) - cdy * (ax - cx);
+      const float o4 = cdx * (by - cy) - cdy * (bx - cx);
+      intersects = intersects || (o1 * o2 < 0.0f && o3 * o4 < 0.0f);
+
+      const float inv_cd = 1.0f / std::max(cdx * cdx + cdy * cdy, tiny);
+      minimum = std::min(minimum, PointSegmentDistanceSquared(ax, ay, cx, cy, cdx, cdy, inv_cd));
+      minimum = std::min(minimum, PointSegmentDistanceSquared(bx, by, cx, cy, cdx, cdy, inv_cd));
+      minimum = std::min(minimum, PointSegmentDistanceSquared(cx, cy, ax, ay, abx, aby, inv_ab));
+      minimum = std::min(minimum, PointSegmentDistanceSquared(dx, dy, ax, ay, abx, aby, inv_ab));
+    }
+
+    accumulator.distance_squared = minimum;
+    accumulator.intersects = intersects;
+  }
+
+#endif // LIBCARLA_TM_COLLISION_GEOMETRY_SSE2
+
+  double GetDistance(const EdgeAccumulator &accumulator,
+                     const BoundaryPolygon &a,
+                     const BoundaryPolygon &b) {
+    if (accumulator.intersects) {
+      return 0.0;
+    }
+    // Without crossing edges the polygons are either disjoint or nested.
+    if (b.Contains(a.X()[0], a.Y()[0]) || a.Contains(b.X()[0], b.Y()[0])) {
+      return 0.0;
+    }
+    return std::sqrt(static_cast<double>(accumulator.distance_squared));
+  }
+
+  Polygon GetPolygon(const LocationVector &boundary) {
+    Polygon boundary_polygon;
+    for (const cg::Location &location : boundary) {
+      bg::append(boundary_polygon.outer(), Point2D(location.x, location.y));
+    }
+    bg::append(boundary_polygon.outer(), Point2D(boundary.front().x, boundary.front().y));
+    return boundary_polygon;
+  }
+
+} // namespace
+
+double PolygonDistance(const BoundaryPolygon &a, const BoundaryPolygon &b) {
+  EdgeAccumulator accumulator;
+  for (size_t i = 0u; i < a.Size(); ++i) {
+    AccumulateEdges(a.X()[i], a.Y()[i], a.X()[i + 1u], a.Y()[i + 1u], b, accumulator);
+  }
+  return GetDistance(accumulator, a, b);
+}
+
+GeometryComparison CompareGeometryBoost(const LocationVector &reference_bbox,
+                                        const LocationVector &other_bbox,
+                                        const LocationVector &reference_geodesic,
+                                        const LocationVector &other_geodesic) {
+  const Polygon reference_polygon = GetPolygon(reference_bbox);
+  const Polygon other_polygon = GetPolygon(other_bbox);
+  const Polygon reference_geodesic_polygon = GetPolygon(reference_geodesic);
+  const Polygon other_geodesic_polygon = GetPolygon(other_geodesic);
+
+  return {bg::distance(reference_polygon, other_geodesic_polygon),
+          bg::distance(other_polygon, reference_geodesic_polygon),
+          bg::distance(reference_geodesic_polygon, other_geodesic_polygon),
+          bg::distance(reference_polygon, other_polygon)};
+}
+
+GeometryComparison CompareGeometry(const LocationVector &reference_bbox,
+                                   const LocationVector &other_bbox,
+                                   const LocationVector &reference_geodesic,
+                                   const LocationVector &other_geodesic) {
+  BoundaryPolygon reference_polygon;
+  BoundaryPolygon other_polygon;
+  BoundaryPolygon reference_geodesic_polygon;
+  BoundaryPolygon other_geodesic_polygon;
+  if (!reference_polygon.Assign(reference_bbox)
+      || !other_polygon.Assign(other_bbox)
+      || !reference_geodesic_polygon.Assign(reference_geodesic)
+      || !other_geodesic_polygon.Assign(other_geodesic)) {
+    return CompareGeometryBoost(reference_bbox, other_bbox, reference_geodesic, other_geodesic);
+  }
+
+  // Every edge of the reference boundaries is loaded once and compared with
+  // both boundaries of the other vehicle.
+  EdgeAccumulator reference_to_other_geodesic;
+  EdgeAccumulator reference_to_other;
+  EdgeAccumulator reference_geodesic_to_other_geodesic;
+  EdgeAccumulator reference_geodesic_to_other;
+  const float *x = reference_polygon.X();
+  const float *y = reference_polygon.Y();
+  for (size_t i = 0u; i < reference_polygon.Size(); ++i) {
+    AccumulateEdges(x[i], y[i], x[i + 1u], y[i + 1u], other_geodesic_polygon, reference_to_other_geodesic);
+    AccumulateEdges(x[i], y[i], x[i + 1u], y[i + 1u], other_polygon, reference_to_other);
+  }
+  x = reference_geodesic_polygon.X();
+  y = reference_geodesic_polygon.Y();
+  for (size_t i = 0u; i < reference_geodesic_polygon.Size(); ++i) {
+    AccumulateEdges(x[i], y[i], x[i + 1u], y[i + 1u], other_geodesic_polygon, reference_geodesic_to_other_geodesic);
+    AccumulateEdges(x[i], y[i], x[i + 1u], y[i + 1u], other_polygon, reference_geodesic_to_other);
+  }
+
+  return {GetDistance(reference_to_other_geodesic, reference_polygon, other_geodesic_polygon),
+          GetDistance(reference_geodesic_to_other, reference_geodesic_polygon, other_polygon),
+          GetDistance(reference_geodesic_to_other_geodesic, reference_geodesic_polygon, other_geodesic_polygon),
+          GetDistance(reference_to_other, reference_polygon, other_polygon)};
+}
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,92 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "carla/geom/Location.h"
+
+namespace carla {
+namespace traffic_manager {
+
+namespace cg = carla::geom;
+
+using LocationVector = std::vector<cg::Location>;
+
+struct GeometryComparison {
+  double reference_vehicle_to_other_geodesic;
+  double other_vehicle_to_reference_geodesic;
+  double inter_geodesic_distance;
+  double inter_bbox_distance;
+};
+
+/// Closed polygon in the x-y plane with inline vertex storage. The
+/// coordinates are kept in separate arrays, followed by the first vertex
+/// again to close the last edge and padded with it up to a multiple of the
+/// SIMD width, so edges can be read four at a time. Padding edges are
+/// degenerate and do not change any distance.
+class BoundaryPolygon {
+public:
+  static constexpr size_t MAX_VERTICES = 64u;
+  static constexpr size_t LANES = 4u;
+
+  /// Returns false, leaving the polygon empty, if the boundary is empty or
+  /// has more than MAX_VERTICES points.
+  bool Assign(const LocationVector &boundary);
+
+  size_t Size() const {
+    return size;
+  }
+
+  /// Number of edges rounded up to a multiple of LANES.
+  size_t PaddedSize() const {
+    return (size + LANES - 1u) / LANES * LANES;
+  }
+
+  const float *X() const {
+    return x;
+  }
+
+  const float *Y() const {
+    return y;
+  }
+
+  /// Whether the point is inside the polygon (even-odd rule).
+  bool Contains(float px, float py) const;
+
+private:
+  static constexpr size_t CAPACITY = MAX_VERTICES + LANES;
+
+  alignas(16) float x[CAPACITY];
+  alignas(16) float y[CAPACITY];
+  size_t size = 0u;
+};
+
+/// Minimum distance between two polygons, zero if they intersect or one
+/// contains the other.
+double PolygonDistance(const BoundaryPolygon &a, const BoundaryPolygon &b);
+
+/// Distances between the bounding boxes and path boundaries of two vehicles,
+/// evaluated with Boost.Geometry.
+GeometryComparison CompareGeometryBoost(const LocationVector &reference_bbox,
+                                        const LocationVector &other_bbox,
+                                        const LocationVector &reference_geodesic,
+                                        const LocationVector &other_geodesic);
+
+/// Same as CompareGeometryBoost, evaluating the four distances in one pass
+/// over the packed boundaries with SSE when available. The results match
+/// those of Boost.Geometry up to float precision. Falls back to
+/// CompareGeometryBoost for boundaries with more than
+/// BoundaryPolygon::MAX_VERTICES points.
+GeometryComparison CompareGeometry(const LocationVector &reference_bbox,
+                                   const LocationVector &other_bbox,
+                                   const LocationVector &reference_geodesic,
+                                   const LocationVector &other_geodesic);
+
+} // namespace traffic_manager
+} // namespace carla
@@ -9,7 +9,6 @@
 namespace carla {
 namespace traffic_manager {
 
-using Point2D = bg::model::point<double, 2, bg::cs::cartesian>;
 using TLS = carla::rpc::TrafficLightState;
 
 using namespace constants::Collision;
@@ -29,27 +28,35 @@ CollisionStage::CollisionStage(
     track_traffic(track_traffic),
     parameters(parameters),
     output_array(output_array),
+    cycle_caches(1u),
     random_devices(random_devices) {}
 
 void CollisionStage::Update(const unsigned long index) {
+  Update(index, 0u);
+}
+
+void CollisionStage::Update(const unsigned long index, const unsigned worker) {
+  CycleCache &cache = cycle_caches.at(worker);
   ActorId obstacle_id = 0u;
   bool collision_hazard = false;
   float available_distance_margin = std::numeric_limits<float>::infinity();
 
   const ActorId ego_actor_id = vehicle_id_list.at(index);
   if (simulation_state.ContainsActor(ego_actor_id)) {
-    const cg::Location ego_location = simulation_state.GetLocation(ego_actor_id);
+    const cg::Location ego_location = simulation_state.GetLocations().at(index);
     const Buffer &ego_buffer = buffer_map.at(ego_actor_id);
     const unsigned long look_ahead_index = GetTargetWaypoint(ego_buffer, JUNCTION_LOOK_AHEAD).second;
-    const float velocity = simulation_state.GetVelocity(ego_actor_id).Length();
+    const float velocity = simulation_state.GetVelocities().at(index).Length();
 
-    ActorIdSet overlapping_actors = track_traffic.GetOverlappingVehicles(ego_actor_id);
-    std::vector<ActorId> collision_candidate_ids;
+    std::vector<ActorId> &overlapping_actors = cache.overlapping_actors;
+    track_traffic.GetOverlappingVehicles(ego_actor_id, overlapping_actors);
+    // Candidates with their squared distance to the ego vehicle.
+    std::vector<std::pair<float, ActorId>> collision_candidates;
     // Run through vehicles with overlapping paths and filter them;
     const float distance_to_leading = parameters.GetDistanceToLeadingVehicle(ego_actor_id);
     float collision_radius_square = SQUARE(COLLISION_RADIUS_RATE * velocity + COLLISION_RADIUS_MIN);
     if (velocity < 2.0f) {
-      const float length = simulation_state.GetDimensions(ego_actor_id).x;
+      const float length = simulation_state.GetAllDimensions().at(index).x;
       const float collision_radius_stop = COLLISION_RADIUS_STOP + length;
       collision_radius_square = SQUARE(collision_radius_stop);
     }
@@ -59,22 +66,25 @@ void CollisionStage::Update(const unsigned long index) {
 
     for (ActorId overlapping_actor_id : overlapping_actors) {
       // If actor is within maximum collision avoidance and vertical overlap range.
-      const cg::Location &overlapping_actor_location = simulation_state.GetLocation(overlapping_actor_id);
-      if (overlapping_actor_id != ego_actor_id
-          && cg::Math::DistanceSquared(overlapping_actor_location, ego_location) < collision_radius_square
+      if (overlapping_actor_id == ego_actor_id) {
+        continue;
+      }
+      const cg::Location overlapping_actor_location = simulation_state.GetLocation(overlapping_actor_id);
+      const float distance_square = cg::Math::DistanceSquared(overlapping_actor_location, ego_location);
+      if (distance_square < collision_radius_square
           && std::abs(ego_location.z - overlapping_actor_location.z) < VERTICAL_OVERLAP_THRESHOLD) {
-        collision_candidate_ids.push_back(overlapping_actor_id);
+        collision_candidates.emplace_back(distance_square, overlapping_actor_id);
       }
     }
 
-    // Sorting collision candidates in accending order of distance to current vehicle.
-    std::sort(collision_candidate_ids.begin(), collision_candidate_ids.end(),
-              [this, &ego_location](const ActorId &a_id_1, const ActorId &a_id_2) {
-                const cg::Location &e_loc = ego_location;
-                const cg::Location &loc_1 = simulation_state.GetLocation(a_id_1);
-                const cg::Location &loc_2 = simulation_state.GetLocation(a_id_2);
-                return (cg::Math::DistanceSquared(e_loc, loc_1) < cg::Math::DistanceSquared(e_loc, loc_2));
-              });
+    // Sorting collision candidates in accending order of distance to current vehicle,
+    // ties by id so the order does not depend on the hash set iteration.
+    std::sort(collision_candidates.begin(), collision_candidates.end());
+    std::vector<ActorId> collision_candidate_ids;
+    collision_candidate_ids.reserve(collision_candidates.size());
+    for (const auto &candidate : collision_candidates) {
+      collision_candidate_ids.push_back(candidate.second);
+    }
 
     // Check every actor in the vicinity if it poses a collision hazard.
     for (auto iter = collision_candidate_ids.begin();
@@ -88,7 +98,9 @@ void CollisionStage::Update(const unsigned long index) {
           && simulation_state.ContainsActor(other_actor_id)) {
         std::pair<bool, float> negotiation_result = NegotiateCollision(ego_actor_id,
                                                                        other_actor_id,
-                                                                       look_ahead_index);
+                                                                       look_ahead_index,
+                                                                       index,
+                                                                       cache);
         if (negotiation_result.first) {
           if ((other_actor_type == ActorType::Vehicle
                && parameters.GetPercentageIgnoreVehicles(ego_actor_id) <= random_devices.at(ego_actor_id).next())
@@ -115,9 +127,41 @@ void CollisionStage::RemoveActor(const ActorId actor_id) {
 
 void CollisionStage::Reset() {
   collision_locks.clear();
+  geometry_history.clear();
+}
+
+const CollisionLock *CollisionStage::FindCommittedLock(const ActorId actor_id) const {
+  auto lock = collision_locks.find(actor_id);
+  return lock != collision_locks.end() ? &lock->second : nullptr;
+}
+
+const CollisionLock *CollisionStage::FindLock(const ActorId actor_id, const unsigned long index) const {
+  if (parallel_update && vehicle_id_list.at(index) == actor_id && lock_updates.at(index).touched) {
+    const LockUpdate &update = lock_updates.at(index);
+    return update.present ? &update.lock : nullptr;
+  }
+  return FindCommittedLock(actor_id);
+}
+
+void CollisionStage::SetLock(const ActorId actor_id, const unsigned long index, const CollisionLock &lock) {
+  if (parallel_update) {
+    lock_updates.at(index) = {true, true, lock};
+  } else {
+    collision_locks[actor_id] = lock;
+  }
 }
 
-float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id) {
+void CollisionStage::ClearLock(const ActorId actor_id, const unsigned long index) {
+  if (parallel_update) {
+    LockUpdate &update = lock_updates.at(index);
+    update.touched = true;
+    update.present = false;
+  } else {
+    collision_locks.erase(actor_id);
+  }
+}
+
+float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id, const CollisionLock *current_lock) {
 
   const float velocity = cg::Math::Dot(simulation_state.GetVelocity(actor_id), simulation_state.GetHeading(actor_id));
   float bbox_extension;
@@ -125,8 +169,8 @@ float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id) {
   float velocity_extension = VEL_EXT_FACTOR * velocity;
   bbox_extension = BOUNDARY_EXTENSION_MINIMUM + velocity_extension * velocity_extension;
   // If a valid collision lock present, change boundary length to maintain lock.
-  if (collision_locks.find(actor_id) != collision_locks.end()) {
-    const CollisionLock &lock = collision_locks.at(actor_id);
+  if (current_lock != nullptr) {
+    const CollisionLock &lock = *current_lock;
     float lock_boundary_length = static_cast<float>(lock.distance_to_lead_vehicle + LOCKING_DISTANCE_PADDING);
     // Only extend boundary track vehicle if the leading vehicle
     // if it is not further than velocity dependent extension by MAX_LOCKING_EXTENSION.
@@ -138,6 +182,43 @@ float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id) {
   return bbox_extension;
 }
 
+const CollisionStage::GeometryInputs &CollisionStage::GetGeometryInputs(const ActorId actor_id, CycleCache &cache) {
+  auto cached_inputs = cache.geometry_inputs.find(actor_id);
+  if (cached_inputs != cache.geometry_inputs.end()) {
+    return cached_inputs->second;
+  }
+
+  GeometryInputs inputs;
+  inputs.location = simulation_state.GetLocation(actor_id);
+  inputs.heading = simulation_state.GetHeading(actor_id);
+  auto buffer = buffer_map.find(actor_id);
+  if (buffer != buffer_map.end()) {
+    // Cached boundaries only depend on the locks of the previous cycle in a parallel update,
+    // so they are the same whichever worker computes them.
+    const float bbox_extension = GetBoundingBoxExtention(actor_id, FindCommittedLock(actor_id));
+    inputs.extension = std::max(parameters.GetDistanceToLeadingVehicle(actor_id), bbox_extension);
+    const Buffer &waypoint_buffer = buffer->second;
+    if (!waypoint_buffer.empty()) {
+      inputs.buffer_front = waypoint_buffer.front()->GetIndex();
+      inputs.buffer_back = waypoint_buffer.back()->GetIndex();
+      inputs.buffer_size = waypoint_buffer.size();
+    }
+  } else if (simulation_state.GetType(actor_id) == ActorType::Pedestrian) {
+    inputs.extension = simulation_state.GetVelocity(actor_id).Length() * WALKER_TIME_EXTENSION;
+  }
+
+  return cache.geometry_inputs.insert({actor_id, inputs}).first->second;
+}
+
+bool CollisionStage::IsWithinTolerance(const GeometryInputs &cached, const GeometryInputs &current) {
+  return cached.buffer_front == current.buffer_front
+      && cached.buffer_back == current.buffer_back
+      && cached.buffer_size == current.buffer_size
+      && cg::Math::DistanceSquared(cached.location, current.location) < SQUARE(GEOMETRY_CACHE_LOCATION_TOLERANCE)
+      && cg::Math::Dot(cached.heading, current.heading) > GEOMETRY_CACHE_HEADING_TOLERANCE
+      && std::abs(cached.extension - current.extension) < GEOMETRY_CACHE_EXTENSION_TOLERANCE;
+}
+
 LocationVector CollisionStage::GetBoundary(const ActorId actor_id) {
   const ActorType actor_type = simulation_state.GetType(actor_id);
   const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
@@ -169,8 +250,9 @@ LocationVector CollisionStage::GetBoundary(const ActorId actor_id) {
   return bbox_boundary;
 }
 
-LocationVector CollisionStage::GetGeodesicBoundary(const ActorId actor_id) {
+LocationVector CollisionStage::GetGeodesicBoundary(const ActorId actor_id, CycleCache &cache) {
   LocationVector geodesic_boundary;
+  GeodesicBoundaryMap &geodesic_boundary_map = cache.geodesic_boundary_map;
 
   if (geodesic_boundary_map.find(actor_id) != geodesic_boundary_map.end()) {
     geodesic_boundary = geodesic_boundary_map.at(actor_id);
@@ -178,10 +260,7 @@ LocationVector CollisionStage::GetGeodesicBoundary(const ActorId actor_id) {
     const LocationVector bbox = GetBoundary(actor_id);
 
     if (buffer_map.find(actor_id) != buffer_map.end()) {
-      float bbox_extension = GetBoundingBoxExtention(actor_id);
-      const float specific_lead_distance = parameters.GetDistanceToLeadingVehicle(actor_id);
-      bbox_extension = std::max(specific_lead_distance, bbox_extension);
-      const float bbox_extension_square = SQUARE(bbox_extension);
+      const float bbox_extension_square = SQUARE(GetGeometryInputs(actor_id, cache).extension);
 
       LocationVector left_boundary;
       LocationVector right_boundary;
@@ -242,20 +321,10 @@ LocationVector CollisionStage::GetGeodesicBoundary(const ActorId actor_id) {
   return geodesic_boundary;
 }
 
-Polygon CollisionStage::GetPolygon(const LocationVector &boundary) {
-
-  traffic_manager::Polygon boundary_polygon;
-  for (const cg::Location &location : boundary) {
-    bg::append(boundary_polygon.outer(), Point2D(location.x, location.y));
-  }
-  bg::append(boundary_polygon.outer(), Point2D(boundary.front().x, boundary.front().y));
-
-  return boundary_polygon;
-}
-
 GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId reference_vehicle_id,
-                                                            const ActorId other_actor_id) {
-
+                                                            const ActorId other_actor_id,
+                                                            CycleCache &cache) {
+  GeometryComparisonMap &geometry_cache = cache.geometry_cache;
 
   std::pair<ActorId, ActorId> key_parts;
   if (reference_vehicle_id < other_actor_id) {
@@ -269,34 +338,48 @@ GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId refere
   actor_id_key <<= 32;
   actor_id_key |= key_parts.second;
 
-  GeometryComparison comparision_result{-1.0, -1.0, -1.0, -1.0};
-
-  if (geometry_cache.find(actor_id_key) != geometry_cache.end()) {
-
-    comparision_result = geometry_cache.at(actor_id_key);
-    double mref_veh_other = comparision_result.reference_vehicle_to_other_geodesic;
-    comparision_result.reference_vehicle_to_other_geodesic = comparision_result.other_vehicle_to_reference_geodesic;
-    comparision_result.other_vehicle_to_reference_geodesic = mref_veh_other;
-  } else {
-
-    const Polygon reference_polygon = GetPolygon(GetBoundary(reference_vehicle_id));
-    const Polygon other_polygon = GetPolygon(GetBoundary(other_actor_id));
+  auto cached = geometry_cache.find(actor_id_key);
+  if (cached == geometry_cache.end()) {
+    CachedGeometry entry;
+    entry.first_inputs = GetGeometryInputs(key_parts.first, cache);
+    entry.second_inputs = GetGeometryInputs(key_parts.second, cache);
+    entry.fast_geometry = parameters.GetFastCollisionGeometry();
+
+    // Reuse the comparison of an earlier cycle if neither actor moved since.
+    auto history = geometry_history.find(actor_id_key);
+    if (history != geometry_history.end()
+        && history->second.fast_geometry == entry.fast_geometry
+        && IsWithinTolerance(history->second.first_inputs, entry.first_inputs)
+        && IsWithinTolerance(history->second.second_inputs, entry.second_inputs)) {
+
+      entry = history->second;
+      ++cache.statistics.hits;
+    } else {
 
-    const Polygon reference_geodesic_polygon = GetPolygon(GetGeodesicBoundary(reference_vehicle_id));
+      const LocationVector first_bbox = GetBoundary(key_parts.first);
+      const LocationVector second_bbox = GetBoundary(key_parts.second);
+      const LocationVector first_geodesic = GetGeodesicBoundary(key_parts.first, cache);
+      const LocationVector second_geodesic = GetGeodesicBoundary(key_parts.second, cache);
 
-    const Polygon other_geodesic_polygon = GetPolygon(GetGeodesicBoundary(other_actor_id));
+      if (entry.fast_geometry) {
+        entry.comparison = CompareGeometry(first_bbox, second_bbox, first_geodesic, second_geodesic);
+      } else {
+        entry.comparison = CompareGeometryBoost(first_bbox, second_bbox, first_geodesic, second_geodesic);
+      }
 
-    const double reference_vehicle_to_other_geodesic = bg::distance(reference_polygon, other_geodesic_polygon);
-    const double other_vehicle_to_reference_geodesic = bg::distance(other_polygon, reference_geodesic_polygon);
-    const auto inter_geodesic_distance = bg::distance(reference_geodesic_polygon, other_geodesic_polygon);
-    const auto inter_bbox_distance = bg::distance(reference_polygon, other_polygon);
+      ++cache.statistics.misses;
+      if (history != geometry_history.end()) {
+        ++cache.statistics.invalidations;
+      }
+    }
 
-    comparision_result = {reference_vehicle_to_other_geodesic,
-              other_vehicle_to_reference_geodesic,
-              inter_geodesic_distance,
-              inter_bbox_distance};
+    cached = geometry_cache.insert({actor_id_key, entry}).first;
+  }
 
-    geometry_cache.insert({actor_id_key, comparision_result});
+  GeometryComparison comparision_result = cached->second.comparison;
+  if (reference_vehicle_id != key_parts.first) {
+    std::swap(comparision_result.reference_vehicle_to_other_geodesic,
+              comparision_result.other_vehicle_to_reference_geodesic);
   }
 
   return comparision_result;
@@ -304,7 +387,9 @@ GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId refere
 
 std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId reference_vehicle_id,
                                                           const ActorId other_actor_id,
-                                                          const uint64_t reference_junction_look_ahead_index) {
+                                                          const uint64_t reference_junction_look_ahead_index,
+                                                          const unsigned long index,
+                                                          CycleCache &cache) {
   // Output variables for the method.
   bool hazard = false;
   float available_distance_margin = std::numeric_limits<float>::infinity();
@@ -328,8 +413,8 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
   float other_vehicle_length = simulation_state.GetDimensions(other_actor_id).x * SQUARE_ROOT_OF_TWO;
 
   float inter_vehicle_distance = cg::Math::DistanceSquared(reference_location, other_location);
-  float ego_bounding_box_extension = GetBoundingBoxExtention(reference_vehicle_id);
-  float other_bounding_box_extension = GetBoundingBoxExtention(other_actor_id);
+  float ego_bounding_box_extension = GetBoundingBoxExtention(reference_vehicle_id, FindLock(reference_vehicle_id, index));
+  float other_bounding_box_extension = GetBoundingBoxExtention(other_actor_id, FindLock(other_actor_id, index));
   // Calculate minimum distance between vehicle to consider collision negotiation.
   float inter_vehicle_length = reference_vehicle_length + other_vehicle_length;
   float ego_detection_range = SQUARE(ego_bounding_box_extension + inter_vehicle_length);
@@ -353,7 +438,7 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
   if (!(ego_at_junction_entrance && ego_at_traffic_light && ego_stopped_by_light)
       && ((ego_inside_junction && other_vehicles_in_cross_detection_range)
           || (!ego_inside_junction && other_vehicle_in_front && other_vehicle_in_ego_range))) {
-    GeometryComparison geometry_comparison = GetGeometryBetweenActors(reference_vehicle_id, other_actor_id);
+    GeometryComparison geometry_comparison = GetGeometryBetweenActors(reference_vehicle_id, other_actor_id, cache);
 
     // Conditions for collision negotiation.
     bool geodesic_path_bbox_touching = geometry_comparison.inter_geodesic_distance < OVERLAP_THRESHOLD;
@@ -385,8 +470,9 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
       // This enables us to smoothly approach the lead vehicle.
 
       // When possible collision found, check if an entry for collision lock present.
-      if (collision_locks.find(reference_vehicle_id) != collision_locks.end()) {
-        CollisionLock &lock = collision_locks.at(reference_vehicle_id);
+      const CollisionLock *current_lock = FindLock(reference_vehicle_id, index);
+      if (current_lock != nullptr) {
+        CollisionLock lock = *current_lock;
         // Check if the same vehicle is under lock.
         if (other_actor_id == lock.lead_vehicle_id) {
           // If the body of the lead vehicle is touching the reference vehicle bounding box.
@@ -401,27 +487,83 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
           // If possible collision with a new vehicle, re-initialize with new lock entry.
           lock = {geometry_comparison.inter_bbox_distance, geometry_comparison.inter_bbox_distance, other_actor_id};
         }
+        SetLock(reference_vehicle_id, index, lock);
       } else {
         // Insert and initialize lock entry if not present.
-        collision_locks.insert({reference_vehicle_id,
-                                {geometry_comparison.inter_bbox_distance,
-                                 geometry_comparison.inter_bbox_distance,
-                                 other_actor_id}});
+        SetLock(reference_vehicle_id, index,
+                {geometry_comparison.inter_bbox_distance,
+                 geometry_comparison.inter_bbox_distance,
+                 other_actor_id});
       }
     }
   }
 
   // If no collision hazard detected, then flush collision lock held by the vehicle.
-  if (!hazard && collision_locks.find(reference_vehicle_id) != collision_locks.end()) {
-    collision_locks.erase(reference_vehicle_id);
+  if (!hazard && FindLock(reference_vehicle_id, index) != nullptr) {
+    ClearLock(reference_vehicle_id, index);
   }
 
   return {hazard, available_distance_margin};
 }
 
+void CollisionStage::PrepareParallelUpdate(const unsigned workers) {
+  cycle_caches.resize(std::max(workers, 1u));
+  parallel_update = workers > 1u;
+  if (parallel_update) {
+    lock_updates.assign(vehicle_id_list.size(), LockUpdate());
+  }
+}
+
 void CollisionStage::ClearCycleCache() {
-  geodesic_boundary_map.clear();
-  geometry_cache.clear();
+  if (parallel_update) {
+    for (unsigned long index = 0u; index < lock_updates.size(); ++index) {
+      const LockUpdate &update = lock_updates.at(index);
+      if (update.touched) {
+        const ActorId actor_id = vehicle_id_list.at(index);
+        if (update.present) {
+          collision_locks[actor_id] = update.lock;
+        } else {
+          collision_locks.erase(actor_id);
+        }
+      }
+    }
+    lock_updates.clear();
+    parallel_update = false;
+  }
+
+  // Keep the comparisons of this cycle, the first worker's copy of a pair wins so the
+  // history does not depend on the order the workers finished in.
+  ++geometry_cycle;
+  geometry_statistics = GeometryCacheStatistics();
+  for (CycleCache &cache : cycle_caches) {
+    for (auto &cached : cache.geometry_cache) {
+      cached.second.last_used_cycle = geometry_cycle;
+      auto history = geometry_history.insert(cached);
+      if (!history.second && history.first->second.last_used_cycle != geometry_cycle) {
+        history.first->second = cached.second;
+      }
+    }
+    geometry_statistics.hits += cache.statistics.hits;
+    geometry_statistics.misses += cache.statistics.misses;
+    geometry_statistics.invalidations += cache.statistics.invalidations;
+
+    cache.geodesic_boundary_map.clear();
+    cache.geometry_cache.clear();
+    cache.geometry_inputs.clear();
+    cache.statistics = GeometryCacheStatistics();
+  }
+
+  // Drop the pairs that were not compared lately, or all but this cycle's ones if there are too many.
+  const uint64_t max_age = geometry_history.size() > GEOMETRY_CACHE_MAX_ENTRIES ? 0u : GEOMETRY_CACHE_MAX_AGE;
+  for (auto iter = geometry_history.begin(); iter != geometry_history.end();) {
+    if (geometry_cycle - iter->second.last_used_cycle > max_age) {
+      iter = geometry_history.erase(iter);
+      ++geometry_statistics.evictions;
+    } else {
+      ++iter;
+    }
+  }
+  geometry_statistics.entries = geometry_history.size();
 }
 
 } // namespace traffic_manager
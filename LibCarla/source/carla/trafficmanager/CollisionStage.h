@@ -2,28 +2,19 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
-#include "boost/geometry.hpp"
-#include "boost/geometry/geometries/geometries.hpp"
-#include "boost/geometry/geometries/point_xy.hpp"
-#include "boost/geometry/geometries/polygon.hpp"
-
+#include "carla/trafficmanager/CollisionGeometry.h"
 #include "carla/trafficmanager/DataStructures.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
 #include "carla/trafficmanager/SimulationState.h"
 #include "carla/trafficmanager/Stage.h"
+#include "carla/trafficmanager/TrackTraffic.h"
 
 namespace carla {
 namespace traffic_manager {
 
-struct GeometryComparison {
-  double reference_vehicle_to_other_geodesic;
-  double other_vehicle_to_reference_geodesic;
-  double inter_geodesic_distance;
-  double inter_bbox_distance;
-};
-
 struct CollisionLock {
   double distance_to_lead_vehicle;
   double initial_lock_distance;
@@ -32,14 +23,23 @@ struct CollisionLock {
 using CollisionLockMap = std::unordered_map<ActorId, CollisionLock>;
 
 namespace cc = carla::client;
-namespace bg = boost::geometry;
 
-using Buffer = std::deque<std::shared_ptr<SimpleWaypoint>>;
 using BufferMap = std::unordered_map<carla::ActorId, Buffer>;
-using LocationVector = std::vector<cg::Location>;
 using GeodesicBoundaryMap = std::unordered_map<ActorId, LocationVector>;
-using GeometryComparisonMap = std::unordered_map<uint64_t, GeometryComparison>;
-using Polygon = bg::model::polygon<bg::model::d2::point_xy<double>>;
+
+/// Geometry cache counters of the last update cycle.
+struct GeometryCacheStatistics {
+  /// Comparisons reused from an earlier cycle.
+  uint64_t hits = 0u;
+  /// Comparisons computed, including the invalidated ones.
+  uint64_t misses = 0u;
+  /// Comparisons recomputed because either actor moved beyond the tolerances.
+  uint64_t invalidations = 0u;
+  /// Entries dropped for not being used in the last cycles.
+  uint64_t evictions = 0u;
+  /// Entries kept for the next cycle.
+  uint64_t entries = 0u;
+};
 
 /// This class has functionality to detect potential collision with a nearby actor.
 class CollisionStage : Stage {
@@ -52,33 +52,89 @@ private:
   CollisionFrame &output_array;
   // Structure keeping track of blocking lead vehicles.
   CollisionLockMap collision_locks;
+  // Inputs of the boundaries of an actor. A comparison computed in an earlier cycle
+  // is reused while the inputs of both actors stay within the geometry cache tolerances.
+  struct GeometryInputs {
+    cg::Location location;
+    cg::Vector3D heading;
+    // Geodesic boundary length of vehicles with a buffer, bounding box extension of pedestrians.
+    float extension = 0.0f;
+    WaypointIndex buffer_front = 0u;
+    WaypointIndex buffer_back = 0u;
+    size_t buffer_size = 0u;
+  };
+  struct CachedGeometry {
+    // Oriented with the actor of lower id as reference.
+    GeometryComparison comparison;
+    GeometryInputs first_inputs;
+    GeometryInputs second_inputs;
+    bool fast_geometry = false;
+    uint64_t last_used_cycle = 0u;
+  };
+  using GeometryComparisonMap = std::unordered_map<uint64_t, CachedGeometry>;
   // Structures to cache geodesic boundaries of vehicle and
   // comparision between vehicle boundaries
   // to avoid repeated computation within a cycle.
-  GeometryComparisonMap geometry_cache;
-  GeodesicBoundaryMap geodesic_boundary_map;
+  struct CycleCache {
+    GeometryComparisonMap geometry_cache;
+    GeodesicBoundaryMap geodesic_boundary_map;
+    std::unordered_map<ActorId, GeometryInputs> geometry_inputs;
+    GeometryCacheStatistics statistics;
+    // Broad phase query results, reused across the vehicles of the worker.
+    std::vector<ActorId> overlapping_actors;
+  };
+  // One cache per worker thread, the first one is used by the sequential update.
+  std::vector<CycleCache> cycle_caches;
+  // Collision lock changes of a vehicle during a parallel update, applied by ClearCycleCache.
+  // Until then every vehicle sees the locks of the previous cycle.
+  struct LockUpdate {
+    bool touched = false;
+    bool present = false;
+    CollisionLock lock;
+  };
+  std::vector<LockUpdate> lock_updates;
+  bool parallel_update = false;
+  // Comparisons of the last cycles by actor pair, merged from the cycle caches by ClearCycleCache.
+  // Read only during an update, so whether a comparison is reused does not depend on the worker.
+  GeometryComparisonMap geometry_history;
+  uint64_t geometry_cycle = 0u;
+  GeometryCacheStatistics geometry_statistics;
   RandomGeneratorMap &random_devices;
 
+  // Collision lock held by a vehicle, nullptr if none. During a parallel update FindCommittedLock
+  // returns the lock of the previous cycle and FindLock also sees the changes made by the vehicle at index.
+  const CollisionLock *FindCommittedLock(const ActorId actor_id) const;
+  const CollisionLock *FindLock(const ActorId actor_id, const unsigned long index) const;
+  void SetLock(const ActorId actor_id, const unsigned long index, const CollisionLock &lock);
+  void ClearLock(const ActorId actor_id, const unsigned long index);
+
   // Method to determine if a vehicle is on a collision path to another.
   std::pair<bool, float> NegotiateCollision(const ActorId reference_vehicle_id,
                                             const ActorId other_actor_id,
-                                            const uint64_t reference_junction_look_ahead_index);
+                                            const uint64_t reference_junction_look_ahead_index,
+                                            const unsigned long index,
+                                            CycleCache &cache);
 
   // Method to calculate bounding box extention length ahead of the vehicle.
-  float GetBoundingBoxExtention(const ActorId actor_id);
+  float GetBoundingBoxExtention(const ActorId actor_id, const CollisionLock *lock);
+
+  // Method to collect the inputs of the boundaries of an actor, once per cycle.
+  const GeometryInputs &GetGeometryInputs(const ActorId actor_id, CycleCache &cache);
+
+  // Method to check whether a boundary computed with the cached inputs can be reused.
+  static bool IsWithinTolerance(const GeometryInputs &cached, const GeometryInputs &current);
 
   // Method to calculate polygon points around the vehicle's bounding box.
   LocationVector GetBoundary(const ActorId actor_id);
 
   // Method to construct polygon points around the path boundary of the vehicle.
-  LocationVector GetGeodesicBoundary(const ActorId actor_id);
-
-  Polygon GetPolygon(const LocationVector &boundary);
+  LocationVector GetGeodesicBoundary(const ActorId actor_id, CycleCache &cache);
 
   // Method to compare path boundaries, bounding boxes of vehicles
-  // and cache the results for reuse in current update cycle.
+  // and cache the results for reuse in current and later update cycles.
   GeometryComparison GetGeometryBetweenActors(const ActorId reference_vehicle_id,
-                                              const ActorId other_actor_id);
+                                              const ActorId other_actor_id,
+                                              CycleCache &cache);
 
   // Method to draw path boundary.
   void DrawBoundary(const LocationVector &boundary);
@@ -94,12 +150,22 @@ public:
 
   void Update (const unsigned long index) override;
 
+  // Update run by the given worker thread, see PrepareParallelUpdate.
+  void Update(const unsigned long index, const unsigned worker);
+
   void RemoveActor(const ActorId actor_id) override;
 
   void Reset() override;
 
-  // Method to flush cache for current update cycle.
+  // Method to prepare the caches for an update cycle run by the given number of worker threads.
+  void PrepareParallelUpdate(const unsigned workers);
+
+  // Method to flush cache for current update cycle, keeping its comparisons for the next ones.
   void ClearCycleCache();
+
+  const GeometryCacheStatistics &GetGeometryCacheStatistics() const {
+    return geometry_statistics;
+  }
 };
 
 } // namespace traffic_manager
@@ -48,6 +48,7 @@ static const float MAX_START_DISTANCE = 20.0f;
 static const float MINIMUM_HORIZON_LENGTH = 15.0f;
 static const float HORIZON_RATE = 2.0f;
 static const float HIGH_SPEED_HORIZON_RATE = 4.0f;
+static const uint64_t BUFFER_CAPACITY = 64u;
 } // namespace PathBufferUpdate
 
 namespace WaypointSelection {
@@ -87,6 +88,11 @@ static const float EPSILON = 2.0f * std::numeric_limits<float>::epsilon();
 static const float MIN_REFERENCE_DISTANCE = 0.5f;
 static const float MIN_VELOCITY_COLL_RADIUS = 2.0f;
 static const float VEL_EXT_FACTOR = 0.36f;
+static const float GEOMETRY_CACHE_LOCATION_TOLERANCE = 0.01f;
+static const float GEOMETRY_CACHE_HEADING_TOLERANCE = 0.999999f;  // Cosine, about 0.08º
+static const float GEOMETRY_CACHE_EXTENSION_TOLERANCE = 0.01f;
+static const uint64_t GEOMETRY_CACHE_MAX_AGE = 20u;
+static const size_t GEOMETRY_CACHE_MAX_ENTRIES = 1u << 16u;
 } // namespace Collision
 
 namespace FrameMemory {
@@ -159,6 +165,8 @@ static const std::vector<float> LATERAL_HIGHWAY_PARAM = {2.0f, 0.02f, 0.04f};
 namespace TrackTraffic {
 static const uint64_t BUFFER_STEP_THROUGH = 5;
 static const float INV_BUFFER_STEP_THROUGH = 1.0f / static_cast<float>(BUFFER_STEP_THROUGH);
+static const float BROAD_PHASE_CELL_SIZE = 20.0f;
+static const float BROAD_PHASE_MARGIN = 2.0f;
 } // namespace TrackTraffic
 
 } // namespace constants
@@ -4,21 +4,78 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "carla/Exception.h"
 #include "carla/Logging.h"
+#include "carla/ThreadGroup.h"
 
 #include "carla/trafficmanager/Constants.h"
 #include "carla/trafficmanager/InMemoryMap.h"
-#include <boost/geometry/geometries/box.hpp>
+#include "carla/trafficmanager/InMemoryMapCache.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 namespace carla {
 namespace traffic_manager {
 
   namespace cg = carla::geom;
+  namespace bip = boost::interprocess;
   using namespace constants::Map;
 
   using TopologyList = std::vector<std::pair<WaypointPtr, WaypointPtr>>;
   using RawNodeList = std::vector<WaypointPtr>;
 
+namespace {
+
+  /// Calls function(i) for every i in [0, count) on up to @a max_threads
+  /// threads (zero for all cores), handing out one index at a time so uneven
+  /// items balance out. Items must only write to their own outputs, the
+  /// result is then the same as the serial loop's whatever the number of
+  /// threads. The first exception thrown is rethrown here once every thread
+  /// is done.
+  template <typename Function>
+  void ParallelFor(const size_t count, const size_t max_threads, Function &&function) {
+    const size_t threads = max_threads > 0u ? max_threads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t thread_count = std::min<size_t>(count, threads);
+    std::atomic<size_t> next_item{0u};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto work = [&]() {
+      for (size_t i = next_item++; i < count; i = next_item++) {
+        try {
+          function(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+          next_item = count;
+        }
+      }
+    };
+    {
+      // The calling thread takes a share too, the group joins the rest.
+      ThreadGroup workers;
+      workers.CreateThreads(thread_count > 0u ? thread_count - 1u : 0u, work);
+      work();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+} // namespace
+
   InMemoryMap::InMemoryMap(WorldMap world_map) : _world_map(world_map) {}
   InMemoryMap::~InMemoryMap() {}
 
@@ -27,7 +84,7 @@ namespace traffic_manager {
   }
 
   SegmentId InMemoryMap::GetSegmentId(const SimpleWaypointPtr &swp) const {
-    return GetSegmentId(swp->GetWaypoint());
+    return std::make_tuple(swp->GetRoadId(), swp->GetLaneId(), swp->GetSectionId());
   }
 
   NodeList InMemoryMap::GetSuccessors(const SegmentId segment_id,
@@ -68,9 +125,9 @@ namespace traffic_manager {
     return result;
   }
 
-  void InMemoryMap::Cook(WorldMap world_map, const std::string& path) {
+  void InMemoryMap::Cook(WorldMap world_map, const std::string& path, const size_t number_of_workers) {
     InMemoryMap local_map(world_map);
-    local_map.SetUp();
+    local_map.SetUp(number_of_workers);
     local_map.Save(path);
   }
 
@@ -89,45 +146,214 @@ namespace traffic_manager {
       return;
     }
 
-    // write total records
-    uint32_t total = static_cast<uint32_t>(dense_topology.size());
-    out_file.write(reinterpret_cast<const char *>(&total), sizeof(uint32_t));
-
-    // write simple waypoints
+    // Build the waypoint records and the links, in arena order.
+    std::vector<map_cache::WaypointRecord> records;
+    std::vector<WaypointIndex> links;
+    records.reserve(waypoint_arena.size());
     std::unordered_set<uint64_t> used_ids;
-    for (auto& wp: dense_topology) {
-      if (used_ids.find(wp->GetId()) != used_ids.end()) {
+    for (auto &wp : waypoint_arena) {
+      if (used_ids.find(wp.GetId()) != used_ids.end()) {
         log_error("Could not generate the binary file. There are repeated waypoints");
       }
-      CachedSimpleWaypoint cached_wp(wp);
-      cached_wp.Write(out_file);
-
-      used_ids.insert(wp->GetId());
+      used_ids.insert(wp.GetId());
+
+      map_cache::WaypointRecord record = {};
+      record.info = wp.GetInfo();
+      record.geodesic_grid_id = wp.GetGeodesicGridId();
+      record.next_first = static_cast<uint32_t>(links.size());
+      for (auto next : wp.GetNextWaypoint()) {
+        links.push_back(next->GetIndex());
+      }
+      record.previous_first = static_cast<uint32_t>(links.size());
+      for (auto previous : wp.GetPreviousWaypoint()) {
+        links.push_back(previous->GetIndex());
+      }
+      record.next_count = static_cast<uint16_t>(wp.GetNextWaypoint().size());
+      record.previous_count = static_cast<uint16_t>(wp.GetPreviousWaypoint().size());
+      record.left = wp.GetLeftWaypoint() != nullptr ? wp.GetLeftWaypoint()->GetIndex() : map_cache::NO_WAYPOINT;
+      record.right = wp.GetRightWaypoint() != nullptr ? wp.GetRightWaypoint()->GetIndex() : map_cache::NO_WAYPOINT;
+      record.is_junction = wp.CheckJunction() ? 1u : 0u;
+      record.road_option = static_cast<uint8_t>(wp.GetRoadOption());
+      records.push_back(record);
     }
 
+    map_cache::Header header = {};
+    std::memcpy(header.magic, map_cache::MAGIC, sizeof(header.magic));
+    header.version = map_cache::VERSION;
+    header.header_size = sizeof(map_cache::Header);
+    header.opendrive_hash = map_cache::HashOpenDrive(_world_map->GetOpenDrive());
+    header.waypoint_count = static_cast<uint32_t>(records.size());
+    header.link_count = static_cast<uint32_t>(links.size());
+    header.spatial_entry_count = static_cast<uint32_t>(spatial_index.GetEntryCount());
+    header.spatial_node_count = static_cast<uint32_t>(spatial_index.GetNodeCount());
+    header.spatial_leaf_count = static_cast<uint32_t>(spatial_index.GetLeafCount());
+    header.waypoints_offset = map_cache::AlignOffset(sizeof(map_cache::Header));
+    header.links_offset = map_cache::AlignOffset(
+        header.waypoints_offset + records.size() * sizeof(map_cache::WaypointRecord));
+    header.spatial_entries_offset = map_cache::AlignOffset(
+        header.links_offset + links.size() * sizeof(WaypointIndex));
+    header.spatial_nodes_offset = map_cache::AlignOffset(
+        header.spatial_entries_offset + spatial_index.GetEntryCount() * sizeof(SpatialIndexEntry));
+    header.file_size = header.spatial_nodes_offset + spatial_index.GetNodeCount() * sizeof(SpatialIndexNode);
+
+    uint64_t written = 0u;
+    auto write = [&](uint64_t offset, const void *data, size_t size) {
+      static const char padding[8u] = {0};
+      out_file.write(padding, static_cast<std::streamsize>(offset - written));
+      out_file.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+      written = offset + size;
+    };
+    write(0u, &header, sizeof(header));
+    write(header.waypoints_offset, records.data(), records.size() * sizeof(map_cache::WaypointRecord));
+    write(header.links_offset, links.data(), links.size() * sizeof(WaypointIndex));
+    write(header.spatial_entries_offset, spatial_index.GetEntries(),
+        spatial_index.GetEntryCount() * sizeof(SpatialIndexEntry));
+    write(header.spatial_nodes_offset, spatial_index.GetNodes(),
+        spatial_index.GetNodeCount() * sizeof(SpatialIndexNode));
+
     out_file.close();
     return;
   }
 
+  bool InMemoryMap::Load(const std::string& filename) {
+    std::shared_ptr<bip::mapped_region> region;
+    try {
+      bip::file_mapping file(filename.c_str(), bip::read_only);
+      region = std::make_shared<bip::mapped_region>(file, bip::read_only);
+    } catch (const bip::interprocess_exception &e) {
+      log_warning("Could not map the InMemoryMap cache", filename, ":", e.what());
+      return false;
+    }
+    region->advise(bip::mapped_region::advice_willneed);
+    cache_storage = region;
+    return LoadCache(static_cast<const uint8_t *>(region->get_address()), region->get_size());
+  }
+
   bool InMemoryMap::Load(const std::vector<uint8_t>& content) {
+    // The spatial index is used in place, so it needs a copy that lives as
+    // long as the map.
+    auto copy = std::make_shared<std::vector<uint8_t>>(content);
+    cache_storage = copy;
+    return LoadCache(copy->data(), copy->size());
+  }
+
+  bool InMemoryMap::LoadCache(const uint8_t *data, const size_t size) {
+    if (size < sizeof(map_cache::Header) || std::memcmp(data, map_cache::MAGIC, sizeof(map_cache::MAGIC)) != 0) {
+      log_warning("InMemoryMap cache uses the legacy format, cook it again to load it faster");
+      return LoadLegacyCache(data, size);
+    }
+
+    map_cache::Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != map_cache::VERSION ||
+        header.header_size != sizeof(map_cache::Header) ||
+        header.file_size != size) {
+      log_warning("InMemoryMap cache has an unsupported version or is truncated, ignoring it");
+      return false;
+    }
+    if (header.opendrive_hash != map_cache::HashOpenDrive(_world_map->GetOpenDrive())) {
+      log_warning("InMemoryMap cache was cooked from another OpenDRIVE, ignoring it");
+      return false;
+    }
+
+    auto fits = [size](uint64_t offset, uint64_t count, uint64_t element_size) {
+      return offset % 8u == 0u && offset <= size && count <= (size - offset) / element_size;
+    };
+    if (!fits(header.waypoints_offset, header.waypoint_count, sizeof(map_cache::WaypointRecord)) ||
+        !fits(header.links_offset, header.link_count, sizeof(WaypointIndex)) ||
+        !fits(header.spatial_entries_offset, header.spatial_entry_count, sizeof(SpatialIndexEntry)) ||
+        !fits(header.spatial_nodes_offset, header.spatial_node_count, sizeof(SpatialIndexNode))) {
+      log_warning("InMemoryMap cache is corrupted, ignoring it");
+      return false;
+    }
+
+    const auto *records = reinterpret_cast<const map_cache::WaypointRecord *>(data + header.waypoints_offset);
+    const auto *links = reinterpret_cast<const WaypointIndex *>(data + header.links_offset);
+    const uint32_t total = header.waypoint_count;
+
+    // Validate every reference before building anything.
+    bool valid = true;
+    for (uint32_t i = 0u; i < total && valid; ++i) {
+      const map_cache::WaypointRecord &record = records[i];
+      valid = static_cast<uint64_t>(record.next_first) + record.next_count <= header.link_count
+          && static_cast<uint64_t>(record.previous_first) + record.previous_count <= header.link_count
+          && (record.left < total || record.left == map_cache::NO_WAYPOINT)
+          && (record.right < total || record.right == map_cache::NO_WAYPOINT);
+    }
+    for (uint32_t i = 0u; i < header.link_count && valid; ++i) {
+      valid = links[i] < total;
+    }
+    spatial_index.View(
+        reinterpret_cast<const SpatialIndexEntry *>(data + header.spatial_entries_offset),
+        header.spatial_entry_count,
+        reinterpret_cast<const SpatialIndexNode *>(data + header.spatial_nodes_offset),
+        header.spatial_node_count,
+        header.spatial_leaf_count);
+    if (!valid || !spatial_index.IsValid(total)) {
+      spatial_index.View(nullptr, 0u, nullptr, 0u, 0u);
+      log_warning("InMemoryMap cache is corrupted, ignoring it");
+      return false;
+    }
+
+    // Place the waypoints, their links and their lane change neighbours.
+    SetUpWaypointArena(total);
+    for (uint32_t i = 0u; i < total; ++i) {
+      const map_cache::WaypointRecord &record = records[i];
+      SimpleWaypointPtr wp = AddWaypoint(record.info);
+      wp->SetGeodesicGridId(record.geodesic_grid_id);
+      wp->SetIsJunction(record.is_junction != 0u);
+      wp->SetRoadOption(static_cast<RoadOption>(record.road_option));
+      dense_topology.push_back(wp);
+    }
+
+    waypoint_links.resize(header.link_count);
+    for (uint32_t i = 0u; i < header.link_count; ++i) {
+      waypoint_links[i] = &waypoint_arena[links[i]];
+    }
+
+    for (uint32_t i = 0u; i < total; ++i) {
+      const map_cache::WaypointRecord &record = records[i];
+      SimpleWaypoint &wp = waypoint_arena[i];
+      wp.SetLinks(
+          WaypointSpan(waypoint_links.data() + record.next_first, record.next_count),
+          WaypointSpan(waypoint_links.data() + record.previous_first, record.previous_count));
+      if (record.left != map_cache::NO_WAYPOINT) {
+        SimpleWaypointPtr left = &waypoint_arena[record.left];
+        wp.SetLeftWaypoint(left);
+      }
+      if (record.right != map_cache::NO_WAYPOINT) {
+        SimpleWaypointPtr right = &waypoint_arena[record.right];
+        wp.SetRightWaypoint(right);
+      }
+    }
+
+    return true;
+  }
+
+  bool InMemoryMap::LoadLegacyCache(const uint8_t *data, const size_t size) {
     unsigned long pos = 0;
     std::vector<CachedSimpleWaypoint> cached_waypoints;
     std::unordered_map<uint64_t, uint32_t> id2index;
 
+    if (size < sizeof(uint32_t)) {
+      return false;
+    }
+
     // read total records
     uint32_t total;
-    memcpy(&total, &content[pos], sizeof(total));
+    memcpy(&total, &data[pos], sizeof(total));
     pos += sizeof(total);
+    SetUpWaypointArena(total);
 
     // read simple waypoints
     for (uint32_t i=0; i < total; i++) {
       CachedSimpleWaypoint cached_wp;
-      cached_wp.Read(content, pos);
+      cached_wp.Read(data, pos);
       cached_waypoints.push_back(cached_wp);
       id2index.insert({cached_wp.waypoint_id, i});
 
       WaypointPtr waypoint_ptr = _world_map->GetWaypointXODR(cached_wp.road_id, cached_wp.lane_id, cached_wp.s);
-      SimpleWaypointPtr wp = std::make_shared<SimpleWaypoint>(waypoint_ptr);
+      SimpleWaypointPtr wp = AddWaypoint(waypoint_ptr);
       wp->SetGeodesicGridId(cached_wp.geodesic_grid_id);
       wp->SetIsJunction(cached_wp.is_junction);
       wp->SetRoadOption(static_cast<RoadOption>(cached_wp.road_option));
@@ -135,20 +361,18 @@ namespace traffic_manager {
     }
 
     // connect waypoints
+    std::vector<NodeList> next_links(total);
+    std::vector<NodeList> previous_links(total);
     for (uint32_t i=0; i < dense_topology.size(); i++) {
       auto wp = dense_topology.at(i);
       auto cached_wp = cached_waypoints.at(i);
 
-      std::vector<SimpleWaypointPtr> next_waypoints;
       for (auto id : cached_wp.next_waypoints) {
-        next_waypoints.push_back(dense_topology.at(id2index.at(id)));
+        next_links[i].push_back(dense_topology.at(id2index.at(id)));
       }
-      std::vector<SimpleWaypointPtr> previous_waypoints;
       for (auto id : cached_wp.previous_waypoints) {
-        previous_waypoints.push_back(dense_topology.at(id2index.at(id)));
+        previous_links[i].push_back(dense_topology.at(id2index.at(id)));
       }
-      wp->SetNextWaypoint(next_waypoints);
-      wp->SetPreviousWaypoint(previous_waypoints);
       if (cached_wp.next_left_waypoint > 0) {
         wp->SetLeftWaypoint(dense_topology.at(id2index.at(cached_wp.next_left_waypoint)));
       }
@@ -156,6 +380,7 @@ namespace traffic_manager {
         wp->SetRightWaypoint(dense_topology.at(id2index.at(cached_wp.next_right_waypoint)));
       }
     }
+    SetUpLinks(next_links, previous_links);
 
     // create spatial tree
     SetUpSpatialTree();
@@ -163,7 +388,8 @@ namespace traffic_manager {
     return true;
   }
 
-  void InMemoryMap::SetUp() {
+  void InMemoryMap::SetUp(const size_t number_of_workers) {
+    setup_workers = number_of_workers;
 
     // 1. Building segment topology (i.e., defining set of segment predecessors and successors)
     assert(_world_map != nullptr && "No map reference found.");
@@ -221,12 +447,12 @@ namespace traffic_manager {
       }
     }
 
-    // 2. Consuming the raw dense topology from cc::Map into SimpleWaypoints.
-    SegmentMap segment_map;
+    // 2. Consuming the raw dense topology from cc::Map into segments.
+    std::map<SegmentId, RawNodeList> raw_segment_map;
     assert(_world_map != nullptr && "No map reference found.");
     auto raw_dense_topology = _world_map->GenerateWaypoints(MAP_RESOLUTION);
     for (auto &waypoint_ptr: raw_dense_topology) {
-      segment_map[GetSegmentId(waypoint_ptr)].emplace_back(std::make_shared<SimpleWaypoint>(waypoint_ptr));
+      raw_segment_map[GetSegmentId(waypoint_ptr)].emplace_back(waypoint_ptr);
     }
 
     // 3. Processing waypoints.
@@ -234,8 +460,8 @@ namespace traffic_manager {
       return cg::Math::DistanceSquared(l1, l2);
     };
     auto square = [](float input) {return std::pow(input, 2);};
-    auto compare_s = [](const SimpleWaypointPtr &swp1, const SimpleWaypointPtr &swp2) {
-      return (swp1->GetWaypoint()->GetDistance() < swp2->GetWaypoint()->GetDistance());
+    auto compare_s = [](const WaypointPtr &wp1, const WaypointPtr &wp2) {
+      return (wp1->GetDistance() < wp2->GetDistance());
     };
     auto wpt_angle = [](cg::Vector3D l1, cg::Vector3D l2) {
       return cg::Math::GetVectorAngle(l1, l2);
@@ -244,23 +470,26 @@ namespace traffic_manager {
       return x ^ ((x ^ y) & -(x < y));
     };
 
-    GeoGridId geodesic_grid_id_counter = -1;
-    for (auto &segment: segment_map) {
-      auto &segment_waypoints = segment.second;
-
-      // Generating geodesic grid ids.
-      ++geodesic_grid_id_counter;
+    // Segments are densified independently, each on its own list, so the
+    // result does not depend on how they are spread over the threads.
+    std::vector<RawNodeList *> raw_segments;
+    raw_segments.reserve(raw_segment_map.size());
+    for (auto &segment: raw_segment_map) {
+      raw_segments.push_back(&segment.second);
+    }
+    ParallelFor(raw_segments.size(), setup_workers, [&](const size_t segment_index) {
+      auto &segment_waypoints = *raw_segments[segment_index];
 
       // Ordering waypoints according to road direction.
       std::sort(segment_waypoints.begin(), segment_waypoints.end(), compare_s);
-      auto lane_id = segment_waypoints.front()->GetWaypoint()->GetLaneId();
+      auto lane_id = segment_waypoints.front()->GetLaneId();
       if (lane_id > 0) {
         std::reverse(segment_waypoints.begin(), segment_waypoints.end());
       }
 
       // Adding more waypoints if the angle is too tight or if they are too distant.
       for (std::size_t i = 0; i < segment_waypoints.size() - 1; ++i) {
-          double distance = std::abs(segment_waypoints.at(i)->GetWaypoint()->GetDistance() - segment_waypoints.at(i+1)->GetWaypoint()->GetDistance());
+          double distance = std::abs(segment_waypoints.at(i)->GetDistance() - segment_waypoints.at(i+1)->GetDistance());
           double angle = wpt_angle(segment_waypoints.at(i)->GetTransform().GetForwardVector(), segment_waypoints.at(i+1)->GetTransform().GetForwardVector());
           int16_t angle_splits = static_cast<int16_t>(angle/MAX_WPT_RADIANS);
           int16_t distance_splits = static_cast<int16_t>((distance*distance)/MAX_WPT_DISTANCE);
@@ -268,11 +497,11 @@ namespace traffic_manager {
           if (max_splits >= 1) {
             // Compute how many waypoints do we need to generate.
             for (uint16_t j = 0; j < max_splits; ++j) {
-              auto next_waypoints = segment_waypoints.at(i)->GetWaypoint()->GetNext(distance/(max_splits+1));
+              auto next_waypoints = segment_waypoints.at(i)->GetNext(distance/(max_splits+1));
               if (next_waypoints.size() != 0) {
                 auto new_waypoint = next_waypoints.front();
                 i++;
-                segment_waypoints.insert(segment_waypoints.begin()+static_cast<int64_t>(i), std::make_shared<SimpleWaypoint>(new_waypoint));
+                segment_waypoints.insert(segment_waypoints.begin()+static_cast<int64_t>(i), new_waypoint);
               } else {
                 // Reached end of the road.
                 break;
@@ -280,6 +509,27 @@ namespace traffic_manager {
             }
           }
         }
+    });
+
+    size_t total_waypoints = 0u;
+    for (const auto *segment_waypoints : raw_segments) {
+      total_waypoints += segment_waypoints->size();
+    }
+
+    // 4. Placing the final waypoints, segment by segment, in the arena.
+    SetUpWaypointArena(total_waypoints);
+    std::vector<NodeList> next_links(total_waypoints);
+    std::vector<NodeList> previous_links(total_waypoints);
+    SegmentMap segment_map;
+    GeoGridId geodesic_grid_id_counter = -1;
+    for (auto &raw_segment: raw_segment_map) {
+      auto &segment_waypoints = segment_map[raw_segment.first];
+      for (auto &waypoint_ptr: raw_segment.second) {
+        segment_waypoints.push_back(AddWaypoint(waypoint_ptr));
+      }
+
+      // Generating geodesic grid ids.
+      ++geodesic_grid_id_counter;
 
       // Placing intra-segment connections.
       cg::Location grid_edge_location = segment_waypoints.front()->GetLocation();
@@ -294,8 +544,8 @@ namespace traffic_manager {
         }
         current_waypoint->SetGeodesicGridId(geodesic_grid_id_counter);
 
-        current_waypoint->SetNextWaypoint({next_waypoint});
-        next_waypoint->SetPreviousWaypoint({current_waypoint});
+        next_links[current_waypoint->GetIndex()].push_back(next_waypoint);
+        previous_links[next_waypoint->GetIndex()].push_back(current_waypoint);
 
       }
       segment_waypoints.back()->SetGeodesicGridId(geodesic_grid_id_counter);
@@ -303,12 +553,11 @@ namespace traffic_manager {
       // Adding simple waypoints to processed dense topology.
       for (auto swp: segment_waypoints) {
         // Checking whether the waypoint is in a real junction.
-        auto wpt = swp->GetWaypoint();
-        auto road_id = wpt->GetRoadId();
-        if (wpt->IsJunction() && !is_real_junction.count(road_id)) {
+        const bool is_junction_road = swp->GetInfo().is_junction_road != 0u;
+        if (is_junction_road && !is_real_junction.count(swp->GetRoadId())) {
           swp->SetIsJunction(false);
         } else {
-          swp->SetIsJunction(swp->GetWaypoint()->IsJunction());
+          swp->SetIsJunction(is_junction_road);
         }
 
         dense_topology.push_back(swp);
@@ -325,51 +574,98 @@ namespace traffic_manager {
       auto successors = GetSuccessors(segment_id, segment_topology, segment_map);
       auto predecessors = GetPredecessors(segment_id, segment_topology, segment_map);
 
-      segment_waypoints.front()->SetPreviousWaypoint(predecessors);
-      segment_waypoints.back()->SetNextWaypoint(successors);
+      NodeList &front_previous = previous_links[segment_waypoints.front()->GetIndex()];
+      front_previous.insert(front_previous.end(), predecessors.begin(), predecessors.end());
+      NodeList &back_next = next_links[segment_waypoints.back()->GetIndex()];
+      back_next.insert(back_next.end(), successors.begin(), successors.end());
     }
 
-    // Linking lane change connections.
-    for (auto &swp : dense_topology) {
-      if (!swp->CheckJunction()) {
-        FindAndLinkLaneChange(swp);
+    // Linking lane change connections. Each waypoint only sets its own
+    // neighbours, found through the spatial index, which is complete by now.
+    ParallelFor(dense_topology.size(), setup_workers, [&](const size_t i) {
+      if (!dense_topology[i]->CheckJunction()) {
+        FindAndLinkLaneChange(dense_topology[i]);
       }
-    }
+    });
 
     // Linking any unconnected segments.
     for (auto &swp : dense_topology) {
-      if (swp->GetNextWaypoint().empty()) {
+      NodeList &swp_next_waypoints = next_links[swp->GetIndex()];
+      if (swp_next_waypoints.empty()) {
         auto neighbour = swp->GetRightWaypoint();
         if (!neighbour) {
           neighbour = swp->GetLeftWaypoint();
         }
 
         if (neighbour) {
-          swp->SetNextWaypoint(neighbour->GetNextWaypoint());
-          for (auto next_waypoint : neighbour->GetNextWaypoint()) {
-            next_waypoint->SetPreviousWaypoint({swp});
+          swp_next_waypoints = next_links[neighbour->GetIndex()];
+          for (auto next_waypoint : swp_next_waypoints) {
+            previous_links[next_waypoint->GetIndex()].push_back(swp);
           }
         }
       }
     }
 
+    SetUpLinks(next_links, previous_links);
+
     // Specifying a RoadOption for each SimpleWaypoint
     SetUpRoadOption();
   }
 
+  void InMemoryMap::SetUpLinks(const std::vector<NodeList> &next_links, const std::vector<NodeList> &previous_links) {
+    size_t total_links = 0u;
+    for (size_t i = 0u; i < waypoint_arena.size(); ++i) {
+      total_links += next_links[i].size() + previous_links[i].size();
+    }
+
+    // Reserved up front, so the ranges stay valid while it is filled.
+    waypoint_links.clear();
+    waypoint_links.reserve(total_links);
+    for (size_t i = 0u; i < waypoint_arena.size(); ++i) {
+      const SimpleWaypointPtr *next_first = waypoint_links.data() + waypoint_links.size();
+      waypoint_links.insert(waypoint_links.end(), next_links[i].begin(), next_links[i].end());
+      const SimpleWaypointPtr *previous_first = waypoint_links.data() + waypoint_links.size();
+      waypoint_links.insert(waypoint_links.end(), previous_links[i].begin(), previous_links[i].end());
+      waypoint_arena[i].SetLinks(
+          WaypointSpan(next_first, next_links[i].size()),
+          WaypointSpan(previous_first, previous_links[i].size()));
+    }
+  }
+
   void InMemoryMap::SetUpSpatialTree() {
+    std::vector<SpatialIndexEntry> entries;
+    entries.reserve(dense_topology.size());
     for (auto &simple_waypoint: dense_topology) {
       if (simple_waypoint != nullptr) {
         const cg::Location loc = simple_waypoint->GetLocation();
-        Point3D point(loc.x, loc.y, loc.z);
-        rtree.insert(std::make_pair(point, simple_waypoint));
+        entries.push_back(SpatialIndexEntry{loc.x, loc.y, loc.z, simple_waypoint->GetIndex()});
       }
     }
+    spatial_index.Build(std::move(entries));
   }
 
   void InMemoryMap::SetUpRoadOption() {
+    // Looking up the landmarks before every junction entry is the slow part,
+    // so it is done up front on all cores. Bytes rather than a vector<bool>,
+    // which cannot be written concurrently.
+    std::vector<uint8_t> junction_landmark(dense_topology.size(), 0u);
+    ParallelFor(dense_topology.size(), setup_workers, [&](const size_t i) {
+      const SimpleWaypointPtr swp = dense_topology[i];
+      const WaypointSpan next_waypoints = swp->GetNextWaypoint();
+      if (next_waypoints.size() != 1u || swp->CheckJunction() || !next_waypoints.front()->CheckJunction()) {
+        return;
+      }
+      for (auto &landmark : swp->GetWaypoint()->GetAllLandmarksInDistance(15.0)) {
+        auto landmark_type = landmark->GetType();
+        if (landmark_type == "1000001" || landmark_type == "206" || landmark_type == "205") {
+          junction_landmark[swp->GetIndex()] = 1u;
+          break;
+        }
+      }
+    });
+
     for (auto &swp : dense_topology) {
-      std::vector<SimpleWaypointPtr> next_waypoints = swp->GetNextWaypoint();
+      const WaypointSpan next_waypoints = swp->GetNextWaypoint();
       std::size_t next_swp_size = next_waypoints.size();
 
       if (next_swp_size == 0) {
@@ -381,26 +677,12 @@ namespace traffic_manager {
         // To check if we are in an actual junction, and not on an highway, we try to see
         // if there's a landmark nearby of type Traffic Light, Stop Sign or Yield Sign.
 
-        bool found_landmark= false;
+        bool found_landmark = false;
         if (next_swp_size <= 1) {
-
-          auto all_landmarks = swp->GetWaypoint()->GetAllLandmarksInDistance(15.0);
-
-          if (all_landmarks.empty()) {
+          found_landmark = junction_landmark[swp->GetIndex()] != 0u;
+          if (!found_landmark) {
             // Landmark hasn't been found, this isn't a junction.
             swp->SetRoadOption(RoadOption::LaneFollow);
-          } else {
-            for (auto &landmark : all_landmarks) {
-              auto landmark_type = landmark->GetType();
-              if (landmark_type == "1000001" || landmark_type == "206" || landmark_type == "205") {
-                // We found a landmark.
-                found_landmark= true;
-                break;
-              }
-            }
-            if (!found_landmark) {
-              swp->SetRoadOption(RoadOption::LaneFollow);
-            }
           }
         }
 
@@ -408,7 +690,7 @@ namespace traffic_manager {
         // in the junction and assign the correct RoadOption.
         if (found_landmark || next_swp_size > 1) {
           swp->SetRoadOption(RoadOption::LaneFollow);
-          for (auto &next_swp : next_waypoints) {
+          for (auto next_swp : next_waypoints) {
             std::vector<SimpleWaypointPtr> traversed_waypoints;
             SimpleWaypointPtr junction_end_waypoint;
 
@@ -420,7 +702,7 @@ namespace traffic_manager {
 
             while (junction_end_waypoint->CheckJunction()){
               traversed_waypoints.push_back(junction_end_waypoint);
-              std::vector<SimpleWaypointPtr> temp = junction_end_waypoint->GetNextWaypoint();
+              const WaypointSpan temp = junction_end_waypoint->GetNextWaypoint();
               if (temp.empty()) {
                 break;
               }
@@ -457,50 +739,70 @@ namespace traffic_manager {
   }
 
   SimpleWaypointPtr InMemoryMap::GetWaypoint(const cg::Location loc) const {
-
-    Point3D query_point(loc.x, loc.y, loc.z);
-    std::vector<SpatialTreeEntry> result_1;
-
-    rtree.query(bgi::nearest(query_point, 1), std::back_inserter(result_1));
-
-    SpatialTreeEntry &closest_entry = result_1.front();
-    SimpleWaypointPtr &closest_point = closest_entry.second;
-
-    return closest_point;
+    WaypointIndex closest_index;
+    if (!spatial_index.Nearest(loc, closest_index)) {
+      return nullptr;
+    }
+    return dense_topology[closest_index];
   }
 
   NodeList InMemoryMap::GetWaypointsInDelta(const cg::Location loc, const uint16_t n_points, const float random_sample) const {
-    Point3D query_point(loc.x, loc.y, loc.z);
-
-    Point3D lower_p1(loc.x + random_sample, loc.y + random_sample, loc.z + Z_DELTA);
-    Point3D lower_p2(loc.x - random_sample, loc.y - random_sample, loc.z - Z_DELTA);
-    Point3D upper_p1(loc.x + random_sample + DELTA, loc.y + random_sample + DELTA, loc.z + Z_DELTA);
-    Point3D upper_p2(loc.x - random_sample - DELTA, loc.y - random_sample - DELTA, loc.z - Z_DELTA);
-
-    Box lower_query_box(lower_p2, lower_p1);
-    Box upper_query_box(upper_p2, upper_p1);
+    const cg::Location lower_max(loc.x + random_sample, loc.y + random_sample, loc.z + Z_DELTA);
+    const cg::Location lower_min(loc.x - random_sample, loc.y - random_sample, loc.z - Z_DELTA);
+    const cg::Location upper_max(loc.x + random_sample + DELTA, loc.y + random_sample + DELTA, loc.z + Z_DELTA);
+    const cg::Location upper_min(loc.x - random_sample - DELTA, loc.y - random_sample - DELTA, loc.z - Z_DELTA);
 
     NodeList result;
-    uint8_t x = 0;
-    for (Rtree::const_query_iterator
-        it = rtree.qbegin(bgi::within(upper_query_box)
-        && !bgi::within(lower_query_box)
-        && bgi::satisfies([&](SpatialTreeEntry const& v) { return !v.second->CheckJunction();}));
-        it != rtree.qend();
-        ++it) {
-    x++;
-    result.push_back(it->second);
-    if (x >= n_points)
-        break;
+    if (n_points == 0u) {
+      return result;
     }
+    spatial_index.Query(upper_min, upper_max, [&](const WaypointIndex index) {
+      const SimpleWaypointPtr swp = dense_topology[index];
+      const cg::Location wp_loc = swp->GetLocation();
+      const bool in_lower_box = wp_loc.x > lower_min.x && wp_loc.x < lower_max.x
+          && wp_loc.y > lower_min.y && wp_loc.y < lower_max.y
+          && wp_loc.z > lower_min.z && wp_loc.z < lower_max.z;
+      if (!in_lower_box && !swp->CheckJunction()) {
+        result.push_back(swp);
+      }
+      return result.size() < n_points;
+    });
 
     return result;
   }
 
-  NodeList InMemoryMap::GetDenseTopology() const {
+  const NodeList &InMemoryMap::GetDenseTopology() const {
     return dense_topology;
   }
 
+  SimpleWaypointPtr InMemoryMap::GetWaypointByIndex(const WaypointIndex index) const {
+    return dense_topology.at(index);
+  }
+
+  void InMemoryMap::SetUpWaypointArena(const size_t size) {
+    assert(waypoint_arena.empty() && "The waypoint arena can only be set up once.");
+    if (size > std::numeric_limits<WaypointIndex>::max()) {
+      throw_exception(std::length_error("too many waypoints for the traffic manager's map"));
+    }
+    waypoint_arena.reserve(size);
+    dense_topology.reserve(size);
+  }
+
+  SimpleWaypointPtr InMemoryMap::AddWaypoint(WaypointPtr waypoint) {
+    // Growing the arena would move the waypoints and invalidate every handle.
+    assert(waypoint_arena.size() < waypoint_arena.capacity() && "Waypoint arena overflow.");
+    const WaypointIndex index = static_cast<WaypointIndex>(waypoint_arena.size());
+    waypoint_arena.emplace_back(waypoint, index);
+    return &waypoint_arena.back();
+  }
+
+  SimpleWaypointPtr InMemoryMap::AddWaypoint(const WaypointInfo &info) {
+    assert(waypoint_arena.size() < waypoint_arena.capacity() && "Waypoint arena overflow.");
+    const WaypointIndex index = static_cast<WaypointIndex>(waypoint_arena.size());
+    waypoint_arena.emplace_back(*_world_map, info, index);
+    return &waypoint_arena.back();
+  }
+
   void InMemoryMap::FindAndLinkLaneChange(SimpleWaypointPtr reference_waypoint) {
 
     const WaypointPtr raw_waypoint = reference_waypoint->GetWaypoint();
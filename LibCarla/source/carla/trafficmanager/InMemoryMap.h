@@ -7,13 +7,13 @@
 #pragma once
 
 #include <chrono>
+#include <map>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
-
-#include "boost/geometry.hpp"
-#include "boost/geometry/geometries/point.hpp"
-#include "boost/geometry/index/rtree.hpp"
+#include <vector>
 
 #include "carla/client/Map.h"
 #include "carla/client/Waypoint.h"
@@ -25,6 +25,7 @@
 #include "carla/trafficmanager/RandomGenerator.h"
 #include "carla/trafficmanager/SimpleWaypoint.h"
 #include "carla/trafficmanager/CachedSimpleWaypoint.h"
+#include "carla/trafficmanager/WaypointSpatialIndex.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -32,23 +33,15 @@ namespace traffic_manager {
 namespace cg = carla::geom;
 namespace cc = carla::client;
 namespace crd = carla::road;
-namespace bg = boost::geometry;
-namespace bgi = boost::geometry::index;
 
   using WaypointPtr = carla::SharedPtr<cc::Waypoint>;
-  using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
   using NodeList = std::vector<SimpleWaypointPtr>;
   using GeoGridId = crd::JuncId;
   using WorldMap = carla::SharedPtr<const cc::Map>;
 
-  using Point3D = bg::model::point<float, 3, bg::cs::cartesian>;
-  using Box = bg::model::box<Point3D>;
-  using SpatialTreeEntry = std::pair<Point3D, SimpleWaypointPtr>;
-
   using SegmentId = std::tuple<crd::RoadId, crd::LaneId, crd::SectionId>;
   using SegmentTopology = std::map<SegmentId, std::pair<std::vector<SegmentId>, std::vector<SegmentId>>>;
   using SegmentMap = std::map<SegmentId, std::vector<SimpleWaypointPtr>>;
-  using Rtree = bgi::rtree<SpatialTreeEntry, bgi::rstar<16>>;
 
   /// This class builds a discretized local map-cache.
   /// Instantiate the class with the world and run SetUp() to construct the
@@ -59,24 +52,39 @@ namespace bgi = boost::geometry::index;
 
     /// Object to hold the world map received by the constructor.
     WorldMap _world_map;
+    /// Contiguous storage owning all custom waypoint objects. It is reserved
+    /// up front and never reallocated, so waypoints can be referenced by
+    /// pointer or by their index in it.
+    std::vector<SimpleWaypoint> waypoint_arena;
     /// Structure to hold all custom waypoint objects after interpolation of
     /// sparse topology.
     NodeList dense_topology;
-    /// Spatial quadratic R-tree for indexing and querying waypoints.
-    Rtree rtree;
+    /// Next and previous waypoints of every waypoint, one range per list.
+    NodeList waypoint_links;
+    /// Packed R-tree for indexing and querying waypoints.
+    WaypointSpatialIndex spatial_index;
+    /// Cache the map was loaded from, the spatial index is used in place.
+    std::shared_ptr<const void> cache_storage;
+    /// Threads SetUp() builds the map with, zero for one per core.
+    size_t setup_workers = 0u;
 
   public:
 
     InMemoryMap(WorldMap world_map);
     ~InMemoryMap();
 
-    static void Cook(WorldMap world_map, const std::string& path);
+    /// Builds the map with @a number_of_workers threads (zero for one per
+    /// core, the result is the same) and saves it to @a path.
+    static void Cook(WorldMap world_map, const std::string& path, size_t number_of_workers = 0u);
 
-    //bool Load(const std::string& filename);
+    /// Loads a cooked map from a file, mapping it in memory. Returns false if
+    /// the file cannot be read or was cooked from another OpenDRIVE.
+    bool Load(const std::string& filename);
     bool Load(const std::vector<uint8_t>& content);
 
-    /// This method constructs the local map with a resolution of sampling_resolution.
-    void SetUp();
+    /// This method constructs the local map with a resolution of sampling_resolution,
+    /// on @a number_of_workers threads (zero for one per core).
+    void SetUp(size_t number_of_workers = 0u);
 
     /// This method returns the closest waypoint to a given location on the map.
     SimpleWaypointPtr GetWaypoint(const cg::Location loc) const;
@@ -85,7 +93,10 @@ namespace bgi = boost::geometry::index;
     NodeList GetWaypointsInDelta(const cg::Location loc, const uint16_t n_points, const float random_sample) const;
 
     /// This method returns the full list of discrete samples of the map in the local cache.
-    NodeList GetDenseTopology() const;
+    const NodeList &GetDenseTopology() const;
+
+    /// This method returns the waypoint stored at the given index of the arena.
+    SimpleWaypointPtr GetWaypointByIndex(const WaypointIndex index) const;
 
     std::string GetMapName();
 
@@ -94,7 +105,16 @@ namespace bgi = boost::geometry::index;
   private:
     void Save(const std::string& path);
 
+    bool LoadCache(const uint8_t *data, const size_t size);
+    bool LoadLegacyCache(const uint8_t *data, const size_t size);
+
     void SetUpDenseTopology();
+    void SetUpWaypointArena(const size_t size);
+    SimpleWaypointPtr AddWaypoint(WaypointPtr waypoint);
+    SimpleWaypointPtr AddWaypoint(const WaypointInfo &info);
+    /// Stores the given next and previous lists, indexed by arena position,
+    /// in waypoint_links and points every waypoint to its ranges.
+    void SetUpLinks(const std::vector<NodeList> &next_links, const std::vector<NodeList> &previous_links);
     void SetUpSpatialTree();
     void SetUpRoadOption();
 
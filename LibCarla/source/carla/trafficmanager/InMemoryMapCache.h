@@ -0,0 +1,96 @@
+// Copyright (c) 2021 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "carla/trafficmanager/SimpleWaypoint.h"
+#include "carla/trafficmanager/WaypointSpatialIndex.h"
+
+namespace carla {
+namespace traffic_manager {
+namespace map_cache {
+
+  /// Binary layout of the InMemoryMap cache.
+  ///
+  /// The file is a Header followed by four arrays, each at an 8-byte aligned
+  /// offset from the start of the file: the WaypointRecords in arena order,
+  /// the links (arena indices of the next and previous waypoints of every
+  /// waypoint), and the entries and nodes of the packed spatial index. Every
+  /// reference is an index or an offset, so the file can be used in place
+  /// wherever it is mapped. Values are stored in the byte order of the
+  /// machine that cooked the file, which is little-endian on all the
+  /// platforms we ship.
+  ///
+  /// Caches written before this format start with the waypoint count instead
+  /// of the magic and are still read by the slow path.
+
+  static const char MAGIC[8u] = {'C', 'A', 'R', 'L', 'A', 'T', 'M', '\0'};
+
+  /// Increase when the layout of any of the structures below changes.
+  static const uint32_t VERSION = 1u;
+
+  /// Stored instead of an index when there is no such waypoint.
+  static const WaypointIndex NO_WAYPOINT = std::numeric_limits<WaypointIndex>::max();
+
+  struct Header {
+    char magic[8u];
+    uint32_t version;
+    uint32_t header_size;
+    /// Hash of the OpenDRIVE the cache was cooked from, see HashOpenDrive.
+    uint64_t opendrive_hash;
+    uint64_t file_size;
+    uint32_t waypoint_count;
+    uint32_t link_count;
+    uint32_t spatial_entry_count;
+    uint32_t spatial_node_count;
+    uint32_t spatial_leaf_count;
+    uint32_t reserved;
+    uint64_t waypoints_offset;
+    uint64_t links_offset;
+    uint64_t spatial_entries_offset;
+    uint64_t spatial_nodes_offset;
+  };
+
+  struct WaypointRecord {
+    WaypointInfo info;
+    int32_t geodesic_grid_id;
+    /// Ranges of the links array.
+    uint32_t next_first;
+    uint32_t previous_first;
+    uint16_t next_count;
+    uint16_t previous_count;
+    WaypointIndex left;
+    WaypointIndex right;
+    uint8_t is_junction;
+    uint8_t road_option;
+    uint8_t padding[6u];
+  };
+
+  static_assert(sizeof(Header) == 88u, "Unexpected padding in the map cache header.");
+  static_assert(sizeof(WaypointRecord) == 88u, "Unexpected padding in the map cache waypoint record.");
+
+  /// 64-bit FNV-1a, stable across platforms and standard libraries.
+  inline uint64_t HashOpenDrive(const std::string &opendrive) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : opendrive) {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  /// Offsets are rounded up to keep every array 8-byte aligned.
+  inline uint64_t AlignOffset(uint64_t offset) {
+    return (offset + 7u) & ~static_cast<uint64_t>(7u);
+  }
+
+} // namespace map_cache
+} // namespace traffic_manager
+} // namespace carla
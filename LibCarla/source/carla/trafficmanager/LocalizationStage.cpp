@@ -36,9 +36,9 @@ LocalizationStage::LocalizationStage(
 void LocalizationStage::Update(const unsigned long index) {
 
   const ActorId actor_id = vehicle_id_list.at(index);
-  const cg::Location vehicle_location = simulation_state.GetLocation(actor_id);
-  const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
-  const cg::Vector3D vehicle_velocity_vector = simulation_state.GetVelocity(actor_id);
+  const cg::Location vehicle_location = simulation_state.GetLocations().at(index);
+  const cg::Vector3D heading_vector = simulation_state.GetHeadings().at(index);
+  const cg::Vector3D vehicle_velocity_vector = simulation_state.GetVelocities().at(index);
   const float vehicle_speed = vehicle_velocity_vector.Length();
 
   // Speed dependent waypoint horizon length.
@@ -48,10 +48,8 @@ void LocalizationStage::Update(const unsigned long index) {
   }
   const float horizon_square = SQUARE(horizon_length);
 
-  if (buffer_map.find(actor_id) == buffer_map.end()) {
-    buffer_map.insert({actor_id, Buffer()});
-  }
-  Buffer &waypoint_buffer = buffer_map.at(actor_id);
+  // Created by BeginParallelUpdate in parallel mode.
+  Buffer &waypoint_buffer = buffer_map[actor_id];
 
   // Clear buffer if vehicle is too far from the first waypoint in the buffer.
   if (!waypoint_buffer.empty() &&
@@ -82,7 +80,7 @@ void LocalizationStage::Update(const unsigned long index) {
       bool front_waypoint_junction = front_waypoint->CheckJunction();
       is_at_junction_entrance = !front_waypoint_junction && look_ahead_point->CheckJunction();
       if (!is_at_junction_entrance) {
-        std::vector<SimpleWaypointPtr> last_passed_waypoints = front_waypoint->GetPreviousWaypoint();
+        const WaypointSpan last_passed_waypoints = front_waypoint->GetPreviousWaypoint();
         if (last_passed_waypoints.size() == 1) {
           is_at_junction_entrance = !last_passed_waypoints.front()->CheckJunction() && front_waypoint_junction;
         }
@@ -143,10 +141,11 @@ void LocalizationStage::Update(const unsigned long index) {
   const SimpleWaypointPtr front_waypoint = waypoint_buffer.front();
   const float lane_change_distance = SQUARE(std::max(10.0f * vehicle_speed, INTER_LANE_CHANGE_DISTANCE));
 
-  bool recently_not_executed_lane_change = last_lane_change_swpt.find(actor_id) == last_lane_change_swpt.end();
+  SimpleWaypointPtr &last_lane_change = last_lane_change_swpt[actor_id];
+  bool recently_not_executed_lane_change = last_lane_change == nullptr;
   bool done_with_previous_lane_change = true;
   if (!recently_not_executed_lane_change) {
-    float distance_frm_previous = cg::Math::DistanceSquared(last_lane_change_swpt.at(actor_id)->GetLocation(), vehicle_location);
+    float distance_frm_previous = cg::Math::DistanceSquared(last_lane_change->GetLocation(), vehicle_location);
     done_with_previous_lane_change = distance_frm_previous > lane_change_distance;
   }
   bool auto_or_force_lane_change = parameters.GetAutoLaneChange(actor_id) || force_lane_change;
@@ -160,11 +159,7 @@ void LocalizationStage::Update(const unsigned long index) {
                                                            force_lane_change, lane_change_direction);
 
     if (change_over_point != nullptr) {
-      if (last_lane_change_swpt.find(actor_id) != last_lane_change_swpt.end()) {
-        last_lane_change_swpt.at(actor_id) = change_over_point;
-      } else {
-        last_lane_change_swpt.insert({actor_id, change_over_point});
-      }
+      last_lane_change = change_over_point;
       auto number_of_pops = waypoint_buffer.size();
       for (uint64_t j = 0u; j < number_of_pops; ++j) {
         PopWaypoint(actor_id, track_traffic, waypoint_buffer);
@@ -190,7 +185,7 @@ void LocalizationStage::Update(const unsigned long index) {
   else {
     while (waypoint_buffer.back()->DistanceSquared(waypoint_buffer.front()) <= horizon_square) {
       SimpleWaypointPtr furthest_waypoint = waypoint_buffer.back();
-      std::vector<SimpleWaypointPtr> next_waypoints = furthest_waypoint->GetNextWaypoint();
+      const WaypointSpan next_waypoints = furthest_waypoint->GetNextWaypoint();
       uint64_t selection_index = 0u;
       // Pseudo-randomized path selection if found more than one choice.
       if (next_waypoints.size() > 1) {
@@ -200,7 +195,7 @@ void LocalizationStage::Update(const unsigned long index) {
         if (!parameters.GetOSMMode()) {
           std::cout << "This map has dead-end roads, please change the set_open_street_map parameter to true" << std::endl;
         }
-        marked_for_removal.push_back(actor_id);
+        MarkForRemoval(actor_id);
         break;
       }
       SimpleWaypointPtr next_wp_selection = next_waypoints.at(selection_index);
@@ -214,7 +209,7 @@ void LocalizationStage::Update(const unsigned long index) {
   output.is_at_junction_entrance = is_at_junction_entrance;
 
   if (is_at_junction_entrance) {
-    const SimpleWaypointPair &safe_space_end_points = vehicles_at_junction_entrance.at(actor_id);
+    const SimpleWaypointPair &safe_space_end_points = vehicles_at_junction_entrance.at(actor_id).end_points;
     output.junction_end_point = safe_space_end_points.first;
     output.safe_point = safe_space_end_points.second;
   } else {
@@ -232,9 +227,9 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
 
   SimpleWaypointPtr junction_end_point = nullptr;
   SimpleWaypointPtr safe_point_after_junction = nullptr;
+  JunctionEntrance &junction_entrance = vehicles_at_junction_entrance[actor_id];
 
-  if (is_at_junction_entrance
-      && vehicles_at_junction_entrance.find(actor_id) == vehicles_at_junction_entrance.end()) {
+  if (is_at_junction_entrance && !junction_entrance.at_entrance) {
 
     bool entered_junction = false;
     bool past_junction = false;
@@ -265,7 +260,7 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
       bool abort = false;
 
       while (!past_junction && !abort) {
-        NodeList next_waypoints = current_waypoint->GetNextWaypoint();
+        const WaypointSpan next_waypoints = current_waypoint->GetNextWaypoint();
         if (!next_waypoints.empty()) {
           current_waypoint = next_waypoints.front();
           PushWaypoint(actor_id, track_traffic, waypoint_buffer, current_waypoint);
@@ -279,7 +274,7 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
       }
 
       while (!safe_point_found && !abort) {
-        std::vector<SimpleWaypointPtr> next_waypoints = current_waypoint->GetNextWaypoint();
+        const WaypointSpan next_waypoints = current_waypoint->GetNextWaypoint();
         if ((junction_end_point->DistanceSquared(current_waypoint) > safe_distance_squared)
             || next_waypoints.size() > 1
             || current_waypoint->CheckJunction()) {
@@ -305,23 +300,69 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
       safe_point_after_junction = nullptr;
     }
 
-    vehicles_at_junction_entrance.insert({actor_id, {junction_end_point, safe_point_after_junction}});
+    junction_entrance = {true, {junction_end_point, safe_point_after_junction}};
   }
-  else if (!is_at_junction_entrance
-           && vehicles_at_junction_entrance.find(actor_id) != vehicles_at_junction_entrance.end()) {
+  else if (!is_at_junction_entrance && junction_entrance.at_entrance) {
 
-    vehicles_at_junction_entrance.erase(actor_id);
+    junction_entrance.at_entrance = false;
+  }
+}
+
+SimpleWaypointPtr LocalizationStage::GetFrontWaypoint(const ActorId actor_id) const {
+  if (parallel_update) {
+    auto front = cycle_start_front.find(actor_id);
+    return front != cycle_start_front.end() ? front->second : nullptr;
+  }
+  auto buffer = buffer_map.find(actor_id);
+  return buffer != buffer_map.end() && !buffer->second.empty() ? buffer->second.front() : nullptr;
+}
+
+void LocalizationStage::MarkForRemoval(const ActorId actor_id) {
+  if (parallel_update) {
+    ++removal_marks.at(actor_id);
+  } else {
+    marked_for_removal.push_back(actor_id);
+  }
+}
+
+void LocalizationStage::BeginParallelUpdate() {
+  cycle_start_front.clear();
+  for (const auto &buffer : buffer_map) {
+    if (!buffer.second.empty()) {
+      cycle_start_front.insert({buffer.first, buffer.second.front()});
+    }
   }
+  for (const ActorId actor_id : vehicle_id_list) {
+    buffer_map[actor_id];
+    last_lane_change_swpt[actor_id];
+    vehicles_at_junction_entrance[actor_id];
+    removal_marks[actor_id] = 0u;
+  }
+  track_traffic.BeginDeferredUpdates(vehicle_id_list);
+  parallel_update = true;
+}
+
+void LocalizationStage::EndParallelUpdate() {
+  parallel_update = false;
+  track_traffic.EndDeferredUpdates();
+  // Same order as the sequential update.
+  for (const ActorId actor_id : vehicle_id_list) {
+    marked_for_removal.insert(marked_for_removal.end(), removal_marks.at(actor_id), actor_id);
+  }
+  removal_marks.clear();
+  cycle_start_front.clear();
 }
 
 void LocalizationStage::RemoveActor(ActorId actor_id) {
     last_lane_change_swpt.erase(actor_id);
     vehicles_at_junction.erase(actor_id);
+    vehicles_at_junction_entrance.erase(actor_id);
 }
 
 void LocalizationStage::Reset() {
   last_lane_change_swpt.clear();
   vehicles_at_junction.clear();
+  vehicles_at_junction_entrance.clear();
 }
 
 SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
@@ -344,7 +385,8 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
     const SimpleWaypointPtr right_waypoint = current_waypoint->GetRightWaypoint();
 
     // Retrieve vehicles with overlapping waypoint buffers with current vehicle.
-    const auto blocking_vehicles = track_traffic.GetOverlappingVehicles(actor_id);
+    std::vector<ActorId> blocking_vehicles;
+    track_traffic.GetOverlappingVehicles(actor_id, blocking_vehicles);
 
     // Find immediate in-lane obstacle and check if any are too close to initiate lane change.
     bool obstacle_too_close = false;
@@ -355,24 +397,21 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
          ++i) {
       const ActorId &other_actor_id = *i;
       // Find vehicle in buffer map and check if it's buffer is not empty.
-      if (buffer_map.find(other_actor_id) != buffer_map.end() && !buffer_map.at(other_actor_id).empty()) {
-        const Buffer &other_buffer = buffer_map.at(other_actor_id);
-        const SimpleWaypointPtr &other_current_waypoint = other_buffer.front();
+      const SimpleWaypointPtr other_current_waypoint = GetFrontWaypoint(other_actor_id);
+      if (other_current_waypoint != nullptr) {
         const cg::Location other_location = other_current_waypoint->GetLocation();
 
         const cg::Vector3D reference_heading = current_waypoint->GetForwardVector();
         cg::Vector3D reference_to_other = other_location - current_waypoint->GetLocation();
         const cg::Vector3D other_heading = other_current_waypoint->GetForwardVector();
 
-        WaypointPtr current_raw_waypoint = current_waypoint->GetWaypoint();
-        WaypointPtr other_current_raw_waypoint = other_current_waypoint->GetWaypoint();
         // Check both vehicles are not in junction,
         // Check if the other vehicle is in front of the current vehicle,
         // Check if the two vehicles have acceptable angular deviation between their headings.
         if (!current_waypoint->CheckJunction()
             && !other_current_waypoint->CheckJunction()
-            && other_current_raw_waypoint->GetRoadId() == current_raw_waypoint->GetRoadId()
-            && other_current_raw_waypoint->GetLaneId() == current_raw_waypoint->GetLaneId()
+            && other_current_waypoint->GetRoadId() == current_waypoint->GetRoadId()
+            && other_current_waypoint->GetLaneId() == current_waypoint->GetLaneId()
             && cg::Math::Dot(reference_heading, reference_to_other) > 0.0f
             && cg::Math::Dot(reference_heading, other_heading) > MAXIMUM_LANE_OBSTACLE_CURVATURE) {
           float squared_distance = cg::Math::DistanceSquared(vehicle_location, other_location);
@@ -392,8 +431,7 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
 
     // If a valid immediate obstacle found.
     if (!obstacle_too_close && obstacle_actor_id != 0u && !force) {
-      const Buffer &other_buffer = buffer_map.at(obstacle_actor_id);
-      const SimpleWaypointPtr &other_current_waypoint = other_buffer.front();
+      const SimpleWaypointPtr other_current_waypoint = GetFrontWaypoint(obstacle_actor_id);
       const auto other_neighbouring_lanes = {other_current_waypoint->GetLeftWaypoint(),
                                              other_current_waypoint->GetRightWaypoint()};
 
@@ -466,12 +504,12 @@ void LocalizationStage::ImportPath(Path &imported_path, Buffer &waypoint_buffer,
       SimpleWaypointPtr latest_waypoint = waypoint_buffer.back();
 
       // Try to link the latest_waypoint to the imported waypoint.
-      std::vector<SimpleWaypointPtr> next_waypoints = latest_waypoint->GetNextWaypoint();
+      const WaypointSpan next_waypoints = latest_waypoint->GetNextWaypoint();
       uint64_t selection_index = 0u;
 
       // Choose correct path.
       if (next_waypoints.size() > 1) {
-        const float imported_road_id = imported->GetWaypoint()->GetRoadId();
+        const float imported_road_id = imported->GetRoadId();
         float min_distance = std::numeric_limits<float>::infinity();
         for (uint64_t k = 0u; k < next_waypoints.size(); ++k) {
           SimpleWaypointPtr junction_end_point = next_waypoints.at(k);
@@ -484,7 +522,7 @@ void LocalizationStage::ImportPath(Path &imported_path, Buffer &waypoint_buffer,
           while (next_waypoints.at(k)->DistanceSquared(junction_end_point) < 50.0f) {
             junction_end_point = junction_end_point->GetNextWaypoint().front();
           }
-          float jep_road_id = junction_end_point->GetWaypoint()->GetRoadId();
+          float jep_road_id = junction_end_point->GetRoadId();
           if (jep_road_id == imported_road_id) {
             selection_index = k;
             break;
@@ -499,7 +537,7 @@ void LocalizationStage::ImportPath(Path &imported_path, Buffer &waypoint_buffer,
         if (!parameters.GetOSMMode()) {
           std::cout << "This map has dead-end roads, please change the set_open_street_map parameter to true" << std::endl;
         }
-        marked_for_removal.push_back(actor_id);
+        MarkForRemoval(actor_id);
         break;
       }
       SimpleWaypointPtr next_wp_selection = next_waypoints.at(selection_index);
@@ -539,7 +577,7 @@ void LocalizationStage::ImportRoute(Route &imported_actions, Buffer &waypoint_bu
       SimpleWaypointPtr latest_waypoint = waypoint_buffer.back();
       RoadOption latest_road_option = latest_waypoint->GetRoadOption();
       // Try to link the latest_waypoint to the correct next RouteOption.
-      std::vector<SimpleWaypointPtr> next_waypoints = latest_waypoint->GetNextWaypoint();
+      const WaypointSpan next_waypoints = latest_waypoint->GetNextWaypoint();
       uint16_t selection_index = 0u;
       if (next_waypoints.size() > 1) {
         for (uint16_t i=0; i<next_waypoints.size(); ++i) {
@@ -556,7 +594,7 @@ void LocalizationStage::ImportRoute(Route &imported_actions, Buffer &waypoint_bu
         if (!parameters.GetOSMMode()) {
           std::cout << "This map has dead-end roads, please change the set_open_street_map parameter to true" << std::endl;
         }
-        marked_for_removal.push_back(actor_id);
+        MarkForRemoval(actor_id);
         break;
       }
 
@@ -582,7 +620,8 @@ Action LocalizationStage::ComputeNextAction(const ActorId& actor_id) {
   auto waypoint_buffer = buffer_map.at(actor_id);
   auto next_action = std::make_pair(RoadOption::LaneFollow, waypoint_buffer.back()->GetWaypoint());
   bool is_lane_change = false;
-  if (last_lane_change_swpt.find(actor_id) != last_lane_change_swpt.end()) {
+  auto last_lane_change = last_lane_change_swpt.find(actor_id);
+  if (last_lane_change != last_lane_change_swpt.end() && last_lane_change->second != nullptr) {
     // A lane change is happening.
     is_lane_change = true;
     const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
@@ -591,7 +630,7 @@ Action LocalizationStage::ComputeNextAction(const ActorId& actor_id) {
     if (left_heading) next_action = std::make_pair(RoadOption::ChangeLaneLeft, last_lane_change_swpt.at(actor_id)->GetWaypoint());
     else next_action = std::make_pair(RoadOption::ChangeLaneRight, last_lane_change_swpt.at(actor_id)->GetWaypoint());
   }
-  for (auto &swpt : waypoint_buffer) {
+  for (SimpleWaypointPtr swpt : waypoint_buffer) {
     RoadOption road_opt = swpt->GetRoadOption();
     if (road_opt != RoadOption::LaneFollow) {
       if (!is_lane_change) {
@@ -620,7 +659,8 @@ ActionBuffer LocalizationStage::ComputeActionBuffer(const ActorId& actor_id) {
   SimpleWaypointPtr buffer_front = waypoint_buffer.front();
   RoadOption last_road_opt = buffer_front->GetRoadOption();
   action_buffer.push_back(std::make_pair(last_road_opt, buffer_front->GetWaypoint()));
-  if (last_lane_change_swpt.find(actor_id) != last_lane_change_swpt.end()) {
+  auto last_lane_change = last_lane_change_swpt.find(actor_id);
+  if (last_lane_change != last_lane_change_swpt.end() && last_lane_change->second != nullptr) {
     // A lane change is happening.
     is_lane_change = true;
     const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
@@ -629,7 +669,7 @@ ActionBuffer LocalizationStage::ComputeActionBuffer(const ActorId& actor_id) {
     if (left_heading) lane_change = std::make_pair(RoadOption::ChangeLaneLeft, last_lane_change_swpt.at(actor_id)->GetWaypoint());
     else lane_change = std::make_pair(RoadOption::ChangeLaneRight, last_lane_change_swpt.at(actor_id)->GetWaypoint());
   }
-  for (auto &wpt : waypoint_buffer) {
+  for (SimpleWaypointPtr wpt : waypoint_buffer) {
     RoadOption current_road_opt = wpt->GetRoadOption();
     if (current_road_opt != last_road_opt) {
       action_buffer.push_back(std::make_pair(current_road_opt, wpt->GetWaypoint()));
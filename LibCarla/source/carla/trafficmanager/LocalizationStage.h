@@ -43,8 +43,24 @@ private:
   LaneChangeSWptMap last_lane_change_swpt;
   ActorIdSet vehicles_at_junction;
   using SimpleWaypointPair = std::pair<SimpleWaypointPtr, SimpleWaypointPtr>;
-  std::unordered_map<ActorId, SimpleWaypointPair> vehicles_at_junction_entrance;
+  // Junction end point and safe point found when the vehicle reached a junction entrance.
+  struct JunctionEntrance {
+    bool at_entrance = false;
+    SimpleWaypointPair end_points;
+  };
+  std::unordered_map<ActorId, JunctionEntrance> vehicles_at_junction_entrance;
   RandomGeneratorMap &random_devices;
+  // Parallel update: per-vehicle entries of the maps above are created up front so workers
+  // never insert, and other vehicles' buffers are read as they were at the start of the cycle.
+  bool parallel_update = false;
+  std::unordered_map<ActorId, SimpleWaypointPtr> cycle_start_front;
+  // Times each vehicle was marked for removal during a parallel update.
+  std::unordered_map<ActorId, unsigned> removal_marks;
+
+  // Front waypoint of a vehicle's buffer, nullptr if it has none.
+  SimpleWaypointPtr GetFrontWaypoint(const ActorId actor_id) const;
+
+  void MarkForRemoval(const ActorId actor_id);
 
   SimpleWaypointPtr AssignLaneChange(const ActorId actor_id,
                                      const cg::Location vehicle_location,
@@ -78,6 +94,10 @@ public:
 
   void Update(const unsigned long index) override;
 
+  // Bracket the Update calls of a cycle running on several threads.
+  void BeginParallelUpdate();
+  void EndParallelUpdate();
+
   void RemoveActor(const ActorId actor_id) override;
 
   void Reset() override;
@@ -26,8 +26,6 @@ namespace traffic_manager {
   using Actor = carla::SharedPtr<cc::Actor>;
   using ActorId = carla::ActorId;
   using ActorIdSet = std::unordered_set<ActorId>;
-  using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-  using Buffer = std::deque<SimpleWaypointPtr>;
   using GeoGridId = carla::road::JuncId;
   using constants::Map::MAP_RESOLUTION;
   using constants::Map::INV_MAP_RESOLUTION;
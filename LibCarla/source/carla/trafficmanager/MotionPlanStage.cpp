@@ -71,17 +71,17 @@ MotionPlanStage::MotionPlanStage(
 
 void MotionPlanStage::Update(const unsigned long index) {
   const ActorId actor_id = vehicle_id_list.at(index);
-  const cg::Location vehicle_location = simulation_state.GetLocation(actor_id);
-  const cg::Vector3D vehicle_velocity = simulation_state.GetVelocity(actor_id);
-  const cg::Rotation vehicle_rotation = simulation_state.GetRotation(actor_id);
+  const cg::Location vehicle_location = simulation_state.GetLocations().at(index);
+  const cg::Vector3D vehicle_velocity = simulation_state.GetVelocities().at(index);
+  const cg::Rotation vehicle_rotation = simulation_state.GetRotations().at(index);
   const float vehicle_speed = vehicle_velocity.Length();
-  const cg::Vector3D vehicle_heading = simulation_state.GetHeading(actor_id);
+  const cg::Vector3D vehicle_heading = simulation_state.GetHeadings().at(index);
   const bool vehicle_physics_enabled = simulation_state.IsPhysicsEnabled(actor_id);
   const Buffer &waypoint_buffer = buffer_map.at(actor_id);
   const LocalizationData &localization = localization_frame.at(index);
   const CollisionHazardData &collision_hazard = collision_frame.at(index);
   const bool &tl_hazard = tl_frame.at(index);
-  current_timestamp = world.GetSnapshot().GetTimestamp();
+  const cc::Timestamp current_timestamp = world.GetSnapshot().GetTimestamp();
   StateEntry current_state;
 
   // Instanciating teleportation transform as current vehicle transform.
@@ -98,9 +98,7 @@ void MotionPlanStage::Update(const unsigned long index) {
                     0.0f};
 
     // Add entry to teleportation duration clock table if not present.
-    if (teleportation_instance.find(actor_id) == teleportation_instance.end()) {
-      teleportation_instance.insert({actor_id, current_timestamp});
-    }
+    const cc::Timestamp last_teleportation = GetTeleportationInstance(index, actor_id, current_timestamp);
 
     // Get lower and upper bound for teleporting vehicle.
     float lower_bound = parameters.GetLowerBoundaryRespawnDormantVehicles();
@@ -108,24 +106,20 @@ void MotionPlanStage::Update(const unsigned long index) {
     float dilate_factor = (upper_bound-lower_bound)/100.0f;
 
     // Measuring time elapsed since last teleportation for the vehicle.
-    double elapsed_time = current_timestamp.elapsed_seconds - teleportation_instance.at(actor_id).elapsed_seconds;
+    double elapsed_time = current_timestamp.elapsed_seconds - last_teleportation.elapsed_seconds;
 
+    output_array.at(index) = carla::rpc::Command::ApplyTransform(actor_id, teleportation_transform);
     if (parameters.GetSynchronousMode() || elapsed_time > HYBRID_MODE_DT) {
       float random_sample = (static_cast<float>(random_devices.at(actor_id).next())*dilate_factor) + lower_bound;
       NodeList teleport_waypoint_list = local_map->GetWaypointsInDelta(hero_location, ATTEMPTS_TO_TELEPORT, random_sample);
-      if (!teleport_waypoint_list.empty()) {
-        for (auto &teleport_waypoint : teleport_waypoint_list) {
-          GeoGridId geogrid_id = teleport_waypoint->GetGeodesicGridId();
-          if (track_traffic.IsGeoGridFree(geogrid_id)) {
-            teleportation_transform = teleport_waypoint->GetTransform();
-            teleportation_transform.location.z += 0.5f;
-            track_traffic.AddTakenGrid(geogrid_id, actor_id);
-            break;
-          }
-        }
+      if (parallel_update) {
+        PendingUpdate &pending = pending_updates.at(index);
+        pending.respawn = true;
+        pending.respawn_candidates = std::move(teleport_waypoint_list);
+      } else {
+        Respawn(index, actor_id, teleport_waypoint_list);
       }
     }
-    output_array.at(index) = carla::rpc::Command::ApplyTransform(actor_id, teleportation_transform);
   }
 
   else {
@@ -168,16 +162,13 @@ void MotionPlanStage::Update(const unsigned long index) {
       }
       const float angular_deviation = dot_product;
       const float velocity_deviation = (dynamic_target_velocity - vehicle_speed) / dynamic_target_velocity;
-      // If previous state for vehicle not found, initialize state entry.
-      if (pid_state_map.find(actor_id) == pid_state_map.end()) {
-        const auto initial_state = StateEntry{current_timestamp, 0.0f, 0.0f, 0.0f};
-        pid_state_map.insert({actor_id, initial_state});
+      // Retrieving the previous state, if not found use an initial state.
+      traffic_manager::StateEntry previous_state = StateEntry{current_timestamp, 0.0f, 0.0f, 0.0f};
+      auto previous_state_entry = pid_state_map.find(actor_id);
+      if (previous_state_entry != pid_state_map.end()) {
+        previous_state = previous_state_entry->second;
       }
 
-      // Retrieving the previous state.
-      traffic_manager::StateEntry previous_state;
-      previous_state = pid_state_map.at(actor_id);
-
       // Select PID parameters.
       std::vector<float> longitudinal_parameters;
       std::vector<float> lateral_parameters;
@@ -213,8 +204,7 @@ void MotionPlanStage::Update(const unsigned long index) {
 
       // Updating PID state.
       current_state.steer = actuation_signal.steer;
-      StateEntry &state = pid_state_map.at(actor_id);
-      state = current_state;
+      SetPidState(index, actor_id, current_state);
 
     }
     // For physics-less vehicles, determine position and orientation for teleportation.
@@ -225,12 +215,10 @@ void MotionPlanStage::Update(const unsigned long index) {
                       0.0f};
 
       // Add entry to teleportation duration clock table if not present.
-      if (teleportation_instance.find(actor_id) == teleportation_instance.end()) {
-        teleportation_instance.insert({actor_id, current_timestamp});
-      }
+      const cc::Timestamp last_teleportation = GetTeleportationInstance(index, actor_id, current_timestamp);
 
       // Measuring time elapsed since last teleportation for the vehicle.
-      double elapsed_time = current_timestamp.elapsed_seconds - teleportation_instance.at(actor_id).elapsed_seconds;
+      double elapsed_time = current_timestamp.elapsed_seconds - last_teleportation.elapsed_seconds;
 
       // Find a location ahead of the vehicle for teleportation to achieve intended velocity.
       if (!emergency_stop && (parameters.GetSynchronousMode() || elapsed_time > HYBRID_MODE_DT)) {
@@ -254,7 +242,7 @@ void MotionPlanStage::Update(const unsigned long index) {
       // In case of an emergency stop, stay in the same location.
       // Also, teleport only once every dt in asynchronous mode.
       } else {
-        teleportation_transform = cg::Transform(vehicle_location, simulation_state.GetRotation(actor_id));
+        teleportation_transform = cg::Transform(vehicle_location, vehicle_rotation);
       }
       // Constructing the actuation signal.
       output_array.at(index) = carla::rpc::Command::ApplyTransform(actor_id, teleportation_transform);
@@ -262,6 +250,68 @@ void MotionPlanStage::Update(const unsigned long index) {
   }
 }
 
+void MotionPlanStage::SetPidState(const unsigned long index, const ActorId actor_id, const StateEntry &state) {
+  if (parallel_update) {
+    PendingUpdate &pending = pending_updates.at(index);
+    pending.update_pid_state = true;
+    pending.pid_state = state;
+  } else {
+    pid_state_map[actor_id] = state;
+  }
+}
+
+cc::Timestamp MotionPlanStage::GetTeleportationInstance(const unsigned long index, const ActorId actor_id,
+                                                        const cc::Timestamp &timestamp) {
+  auto instance = teleportation_instance.find(actor_id);
+  if (instance != teleportation_instance.end()) {
+    return instance->second;
+  }
+  if (parallel_update) {
+    PendingUpdate &pending = pending_updates.at(index);
+    pending.insert_teleportation_instance = true;
+    pending.teleportation_instance = timestamp;
+  } else {
+    teleportation_instance.insert({actor_id, timestamp});
+  }
+  return timestamp;
+}
+
+void MotionPlanStage::Respawn(const unsigned long index, const ActorId actor_id, const NodeList &candidates) {
+  for (auto &teleport_waypoint : candidates) {
+    const cg::Location teleport_location = teleport_waypoint->GetLocation();
+    if (track_traffic.IsLocationFree(teleport_location)) {
+      cg::Transform teleportation_transform = teleport_waypoint->GetTransform();
+      teleportation_transform.location.z += 0.5f;
+      track_traffic.TakeLocation(actor_id, teleport_location);
+      output_array.at(index) = carla::rpc::Command::ApplyTransform(actor_id, teleportation_transform);
+      break;
+    }
+  }
+}
+
+void MotionPlanStage::BeginParallelUpdate() {
+  pending_updates.assign(vehicle_id_list.size(), PendingUpdate());
+  parallel_update = true;
+}
+
+void MotionPlanStage::EndParallelUpdate() {
+  parallel_update = false;
+  for (unsigned long index = 0u; index < pending_updates.size(); ++index) {
+    const PendingUpdate &pending = pending_updates.at(index);
+    const ActorId actor_id = vehicle_id_list.at(index);
+    if (pending.update_pid_state) {
+      pid_state_map[actor_id] = pending.pid_state;
+    }
+    if (pending.insert_teleportation_instance) {
+      teleportation_instance.insert({actor_id, pending.teleportation_instance});
+    }
+    if (pending.respawn) {
+      Respawn(index, actor_id, pending.respawn_candidates);
+    }
+  }
+  pending_updates.clear();
+}
+
 bool MotionPlanStage::SafeAfterJunction(const LocalizationData &localization,
                                         const bool tl_hazard,
                                         const bool collision_emergency_stop) {
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "carla/trafficmanager/DataStructures.h"
 #include "carla/trafficmanager/InMemoryMap.h"
 #include "carla/trafficmanager/LocalizationUtils.h"
@@ -41,7 +43,19 @@ private:
   // in hybrid physics mode.
   std::unordered_map<ActorId, cc::Timestamp> teleportation_instance;
   ControlFrame &output_array;
-  cc::Timestamp current_timestamp;
+  // State changes of a vehicle during a parallel update, applied in vehicle order by EndParallelUpdate.
+  // Respawn locations of dormant vehicles are chosen there too as they depend on the locations taken
+  // by the vehicles before them.
+  struct PendingUpdate {
+    bool update_pid_state = false;
+    StateEntry pid_state;
+    bool insert_teleportation_instance = false;
+    cc::Timestamp teleportation_instance;
+    bool respawn = false;
+    NodeList respawn_candidates;
+  };
+  std::vector<PendingUpdate> pending_updates;
+  bool parallel_update = false;
   RandomGeneratorMap &random_devices;
   const LocalMapPtr &local_map;
   TLMap tl_map;
@@ -64,6 +78,15 @@ private:
   float GetTurnTargetVelocity(const Buffer &waypoint_buffer,
                               float max_target_velocity);
 
+  void SetPidState(const unsigned long index, const ActorId actor_id, const StateEntry &state);
+
+  // Timestamp of the vehicle's last teleportation, inserting timestamp if there is none.
+  cc::Timestamp GetTeleportationInstance(const unsigned long index, const ActorId actor_id,
+                                         const cc::Timestamp &timestamp);
+
+  // Moves a dormant vehicle to the first free grid among the candidates around the hero.
+  void Respawn(const unsigned long index, const ActorId actor_id, const NodeList &candidates);
+
   float GetThreePointCircleRadius(cg::Location first_location,
                                   cg::Location middle_location,
                                   cg::Location last_location);
@@ -88,6 +111,10 @@ public:
 
   void Update(const unsigned long index);
 
+  // Bracket the Update calls of a cycle running on several threads.
+  void BeginParallelUpdate();
+  void EndParallelUpdate();
+
   void RemoveActor(const ActorId actor_id);
 
   void Reset();
@@ -172,6 +172,14 @@ void Parameters::SetOSMMode(const bool mode_switch) {
   osm_mode.store(mode_switch);
 }
 
+void Parameters::SetParallelWorkers(const unsigned workers) {
+  parallel_workers.store(workers);
+}
+
+void Parameters::SetFastCollisionGeometry(const bool mode_switch) {
+  fast_collision_geometry.store(mode_switch);
+}
+
 void Parameters::SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
   const auto entry = std::make_pair(actor->GetId(), path);
   custom_path.AddEntry(entry);
@@ -401,6 +409,16 @@ bool Parameters::GetOSMMode() const {
   return osm_mode.load();
 }
 
+unsigned Parameters::GetParallelWorkers() const {
+
+  return parallel_workers.load();
+}
+
+bool Parameters::GetFastCollisionGeometry() const {
+
+  return fast_collision_geometry.load();
+}
+
 bool Parameters::GetUploadPath(const ActorId &actor_id) const {
 
   bool custom_path_bool = false;
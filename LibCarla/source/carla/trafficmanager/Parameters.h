@@ -85,6 +85,10 @@ private:
   std::atomic<float> hybrid_physics_radius {70.0};
   /// Parameter specifying Open Street Map mode.
   std::atomic<bool> osm_mode {true};
+  /// Number of threads running the stages of a cycle (1 is sequential).
+  std::atomic<unsigned> parallel_workers {1u};
+  /// Parameter specifying if the collision stage uses the specialized polygon distance kernel.
+  std::atomic<bool> fast_collision_geometry {true};
   /// Parameter specifying if importing a custom path.
   AtomicMap<ActorId, bool> upload_path;
   /// Structure to hold all custom paths.
@@ -167,6 +171,12 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set the number of threads running the stages.
+  void SetParallelWorkers(const unsigned workers);
+
+  /// Method to set if the collision stage uses the specialized polygon distance kernel.
+  void SetFastCollisionGeometry(const bool mode_switch);
+
   /// Method to set if we are automatically respawning vehicles.
   void SetRespawnDormantVehicles(const bool mode_switch);
 
@@ -259,6 +269,12 @@ public:
   /// Method to get Open Street Map mode.
   bool GetOSMMode() const;
 
+  /// Method to get the number of threads running the stages.
+  unsigned GetParallelWorkers() const;
+
+  /// Method to get if the collision stage uses the specialized polygon distance kernel.
+  bool GetFastCollisionGeometry() const;
+
   /// Method to get if we are uploading a path.
   bool GetUploadPath(const ActorId &actor_id) const;
 
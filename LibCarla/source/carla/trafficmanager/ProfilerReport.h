@@ -0,0 +1,53 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "carla/MsgPack.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Timings of one section of the traffic manager cycle, in milliseconds.
+/// Percentiles come from a log-linear histogram and are accurate to about
+/// 6%; count, total, min and max are exact.
+struct ProfilerSectionReport {
+  std::string name;
+  uint64_t count = 0u;
+  double total = 0.0;
+  double mean = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+  double p50 = 0.0;
+  double p90 = 0.0;
+  double p99 = 0.0;
+
+  MSGPACK_DEFINE_ARRAY(name, count, total, mean, min, max, p50, p90, p99);
+};
+
+/// Event count measured by the profiler, such as the hits of a cache.
+struct ProfilerCounterReport {
+  std::string name;
+  uint64_t value = 0u;
+
+  MSGPACK_DEFINE_ARRAY(name, value);
+};
+
+/// Snapshot of the traffic manager profiler, sent over the RPC as is.
+struct ProfilerReport {
+  bool enabled = false;
+  std::vector<ProfilerSectionReport> sections;
+  std::vector<ProfilerCounterReport> counters;
+
+  MSGPACK_DEFINE_ARRAY(enabled, sections, counters);
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -4,6 +4,7 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
+#include "carla/client/Map.h"
 #include "carla/geom/Math.h"
 
 #include "carla/trafficmanager/SimpleWaypoint.h"
@@ -11,29 +12,76 @@
 namespace carla {
 namespace traffic_manager {
 
-  using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-
-  SimpleWaypoint::SimpleWaypoint(WaypointPtr _waypoint) {
+  SimpleWaypoint::SimpleWaypoint(WaypointPtr _waypoint, WaypointIndex _index) {
     waypoint = _waypoint;
+    index = _index;
     next_left_waypoint = nullptr;
     next_right_waypoint = nullptr;
+    if (waypoint != nullptr) {
+      info.id = waypoint->GetId();
+      info.transform = waypoint->GetTransform();
+      info.road_id = waypoint->GetRoadId();
+      info.section_id = waypoint->GetSectionId();
+      info.lane_id = waypoint->GetLaneId();
+      info.s = static_cast<float>(waypoint->GetDistance());
+      info.junction_id = waypoint->GetJunctionId();
+      info.is_junction_road = waypoint->IsJunction() ? 1u : 0u;
+    }
   }
+
+  SimpleWaypoint::SimpleWaypoint(const cc::Map &_map, const WaypointInfo &_info, WaypointIndex _index)
+    : info(_info),
+      map(&_map),
+      index(_index),
+      next_left_waypoint(nullptr),
+      next_right_waypoint(nullptr) {}
+
   SimpleWaypoint::~SimpleWaypoint() {}
 
-  std::vector<SimpleWaypointPtr> SimpleWaypoint::GetNextWaypoint() const {
+  WaypointSpan SimpleWaypoint::GetNextWaypoint() const {
     return next_waypoints;
   }
 
-  std::vector<SimpleWaypointPtr> SimpleWaypoint::GetPreviousWaypoint() const {
+  WaypointSpan SimpleWaypoint::GetPreviousWaypoint() const {
     return previous_waypoints;
   }
 
   WaypointPtr SimpleWaypoint::GetWaypoint() const {
-    return waypoint;
+    WaypointPtr result = boost::atomic_load(&waypoint);
+    if (result == nullptr && map != nullptr) {
+      // Stages may race to resolve it; they all get an equivalent waypoint.
+      result = map->GetWaypointXODR(info.road_id, info.lane_id, info.s);
+      boost::atomic_store(&waypoint, result);
+    }
+    return result;
+  }
+
+  const WaypointInfo &SimpleWaypoint::GetInfo() const {
+    return info;
+  }
+
+  carla::road::RoadId SimpleWaypoint::GetRoadId() const {
+    return info.road_id;
+  }
+
+  carla::road::SectionId SimpleWaypoint::GetSectionId() const {
+    return info.section_id;
+  }
+
+  carla::road::LaneId SimpleWaypoint::GetLaneId() const {
+    return info.lane_id;
+  }
+
+  float SimpleWaypoint::GetDistance() const {
+    return info.s;
+  }
+
+  WaypointIndex SimpleWaypoint::GetIndex() const {
+    return index;
   }
 
   uint64_t SimpleWaypoint::GetId() const {
-    return waypoint->GetId();
+    return info.id;
   }
 
   SimpleWaypointPtr SimpleWaypoint::GetLeftWaypoint() {
@@ -45,30 +93,21 @@ namespace traffic_manager {
   }
 
   cg::Location SimpleWaypoint::GetLocation() const {
-    return waypoint->GetTransform().location;
+    return info.transform.location;
   }
 
   cg::Vector3D SimpleWaypoint::GetForwardVector() const {
-    return waypoint->GetTransform().rotation.GetForwardVector();
+    return info.transform.rotation.GetForwardVector();
   }
 
-  uint64_t SimpleWaypoint::SetNextWaypoint(const std::vector<SimpleWaypointPtr> &waypoints) {
-    for (auto &simple_waypoint: waypoints) {
-      next_waypoints.push_back(simple_waypoint);
-    }
-    return static_cast<uint64_t>(waypoints.size());
-  }
-
-  uint64_t SimpleWaypoint::SetPreviousWaypoint(const std::vector<SimpleWaypointPtr> &waypoints) {
-    for (auto &simple_waypoint: waypoints) {
-      previous_waypoints.push_back(simple_waypoint);
-    }
-    return static_cast<uint64_t>(waypoints.size());
+  void SimpleWaypoint::SetLinks(WaypointSpan _next_waypoints, WaypointSpan _previous_waypoints) {
+    next_waypoints = _next_waypoints;
+    previous_waypoints = _previous_waypoints;
   }
 
   void SimpleWaypoint::SetLeftWaypoint(SimpleWaypointPtr &_waypoint) {
 
-    const cg::Vector3D heading_vector = waypoint->GetTransform().GetForwardVector();
+    const cg::Vector3D heading_vector = info.transform.GetForwardVector();
     const cg::Vector3D relative_vector = GetLocation() - _waypoint->GetLocation();
     if ((heading_vector.x * relative_vector.y - heading_vector.y * relative_vector.x) > 0.0f) {
       next_left_waypoint = _waypoint;
@@ -77,7 +116,7 @@ namespace traffic_manager {
 
   void SimpleWaypoint::SetRightWaypoint(SimpleWaypointPtr &_waypoint) {
 
-    const cg::Vector3D heading_vector = waypoint->GetTransform().GetForwardVector();
+    const cg::Vector3D heading_vector = info.transform.GetForwardVector();
     const cg::Vector3D relative_vector = GetLocation() - _waypoint->GetLocation();
     if ((heading_vector.x * relative_vector.y - heading_vector.y * relative_vector.x) < 0.0f) {
       next_right_waypoint = _waypoint;
@@ -118,8 +157,8 @@ namespace traffic_manager {
 
   GeoGridId SimpleWaypoint::GetGeodesicGridId() {
     GeoGridId grid_id;
-    if (waypoint->IsJunction()) {
-      grid_id = waypoint->GetJunctionId();
+    if (info.is_junction_road != 0u) {
+      grid_id = info.junction_id;
     } else {
       grid_id = geodesic_grid_id;
     }
@@ -127,11 +166,11 @@ namespace traffic_manager {
   }
 
   GeoGridId SimpleWaypoint::GetJunctionId() const {
-    return waypoint->GetJunctionId();
+    return info.junction_id;
   }
 
   cg::Transform SimpleWaypoint::GetTransform() const {
-    return waypoint->GetTransform();
+    return info.transform;
   }
 
   void SimpleWaypoint::SetRoadOption(RoadOption _road_option) {
@@ -7,7 +7,11 @@
 #pragma once
 
 #include <memory.h>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
 
+#include "carla/Exception.h"
 #include "carla/client/Waypoint.h"
 #include "carla/geom/Location.h"
 #include "carla/geom/Transform.h"
@@ -16,6 +20,9 @@
 #include "carla/road/RoadTypes.h"
 
 namespace carla {
+namespace client {
+  class Map;
+} // namespace client
 namespace traffic_manager {
 
   namespace cc = carla::client;
@@ -33,20 +40,111 @@ namespace traffic_manager {
     RoadEnd = 7
   };
 
+  class SimpleWaypoint;
+
+  /// Non-owning handle to a waypoint. All simple waypoints are owned by the
+  /// InMemoryMap and stay valid for as long as the map is alive.
+  using SimpleWaypointPtr = SimpleWaypoint *;
+
+  /// Position of a waypoint in the InMemoryMap's waypoint arena.
+  using WaypointIndex = uint32_t;
+
+  /// OpenDRIVE identity and pose of a waypoint. This is all the stages read
+  /// from the waypoint, so Carla's waypoint object only has to be resolved
+  /// when any other attribute is requested. It is trivially copyable and
+  /// stored as is in the map cache.
+  struct WaypointInfo {
+    uint64_t id = 0u;
+    cg::Transform transform;
+    uint32_t road_id = 0u;
+    uint32_t section_id = 0u;
+    int32_t lane_id = 0;
+    float s = 0.0f;
+    int32_t junction_id = -1;
+    /// Whether the OpenDRIVE road belongs to a junction.
+    uint8_t is_junction_road = 0u;
+    uint8_t padding[3u] = {0u, 0u, 0u};
+  };
+
+  static_assert(sizeof(WaypointInfo) == 56u, "WaypointInfo layout is part of the map cache format.");
+
+  /// Read-only view over a contiguous list of waypoints.
+  class WaypointSpan {
+  public:
+
+    using const_iterator = const SimpleWaypointPtr *;
+
+    WaypointSpan() = default;
+
+    WaypointSpan(const SimpleWaypointPtr *data, size_t size)
+      : _data(data),
+        _size(size) {}
+
+    WaypointSpan(const std::vector<SimpleWaypointPtr> &waypoints)
+      : _data(waypoints.data()),
+        _size(waypoints.size()) {}
+
+    const_iterator begin() const {
+      return _data;
+    }
+
+    const_iterator end() const {
+      return _data + _size;
+    }
+
+    size_t size() const {
+      return _size;
+    }
+
+    bool empty() const {
+      return _size == 0u;
+    }
+
+    SimpleWaypointPtr front() const {
+      return _data[0u];
+    }
+
+    SimpleWaypointPtr back() const {
+      return _data[_size - 1u];
+    }
+
+    SimpleWaypointPtr operator[](size_t pos) const {
+      return _data[pos];
+    }
+
+    SimpleWaypointPtr at(size_t pos) const {
+      if (pos >= _size) {
+        throw_exception(std::out_of_range("waypoint span index out of range"));
+      }
+      return _data[pos];
+    }
+
+  private:
+
+    const SimpleWaypointPtr *_data = nullptr;
+
+    size_t _size = 0u;
+  };
+
   /// This is a simple wrapper class on Carla's waypoint object.
   /// The class is used to represent discrete samples of the world map.
   class SimpleWaypoint {
 
-    using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-
   private:
 
+    /// Identity and pose of Carla's waypoint object.
+    WaypointInfo info;
     /// Pointer to Carla's waypoint object around which this class wraps around.
-    WaypointPtr waypoint;
-    /// List of pointers to next connecting waypoints.
-    std::vector<SimpleWaypointPtr> next_waypoints;
-    /// List of pointers to previous connecting waypoints.
-    std::vector<SimpleWaypointPtr> previous_waypoints;
+    /// Waypoints loaded from a map cache resolve it on first use.
+    mutable WaypointPtr waypoint;
+    /// Map used to resolve the waypoint object, null if it was given.
+    const cc::Map *map = nullptr;
+    /// Position of this waypoint in the map's waypoint arena.
+    WaypointIndex index;
+    /// Next connecting waypoints, stored in the map's link list.
+    WaypointSpan next_waypoints;
+    /// Previous connecting waypoints, stored in the map's link list.
+    WaypointSpan previous_waypoints;
     /// Pointer to left lane change waypoint.
     SimpleWaypointPtr next_left_waypoint;
     /// Pointer to right lane change waypoint.
@@ -60,7 +158,10 @@ namespace traffic_manager {
 
   public:
 
-    SimpleWaypoint(WaypointPtr _waypoint);
+    SimpleWaypoint(WaypointPtr _waypoint, WaypointIndex _index);
+    /// Waypoint described by its info only, the waypoint object is resolved
+    /// against _map if it is ever requested.
+    SimpleWaypoint(const cc::Map &_map, const WaypointInfo &_info, WaypointIndex _index);
     ~SimpleWaypoint();
 
     /// Returns the location object for this waypoint.
@@ -69,11 +170,23 @@ namespace traffic_manager {
     /// Returns a carla::shared_ptr to carla::waypoint.
     WaypointPtr GetWaypoint() const;
 
+    /// Returns the identity and pose of the waypoint.
+    const WaypointInfo &GetInfo() const;
+
+    /// Accessors for the OpenDRIVE identity of the waypoint.
+    carla::road::RoadId GetRoadId() const;
+    carla::road::SectionId GetSectionId() const;
+    carla::road::LaneId GetLaneId() const;
+    float GetDistance() const;
+
+    /// Returns the position of this waypoint in the map's waypoint arena.
+    WaypointIndex GetIndex() const;
+
     /// Returns the list of next waypoints.
-    std::vector<SimpleWaypointPtr> GetNextWaypoint() const;
+    WaypointSpan GetNextWaypoint() const;
 
     /// Returns the list of previous waypoints.
-    std::vector<SimpleWaypointPtr> GetPreviousWaypoint() const;
+    WaypointSpan GetPreviousWaypoint() const;
 
     /// Returns the vector along the waypoint's direction.
     cg::Vector3D GetForwardVector() const;
@@ -81,11 +194,9 @@ namespace traffic_manager {
     /// Returns the unique id for the waypoint.
     uint64_t GetId() const;
 
-    /// This method is used to set the next waypoints.
-    uint64_t SetNextWaypoint(const std::vector<SimpleWaypointPtr> &next_waypoints);
-
-    /// This method is used to set the previous waypoints.
-    uint64_t SetPreviousWaypoint(const std::vector<SimpleWaypointPtr> &next_waypoints);
+    /// This method is used to set the next and previous waypoints. The
+    /// spans must outlive the waypoint.
+    void SetLinks(WaypointSpan _next_waypoints, WaypointSpan _previous_waypoints);
 
     /// This method is used to set the closest left waypoint for a lane change.
     void SetLeftWaypoint(SimpleWaypointPtr &waypoint);
@@ -6,81 +6,190 @@ namespace traffic_manager {
 
 SimulationState::SimulationState() {}
 
+unsigned long SimulationState::AddSlot(ActorId actor_id, bool occupied) {
+  const unsigned long slot = slot_actor.size();
+  slot_actor.push_back(actor_id);
+  slot_occupied.push_back(occupied);
+  locations.emplace_back();
+  rotations.emplace_back();
+  headings.emplace_back();
+  velocities.emplace_back();
+  speed_limits.push_back(0.0f);
+  physics_enabled.push_back(false);
+  dormant.push_back(false);
+  tl_states.push_back({TLS::Unknown, false});
+  actor_types.push_back(ActorType::Any);
+  dimensions.emplace_back();
+  if (occupied) {
+    actor_index.insert({actor_id, slot});
+  }
+  return slot;
+}
+
+void SimulationState::SwapSlots(unsigned long first, unsigned long second) {
+  if (first == second) {
+    return;
+  }
+  std::swap(slot_actor[first], slot_actor[second]);
+  std::swap(slot_occupied[first], slot_occupied[second]);
+  std::swap(locations[first], locations[second]);
+  std::swap(rotations[first], rotations[second]);
+  std::swap(headings[first], headings[second]);
+  std::swap(velocities[first], velocities[second]);
+  std::swap(speed_limits[first], speed_limits[second]);
+  std::swap(physics_enabled[first], physics_enabled[second]);
+  std::swap(dormant[first], dormant[second]);
+  std::swap(tl_states[first], tl_states[second]);
+  std::swap(actor_types[first], actor_types[second]);
+  std::swap(dimensions[first], dimensions[second]);
+  if (slot_occupied[first]) {
+    actor_index.at(slot_actor[first]) = first;
+  }
+  if (slot_occupied[second]) {
+    actor_index.at(slot_actor[second]) = second;
+  }
+}
+
+void SimulationState::RemoveSlot(unsigned long slot) {
+  // Swap with the last slot and drop it.
+  SwapSlots(slot, slot_actor.size() - 1u);
+  if (slot_occupied.back()) {
+    actor_index.erase(slot_actor.back());
+  }
+  slot_actor.pop_back();
+  slot_occupied.pop_back();
+  locations.pop_back();
+  rotations.pop_back();
+  headings.pop_back();
+  velocities.pop_back();
+  speed_limits.pop_back();
+  physics_enabled.pop_back();
+  dormant.pop_back();
+  tl_states.pop_back();
+  actor_types.pop_back();
+  dimensions.pop_back();
+}
+
+void SimulationState::SetKinematicState(unsigned long slot, const KinematicState &state) {
+  locations[slot] = state.location;
+  rotations[slot] = state.rotation;
+  // Computed once here instead of at every query.
+  headings[slot] = state.rotation.GetForwardVector();
+  velocities[slot] = state.velocity;
+  speed_limits[slot] = state.speed_limit;
+  physics_enabled[slot] = state.physics_enabled;
+  dormant[slot] = state.is_dormant;
+}
+
 void SimulationState::AddActor(ActorId actor_id,
                                KinematicState kinematic_state,
                                StaticAttributes attributes,
                                TrafficLightState tl_state) {
-  actor_set.insert(actor_id);
-  kinematic_state_map.insert({actor_id, kinematic_state});
-  static_attribute_map.insert({actor_id, attributes});
-  tl_state_map.insert({actor_id, tl_state});
+  if (ContainsActor(actor_id)) {
+    return;
+  }
+  const unsigned long slot = AddSlot(actor_id, true);
+  SetKinematicState(slot, kinematic_state);
+  tl_states[slot] = tl_state;
+  actor_types[slot] = attributes.actor_type;
+  dimensions[slot] = cg::Vector3D(attributes.half_length, attributes.half_width, attributes.half_height);
 }
 
 bool SimulationState::ContainsActor(ActorId actor_id) const {
-  return actor_set.find(actor_id) != actor_set.end();
+  return actor_index.find(actor_id) != actor_index.end();
 }
 
 void SimulationState::RemoveActor(ActorId actor_id) {
-  actor_set.erase(actor_id);
-  kinematic_state_map.erase(actor_id);
-  static_attribute_map.erase(actor_id);
-  tl_state_map.erase(actor_id);
+  auto slot = actor_index.find(actor_id);
+  if (slot != actor_index.end()) {
+    RemoveSlot(slot->second);
+  }
 }
 
 void SimulationState::Reset() {
-  actor_set.clear();
-  kinematic_state_map.clear();
-  static_attribute_map.clear();
-  tl_state_map.clear();
+  actor_index.clear();
+  slot_actor.clear();
+  slot_occupied.clear();
+  locations.clear();
+  rotations.clear();
+  headings.clear();
+  velocities.clear();
+  speed_limits.clear();
+  physics_enabled.clear();
+  dormant.clear();
+  tl_states.clear();
+  actor_types.clear();
+  dimensions.clear();
+}
+
+void SimulationState::AlignVehicles(const std::vector<ActorId> &vehicle_id_list) {
+  // Drop the vacant slots of the previous alignment.
+  for (unsigned long slot = slot_actor.size(); slot > 0u; --slot) {
+    if (!slot_occupied[slot - 1u]) {
+      RemoveSlot(slot - 1u);
+    }
+  }
+
+  for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+    const ActorId actor_id = vehicle_id_list[index];
+    if (index < slot_actor.size() && slot_occupied[index] && slot_actor[index] == actor_id) {
+      continue;
+    }
+    auto slot = actor_index.find(actor_id);
+    if (slot != actor_index.end()) {
+      SwapSlots(index, slot->second);
+    } else {
+      SwapSlots(index, AddSlot(actor_id, false));
+    }
+  }
 }
 
 void SimulationState::UpdateKinematicState(ActorId actor_id, KinematicState state) {
-  kinematic_state_map.at(actor_id) = state;
+  SetKinematicState(actor_index.at(actor_id), state);
 }
 
 void SimulationState::UpdateTrafficLightState(ActorId actor_id, TrafficLightState state) {
-  tl_state_map.at(actor_id) = state;
+  tl_states[actor_index.at(actor_id)] = state;
 }
 
 cg::Location SimulationState::GetLocation(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).location;
+  return locations[actor_index.at(actor_id)];
 }
 
 cg::Rotation SimulationState::GetRotation(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).rotation;
+  return rotations[actor_index.at(actor_id)];
 }
 
 cg::Vector3D SimulationState::GetHeading(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).rotation.GetForwardVector();
+  return headings[actor_index.at(actor_id)];
 }
 
 cg::Vector3D SimulationState::GetVelocity(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).velocity;
+  return velocities[actor_index.at(actor_id)];
 }
 
 float SimulationState::GetSpeedLimit(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).speed_limit;
+  return speed_limits[actor_index.at(actor_id)];
 }
 
 bool SimulationState::IsPhysicsEnabled(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).physics_enabled;
+  return physics_enabled[actor_index.at(actor_id)] != 0u;
 }
 
 bool SimulationState::IsDormant(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).is_dormant;
+  return dormant[actor_index.at(actor_id)] != 0u;
 }
 
 TrafficLightState SimulationState::GetTLS(ActorId actor_id) const {
-  return tl_state_map.at(actor_id);
+  return tl_states[actor_index.at(actor_id)];
 }
 
 ActorType SimulationState::GetType(ActorId actor_id) const {
-  return static_attribute_map.at(actor_id).actor_type;
+  return actor_types[actor_index.at(actor_id)];
 }
 
 cg::Vector3D SimulationState::GetDimensions(ActorId actor_id) const {
-  const StaticAttributes &attributes = static_attribute_map.at(actor_id);
-  return cg::Vector3D(attributes.half_length, attributes.half_width, attributes.half_height);
+  return dimensions[actor_index.at(actor_id)];
 }
 
 } // namespace  traffic_manager
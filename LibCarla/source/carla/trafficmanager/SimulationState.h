@@ -1,7 +1,8 @@
 
 #pragma once
 
-#include <unordered_set>
+#include <unordered_map>
+#include <vector>
 
 #include "carla/trafficmanager/DataStructures.h"
 
@@ -39,17 +40,37 @@ struct StaticAttributes {
 using StaticAttributeMap = std::unordered_map<ActorId, StaticAttributes>;
 
 /// This class holds the state of all the vehicles in the simlation.
+/// The state is stored as a structure of arrays with one slot per actor. After
+/// AlignVehicles the registered vehicles occupy the first slots in the order of
+/// the traffic manager's vehicle list, so the stages can read the arrays with
+/// their vehicle index instead of looking the actor up.
 class SimulationState {
 
 private:
-  // Structure to hold ids of all actors in the simulation.
-  std::unordered_set<ActorId> actor_set;
-  // Structure containing dynamic motion related state of actors.
-  KinematicStateMap kinematic_state_map;
-  // Structure containing static attributes of actors.
-  StaticAttributeMap static_attribute_map;
-  // Structure containing dynamic traffic light related state of actors.
-  TrafficLightStateMap tl_state_map;
+  // Slot of every actor in the simulation.
+  std::unordered_map<ActorId, unsigned long> actor_index;
+  // Actor of every slot. Slots of registered vehicles missing from the state
+  // are kept vacant so that the following vehicles stay aligned.
+  std::vector<ActorId> slot_actor;
+  std::vector<uint8_t> slot_occupied;
+  // Dynamic motion related state of actors.
+  std::vector<cg::Location> locations;
+  std::vector<cg::Rotation> rotations;
+  std::vector<cg::Vector3D> headings;
+  std::vector<cg::Vector3D> velocities;
+  std::vector<float> speed_limits;
+  std::vector<uint8_t> physics_enabled;
+  std::vector<uint8_t> dormant;
+  // Dynamic traffic light related state of actors.
+  std::vector<TrafficLightState> tl_states;
+  // Static attributes of actors.
+  std::vector<ActorType> actor_types;
+  std::vector<cg::Vector3D> dimensions;
+
+  unsigned long AddSlot(ActorId actor_id, bool occupied);
+  void SwapSlots(unsigned long first, unsigned long second);
+  void RemoveSlot(unsigned long slot);
+  void SetKinematicState(unsigned long slot, const KinematicState &state);
 
 public :
   SimulationState();
@@ -69,6 +90,10 @@ public :
   // Method to flush all states and actors.
   void Reset();
 
+  // Method to move the given vehicles to the first slots, in the same order.
+  // Adding or removing actors afterwards breaks the alignment.
+  void AlignVehicles(const std::vector<ActorId> &vehicle_id_list);
+
   void UpdateKinematicState(ActorId actor_id, KinematicState state);
 
   void UpdateTrafficLightState(ActorId actor_id, TrafficLightState state);
@@ -95,6 +120,29 @@ public :
 
   cg::Vector3D GetDimensions(const ActorId actor_id) const;
 
+  // Per slot arrays, indexed by vehicle index after AlignVehicles. Only valid
+  // for a vehicle contained in the state.
+  const std::vector<cg::Location> &GetLocations() const {
+    return locations;
+  }
+
+  const std::vector<cg::Rotation> &GetRotations() const {
+    return rotations;
+  }
+
+  const std::vector<cg::Vector3D> &GetHeadings() const {
+    return headings;
+  }
+
+  const std::vector<cg::Vector3D> &GetVelocities() const {
+    return velocities;
+  }
+
+  // Half length, width and height of the actors, as GetDimensions.
+  const std::vector<cg::Vector3D> &GetAllDimensions() const {
+    return dimensions;
+  }
+
 };
 
 } // namespace traffic_manager
@@ -0,0 +1,303 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+#include "carla/trafficmanager/StageProfiler.h"
+
+namespace carla {
+namespace traffic_manager {
+
+constexpr size_t StageProfiler::SECTION_COUNT;
+constexpr size_t StageProfiler::COUNTER_COUNT;
+constexpr size_t StageProfiler::SUB_BUCKETS;
+constexpr size_t StageProfiler::BUCKET_COUNT;
+constexpr size_t StageProfiler::TRACE_CAPACITY;
+
+namespace {
+
+  /// Single writer update, cheaper than a read-modify-write.
+  void Store(std::atomic<uint64_t> &value, const uint64_t new_value) {
+    value.store(new_value, std::memory_order_relaxed);
+  }
+
+  uint64_t Load(const std::atomic<uint64_t> &value) {
+    return value.load(std::memory_order_relaxed);
+  }
+
+  double ToMilliseconds(const double nanoseconds) {
+    return 1e-6 * nanoseconds;
+  }
+
+} // namespace
+
+StageProfiler::StageProfiler() : epoch(Clock::now()) {
+  for (auto &counter : counters) {
+    Store(counter, 0u);
+  }
+}
+
+StageProfiler::~StageProfiler() {}
+
+const char *StageProfiler::GetSectionName(const ProfiledSection section) {
+  switch (section) {
+    case ProfiledSection::Cycle:               return "cycle";
+    case ProfiledSection::StepBeginWait:       return "step_begin_wait";
+    case ProfiledSection::ActorUpdate:         return "actor_update";
+    case ProfiledSection::Localization:        return "localization";
+    case ProfiledSection::Collision:           return "collision";
+    case ProfiledSection::WorldInfo:           return "world_info";
+    case ProfiledSection::TrafficLight:        return "traffic_light";
+    case ProfiledSection::MotionPlan:          return "motion_plan";
+    case ProfiledSection::VehicleLight:        return "vehicle_light";
+    case ProfiledSection::Planning:            return "planning";
+    case ProfiledSection::BatchSend:           return "batch_send";
+    case ProfiledSection::LocalizationVehicle: return "localization_vehicle";
+    case ProfiledSection::CollisionVehicle:    return "collision_vehicle";
+    case ProfiledSection::TrafficLightVehicle: return "traffic_light_vehicle";
+    case ProfiledSection::MotionPlanVehicle:   return "motion_plan_vehicle";
+    case ProfiledSection::VehicleLightVehicle: return "vehicle_light_vehicle";
+    default:                                   return "unknown";
+  }
+}
+
+const char *StageProfiler::GetCounterName(const ProfiledCounter counter) {
+  switch (counter) {
+    case ProfiledCounter::CollisionGeometryHits:          return "collision_geometry_cache_hits";
+    case ProfiledCounter::CollisionGeometryMisses:        return "collision_geometry_cache_misses";
+    case ProfiledCounter::CollisionGeometryInvalidations: return "collision_geometry_cache_invalidations";
+    case ProfiledCounter::CollisionGeometryEvictions:     return "collision_geometry_cache_evictions";
+    case ProfiledCounter::CollisionGeometryEntries:       return "collision_geometry_cache_entries";
+    default:                                              return "unknown";
+  }
+}
+
+void StageProfiler::SetEnabled(const bool enable) {
+  enabled.store(enable);
+}
+
+void StageProfiler::Reset() {
+  reset_requested.store(true);
+}
+
+void StageProfiler::BeginCycle(const unsigned number_of_workers) {
+  if (reset_requested.exchange(false)) {
+    std::lock_guard<std::mutex> lock(workers_mutex);
+    for (auto &statistics : workers) {
+      Clear(*statistics);
+    }
+    for (auto &counter : counters) {
+      Store(counter, 0u);
+    }
+    std::lock_guard<std::mutex> trace_lock(trace_mutex);
+    trace.clear();
+    trace_next = 0u;
+    cycle_events.clear();
+  }
+
+  if (!cycle_events.empty()) {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    for (const TraceEvent &event : cycle_events) {
+      if (trace.size() < TRACE_CAPACITY) {
+        trace.push_back(event);
+      } else {
+        trace[trace_next] = event;
+      }
+      trace_next = (trace_next + 1u) % TRACE_CAPACITY;
+    }
+    cycle_events.clear();
+  }
+
+  active = enabled.load();
+  if (!active) {
+    return;
+  }
+  ++cycle;
+  if (workers.size() < number_of_workers) {
+    std::lock_guard<std::mutex> lock(workers_mutex);
+    while (workers.size() < number_of_workers) {
+      workers.emplace_back(std::make_unique<WorkerStatistics>());
+      Clear(*workers.back());
+    }
+  }
+}
+
+void StageProfiler::Record(
+    const ProfiledSection section,
+    const TimePoint begin,
+    const TimePoint end,
+    const unsigned worker) {
+  if (!active) {
+    return;
+  }
+  const uint64_t nanoseconds = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+  Add(section, nanoseconds, worker);
+  if (worker == 0u && section < ProfiledSection::LocalizationVehicle) {
+    const uint64_t since_epoch = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(begin - epoch).count());
+    cycle_events.push_back(TraceEvent{since_epoch, nanoseconds, cycle, section});
+  }
+}
+
+void StageProfiler::RecordDuration(
+    const ProfiledSection section,
+    const Duration duration,
+    const unsigned worker) {
+  if (active) {
+    Add(section, static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()), worker);
+  }
+}
+
+void StageProfiler::AddCount(const ProfiledCounter counter, const uint64_t value) {
+  if (active) {
+    auto &total = counters[static_cast<size_t>(counter)];
+    Store(total, Load(total) + value);
+  }
+}
+
+void StageProfiler::SetCount(const ProfiledCounter counter, const uint64_t value) {
+  if (active) {
+    Store(counters[static_cast<size_t>(counter)], value);
+  }
+}
+
+void StageProfiler::Add(const ProfiledSection section, const uint64_t nanoseconds, const unsigned worker) {
+  SectionStatistics &statistics = workers[worker]->sections[static_cast<size_t>(section)];
+  Store(statistics.count, Load(statistics.count) + 1u);
+  Store(statistics.total, Load(statistics.total) + nanoseconds);
+  Store(statistics.min, std::min(Load(statistics.min), nanoseconds));
+  Store(statistics.max, std::max(Load(statistics.max), nanoseconds));
+  auto &bucket = statistics.histogram[GetBucket(nanoseconds)];
+  Store(bucket, Load(bucket) + 1u);
+}
+
+size_t StageProfiler::GetBucket(uint64_t nanoseconds) {
+  size_t shift = 0u;
+  while (nanoseconds >= 2u * SUB_BUCKETS) {
+    nanoseconds >>= 1u;
+    ++shift;
+  }
+  return std::min(shift * SUB_BUCKETS + static_cast<size_t>(nanoseconds), BUCKET_COUNT - 1u);
+}
+
+uint64_t StageProfiler::GetBucketLowerBound(const size_t bucket) {
+  if (bucket < 2u * SUB_BUCKETS) {
+    return bucket;
+  }
+  const size_t shift = bucket / SUB_BUCKETS - 1u;
+  return static_cast<uint64_t>(bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+}
+
+void StageProfiler::Clear(WorkerStatistics &statistics) {
+  for (auto &section : statistics.sections) {
+    Store(section.count, 0u);
+    Store(section.total, 0u);
+    Store(section.min, std::numeric_limits<uint64_t>::max());
+    Store(section.max, 0u);
+    for (auto &bucket : section.histogram) {
+      Store(bucket, 0u);
+    }
+  }
+}
+
+ProfilerReport StageProfiler::GetReport() const {
+  ProfilerReport report;
+  report.enabled = IsEnabled();
+  report.sections.resize(SECTION_COUNT);
+  report.counters.resize(COUNTER_COUNT);
+  for (size_t i = 0u; i < COUNTER_COUNT; ++i) {
+    report.counters[i].name = GetCounterName(static_cast<ProfiledCounter>(i));
+    report.counters[i].value = Load(counters[i]);
+  }
+
+  std::lock_guard<std::mutex> lock(workers_mutex);
+  std::array<uint64_t, BUCKET_COUNT> histogram;
+  for (size_t i = 0u; i < SECTION_COUNT; ++i) {
+    ProfilerSectionReport &section = report.sections[i];
+    section.name = GetSectionName(static_cast<ProfiledSection>(i));
+
+    uint64_t total = 0u;
+    uint64_t min = std::numeric_limits<uint64_t>::max();
+    uint64_t max = 0u;
+    histogram.fill(0u);
+    for (const auto &worker : workers) {
+      const SectionStatistics &statistics = worker->sections[i];
+      section.count += Load(statistics.count);
+      total += Load(statistics.total);
+      min = std::min(min, Load(statistics.min));
+      max = std::max(max, Load(statistics.max));
+      for (size_t bucket = 0u; bucket < BUCKET_COUNT; ++bucket) {
+        histogram[bucket] += Load(statistics.histogram[bucket]);
+      }
+    }
+    if (section.count == 0u) {
+      continue;
+    }
+
+    // Workers may be recording, so the histogram can be a few samples ahead
+    // of the count; percentiles are taken over the histogram itself.
+    uint64_t samples = 0u;
+    for (const uint64_t bucket_count : histogram) {
+      samples += bucket_count;
+    }
+    auto percentile = [&](const double fraction) {
+      const uint64_t rank = std::max<uint64_t>(1u,
+          static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(samples))));
+      uint64_t seen = 0u;
+      for (size_t bucket = 0u; bucket < BUCKET_COUNT; ++bucket) {
+        seen += histogram[bucket];
+        if (seen >= rank) {
+          const double middle = 0.5 * static_cast<double>(
+              GetBucketLowerBound(bucket) + GetBucketLowerBound(bucket + 1u));
+          return ToMilliseconds(std::min(std::max(middle, static_cast<double>(min)), static_cast<double>(max)));
+        }
+      }
+      return ToMilliseconds(static_cast<double>(max));
+    };
+
+    section.total = ToMilliseconds(static_cast<double>(total));
+    section.mean = section.total / static_cast<double>(section.count);
+    section.min = ToMilliseconds(static_cast<double>(min));
+    section.max = ToMilliseconds(static_cast<double>(max));
+    section.p50 = percentile(0.50);
+    section.p90 = percentile(0.90);
+    section.p99 = percentile(0.99);
+  }
+  return report;
+}
+
+bool StageProfiler::ExportTrace(const std::string &path) const {
+  std::ofstream out(path, std::ios::trunc);
+  if (!out.good()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(trace_mutex);
+  // Oldest first; the ring starts at trace_next once it is full.
+  const size_t first = trace.size() < TRACE_CAPACITY ? 0u : trace_next;
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  out.precision(3);
+  out << std::fixed;
+  for (size_t i = 0u; i < trace.size(); ++i) {
+    const TraceEvent &event = trace[(first + i) % trace.size()];
+    out << (i == 0u ? "\n" : ",\n")
+        << "{\"name\":\"" << GetSectionName(event.section) << "\""
+        << ",\"cat\":\"traffic_manager\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+        << ",\"ts\":" << 1e-3 * static_cast<double>(event.begin)
+        << ",\"dur\":" << 1e-3 * static_cast<double>(event.duration)
+        << ",\"args\":{\"cycle\":" << event.cycle << "}}";
+  }
+  out << "\n]}\n";
+  return out.good();
+}
+
+} // namespace traffic_manager
+} // namespace carla
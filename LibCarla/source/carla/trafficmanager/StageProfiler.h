@@ -0,0 +1,240 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "carla/NonCopyable.h"
+#include "carla/trafficmanager/ProfilerReport.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Sections of the traffic manager cycle the profiler measures. The ones
+/// before LocalizationVehicle are measured once per cycle on the traffic
+/// manager thread and go to the trace, the rest once per vehicle on the
+/// thread that runs it.
+enum class ProfiledSection : uint8_t {
+  Cycle,
+  StepBeginWait,
+  ActorUpdate,
+  Localization,
+  Collision,
+  /// Weather and light states query of the vehicle light stage.
+  WorldInfo,
+  TrafficLight,
+  MotionPlan,
+  VehicleLight,
+  /// Traffic light, motion plan and vehicle light stages when they run
+  /// interleaved per vehicle, only their sum is a contiguous span.
+  Planning,
+  BatchSend,
+  LocalizationVehicle,
+  CollisionVehicle,
+  TrafficLightVehicle,
+  MotionPlanVehicle,
+  VehicleLightVehicle,
+  Count
+};
+
+/// Counters the profiler reports along with the sections.
+enum class ProfiledCounter : uint8_t {
+  CollisionGeometryHits,
+  CollisionGeometryMisses,
+  CollisionGeometryInvalidations,
+  CollisionGeometryEvictions,
+  /// Set rather than added to, entries kept at the end of the last cycle.
+  CollisionGeometryEntries,
+  Count
+};
+
+/// Low overhead profiler of the traffic manager cycle. Every section has
+/// pre-registered counters and a histogram per worker thread, written only
+/// by that thread with relaxed atomics, so recording takes no lock; reading
+/// them merges the workers. Nothing is measured while it is disabled.
+///
+/// The last TRACE_CAPACITY per-cycle sections are also kept as a timeline
+/// that can be exported in the Chrome trace event format (chrome://tracing,
+/// Perfetto).
+class StageProfiler : private NonCopyable {
+public:
+
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = Clock::time_point;
+  using Duration = Clock::duration;
+
+  static constexpr size_t SECTION_COUNT = static_cast<size_t>(ProfiledSection::Count);
+  static constexpr size_t COUNTER_COUNT = static_cast<size_t>(ProfiledCounter::Count);
+  /// Log-linear histogram: values below 2 * SUB_BUCKETS nanoseconds have a
+  /// bucket each, every octave above is split in SUB_BUCKETS buckets, up to
+  /// about 18 minutes.
+  static constexpr size_t SUB_BUCKETS = 8u;
+  static constexpr size_t BUCKET_COUNT = 304u;
+  static constexpr size_t TRACE_CAPACITY = 1u << 16u;
+
+  StageProfiler();
+  ~StageProfiler();
+
+  static const char *GetSectionName(ProfiledSection section);
+
+  static const char *GetCounterName(ProfiledCounter counter);
+
+  /// Thread safe, takes effect at the next BeginCycle.
+  void SetEnabled(bool enable);
+
+  bool IsEnabled() const {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  /// Thread safe, clears the statistics and the trace at the next BeginCycle.
+  void Reset();
+
+  /// Called by the traffic manager thread at the start of every cycle, before
+  /// any section is recorded. Workers [0, number_of_workers) may record in
+  /// this cycle.
+  void BeginCycle(unsigned number_of_workers);
+
+  /// Whether sections are measured in the current cycle.
+  bool IsActive() const {
+    return active;
+  }
+
+  /// Records a section measured on the given worker. Each worker must only be
+  /// used by one thread at a time, worker 0 is the traffic manager thread.
+  void Record(ProfiledSection section, TimePoint begin, TimePoint end, unsigned worker = 0u);
+
+  /// Records the duration of a section that was not a contiguous span, it
+  /// does not go to the trace.
+  void RecordDuration(ProfiledSection section, Duration duration, unsigned worker = 0u);
+
+  /// Adds to a counter if the profiler is active, only from the traffic
+  /// manager thread.
+  void AddCount(ProfiledCounter counter, uint64_t value);
+
+  /// Sets a counter if the profiler is active, only from the traffic manager
+  /// thread.
+  void SetCount(ProfiledCounter counter, uint64_t value);
+
+  /// Thread safe.
+  ProfilerReport GetReport() const;
+
+  /// Thread safe. Writes the trace as Chrome trace event JSON, returns false
+  /// if the file cannot be written.
+  bool ExportTrace(const std::string &path) const;
+
+private:
+
+  struct SectionStatistics {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> min;
+    std::atomic<uint64_t> max;
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> histogram;
+  };
+
+  struct WorkerStatistics {
+    std::array<SectionStatistics, SECTION_COUNT> sections;
+  };
+
+  struct TraceEvent {
+    uint64_t begin;
+    uint64_t duration;
+    uint64_t cycle;
+    ProfiledSection section;
+  };
+
+  static size_t GetBucket(uint64_t nanoseconds);
+
+  static uint64_t GetBucketLowerBound(size_t bucket);
+
+  static void Clear(WorkerStatistics &statistics);
+
+  void Add(ProfiledSection section, uint64_t nanoseconds, unsigned worker);
+
+  std::atomic<bool> enabled {false};
+
+  std::atomic<bool> reset_requested {false};
+
+  /// Only changed by BeginCycle.
+  bool active = false;
+
+  const TimePoint epoch;
+
+  uint64_t cycle = 0u;
+
+  /// Guards the growth of workers against the readers. Recording reads the
+  /// vector without it: it only grows in BeginCycle, when no worker records.
+  mutable std::mutex workers_mutex;
+
+  std::vector<std::unique_ptr<WorkerStatistics>> workers;
+
+  /// Written by the traffic manager thread only.
+  std::array<std::atomic<uint64_t>, COUNTER_COUNT> counters;
+
+  /// Per-cycle sections of the current cycle, moved to the trace by the next
+  /// BeginCycle so the trace lock is taken once per cycle.
+  std::vector<TraceEvent> cycle_events;
+
+  mutable std::mutex trace_mutex;
+
+  /// Ring buffer of the last TRACE_CAPACITY events.
+  std::vector<TraceEvent> trace;
+
+  size_t trace_next = 0u;
+};
+
+/// Measures the enclosing scope as the given section if the profiler is
+/// active, optionally adding its duration to total as well.
+class ProfileScope : private NonCopyable {
+public:
+
+  ProfileScope(
+      StageProfiler &_profiler,
+      ProfiledSection _section,
+      unsigned _worker = 0u,
+      StageProfiler::Duration *_total = nullptr)
+    : profiler(_profiler.IsActive() ? &_profiler : nullptr),
+      section(_section),
+      worker(_worker),
+      total(_total) {
+    if (profiler != nullptr) {
+      begin = StageProfiler::Clock::now();
+    }
+  }
+
+  ~ProfileScope() {
+    if (profiler != nullptr) {
+      const auto end = StageProfiler::Clock::now();
+      profiler->Record(section, begin, end, worker);
+      if (total != nullptr) {
+        *total += end - begin;
+      }
+    }
+  }
+
+private:
+
+  StageProfiler *profiler;
+
+  const ProfiledSection section;
+
+  const unsigned worker;
+
+  StageProfiler::Duration *total;
+
+  StageProfiler::TimePoint begin;
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,92 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Pool of worker threads splitting the vehicles of a traffic manager cycle.
+/// The vehicle indices are split in contiguous ranges, one per worker, so the
+/// same number of vehicles and workers always gives the same split. The
+/// traffic manager thread runs the first range itself.
+class StageWorkerPool : private NonCopyable {
+
+public:
+  ~StageWorkerPool() {
+    SetWorkers(1u);
+  }
+
+  /// Number of threads running the stages (including the traffic manager
+  /// thread). 0 or 1 runs them sequentially. Must not be called while a
+  /// ForEach is running.
+  void SetWorkers(unsigned number_of_workers) {
+    number_of_workers = std::max(number_of_workers, 1u);
+    if (number_of_workers == workers) {
+      return;
+    }
+    pool.reset();
+    workers = number_of_workers;
+    if (workers > 1u) {
+      pool = std::make_unique<ThreadPool>();
+      pool->AsyncRun(workers - 1u);
+    }
+  }
+
+  unsigned GetWorkers() const {
+    return workers;
+  }
+
+  bool IsParallel() const {
+    return workers > 1u;
+  }
+
+  /// Calls function(index, worker) for every index in [0, count) and returns
+  /// once all of them are done. Worker is in [0, GetWorkers()).
+  template <typename F>
+  void ForEach(const unsigned long count, F &&function) {
+    const unsigned long chunks = std::min<unsigned long>(workers, count);
+    if (chunks <= 1u) {
+      for (unsigned long index = 0u; index < count; ++index) {
+        function(index, 0u);
+      }
+      return;
+    }
+
+    auto run_chunk = [&function, count, chunks](const unsigned long chunk) {
+      const unsigned long begin = count * chunk / chunks;
+      const unsigned long end = count * (chunk + 1u) / chunks;
+      for (unsigned long index = begin; index < end; ++index) {
+        function(index, static_cast<unsigned>(chunk));
+      }
+    };
+
+    std::vector<std::future<void>> pending;
+    pending.reserve(chunks - 1u);
+    for (unsigned long chunk = 1u; chunk < chunks; ++chunk) {
+      pending.emplace_back(pool->Post([&run_chunk, chunk]() { run_chunk(chunk); }));
+    }
+    run_chunk(0u);
+    for (auto &future : pending) {
+      future.get();
+    }
+  }
+
+private:
+  unsigned workers {1u};
+  std::unique_ptr<ThreadPool> pool;
+};
+
+} // namespace traffic_manager
+} // namespace carla
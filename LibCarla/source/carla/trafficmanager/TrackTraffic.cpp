@@ -9,84 +9,69 @@ namespace traffic_manager {
 using constants::TrackTraffic::BUFFER_STEP_THROUGH;
 using constants::TrackTraffic::INV_BUFFER_STEP_THROUGH;
 
-TrackTraffic::TrackTraffic() {}
+using constants::TrackTraffic::BROAD_PHASE_CELL_SIZE;
+using constants::TrackTraffic::BROAD_PHASE_MARGIN;
+using constants::Map::MAX_GEODESIC_GRID_LENGTH;
+
+TrackTraffic::TrackTraffic()
+    : broad_phase(BROAD_PHASE_CELL_SIZE) {}
 
 void TrackTraffic::UpdateUnregisteredGridPosition(const ActorId actor_id,
                                                   const std::vector<SimpleWaypointPtr> waypoints) {
 
     DeleteActor(actor_id);
 
-    std::unordered_set<GeoGridId> current_grids;
-    // Step through waypoints and update grid list for actor and actor list for grids.
+    BroadPhaseBounds bounds;
+    // Step through waypoints and update passing vehicles and the path bounds.
     for (auto &waypoint : waypoints) {
         UpdatePassingVehicle(waypoint->GetId(), actor_id);
-
-        GeoGridId ggid = waypoint->GetGeodesicGridId();
-        current_grids.insert(ggid);
-
-        if (grid_to_actors.find(ggid) != grid_to_actors.end()) {
-            ActorIdSet &actor_ids = grid_to_actors.at(ggid);
-            if (actor_ids.find(actor_id) == actor_ids.end()) {
-                actor_ids.insert(actor_id);
-            }
-        } else {
-            grid_to_actors.insert({ggid, {actor_id}});
-        }
+        bounds.Extend(waypoint->GetLocation());
     }
 
-    actor_to_grids.insert({actor_id, current_grids});
+    if (!bounds.IsEmpty()) {
+        bounds.Inflate(BROAD_PHASE_MARGIN);
+        broad_phase.Update(actor_id, bounds);
+    }
 }
 
 void TrackTraffic::UpdateGridPosition(const ActorId actor_id, const Buffer &buffer) {
     if (!buffer.empty()) {
 
-        // Clear current actor from all grids containing itself.
-        if (actor_to_grids.find(actor_id) != actor_to_grids.end()) {
-            std::unordered_set<GeoGridId> &current_grids = actor_to_grids.at(actor_id);
-            for (auto &grid_id : current_grids) {
-                if (grid_to_actors.find(grid_id) != grid_to_actors.end()) {
-                    ActorIdSet &actor_ids = grid_to_actors.at(grid_id);
-                    actor_ids.erase(actor_id);
-                }
-            }
-
-            actor_to_grids.erase(actor_id);
+        BroadPhaseBounds bounds;
+        for (SimpleWaypointPtr waypoint : buffer) {
+            bounds.Extend(waypoint->GetLocation());
         }
+        bounds.Inflate(BROAD_PHASE_MARGIN);
 
-        // Step through buffer and update grid list for actor and actor list for grids.
-        std::unordered_set<GeoGridId> current_grids;
-        uint64_t buffer_size = buffer.size();
-        for (uint64_t i = 0u; i <= buffer_size - 1u; ++i) {
-            auto waypoint = buffer.at(i);
-            GeoGridId ggid = waypoint->GetGeodesicGridId();
-            current_grids.insert(ggid);
-            // Add grid entry if not present.
-            if (grid_to_actors.find(ggid) == grid_to_actors.end()) {
-                grid_to_actors.insert({ggid, {}});
-            }
-
-            ActorIdSet &actor_ids = grid_to_actors.at(ggid);
-            if (actor_ids.find(actor_id) == actor_ids.end()) {
-                actor_ids.insert(actor_id);
-            }
+        DeferredUpdate *deferred = GetDeferredUpdate(actor_id);
+        if (deferred != nullptr) {
+            deferred->update_bounds = true;
+            deferred->bounds = bounds;
+        } else {
+            ApplyGridPosition(actor_id, bounds);
         }
-
-        actor_to_grids.insert({actor_id, current_grids});
     }
 }
 
+void TrackTraffic::ApplyGridPosition(const ActorId actor_id, const BroadPhaseBounds &bounds) {
+    broad_phase.Update(actor_id, bounds);
+}
+
 
-bool TrackTraffic::IsGeoGridFree(const GeoGridId geogrid_id) const {
-    if (grid_to_actors.find(geogrid_id) != grid_to_actors.end()) {
-        return grid_to_actors.at(geogrid_id).empty();
-    }
-    return true;
+bool TrackTraffic::IsLocationFree(const cg::Location &location) const {
+    BroadPhaseBounds bounds;
+    bounds.Extend(location);
+    bounds.Inflate(0.5f * MAX_GEODESIC_GRID_LENGTH);
+    std::vector<ActorId> actor_ids;
+    broad_phase.Query(bounds, actor_ids);
+    return actor_ids.empty();
 }
 
-void TrackTraffic::AddTakenGrid(const GeoGridId geogrid_id, const ActorId actor_id) {
-    if (grid_to_actors.find(geogrid_id) == grid_to_actors.end()) {
-        grid_to_actors.insert({geogrid_id, {actor_id}});
-    }
+void TrackTraffic::TakeLocation(const ActorId actor_id, const cg::Location &location) {
+    BroadPhaseBounds bounds;
+    bounds.Extend(location);
+    bounds.Inflate(BROAD_PHASE_MARGIN);
+    broad_phase.Update(actor_id, bounds);
 }
 
 
@@ -98,33 +83,12 @@ cg::Location TrackTraffic::GetHeroLocation() const {
     return hero_location;
 }
 
-ActorIdSet TrackTraffic::GetOverlappingVehicles(ActorId actor_id) const {
-    ActorIdSet actor_id_set;
-
-    if (actor_to_grids.find(actor_id) != actor_to_grids.end()) {
-        const std::unordered_set<GeoGridId> &grid_ids = actor_to_grids.at(actor_id);
-        for (auto &grid_id : grid_ids) {
-            if (grid_to_actors.find(grid_id) != grid_to_actors.end()) {
-                const ActorIdSet &actor_ids = grid_to_actors.at(grid_id);
-                actor_id_set.insert(actor_ids.begin(), actor_ids.end());
-            }
-        }
-    }
-
-    return actor_id_set;
+void TrackTraffic::GetOverlappingVehicles(ActorId actor_id, std::vector<ActorId> &overlapping_actors) const {
+    broad_phase.Query(actor_id, overlapping_actors);
 }
 
 void TrackTraffic::DeleteActor(ActorId actor_id) {
-    if (actor_to_grids.find(actor_id) != actor_to_grids.end()) {
-        std::unordered_set<GeoGridId> &grid_ids = actor_to_grids.at(actor_id);
-        for (auto &grid_id : grid_ids) {
-            if (grid_to_actors.find(grid_id) != grid_to_actors.end()) {
-                ActorIdSet &actor_ids = grid_to_actors.at(grid_id);
-                actor_ids.erase(actor_id);
-                }
-            }
-        actor_to_grids.erase(actor_id);
-    }
+    broad_phase.Remove(actor_id);
 
     if (waypoint_occupied.find(actor_id) != waypoint_occupied.end()) {
         WaypointIdSet waypoint_id_set = waypoint_occupied.at(actor_id);
@@ -135,6 +99,24 @@ void TrackTraffic::DeleteActor(ActorId actor_id) {
 }
 
 void TrackTraffic::UpdatePassingVehicle(uint64_t waypoint_id, ActorId actor_id) {
+    DeferredUpdate *deferred = GetDeferredUpdate(actor_id);
+    if (deferred != nullptr) {
+        deferred->passing_waypoints.emplace_back(waypoint_id, true);
+    } else {
+        ApplyPassingVehicle(waypoint_id, actor_id);
+    }
+}
+
+void TrackTraffic::RemovePassingVehicle(uint64_t waypoint_id, ActorId actor_id) {
+    DeferredUpdate *deferred = GetDeferredUpdate(actor_id);
+    if (deferred != nullptr) {
+        deferred->passing_waypoints.emplace_back(waypoint_id, false);
+    } else {
+        ApplyRemovePassingVehicle(waypoint_id, actor_id);
+    }
+}
+
+void TrackTraffic::ApplyPassingVehicle(uint64_t waypoint_id, ActorId actor_id) {
     if (waypoint_overlap_tracker.find(waypoint_id) != waypoint_overlap_tracker.end()) {
         ActorIdSet &actor_id_set = waypoint_overlap_tracker.at(waypoint_id);
         if (actor_id_set.find(actor_id) == actor_id_set.end()) {
@@ -154,7 +136,7 @@ void TrackTraffic::UpdatePassingVehicle(uint64_t waypoint_id, ActorId actor_id)
     }
 }
 
-void TrackTraffic::RemovePassingVehicle(uint64_t waypoint_id, ActorId actor_id) {
+void TrackTraffic::ApplyRemovePassingVehicle(uint64_t waypoint_id, ActorId actor_id) {
     if (waypoint_overlap_tracker.find(waypoint_id) != waypoint_overlap_tracker.end()) {
         ActorIdSet &actor_id_set = waypoint_overlap_tracker.at(waypoint_id);
         actor_id_set.erase(actor_id);
@@ -183,11 +165,51 @@ ActorIdSet TrackTraffic::GetPassingVehicles(uint64_t waypoint_id) const {
     }
 }
 
+TrackTraffic::DeferredUpdate *TrackTraffic::GetDeferredUpdate(ActorId actor_id) {
+    if (!deferring) {
+        return nullptr;
+    }
+    // Only looked up while deferring: the map is not modified until EndDeferredUpdates.
+    auto deferred = deferred_updates.find(actor_id);
+    return deferred != deferred_updates.end() ? &deferred->second : nullptr;
+}
+
+void TrackTraffic::BeginDeferredUpdates(const std::vector<ActorId> &actor_ids) {
+    deferred_order = actor_ids;
+    for (const ActorId actor_id : actor_ids) {
+        DeferredUpdate &deferred = deferred_updates[actor_id];
+        deferred.passing_waypoints.clear();
+        deferred.update_bounds = false;
+    }
+    deferring = true;
+}
+
+void TrackTraffic::EndDeferredUpdates() {
+    deferring = false;
+    for (const ActorId actor_id : deferred_order) {
+        DeferredUpdate &deferred = deferred_updates.at(actor_id);
+        for (const auto &passing : deferred.passing_waypoints) {
+            if (passing.second) {
+                ApplyPassingVehicle(passing.first, actor_id);
+            } else {
+                ApplyRemovePassingVehicle(passing.first, actor_id);
+            }
+        }
+        if (deferred.update_bounds) {
+            ApplyGridPosition(actor_id, deferred.bounds);
+        }
+    }
+    deferred_updates.clear();
+    deferred_order.clear();
+}
+
 void TrackTraffic::Clear() {
     waypoint_overlap_tracker.clear();
     waypoint_occupied.clear();
-    actor_to_grids.clear();
-    grid_to_actors.clear();
+    broad_phase.Clear();
+    deferred_updates.clear();
+    deferred_order.clear();
+    deferring = false;
 }
 
 } // namespace traffic_manager
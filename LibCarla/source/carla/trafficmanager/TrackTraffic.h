@@ -1,18 +1,20 @@
 
 #pragma once
 
+#include <unordered_set>
+
 #include "carla/road/RoadTypes.h"
 #include "carla/rpc/ActorId.h"
 
+#include "carla/trafficmanager/BroadPhase.h"
 #include "carla/trafficmanager/SimpleWaypoint.h"
+#include "carla/trafficmanager/WaypointBuffer.h"
 
 namespace carla {
 namespace traffic_manager {
 
 using ActorId = carla::ActorId;
 using ActorIdSet = std::unordered_set<ActorId>;
-using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-using Buffer = std::deque<SimpleWaypointPtr>;
 using GeoGridId = carla::road::JuncId;
 
 // This class is used to track the waypoint occupancy of all the actors.
@@ -28,13 +30,28 @@ private:
     using WaypointOccupancyMap = std::unordered_map<ActorId, WaypointIdSet>;
     WaypointOccupancyMap waypoint_occupied;
 
-    /// Geodesic grids occupied by actors's paths.
-    std::unordered_map<ActorId, std::unordered_set<GeoGridId>> actor_to_grids;
-    /// Actors currently passing through grids.
-    std::unordered_map<GeoGridId, ActorIdSet> grid_to_actors;
+    /// Bounds of the actors' paths.
+    BroadPhase broad_phase;
     /// Current hero location.
     cg::Location hero_location = cg::Location(0,0,0);
 
+    /// Changes recorded for an actor while deferring updates.
+    struct DeferredUpdate {
+      std::vector<std::pair<uint64_t, bool>> passing_waypoints; // waypoint id, true if added
+      bool update_bounds = false;
+      BroadPhaseBounds bounds;
+    };
+    std::unordered_map<ActorId, DeferredUpdate> deferred_updates;
+    std::vector<ActorId> deferred_order;
+    bool deferring = false;
+
+    /// Returns the deferred record of the actor, nullptr if its updates apply directly.
+    DeferredUpdate *GetDeferredUpdate(ActorId actor_id);
+
+    void ApplyPassingVehicle(uint64_t waypoint_id, ActorId actor_id);
+    void ApplyRemovePassingVehicle(uint64_t waypoint_id, ActorId actor_id);
+    void ApplyGridPosition(const ActorId actor_id, const BroadPhaseBounds &bounds);
+
 
 public:
     TrackTraffic();
@@ -48,9 +65,14 @@ public:
     void UpdateUnregisteredGridPosition(const ActorId actor_id,
                                         const std::vector<SimpleWaypointPtr> waypoints);
 
-    ActorIdSet GetOverlappingVehicles(ActorId actor_id) const;
-    bool IsGeoGridFree(const GeoGridId geogrid_id) const;
-    void AddTakenGrid(const GeoGridId geogrid_id, const ActorId actor_id);
+    /// Fills overlapping_actors (cleared first) with the actors whose path
+    /// bounds overlap those of actor_id, including actor_id, sorted by id.
+    void GetOverlappingVehicles(ActorId actor_id, std::vector<ActorId> &overlapping_actors) const;
+    /// Whether no actor's path passes near the location.
+    bool IsLocationFree(const cg::Location &location) const;
+    /// Marks the surroundings of the location as taken by the actor until its
+    /// path is updated.
+    void TakeLocation(const ActorId actor_id, const cg::Location &location);
 
     void SetHeroLocation(const cg::Location location);
     cg::Location GetHeroLocation() const;
@@ -59,6 +81,15 @@ public:
     /// Method to delete actor data from tracking.
     void DeleteActor(ActorId actor_id);
 
+    /// Phase separated updates for the parallel localization stage. Between
+    /// these calls the passing waypoints and grid positions of the given
+    /// actors are recorded per actor instead of applied, so each worker only
+    /// writes the record of its own vehicles and every reader sees the
+    /// tracking as it was before. EndDeferredUpdates applies the records in
+    /// the order of actor_ids.
+    void BeginDeferredUpdates(const std::vector<ActorId> &actor_ids);
+    void EndDeferredUpdates();
+
     void Clear();
 };
 
@@ -34,8 +34,8 @@ void TrafficLightStage::Update(const unsigned long index) {
     const Buffer &waypoint_buffer = buffer_map.at(ego_actor_id);
     const SimpleWaypointPtr look_ahead_point = GetTargetWaypoint(waypoint_buffer, JUNCTION_LOOK_AHEAD).first;
 
-    const JunctionID junction_id = look_ahead_point->GetWaypoint()->GetJunctionId();
-    current_timestamp = world.GetSnapshot().GetTimestamp();
+    const JunctionID junction_id = look_ahead_point->GetJunctionId();
+    const cc::Timestamp current_timestamp = world.GetSnapshot().GetTimestamp();
 
     const TrafficLightState tl_state = simulation_state.GetTLS(ego_actor_id);
     const TLS traffic_light_state = tl_state.tl_state;
@@ -57,12 +57,34 @@ void TrafficLightStage::Update(const unsigned long index) {
             traffic_light_state != TLS::Off &&
             parameters.GetPercentageRunningSign(ego_actor_id) <= random_devices.at(ego_actor_id).next()) {
 
-      traffic_light_hazard = HandleNonSignalisedJunction(ego_actor_id, junction_id, current_timestamp);
+      if (parallel_update) {
+        pending_junctions.at(index) = {true, junction_id, current_timestamp};
+      } else {
+        traffic_light_hazard = HandleNonSignalisedJunction(ego_actor_id, junction_id, current_timestamp);
+      }
     }
   }
   output_array.at(index) = traffic_light_hazard;
 }
 
+void TrafficLightStage::BeginParallelUpdate() {
+  pending_junctions.assign(vehicle_id_list.size(), PendingJunction());
+  parallel_update = true;
+}
+
+void TrafficLightStage::EndParallelUpdate() {
+  parallel_update = false;
+  for (unsigned long index = 0u; index < pending_junctions.size(); ++index) {
+    const PendingJunction &pending = pending_junctions.at(index);
+    if (pending.pending) {
+      output_array.at(index) = HandleNonSignalisedJunction(vehicle_id_list.at(index),
+                                                           pending.junction_id,
+                                                           pending.timestamp);
+    }
+  }
+  pending_junctions.clear();
+}
+
 bool TrafficLightStage::HandleNonSignalisedJunction(const ActorId ego_actor_id, const JunctionID junction_id,
                                                     cc::Timestamp timestamp) {
 
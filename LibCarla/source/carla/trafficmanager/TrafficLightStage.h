@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "carla/trafficmanager/DataStructures.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
@@ -27,7 +29,15 @@ private:
   std::unordered_map<ActorId, JunctionID> vehicle_last_junction;
   TLFrame &output_array;
   RandomGeneratorMap &random_devices;
-  cc::Timestamp current_timestamp;
+  /// Non-signalised junction negotiations found by a parallel update. Tickets are issued in
+  /// vehicle order by EndParallelUpdate, the same order as the sequential update.
+  struct PendingJunction {
+    bool pending = false;
+    JunctionID junction_id = 0;
+    cc::Timestamp timestamp;
+  };
+  std::vector<PendingJunction> pending_junctions;
+  bool parallel_update = false;
 
   bool HandleNonSignalisedJunction(const ActorId ego_actor_id, const JunctionID junction_id,
                                    cc::Timestamp timestamp);
@@ -43,6 +53,10 @@ public:
 
   void Update(const unsigned long index) override;
 
+  /// Bracket the Update calls of a cycle running on several threads.
+  void BeginParallelUpdate();
+  void EndParallelUpdate();
+
   void RemoveActor(const ActorId actor_id) override;
 
   void Reset() override;
@@ -65,6 +65,61 @@ public:
     }
   }
 
+  /// Method to set the number of threads running the stages of a cycle
+  /// (0 or 1 runs them sequentially).
+  void SetParallelWorkers(const unsigned workers) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      tm_ptr->SetParallelWorkers(workers);
+    }
+  }
+
+  /// Method to switch the collision stage between the specialized polygon
+  /// distance kernel and Boost.Geometry.
+  void SetFastCollisionGeometry(const bool mode_switch) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      tm_ptr->SetFastCollisionGeometry(mode_switch);
+    }
+  }
+
+  /// Method to enable or disable the profiler of the cycles. It measures the
+  /// stages of every cycle and of every vehicle, and keeps a trace of the
+  /// last cycles.
+  void SetProfiling(const bool mode_switch) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      tm_ptr->SetProfiling(mode_switch);
+    }
+  }
+
+  /// Method to clear the statistics and the trace of the profiler.
+  void ResetProfiler() {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      tm_ptr->ResetProfiler();
+    }
+  }
+
+  /// Method to get the statistics of the profiler.
+  ProfilerReport GetProfilerReport() {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      return tm_ptr->GetProfilerReport();
+    }
+    return ProfilerReport();
+  }
+
+  /// Method to write the trace of the profiler to a file on the machine
+  /// running the traffic manager, in the Chrome trace event format.
+  bool ExportProfilerTrace(const std::string &path) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      return tm_ptr->ExportProfilerTrace(path);
+    }
+    return false;
+  }
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
     TrafficManagerBase* tm_ptr = GetTM(_port);
@@ -7,7 +7,9 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include "carla/client/Actor.h"
+#include "carla/trafficmanager/ProfilerReport.h"
 #include "carla/trafficmanager/SimpleWaypoint.h"
 
 namespace carla {
@@ -123,6 +125,25 @@ public:
   /// Method to set Open Street Map mode.
   virtual void SetOSMMode(const bool mode_switch) = 0;
 
+  /// Method to set the number of threads running the stages of a cycle.
+  virtual void SetParallelWorkers(const unsigned workers) = 0;
+
+  /// Method to set if the collision stage uses the specialized polygon distance kernel.
+  virtual void SetFastCollisionGeometry(const bool mode_switch) = 0;
+
+  /// Method to enable or disable the profiler of the cycles.
+  virtual void SetProfiling(const bool mode_switch) = 0;
+
+  /// Method to clear the statistics and the trace of the profiler.
+  virtual void ResetProfiler() = 0;
+
+  /// Method to get the statistics of the profiler.
+  virtual ProfilerReport GetProfilerReport() = 0;
+
+  /// Method to write the trace of the profiler to a file on the machine
+  /// running the traffic manager, returns false if it cannot be written.
+  virtual bool ExportProfilerTrace(const std::string &path) = 0;
+
   /// Method to set our own imported path.
   virtual void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) = 0;
 
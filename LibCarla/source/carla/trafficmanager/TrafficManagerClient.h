@@ -7,6 +7,7 @@
 #pragma once
 
 #include "carla/trafficmanager/Constants.h"
+#include "carla/trafficmanager/ProfilerReport.h"
 #include "carla/rpc/Actor.h"
 
 #include <rpc/client.h>
@@ -217,6 +218,42 @@ public:
     _client->call("set_osm_mode", mode_switch);
   }
 
+  /// Method to set the number of threads running the stages.
+  void SetParallelWorkers(const unsigned workers) {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("set_parallel_workers", workers);
+  }
+
+  /// Method to set if the collision stage uses the specialized polygon distance kernel.
+  void SetFastCollisionGeometry(const bool mode_switch) {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("set_fast_collision_geometry", mode_switch);
+  }
+
+  /// Method to enable or disable the profiler of the cycles.
+  void SetProfiling(const bool mode_switch) {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("set_profiling", mode_switch);
+  }
+
+  /// Method to clear the statistics and the trace of the profiler.
+  void ResetProfiler() {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("reset_profiler");
+  }
+
+  /// Method to get the statistics of the profiler.
+  ProfilerReport GetProfilerReport() {
+    DEBUG_ASSERT(_client != nullptr);
+    return _client->call("get_profiler_report").as<ProfilerReport>();
+  }
+
+  /// Method to write the trace of the profiler to a file on the traffic manager's machine.
+  bool ExportProfilerTrace(const std::string &path) {
+    DEBUG_ASSERT(_client != nullptr);
+    return _client->call("export_profiler_trace", path).as<bool>();
+  }
+
   /// Method to set our own imported path.
   void SetCustomPath(const carla::rpc::Actor &actor, const Path path, const bool empty_buffer) {
     DEBUG_ASSERT(_client != nullptr);
@@ -8,6 +8,7 @@
 
 #include "carla/Logging.h"
 
+#include "carla/client/FileTransfer.h"
 #include "carla/client/detail/Simulator.h"
 
 #include "carla/trafficmanager/TrafficManagerLocal.h"
@@ -118,17 +119,12 @@ void TrafficManagerLocal::SetupLocalMap() {
   const carla::SharedPtr<const cc::Map> world_map = world.GetMap();
   local_map = std::make_shared<InMemoryMap>(world_map);
 
+  // Required files are downloaded to the cache folder, the map is loaded
+  // straight from there.
   auto files = episode_proxy.Lock()->GetRequiredFiles("TM");
-  if (!files.empty()) {
-    auto content = episode_proxy.Lock()->GetCacheFile(files[0], true);
-    if (content.size() != 0) {
-      local_map->Load(content);
-    } else {
-      log_warning("No InMemoryMap cache found. Setting up local map. This may take a while...");
-      local_map->SetUp();
-    }
-  } else {
+  if (files.empty() || !local_map->Load(cc::FileTransfer::GetFullPath(files[0]))) {
     log_warning("No InMemoryMap cache found. Setting up local map. This may take a while...");
+    local_map = std::make_shared<InMemoryMap>(world_map);
     local_map->SetUp();
   }
 }
@@ -153,8 +149,12 @@ void TrafficManagerLocal::Run() {
     bool hybrid_physics_mode = parameters.GetHybridPhysicsMode();
     parameters.SetMaxBoundaries(20.0f, episode_proxy.Lock()->GetEpisodeSettings().actor_active_distance);
 
+    stage_workers.SetWorkers(parameters.GetParallelWorkers());
+    profiler.BeginCycle(stage_workers.GetWorkers());
+
     // Wait for external trigger to initiate cycle in synchronous mode.
     if (synchronous_mode) {
+      ProfileScope wait_scope(profiler, ProfiledSection::StepBeginWait);
       std::unique_lock<std::mutex> lock(step_execution_mutex);
       step_begin_trigger.wait(lock, [this]() {return step_begin.load() || !run_traffic_manger.load();});
       step_begin.store(false);
@@ -180,9 +180,14 @@ void TrafficManagerLocal::Run() {
       last_frame = timestamp.frame;
     }
 
+    ProfileScope cycle_scope(profiler, ProfiledSection::Cycle);
+
     std::unique_lock<std::mutex> registration_lock(registration_mutex);
     // Updating simulation state, actor life cycle and performing necessary cleanup.
-    alsm.Update();
+    {
+      ProfileScope scope(profiler, ProfiledSection::ActorUpdate);
+      alsm.Update();
+    }
 
 
     // Re-allocating inter-stage communication frames based on changed number of registered vehicles.
@@ -209,6 +214,9 @@ void TrafficManagerLocal::Run() {
       registered_vehicles_state = registered_vehicles.GetState();
     }
 
+    // Put the registered vehicles at their vehicle index in the simulation state.
+    simulation_state.AlignVehicles(vehicle_id_list);
+
     // Reset frames for current cycle.
     localization_frame.clear();
     localization_frame.resize(number_of_vehicles);
@@ -224,30 +232,37 @@ void TrafficManagerLocal::Run() {
     // that will be inserted by the motion_plan_stage stage.
     control_frame.resize(number_of_vehicles);
 
-    // Run core operation stages.
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      localization_stage.Update(index);
-    }
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      collision_stage.Update(index);
-    }
-    collision_stage.ClearCycleCache();
-    vehicle_light_stage.UpdateWorldInfo();
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      traffic_light_stage.Update(index);
-      motion_plan_stage.Update(index);
-      vehicle_light_stage.Update(index);
+    // Run core operation stages. Only runs with more than one worker are comparable
+    // with each other, see RunParallelStages.
+    if (stage_workers.IsParallel()) {
+      RunParallelStages();
+    } else {
+      RunSequentialStages();
     }
 
+    const GeometryCacheStatistics &geometry_cache = collision_stage.GetGeometryCacheStatistics();
+    profiler.AddCount(ProfiledCounter::CollisionGeometryHits, geometry_cache.hits);
+    profiler.AddCount(ProfiledCounter::CollisionGeometryMisses, geometry_cache.misses);
+    profiler.AddCount(ProfiledCounter::CollisionGeometryInvalidations, geometry_cache.invalidations);
+    profiler.AddCount(ProfiledCounter::CollisionGeometryEvictions, geometry_cache.evictions);
+    profiler.SetCount(ProfiledCounter::CollisionGeometryEntries, geometry_cache.entries);
+
+    // Hybrid mode physics changes go in the same batch, ahead of the vehicle commands.
+    alsm.AddPhysicsCommands(control_frame);
+
     registration_lock.unlock();
 
     // Sending the current cycle's batch command to the simulator.
     if (synchronous_mode) {
-      episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
+      {
+        ProfileScope scope(profiler, ProfiledSection::BatchSend);
+        episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
+      }
       step_end.store(true);
       step_end_trigger.notify_one();
     } else {
       if (control_frame.size() > 0){
+        ProfileScope scope(profiler, ProfiledSection::BatchSend);
         episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
       }
     }
@@ -266,6 +281,119 @@ bool TrafficManagerLocal::SynchronousTick() {
   return true;
 }
 
+void TrafficManagerLocal::RunSequentialStages() {
+  const unsigned long number_of_vehicles = vehicle_id_list.size();
+
+  {
+    ProfileScope stage_scope(profiler, ProfiledSection::Localization);
+    for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+      ProfileScope scope(profiler, ProfiledSection::LocalizationVehicle);
+      localization_stage.Update(index);
+    }
+  }
+
+  {
+    ProfileScope stage_scope(profiler, ProfiledSection::Collision);
+    for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+      ProfileScope scope(profiler, ProfiledSection::CollisionVehicle);
+      collision_stage.Update(index);
+    }
+    collision_stage.ClearCycleCache();
+  }
+
+  {
+    ProfileScope scope(profiler, ProfiledSection::WorldInfo);
+    vehicle_light_stage.UpdateWorldInfo();
+  }
+
+  // Traffic light, motion plan and vehicle light run interleaved per vehicle,
+  // so their stage times are the sums of their vehicle times and only the
+  // whole loop is a span of the trace.
+  ProfileScope planning_scope(profiler, ProfiledSection::Planning);
+  StageProfiler::Duration traffic_light_time {0};
+  StageProfiler::Duration motion_plan_time {0};
+  StageProfiler::Duration vehicle_light_time {0};
+  for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+    {
+      ProfileScope scope(profiler, ProfiledSection::TrafficLightVehicle, 0u, &traffic_light_time);
+      traffic_light_stage.Update(index);
+    }
+    {
+      ProfileScope scope(profiler, ProfiledSection::MotionPlanVehicle, 0u, &motion_plan_time);
+      motion_plan_stage.Update(index);
+    }
+    {
+      ProfileScope scope(profiler, ProfiledSection::VehicleLightVehicle, 0u, &vehicle_light_time);
+      vehicle_light_stage.Update(index);
+    }
+  }
+  profiler.RecordDuration(ProfiledSection::TrafficLight, traffic_light_time);
+  profiler.RecordDuration(ProfiledSection::MotionPlan, motion_plan_time);
+  profiler.RecordDuration(ProfiledSection::VehicleLight, vehicle_light_time);
+}
+
+void TrafficManagerLocal::RunParallelStages() {
+  // Every stage finishes with all the vehicles before the next one starts. State shared between
+  // vehicles is either read as it was at the start of the stage (localization, collision) or
+  // updated in vehicle order after the stage (junction tickets, controller state, respawns),
+  // so the result only depends on the seed and not on the number of workers. A single worker
+  // runs RunSequentialStages instead, which interleaves the stages per vehicle like the
+  // original traffic manager and so gives different results than any parallel run.
+  const unsigned long number_of_vehicles = vehicle_id_list.size();
+
+  {
+    ProfileScope stage_scope(profiler, ProfiledSection::Localization);
+    localization_stage.BeginParallelUpdate();
+    stage_workers.ForEach(number_of_vehicles, [this](const unsigned long index, const unsigned worker) {
+      ProfileScope scope(profiler, ProfiledSection::LocalizationVehicle, worker);
+      localization_stage.Update(index);
+    });
+    localization_stage.EndParallelUpdate();
+  }
+
+  {
+    ProfileScope stage_scope(profiler, ProfiledSection::Collision);
+    collision_stage.PrepareParallelUpdate(stage_workers.GetWorkers());
+    stage_workers.ForEach(number_of_vehicles, [this](const unsigned long index, const unsigned worker) {
+      ProfileScope scope(profiler, ProfiledSection::CollisionVehicle, worker);
+      collision_stage.Update(index, worker);
+    });
+    collision_stage.ClearCycleCache();
+  }
+
+  {
+    ProfileScope stage_scope(profiler, ProfiledSection::WorldInfo);
+    vehicle_light_stage.UpdateWorldInfo();
+  }
+
+  {
+    ProfileScope stage_scope(profiler, ProfiledSection::TrafficLight);
+    traffic_light_stage.BeginParallelUpdate();
+    stage_workers.ForEach(number_of_vehicles, [this](const unsigned long index, const unsigned worker) {
+      ProfileScope scope(profiler, ProfiledSection::TrafficLightVehicle, worker);
+      traffic_light_stage.Update(index);
+    });
+    traffic_light_stage.EndParallelUpdate();
+  }
+
+  {
+    ProfileScope stage_scope(profiler, ProfiledSection::MotionPlan);
+    motion_plan_stage.BeginParallelUpdate();
+    stage_workers.ForEach(number_of_vehicles, [this](const unsigned long index, const unsigned worker) {
+      ProfileScope scope(profiler, ProfiledSection::MotionPlanVehicle, worker);
+      motion_plan_stage.Update(index);
+    });
+    motion_plan_stage.EndParallelUpdate();
+  }
+
+  // Appends to the control frame, so it stays on this thread.
+  ProfileScope stage_scope(profiler, ProfiledSection::VehicleLight);
+  for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+    ProfileScope scope(profiler, ProfiledSection::VehicleLightVehicle);
+    vehicle_light_stage.Update(index);
+  }
+}
+
 void TrafficManagerLocal::Stop() {
 
   run_traffic_manger.store(false);
@@ -415,6 +543,30 @@ void TrafficManagerLocal::SetOSMMode(const bool mode_switch) {
   parameters.SetOSMMode(mode_switch);
 }
 
+void TrafficManagerLocal::SetParallelWorkers(const unsigned workers) {
+  parameters.SetParallelWorkers(workers);
+}
+
+void TrafficManagerLocal::SetProfiling(const bool mode_switch) {
+  profiler.SetEnabled(mode_switch);
+}
+
+void TrafficManagerLocal::ResetProfiler() {
+  profiler.Reset();
+}
+
+ProfilerReport TrafficManagerLocal::GetProfilerReport() {
+  return profiler.GetReport();
+}
+
+bool TrafficManagerLocal::ExportProfilerTrace(const std::string &path) {
+  return profiler.ExportTrace(path);
+}
+
+void TrafficManagerLocal::SetFastCollisionGeometry(const bool mode_switch) {
+  parameters.SetFastCollisionGeometry(mode_switch);
+}
+
 void TrafficManagerLocal::SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
   parameters.SetCustomPath(actor, path, empty_buffer);
 }
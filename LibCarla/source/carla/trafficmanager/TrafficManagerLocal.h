@@ -32,6 +32,8 @@
 #include "carla/trafficmanager/CollisionStage.h"
 #include "carla/trafficmanager/TrafficLightStage.h"
 #include "carla/trafficmanager/MotionPlanStage.h"
+#include "carla/trafficmanager/StageProfiler.h"
+#include "carla/trafficmanager/StageWorkerPool.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -94,6 +96,10 @@ private:
   TrafficLightStage traffic_light_stage;
   MotionPlanStage motion_plan_stage;
   VehicleLightStage vehicle_light_stage;
+  /// Worker threads sharing the vehicles of a cycle between them.
+  StageWorkerPool stage_workers;
+  /// Timings of the cycles, per stage and per vehicle.
+  StageProfiler profiler;
   ALSM alsm;
   /// Traffic manager server instance.
   TrafficManagerServer server;
@@ -121,6 +127,12 @@ private:
   /// Method to check if all traffic lights are frozen in a group.
   bool CheckAllFrozen(TLGroup tl_to_freeze);
 
+  /// Method running the stages of a cycle on the traffic manager thread.
+  void RunSequentialStages();
+
+  /// Method running the stages of a cycle on the stage workers.
+  void RunParallelStages();
+
 public:
   /// Private constructor for singleton lifecycle management.
   TrafficManagerLocal(std::vector<float> longitudinal_PID_parameters,
@@ -235,6 +247,24 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set the number of threads running the stages of a cycle.
+  void SetParallelWorkers(const unsigned workers);
+
+  /// Method to set if the collision stage uses the specialized polygon distance kernel.
+  void SetFastCollisionGeometry(const bool mode_switch);
+
+  /// Method to enable or disable the profiler of the cycles.
+  void SetProfiling(const bool mode_switch);
+
+  /// Method to clear the statistics and the trace of the profiler.
+  void ResetProfiler();
+
+  /// Method to get the statistics of the profiler.
+  ProfilerReport GetProfilerReport();
+
+  /// Method to write the trace of the profiler to a file, returns false if it cannot be written.
+  bool ExportProfilerTrace(const std::string &path);
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer);
 
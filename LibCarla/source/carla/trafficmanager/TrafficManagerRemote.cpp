@@ -205,6 +205,30 @@ void TrafficManagerRemote::SetOSMMode(const bool mode_switch) {
   client.SetOSMMode(mode_switch);
 }
 
+void TrafficManagerRemote::SetParallelWorkers(const unsigned workers) {
+  client.SetParallelWorkers(workers);
+}
+
+void TrafficManagerRemote::SetFastCollisionGeometry(const bool mode_switch) {
+  client.SetFastCollisionGeometry(mode_switch);
+}
+
+void TrafficManagerRemote::SetProfiling(const bool mode_switch) {
+  client.SetProfiling(mode_switch);
+}
+
+void TrafficManagerRemote::ResetProfiler() {
+  client.ResetProfiler();
+}
+
+ProfilerReport TrafficManagerRemote::GetProfilerReport() {
+  return client.GetProfilerReport();
+}
+
+bool TrafficManagerRemote::ExportProfilerTrace(const std::string &path) {
+  return client.ExportProfilerTrace(path);
+}
+
 void TrafficManagerRemote::SetCustomPath(const ActorPtr &_actor, const Path path, const bool empty_buffer) {
   carla::rpc::Actor actor(_actor->Serialize());
 
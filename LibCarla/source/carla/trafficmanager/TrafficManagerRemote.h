@@ -117,6 +117,24 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set the number of threads running the stages of a cycle.
+  void SetParallelWorkers(const unsigned workers);
+
+  /// Method to set if the collision stage uses the specialized polygon distance kernel.
+  void SetFastCollisionGeometry(const bool mode_switch);
+
+  /// Method to enable or disable the profiler of the cycles.
+  void SetProfiling(const bool mode_switch);
+
+  /// Method to clear the statistics and the trace of the profiler.
+  void ResetProfiler();
+
+  /// Method to get the statistics of the profiler.
+  ProfilerReport GetProfilerReport();
+
+  /// Method to write the trace of the profiler to a file, returns false if it cannot be written.
+  bool ExportProfilerTrace(const std::string &path);
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer);
 
@@ -185,6 +185,36 @@ public:
         tm->SetOSMMode(mode_switch);
       });
 
+      /// Method to set the number of threads running the stages.
+      server->bind("set_parallel_workers", [=](const unsigned workers) {
+        tm->SetParallelWorkers(workers);
+      });
+
+      /// Method to set if the collision stage uses the specialized polygon distance kernel.
+      server->bind("set_fast_collision_geometry", [=](const bool mode_switch) {
+        tm->SetFastCollisionGeometry(mode_switch);
+      });
+
+      /// Method to enable or disable the profiler of the cycles.
+      server->bind("set_profiling", [=](const bool mode_switch) {
+        tm->SetProfiling(mode_switch);
+      });
+
+      /// Method to clear the statistics and the trace of the profiler.
+      server->bind("reset_profiler", [=]() {
+        tm->ResetProfiler();
+      });
+
+      /// Method to get the statistics of the profiler.
+      server->bind("get_profiler_report", [=]() -> ProfilerReport {
+        return tm->GetProfilerReport();
+      });
+
+      /// Method to write the trace of the profiler to a file.
+      server->bind("export_profiler_trace", [=](const std::string path) -> bool {
+        return tm->ExportProfilerTrace(path);
+      });
+
       /// Method to set our own imported path.
       server->bind("set_path", [=](carla::rpc::Actor actor, const Path path, const bool empty_buffer) {
         tm->SetCustomPath(carla::client::detail::ActorVariant(actor).Get(tm->GetEpisodeProxy()), path, empty_buffer);
@@ -67,14 +67,12 @@ void VehicleLightStage::Update(const unsigned long index) {
     }
   }
 
-  // Determine brake light state
-  for (size_t cc = 0; cc < control_frame.size(); cc++) {
-    if (control_frame[cc].command.type() == typeid(carla::rpc::Command::ApplyVehicleControl)) {
-      carla::rpc::Command::ApplyVehicleControl& ctrl = boost::get<carla::rpc::Command::ApplyVehicleControl>(control_frame[cc].command);
-      if (ctrl.actor == actor_id) {
-        brake_lights = (ctrl.control.brake > 0.5); // hard braking, avoid blinking for throttle control
-        break;
-      }
+  // Determine brake light state, the motion plan stage wrote the command of the vehicle at its index
+  if (index < control_frame.size() &&
+      control_frame[index].command.type() == typeid(carla::rpc::Command::ApplyVehicleControl)) {
+    carla::rpc::Command::ApplyVehicleControl& ctrl = boost::get<carla::rpc::Command::ApplyVehicleControl>(control_frame[index].command);
+    if (ctrl.actor == actor_id) {
+      brake_lights = (ctrl.control.brake > 0.5); // hard braking, avoid blinking for throttle control
     }
   }
 
@@ -0,0 +1,222 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+
+#include "carla/trafficmanager/Constants.h"
+#include "carla/trafficmanager/SimpleWaypoint.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Double ended queue of waypoints of a vehicle's path, stored as a ring of
+/// waypoint indices into the InMemoryMap's arena. The ring is allocated once
+/// with a fixed capacity on the first push, and only reallocated if a path
+/// ever outgrows it, so the buffers do not touch the heap in steady state.
+class WaypointBuffer {
+public:
+
+  class const_iterator {
+  public:
+
+    using iterator_category = std::input_iterator_tag;
+    using value_type = SimpleWaypointPtr;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const SimpleWaypointPtr *;
+    using reference = SimpleWaypointPtr;
+
+    const_iterator(const WaypointBuffer *buffer, size_t pos)
+      : buffer(buffer),
+        pos(pos) {}
+
+    SimpleWaypointPtr operator*() const {
+      return (*buffer)[pos];
+    }
+
+    const_iterator &operator++() {
+      ++pos;
+      return *this;
+    }
+
+    const_iterator &operator--() {
+      --pos;
+      return *this;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return pos == other.pos;
+    }
+
+    bool operator!=(const const_iterator &other) const {
+      return pos != other.pos;
+    }
+
+  private:
+
+    const WaypointBuffer *buffer;
+
+    size_t pos;
+  };
+
+  using value_type = SimpleWaypointPtr;
+  using size_type = size_t;
+
+  WaypointBuffer() = default;
+
+  WaypointBuffer(const WaypointBuffer &other) {
+    *this = other;
+  }
+
+  WaypointBuffer(WaypointBuffer &&other) noexcept {
+    *this = std::move(other);
+  }
+
+  WaypointBuffer &operator=(const WaypointBuffer &other) {
+    if (this != &other) {
+      clear();
+      for (SimpleWaypointPtr waypoint : other) {
+        push_back(waypoint);
+      }
+    }
+    return *this;
+  }
+
+  WaypointBuffer &operator=(WaypointBuffer &&other) noexcept {
+    arena = other.arena;
+    ring = std::move(other.ring);
+    mask = other.mask;
+    head = other.head;
+    count = other.count;
+    ring_allocations = other.ring_allocations;
+    other.mask = static_cast<size_t>(-1);
+    other.head = 0u;
+    other.count = 0u;
+    other.ring_allocations = 0u;
+    return *this;
+  }
+
+  bool empty() const {
+    return count == 0u;
+  }
+
+  size_t size() const {
+    return count;
+  }
+
+  size_t capacity() const {
+    return mask + 1u;
+  }
+
+  /// Number of times the ring was allocated, moves take it with the ring.
+  size_t allocations() const {
+    return ring_allocations;
+  }
+
+  SimpleWaypointPtr operator[](size_t pos) const {
+    DEBUG_ASSERT(pos < count);
+    return arena + ring[(head + pos) & mask];
+  }
+
+  SimpleWaypointPtr at(size_t pos) const {
+    if (pos >= count) {
+      throw_exception(std::out_of_range("waypoint buffer index out of range"));
+    }
+    return (*this)[pos];
+  }
+
+  SimpleWaypointPtr front() const {
+    return (*this)[0u];
+  }
+
+  SimpleWaypointPtr back() const {
+    return (*this)[count - 1u];
+  }
+
+  const_iterator begin() const {
+    return {this, 0u};
+  }
+
+  const_iterator end() const {
+    return {this, count};
+  }
+
+  void push_back(SimpleWaypointPtr waypoint) {
+    DEBUG_ASSERT(waypoint != nullptr);
+    const WaypointIndex index = waypoint->GetIndex();
+    if (count == 0u) {
+      // Waypoints are laid out contiguously in the arena, so the arena's
+      // base can be recovered from any of them.
+      arena = waypoint - index;
+    }
+    DEBUG_ASSERT(arena + index == waypoint);
+    if (count == capacity()) {
+      Grow();
+    }
+    ring[(head + count) & mask] = index;
+    ++count;
+  }
+
+  void pop_front() {
+    DEBUG_ASSERT(count > 0u);
+    head = (head + 1u) & mask;
+    --count;
+  }
+
+  void pop_back() {
+    DEBUG_ASSERT(count > 0u);
+    --count;
+  }
+
+  void clear() {
+    head = 0u;
+    count = 0u;
+  }
+
+private:
+
+  void Grow() {
+    const size_t new_capacity = ring == nullptr
+        ? static_cast<size_t>(constants::PathBufferUpdate::BUFFER_CAPACITY)
+        : 2u * capacity();
+    DEBUG_ASSERT((new_capacity & (new_capacity - 1u)) == 0u);
+    std::unique_ptr<WaypointIndex[]> new_ring(new WaypointIndex[new_capacity]);
+    for (size_t i = 0u; i < count; ++i) {
+      new_ring[i] = ring[(head + i) & mask];
+    }
+    ring = std::move(new_ring);
+    mask = new_capacity - 1u;
+    head = 0u;
+    ++ring_allocations;
+  }
+
+  /// First waypoint of the arena the indices refer to.
+  SimpleWaypointPtr arena = nullptr;
+
+  std::unique_ptr<WaypointIndex[]> ring;
+
+  /// Capacity minus one, the capacity is always a power of two.
+  size_t mask = static_cast<size_t>(-1);
+
+  size_t head = 0u;
+
+  size_t count = 0u;
+
+  size_t ring_allocations = 0u;
+};
+
+using Buffer = WaypointBuffer;
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,204 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include "carla/trafficmanager/WaypointSpatialIndex.h"
+
+namespace carla {
+namespace traffic_manager {
+
+constexpr uint32_t WaypointSpatialIndex::NODE_CAPACITY;
+
+namespace {
+
+  /// Orders the items so that each run of NODE_CAPACITY items is a tile:
+  /// items are sorted by x, cut in vertical slices of about sqrt(tiles)
+  /// tiles, and each slice is sorted by y.
+  template <typename Iterator, typename GetX, typename GetY>
+  void SortTileRecursive(Iterator begin, Iterator end, GetX get_x, GetY get_y) {
+    using Item = typename std::iterator_traits<Iterator>::value_type;
+    const size_t size = static_cast<size_t>(std::distance(begin, end));
+    const size_t capacity = WaypointSpatialIndex::NODE_CAPACITY;
+    const size_t tile_count = (size + capacity - 1u) / capacity;
+    const size_t slice_count = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(tile_count))));
+    const size_t slice_size = std::max<size_t>(slice_count, 1u) * capacity;
+
+    std::sort(begin, end, [&](const Item &lhs, const Item &rhs) { return get_x(lhs) < get_x(rhs); });
+    for (size_t first = 0u; first < size; first += slice_size) {
+      const size_t last = std::min(first + slice_size, size);
+      std::sort(begin + static_cast<std::ptrdiff_t>(first), begin + static_cast<std::ptrdiff_t>(last),
+          [&](const Item &lhs, const Item &rhs) { return get_y(lhs) < get_y(rhs); });
+    }
+  }
+
+  SpatialIndexNode MakeNode(const size_t first, const size_t count) {
+    SpatialIndexNode node;
+    for (auto axis = 0u; axis < 3u; ++axis) {
+      node.min[axis] = std::numeric_limits<float>::max();
+      node.max[axis] = std::numeric_limits<float>::lowest();
+    }
+    node.first = static_cast<uint32_t>(first);
+    node.count = static_cast<uint32_t>(count);
+    return node;
+  }
+
+  void Extend(SpatialIndexNode &node, const float (&min)[3u], const float (&max)[3u]) {
+    for (auto axis = 0u; axis < 3u; ++axis) {
+      node.min[axis] = std::min(node.min[axis], min[axis]);
+      node.max[axis] = std::max(node.max[axis], max[axis]);
+    }
+  }
+
+  float DistanceSquared(const SpatialIndexNode &node, const cg::Location &location) {
+    const float point[3u] = {location.x, location.y, location.z};
+    float result = 0.0f;
+    for (auto axis = 0u; axis < 3u; ++axis) {
+      float delta = 0.0f;
+      if (point[axis] < node.min[axis]) {
+        delta = node.min[axis] - point[axis];
+      } else if (point[axis] > node.max[axis]) {
+        delta = point[axis] - node.max[axis];
+      }
+      result += delta * delta;
+    }
+    return result;
+  }
+
+} // namespace
+
+void WaypointSpatialIndex::Build(std::vector<SpatialIndexEntry> in_entries) {
+  owned_entries = std::move(in_entries);
+  owned_nodes.clear();
+
+  // Leaves, one per tile of entries.
+  SortTileRecursive(owned_entries.begin(), owned_entries.end(),
+      [](const SpatialIndexEntry &entry) { return entry.x; },
+      [](const SpatialIndexEntry &entry) { return entry.y; });
+  for (size_t first = 0u; first < owned_entries.size(); first += NODE_CAPACITY) {
+    const size_t count = std::min<size_t>(NODE_CAPACITY, owned_entries.size() - first);
+    SpatialIndexNode node = MakeNode(first, count);
+    for (size_t i = first; i < first + count; ++i) {
+      const float point[3u] = {owned_entries[i].x, owned_entries[i].y, owned_entries[i].z};
+      Extend(node, point, point);
+    }
+    owned_nodes.push_back(node);
+  }
+  const size_t leaves = owned_nodes.size();
+
+  // Upper levels, until a single root is left.
+  size_t level_begin = 0u;
+  while (owned_nodes.size() - level_begin > 1u) {
+    const size_t level_end = owned_nodes.size();
+    auto center = [](const SpatialIndexNode &node, size_t axis) {
+      return 0.5f * (node.min[axis] + node.max[axis]);
+    };
+    SortTileRecursive(
+        owned_nodes.begin() + static_cast<std::ptrdiff_t>(level_begin),
+        owned_nodes.begin() + static_cast<std::ptrdiff_t>(level_end),
+        [&](const SpatialIndexNode &node) { return center(node, 0u); },
+        [&](const SpatialIndexNode &node) { return center(node, 1u); });
+    for (size_t first = level_begin; first < level_end; first += NODE_CAPACITY) {
+      const size_t count = std::min<size_t>(NODE_CAPACITY, level_end - first);
+      SpatialIndexNode node = MakeNode(first, count);
+      for (size_t i = first; i < first + count; ++i) {
+        Extend(node, owned_nodes[i].min, owned_nodes[i].max);
+      }
+      owned_nodes.push_back(node);
+    }
+    level_begin = level_end;
+  }
+
+  View(owned_entries.data(), owned_entries.size(), owned_nodes.data(), owned_nodes.size(), leaves);
+}
+
+void WaypointSpatialIndex::View(
+    const SpatialIndexEntry *in_entries,
+    const size_t in_entry_count,
+    const SpatialIndexNode *in_nodes,
+    const size_t in_node_count,
+    const size_t in_leaf_count) {
+  entries = in_entries;
+  entry_count = in_entry_count;
+  nodes = in_nodes;
+  node_count = in_node_count;
+  leaf_count = in_leaf_count;
+}
+
+bool WaypointSpatialIndex::IsValid(const size_t waypoint_count) const {
+  if (leaf_count > node_count || (entry_count > 0u) != (node_count > 0u)) {
+    return false;
+  }
+  for (size_t i = 0u; i < entry_count; ++i) {
+    if (entries[i].index >= waypoint_count) {
+      return false;
+    }
+  }
+  for (size_t i = 0u; i < node_count; ++i) {
+    const SpatialIndexNode &node = nodes[i];
+    const size_t last = static_cast<size_t>(node.first) + node.count;
+    if (node.count == 0u || node.count > NODE_CAPACITY) {
+      return false;
+    }
+    // Children always precede their parent, so a walk from the root ends.
+    if (i < leaf_count ? last > entry_count : last > i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WaypointSpatialIndex::Nearest(const cg::Location &location, WaypointIndex &result) const {
+  if (node_count == 0u) {
+    return false;
+  }
+  float best_distance = std::numeric_limits<float>::max();
+  Nearest(static_cast<uint32_t>(node_count - 1u), location, best_distance, result);
+  return true;
+}
+
+void WaypointSpatialIndex::Nearest(
+    const uint32_t node_id,
+    const cg::Location &location,
+    float &best_distance,
+    WaypointIndex &result) const {
+  const SpatialIndexNode &node = nodes[node_id];
+
+  if (IsLeaf(node_id)) {
+    for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+      const SpatialIndexEntry &entry = entries[i];
+      const float dx = entry.x - location.x;
+      const float dy = entry.y - location.y;
+      const float dz = entry.z - location.z;
+      const float distance = dx * dx + dy * dy + dz * dz;
+      if (distance < best_distance) {
+        best_distance = distance;
+        result = entry.index;
+      }
+    }
+    return;
+  }
+
+  // Visit the closest children first, and only while they can still hold a
+  // closer entry.
+  std::array<std::pair<float, uint32_t>, NODE_CAPACITY> children;
+  size_t child_count = 0u;
+  for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+    children[child_count++] = std::make_pair(DistanceSquared(nodes[i], location), i);
+  }
+  std::sort(children.begin(), children.begin() + static_cast<std::ptrdiff_t>(child_count));
+  for (size_t i = 0u; i < child_count && children[i].first < best_distance; ++i) {
+    Nearest(children[i].second, location, best_distance, result);
+  }
+}
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,159 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "carla/geom/Location.h"
+#include "carla/trafficmanager/SimpleWaypoint.h"
+
+namespace carla {
+namespace traffic_manager {
+
+namespace cg = carla::geom;
+
+/// Point of the spatial index, the location of a waypoint of the arena.
+struct SpatialIndexEntry {
+  float x;
+  float y;
+  float z;
+  WaypointIndex index;
+};
+
+/// Node of the spatial index. Leaf nodes hold the range [first, first + count)
+/// of the entries, inner nodes the same range of their child nodes.
+struct SpatialIndexNode {
+  float min[3u];
+  float max[3u];
+  uint32_t first;
+  uint32_t count;
+};
+
+static_assert(sizeof(SpatialIndexEntry) == 16u, "SpatialIndexEntry layout is part of the map cache format.");
+static_assert(sizeof(SpatialIndexNode) == 32u, "SpatialIndexNode layout is part of the map cache format.");
+
+/// Static R-tree over the waypoints of the InMemoryMap, packed bottom-up with
+/// Sort-Tile-Recursive. Nodes are stored level by level in one array, leaves
+/// first and root last, so the whole tree is two flat arrays that can be
+/// written to the map cache and used in place once it is mapped back.
+class WaypointSpatialIndex {
+public:
+
+  static constexpr uint32_t NODE_CAPACITY = 16u;
+
+  WaypointSpatialIndex() = default;
+
+  WaypointSpatialIndex(const WaypointSpatialIndex &) = delete;
+  WaypointSpatialIndex &operator=(const WaypointSpatialIndex &) = delete;
+
+  /// Packs the given entries, the index owns the resulting arrays.
+  void Build(std::vector<SpatialIndexEntry> in_entries);
+
+  /// Uses arrays produced by Build and stored elsewhere, without copying
+  /// them. They must outlive the index.
+  void View(
+      const SpatialIndexEntry *in_entries,
+      size_t in_entry_count,
+      const SpatialIndexNode *in_nodes,
+      size_t in_node_count,
+      size_t in_leaf_count);
+
+  /// Checks that the viewed arrays form a tree over waypoints below
+  /// waypoint_count, so queries cannot read out of bounds.
+  bool IsValid(size_t waypoint_count) const;
+
+  bool Empty() const {
+    return entry_count == 0u;
+  }
+
+  /// Returns false if the index is empty.
+  bool Nearest(const cg::Location &location, WaypointIndex &result) const;
+
+  /// Calls callback(index) for every entry inside the box [min, max] in tree
+  /// order, until the callback returns false.
+  template <typename Callback>
+  void Query(const cg::Location &min, const cg::Location &max, Callback &&callback) const {
+    if (node_count > 0u) {
+      Query(static_cast<uint32_t>(node_count - 1u), min, max, callback);
+    }
+  }
+
+  const SpatialIndexEntry *GetEntries() const {
+    return entries;
+  }
+
+  size_t GetEntryCount() const {
+    return entry_count;
+  }
+
+  const SpatialIndexNode *GetNodes() const {
+    return nodes;
+  }
+
+  size_t GetNodeCount() const {
+    return node_count;
+  }
+
+  size_t GetLeafCount() const {
+    return leaf_count;
+  }
+
+private:
+
+  bool IsLeaf(uint32_t node) const {
+    return node < leaf_count;
+  }
+
+  static bool Overlaps(const SpatialIndexNode &node, const cg::Location &min, const cg::Location &max) {
+    return node.min[0u] <= max.x && min.x <= node.max[0u]
+        && node.min[1u] <= max.y && min.y <= node.max[1u]
+        && node.min[2u] <= max.z && min.z <= node.max[2u];
+  }
+
+  template <typename Callback>
+  bool Query(uint32_t node_id, const cg::Location &min, const cg::Location &max, Callback &callback) const {
+    const SpatialIndexNode &node = nodes[node_id];
+    if (!Overlaps(node, min, max)) {
+      return true;
+    }
+    for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+      if (IsLeaf(node_id)) {
+        const SpatialIndexEntry &entry = entries[i];
+        if (entry.x >= min.x && entry.x <= max.x &&
+            entry.y >= min.y && entry.y <= max.y &&
+            entry.z >= min.z && entry.z <= max.z &&
+            !callback(entry.index)) {
+          return false;
+        }
+      } else if (!Query(i, min, max, callback)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void Nearest(uint32_t node_id, const cg::Location &location, float &best_distance, WaypointIndex &result) const;
+
+  std::vector<SpatialIndexEntry> owned_entries;
+
+  std::vector<SpatialIndexNode> owned_nodes;
+
+  const SpatialIndexEntry *entries = nullptr;
+
+  size_t entry_count = 0u;
+
+  const SpatialIndexNode *nodes = nullptr;
+
+  size_t node_count = 0u;
+
+  size_t leaf_count = 0u;
+};
+
+} // namespace traffic_manager
+} // namespace carla
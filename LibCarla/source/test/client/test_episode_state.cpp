@@ -0,0 +1,387 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/client/detail/EpisodeState.h>
+#include <carla/sensor/Deserializer.h>
+#include <carla/sensor/SensorRegistry.h>
+#include <carla/sensor/data/RawEpisodeState.h>
+#include <carla/sensor/s11n/EpisodeStateDecoder.h>
+#include <carla/sensor/s11n/EpisodeStateEncoder.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using carla::ActorId;
+using carla::client::ActorSnapshot;
+using carla::client::detail::EpisodeState;
+using carla::sensor::data::ActorDynamicState;
+using carla::sensor::data::RawEpisodeState;
+using carla::sensor::s11n::EpisodeStateDecoder;
+using carla::sensor::s11n::EpisodeStateEncoder;
+using carla::sensor::s11n::EpisodeStateSerializer;
+
+/// Prepends the sensor header the stream adds to every message.
+static carla::Buffer make_message(uint64_t frame, const carla::Buffer &payload) {
+  using SensorHeader = carla::sensor::s11n::SensorHeaderSerializer;
+  constexpr auto index = carla::sensor::SensorRegistry::get<FWorldObserver *>::index;
+  const carla::Buffer sensor_header = SensorHeader::Serialize(index, frame, 1.5, carla::rpc::Transform{});
+  carla::Buffer message(sensor_header.size() + payload.size());
+  std::memcpy(message.data(), sensor_header.data(), sensor_header.size());
+  std::memcpy(message.data() + sensor_header.size(), payload.data(), payload.size());
+  return message;
+}
+
+static EpisodeStateSerializer::Header make_header() {
+  EpisodeStateSerializer::Header header{};
+  header.episode_id = 7u;
+  header.delta_seconds = 0.05f;
+  return header;
+}
+
+/// Makes the message the world observer sends with the given actors.
+static carla::Buffer make_episode_state_message(
+    const std::vector<ActorDynamicState> &actors,
+    uint8_t simulation_state = EpisodeStateSerializer::None) {
+  auto header = make_header();
+  header.simulation_state = static_cast<EpisodeStateSerializer::SimulationState>(simulation_state);
+  const size_t actors_size = sizeof(ActorDynamicState) * actors.size();
+  carla::Buffer payload(sizeof(header) + actors_size);
+  std::memcpy(payload.data(), &header, sizeof(header));
+  if (actors_size > 0u) {
+    std::memcpy(payload.data() + sizeof(header), actors.data(), actors_size);
+  }
+  return make_message(42u, payload);
+}
+
+static auto deserialize(carla::Buffer message) {
+  return boost::static_pointer_cast<const RawEpisodeState>(
+      carla::sensor::Deserializer::Deserialize(std::move(message)));
+}
+
+static auto make_episode_state(carla::Buffer message) {
+  return std::make_shared<const EpisodeState>(deserialize(std::move(message)));
+}
+
+static std::vector<ActorDynamicState> make_actors(size_t number_of_actors, uint32_t stride = 2u) {
+  std::vector<ActorDynamicState> actors(number_of_actors);
+  for (auto i = 0u; i < number_of_actors; ++i) {
+    actors[i] = ActorDynamicState{};
+    actors[i].id = stride * i + 1u;
+    actors[i].transform.location.x = static_cast<float>(i);
+    actors[i].velocity.y = static_cast<float>(i);
+  }
+  return actors;
+}
+
+static void check_lookups(const EpisodeState &state, const std::vector<ActorDynamicState> &actors) {
+  ASSERT_EQ(state.size(), actors.size());
+  for (auto &&actor : actors) {
+    ASSERT_TRUE(state.ContainsActorSnapshot(actor.id));
+    const ActorSnapshot snapshot = state.GetActorSnapshot(actor.id);
+    ASSERT_EQ(snapshot.id, actor.id);
+    ASSERT_EQ(snapshot.transform.location.x, actor.transform.location.x);
+    ASSERT_EQ(snapshot.velocity.y, actor.velocity.y);
+    ASSERT_FALSE(state.ContainsActorSnapshot(actor.id + 1u));
+    ASSERT_FALSE(state.GetActorSnapshotIfPresent(actor.id + 1u).has_value());
+  }
+  ASSERT_FALSE(state.ContainsActorSnapshot(0u));
+}
+
+TEST(episode_state, lookup_sorted) {
+  const auto actors = make_actors(100u);
+  const auto state = make_episode_state(make_episode_state_message(actors, EpisodeStateSerializer::ActorsSortedById));
+  ASSERT_EQ(state->GetEpisodeId(), 7u);
+  ASSERT_EQ(state->GetFrame(), 42u);
+  ASSERT_FALSE(state->HasMapChanged());
+  check_lookups(*state, actors);
+}
+
+TEST(episode_state, lookup_unsorted) {
+  auto actors = make_actors(100u);
+  std::shuffle(actors.begin(), actors.end(), std::mt19937{42u});
+  const auto state = make_episode_state(make_episode_state_message(actors));
+  check_lookups(*state, actors);
+
+  // Iteration and ids keep the order received.
+  size_t i = 0u;
+  for (const ActorSnapshot &snapshot : *state) {
+    ASSERT_EQ(snapshot.id, actors[i++].id);
+  }
+  i = 0u;
+  for (auto id : state->GetActorIds()) {
+    ASSERT_EQ(id, actors[i++].id);
+  }
+}
+
+TEST(episode_state, lookup_unsorted_sparse_ids) {
+  auto actors = make_actors(100u, 1000u);
+  std::shuffle(actors.begin(), actors.end(), std::mt19937{42u});
+  const auto state = make_episode_state(make_episode_state_message(actors));
+  check_lookups(*state, actors);
+}
+
+TEST(episode_state, empty) {
+  const auto state = make_episode_state(make_episode_state_message({}));
+  ASSERT_EQ(state->size(), 0u);
+  ASSERT_FALSE(state->ContainsActorSnapshot(1u));
+  const EpisodeState initial{3u};
+  ASSERT_EQ(initial.size(), 0u);
+  ASSERT_FALSE(initial.ContainsActorSnapshot(1u));
+  ASSERT_EQ(initial.begin(), initial.end());
+}
+
+/// Time of receiving a tick and reading two actors from it, compared to
+/// copying every actor into a hash map as the episode state used to do.
+TEST(episode_state, benchmark_tick) {
+  constexpr auto ticks = 200u;
+  for (size_t number_of_actors : {100u, 1000u, 5000u}) {
+    const auto actors = make_actors(number_of_actors);
+    const ActorId first = actors.front().id;
+    const ActorId last = actors.back().id;
+    for (bool sorted : {true, false}) {
+      auto received = actors;
+      if (!sorted) {
+        std::shuffle(received.begin(), received.end(), std::mt19937{42u});
+      }
+      const auto message = make_episode_state_message(
+          received,
+          sorted ? EpisodeStateSerializer::ActorsSortedById : EpisodeStateSerializer::None);
+      std::vector<carla::Buffer> messages;
+      for (auto i = 0u; i < ticks; ++i) {
+        messages.emplace_back(message.size());
+        std::memcpy(messages.back().data(), message.data(), message.size());
+      }
+
+      float sum = 0.0f;
+      carla::StopWatch flat_watch;
+      for (auto &&buffer : messages) {
+        const auto state = make_episode_state(std::move(buffer));
+        sum += state->GetActorSnapshot(first).transform.location.x;
+        sum += state->GetActorSnapshot(last).transform.location.x;
+      }
+      flat_watch.Stop();
+
+      carla::StopWatch map_watch;
+      for (auto i = 0u; i < ticks; ++i) {
+        std::unordered_map<ActorId, ActorSnapshot> map;
+        map.reserve(received.size());
+        for (auto &&actor : received) {
+          map.emplace(actor.id, ActorSnapshot{
+              actor.id,
+              actor.actor_state,
+              actor.transform,
+              actor.velocity,
+              actor.angular_velocity,
+              actor.acceleration,
+              actor.state});
+        }
+        sum += map.at(first).transform.location.x;
+        sum += map.at(last).transform.location.x;
+      }
+      map_watch.Stop();
+
+      carla::logging::log(
+          number_of_actors, "actors,", sorted ? "sorted:" : "unsorted:",
+          static_cast<double>(flat_watch.GetElapsedTime<std::chrono::microseconds>()) / ticks,
+          "us per tick, hash map",
+          static_cast<double>(map_watch.GetElapsedTime<std::chrono::microseconds>()) / ticks,
+          "us per tick");
+      ASSERT_GT(sum, 0.0f);
+    }
+  }
+}
+
+/// Rebuilds the tick the encoder wrote for @a frame as the client episode
+/// does.
+static std::shared_ptr<const EpisodeState> decode(
+    EpisodeStateDecoder &decoder,
+    uint64_t frame,
+    const carla::Buffer &payload) {
+  auto data = decoder.Decode(deserialize(make_message(frame, payload)));
+  return data != nullptr ? std::make_shared<const EpisodeState>(std::move(data)) : nullptr;
+}
+
+static void check_equal(const EpisodeState &state, const std::vector<ActorDynamicState> &actors) {
+  ASSERT_EQ(state.size(), actors.size());
+  for (auto &&actor : actors) {
+    const auto snapshot = state.GetActorSnapshotIfPresent(actor.id);
+    ASSERT_TRUE(snapshot.has_value());
+    ASSERT_NEAR(snapshot->transform.location.x, actor.transform.location.x, 1e-3f);
+    ASSERT_NEAR(snapshot->transform.location.y, actor.transform.location.y, 1e-3f);
+    ASSERT_NEAR(snapshot->transform.rotation.yaw, actor.transform.rotation.yaw, 1e-2f);
+    ASSERT_EQ(snapshot->velocity.y, actor.velocity.y);
+  }
+}
+
+TEST(episode_state, quantized_transform) {
+  const carla::geom::Transform transform{
+      carla::geom::Location{1234.5678f, -0.0004f, 12.3456f},
+      carla::geom::Rotation{-89.99f, 179.99f, -180.0f}};
+  const auto result = EpisodeStateSerializer::Dequantize(EpisodeStateSerializer::Quantize(transform));
+  ASSERT_NEAR(result.location.x, transform.location.x, 1e-3f);
+  ASSERT_NEAR(result.location.y, transform.location.y, 1e-3f);
+  ASSERT_NEAR(result.location.z, transform.location.z, 1e-3f);
+  ASSERT_NEAR(result.rotation.pitch, transform.rotation.pitch, 1e-2f);
+  // 179.99 wraps around to -180.
+  ASSERT_NEAR(std::remainder(result.rotation.yaw - transform.rotation.yaw, 360.0f), 0.0f, 1e-2f);
+  ASSERT_NEAR(std::remainder(result.rotation.roll - transform.rotation.roll, 360.0f), 0.0f, 1e-2f);
+}
+
+TEST(episode_state, delta_ticks) {
+  EpisodeStateEncoder encoder;
+  encoder.SetKeyframeInterval(10u);
+  EpisodeStateDecoder decoder;
+  auto actors = make_actors(200u);
+  std::mt19937 random{42u};
+  size_t number_of_deltas = 0u;
+  for (auto frame = 1u; frame <= 35u; ++frame) {
+    // Move a few actors, remove one and add another.
+    for (auto i = 0u; i < 5u; ++i) {
+      auto &actor = actors[random() % actors.size()];
+      actor.transform.location.y += 0.5f;
+      actor.transform.rotation.yaw = static_cast<float>(random() % 360u) - 180.0f;
+    }
+    if (frame % 3u == 0u) {
+      actors.erase(actors.begin() + (random() % actors.size()));
+      auto added = ActorDynamicState{};
+      added.id = actors.back().id + 2u;
+      actors.emplace_back(added);
+    }
+    carla::Buffer payload;
+    encoder.Encode(frame, make_header(), actors, payload);
+    const auto state = decode(decoder, frame, payload);
+    ASSERT_NE(state, nullptr);
+    ASSERT_EQ(state->GetFrame(), frame);
+    ASSERT_EQ(state->GetEpisodeId(), 7u);
+    check_equal(*state, actors);
+    if (payload.size() < sizeof(EpisodeStateSerializer::Header) + sizeof(ActorDynamicState) * actors.size()) {
+      ++number_of_deltas;
+    }
+  }
+  // Every tick but one in ten is a delta.
+  ASSERT_EQ(number_of_deltas, 31u);
+
+  // A client that subscribes late waits for a keyframe, or for the server
+  // to force one.
+  EpisodeStateDecoder late_decoder;
+  carla::Buffer payload;
+  encoder.Encode(36u, make_header(), actors, payload);
+  ASSERT_EQ(decode(late_decoder, 36u, payload), nullptr);
+  encoder.ForceKeyframe();
+  encoder.Encode(37u, make_header(), actors, payload);
+  ASSERT_NE(decode(late_decoder, 37u, payload), nullptr);
+}
+
+TEST(episode_state, delta_wrong_keyframe) {
+  EpisodeStateEncoder encoder;
+  encoder.SetKeyframeInterval(10u);
+  const auto actors = make_actors(100u);
+  carla::Buffer keyframe;
+  encoder.Encode(1u, make_header(), actors, keyframe);
+  carla::Buffer delta;
+  encoder.Encode(2u, make_header(), actors, delta);
+  const auto raw_keyframe = deserialize(make_message(1u, keyframe));
+  const auto raw_delta = deserialize(make_message(2u, delta));
+  ASSERT_FALSE(raw_keyframe->IsDelta());
+  ASSERT_TRUE(raw_delta->IsDelta());
+  ASSERT_EQ(raw_delta->size(), 0u);
+  ASSERT_NE(EpisodeStateSerializer::ApplyDelta(*raw_keyframe, *raw_delta), nullptr);
+  // Same actors, but the delta names frame 1 as its keyframe.
+  const auto other_keyframe = deserialize(make_message(3u, keyframe));
+  ASSERT_EQ(EpisodeStateSerializer::ApplyDelta(*other_keyframe, *raw_delta), nullptr);
+
+  // The decoder forgets the keyframe and drops the deltas until the next one.
+  EpisodeStateDecoder decoder;
+  ASSERT_NE(decoder.Decode(other_keyframe), nullptr);
+  ASSERT_EQ(decoder.Decode(raw_delta), nullptr);
+  ASSERT_FALSE(decoder.HasKeyframe());
+  ASSERT_EQ(decoder.Decode(raw_delta), nullptr);
+  ASSERT_NE(decoder.Decode(raw_keyframe), nullptr);
+  ASSERT_NE(decoder.Decode(raw_delta), nullptr);
+}
+
+TEST(episode_state, delta_malformed) {
+  EpisodeStateEncoder encoder;
+  encoder.SetKeyframeInterval(10u);
+  auto actors = make_actors(100u);
+  carla::Buffer keyframe;
+  encoder.Encode(1u, make_header(), actors, keyframe);
+  actors[10u].transform.location.y += 1.0f;
+  actors.erase(actors.begin() + 20u);
+  carla::Buffer delta;
+  encoder.Encode(2u, make_header(), actors, delta);
+  const auto raw_keyframe = deserialize(make_message(1u, keyframe));
+  ASSERT_NE(EpisodeStateSerializer::ApplyDelta(*raw_keyframe, *deserialize(make_message(2u, delta))), nullptr);
+
+  // Truncated anywhere, including inside the delta header.
+  const size_t delta_size = delta.size();
+  for (size_t size : {delta_size - 1u, delta_size - sizeof(ActorId), sizeof(EpisodeStateSerializer::Header) + 4u}) {
+    carla::Buffer truncated(delta.data(), size);
+    const auto raw_delta = deserialize(make_message(2u, truncated));
+    ASSERT_TRUE(raw_delta->IsDelta());
+    ASSERT_EQ(EpisodeStateSerializer::ApplyDelta(*raw_keyframe, *raw_delta), nullptr);
+  }
+
+  // More removed actors than the keyframe has, with the sizes adjusted to
+  // match.
+  EpisodeStateSerializer::DeltaHeader delta_header;
+  std::memcpy(&delta_header, delta.data() + sizeof(EpisodeStateSerializer::Header), sizeof(delta_header));
+  ASSERT_EQ(delta_header.number_of_removed_actors, 1u);
+  const auto removed = delta_header.number_of_removed_actors;
+  delta_header.number_of_removed_actors = 101u;
+  std::vector<unsigned char> forged(delta.begin(), delta.end());
+  std::memcpy(forged.data() + sizeof(EpisodeStateSerializer::Header), &delta_header, sizeof(delta_header));
+  forged.insert(
+      forged.begin() + sizeof(EpisodeStateSerializer::Header) + sizeof(delta_header) + removed * sizeof(ActorId),
+      (101u - removed) * sizeof(ActorId),
+      0u);
+  const auto raw_forged = deserialize(make_message(2u, carla::Buffer(forged)));
+  ASSERT_EQ(EpisodeStateSerializer::ApplyDelta(*raw_keyframe, *raw_forged), nullptr);
+}
+
+/// Size of the ticks and time to rebuild them with most of the actors static.
+TEST(episode_state, benchmark_delta) {
+  constexpr auto ticks = 100u;
+  constexpr auto number_of_moving_actors = 100u;
+  for (size_t number_of_actors : {1000u, 5000u}) {
+    EpisodeStateEncoder encoder;
+    encoder.SetKeyframeInterval(30u);
+    EpisodeStateDecoder decoder;
+    auto actors = make_actors(number_of_actors);
+    size_t bytes = 0u;
+    float sum = 0.0f;
+    carla::StopWatch watch;
+    for (auto frame = 1u; frame <= ticks; ++frame) {
+      for (auto i = 0u; i < number_of_moving_actors; ++i) {
+        actors[i * (number_of_actors / number_of_moving_actors)].transform.location.y += 0.1f;
+      }
+      carla::Buffer payload;
+      encoder.Encode(frame, make_header(), actors, payload);
+      bytes += payload.size();
+      const auto state = decode(decoder, frame, payload);
+      sum += state->GetActorSnapshot(actors.back().id).transform.location.x;
+    }
+    watch.Stop();
+    const size_t full_bytes =
+        ticks * (sizeof(EpisodeStateSerializer::Header) + sizeof(ActorDynamicState) * number_of_actors);
+    carla::logging::log(
+        number_of_actors, "actors,", number_of_moving_actors, "moving:",
+        bytes / ticks, "bytes per tick, full",
+        full_bytes / ticks, "bytes per tick,",
+        static_cast<double>(watch.GetElapsedTime<std::chrono::microseconds>()) / ticks,
+        "us per tick to encode and rebuild");
+    ASSERT_LT(bytes, full_bytes / 4u);
+    ASSERT_GT(sum, 0.0f);
+  }
+}
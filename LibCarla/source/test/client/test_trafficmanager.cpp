@@ -0,0 +1,751 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "OpenDrive.h"
+#include "Random.h"
+
+#include <carla/StopWatch.h>
+#include <carla/client/Map.h>
+#include <carla/opendrive/OpenDriveParser.h>
+#include <carla/trafficmanager/BroadPhase.h>
+#include <carla/trafficmanager/CollisionGeometry.h>
+#include <carla/trafficmanager/CollisionStage.h>
+#include <carla/trafficmanager/InMemoryMap.h>
+#include <carla/trafficmanager/StageProfiler.h>
+#include <carla/trafficmanager/WaypointBuffer.h>
+#include <carla/trafficmanager/WaypointSpatialIndex.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace carla::traffic_manager;
+using carla::geom::Location;
+using carla::opendrive::OpenDriveParser;
+using ActorId = carla::ActorId;
+using util::Random;
+
+// Standard allocator that counts the allocations made through it, so a
+// benchmark only counts the allocations of the containers it is given to.
+template <typename T>
+class CountingAllocator {
+public:
+
+  using value_type = T;
+
+  explicit CountingAllocator(size_t *count) : count(count) {}
+
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U> &other) : count(other.count) {}
+
+  T *allocate(size_t n) {
+    ++*count;
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T *ptr, size_t n) {
+    std::allocator<T>().deallocate(ptr, n);
+  }
+
+  template <typename U>
+  bool operator==(const CountingAllocator<U> &other) const {
+    return count == other.count;
+  }
+
+  template <typename U>
+  bool operator!=(const CountingAllocator<U> &other) const {
+    return count != other.count;
+  }
+
+private:
+
+  template <typename U>
+  friend class CountingAllocator;
+
+  size_t *count;
+};
+
+static std::vector<ActorId> brute_force_query(
+    const std::vector<BroadPhaseBounds> &all_bounds,
+    const BroadPhaseBounds &bounds) {
+  std::vector<ActorId> result;
+  for (auto i = 0u; i < all_bounds.size(); ++i) {
+    if (all_bounds[i].Overlaps(bounds)) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+TEST(trafficmanager, broad_phase) {
+  BroadPhase broad_phase(20.0f);
+  std::vector<BroadPhaseBounds> all_bounds(300u);
+  for (auto cycle = 0u; cycle < 20u; ++cycle) {
+    for (auto i = 0u; i < all_bounds.size(); ++i) {
+      BroadPhaseBounds bounds;
+      const auto origin = Random::Location(-300.0f, 300.0f);
+      bounds.Extend(origin);
+      bounds.Extend(origin + Random::Location(-40.0f, 40.0f));
+      all_bounds[i] = bounds;
+      broad_phase.Update(i, bounds);
+    }
+    std::vector<ActorId> result;
+    for (auto i = 0u; i < all_bounds.size(); ++i) {
+      broad_phase.Query(i, result);
+      ASSERT_EQ(result, brute_force_query(all_bounds, all_bounds[i]));
+    }
+  }
+  broad_phase.Remove(0u);
+  ASSERT_FALSE(broad_phase.Contains(0u));
+  std::vector<ActorId> result;
+  broad_phase.Query(0u, result);
+  ASSERT_TRUE(result.empty());
+  broad_phase.Query(all_bounds[1u], result);
+  ASSERT_EQ(std::count(result.begin(), result.end(), 0u), 0);
+  broad_phase.Clear();
+  ASSERT_EQ(broad_phase.Size(), 0u);
+}
+
+TEST(trafficmanager, broad_phase_benchmark) {
+  const std::string file = "Town10HD.xodr";
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  if (std::find(files.begin(), files.end(), file) == files.end()) {
+    carla::logging::log("Skipping broad phase benchmark,", file, "not found.");
+    return;
+  }
+  auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+  ASSERT_TRUE(m.has_value());
+  auto &map = *m;
+  auto waypoints = map.GenerateWaypoints(2.0);
+  ASSERT_FALSE(waypoints.empty());
+
+  // Waypoint buffer of a vehicle advancing one waypoint per cycle.
+  constexpr auto buffer_size = 25u;
+  constexpr auto cycles = 100u;
+  for (const auto number_of_vehicles : {500u, 1000u, 2000u}) {
+    std::vector<std::vector<Location>> routes(number_of_vehicles);
+    for (auto &route : routes) {
+      auto waypoint = waypoints[static_cast<size_t>(Random::Uniform(0.0, waypoints.size() - 1.0))];
+      route.push_back(map.ComputeTransform(waypoint).location);
+      while (route.size() < buffer_size + cycles) {
+        auto next = map.GetNext(waypoint, 2.0);
+        if (!next.empty()) {
+          waypoint = next[0u];
+        }
+        route.push_back(map.ComputeTransform(waypoint).location);
+      }
+    }
+
+    BroadPhase broad_phase(20.0f);
+    std::vector<BroadPhaseBounds> all_bounds(number_of_vehicles);
+    std::vector<ActorId> result;
+    size_t candidates = 0u;
+    size_t update_time = 0u;
+    size_t query_time = 0u;
+    for (auto cycle = 0u; cycle < cycles; ++cycle) {
+      for (auto i = 0u; i < number_of_vehicles; ++i) {
+        BroadPhaseBounds bounds;
+        for (auto j = cycle; j < cycle + buffer_size; ++j) {
+          bounds.Extend(routes[i][j]);
+        }
+        bounds.Inflate(2.0f);
+        all_bounds[i] = bounds;
+      }
+
+      carla::StopWatch update_watch;
+      for (auto i = 0u; i < number_of_vehicles; ++i) {
+        broad_phase.Update(i, all_bounds[i]);
+      }
+      update_time += update_watch.GetElapsedTime<std::chrono::microseconds>();
+
+      carla::StopWatch query_watch;
+      for (auto i = 0u; i < number_of_vehicles; ++i) {
+        broad_phase.Query(i, result);
+        candidates += result.size();
+      }
+      query_time += query_watch.GetElapsedTime<std::chrono::microseconds>();
+
+      if (cycle % 25u == 0u) {
+        for (auto i = 0u; i < number_of_vehicles; ++i) {
+          broad_phase.Query(i, result);
+          ASSERT_EQ(result, brute_force_query(all_bounds, all_bounds[i]));
+        }
+      }
+    }
+    carla::logging::log(
+        file, number_of_vehicles, "vehicles:",
+        static_cast<double>(update_time) / cycles, "us update,",
+        static_cast<double>(query_time) / cycles, "us queries per cycle,",
+        static_cast<double>(candidates) / (cycles * number_of_vehicles), "candidates per vehicle.");
+  }
+}
+
+// Rectangle around a vehicle, in the order of CollisionStage::GetBoundary.
+static LocationVector make_bbox(const Location &location, float yaw) {
+  const Location forward(2.3f * std::cos(yaw), 2.3f * std::sin(yaw), 0.0f);
+  const Location left(-1.0f * std::sin(yaw), 1.0f * std::cos(yaw), 0.0f);
+  return {
+      location + forward - left,
+      location - forward - left,
+      location - forward + left,
+      location + forward + left};
+}
+
+// Curved strip ahead of a vehicle, laid out as CollisionStage::GetGeodesicBoundary.
+static LocationVector make_geodesic(const LocationVector &bbox, Location location, float yaw, int points) {
+  LocationVector left_boundary;
+  LocationVector right_boundary;
+  for (auto i = 0; i < points; ++i) {
+    location += Location(5.0f * std::cos(yaw), 5.0f * std::sin(yaw), 0.0f);
+    yaw += static_cast<float>(Random::Uniform(-0.3, 0.3));
+    const Location left(-1.0f * std::sin(yaw), 1.0f * std::cos(yaw), 0.0f);
+    left_boundary.push_back(location + left);
+    right_boundary.push_back(location - left);
+  }
+  LocationVector boundary(right_boundary.rbegin(), right_boundary.rend());
+  boundary.insert(boundary.end(), bbox.begin(), bbox.end());
+  boundary.insert(boundary.end(), left_boundary.begin(), left_boundary.end());
+  return boundary;
+}
+
+static std::array<double, 4u> get_distances(const GeometryComparison &comparison) {
+  return {comparison.reference_vehicle_to_other_geodesic,
+          comparison.other_vehicle_to_reference_geodesic,
+          comparison.inter_geodesic_distance,
+          comparison.inter_bbox_distance};
+}
+
+TEST(trafficmanager, collision_geometry) {
+  std::vector<std::array<LocationVector, 4u>> pairs;
+  for (auto i = 0u; i < 20'000u; ++i) {
+    const auto reference_location = Random::Location(-400.0f, 400.0f);
+    const auto other_location = reference_location + Random::Location(-30.0f, 30.0f);
+    const auto reference_yaw = static_cast<float>(Random::Uniform(-M_PI, M_PI));
+    const auto other_yaw = static_cast<float>(Random::Uniform(-M_PI, M_PI));
+    const auto reference_bbox = make_bbox(reference_location, reference_yaw);
+    const auto other_bbox = make_bbox(other_location, other_yaw);
+    pairs.push_back({
+        reference_bbox,
+        other_bbox,
+        make_geodesic(reference_bbox, reference_location, reference_yaw, static_cast<int>(Random::Uniform(1.0, 12.0))),
+        make_geodesic(other_bbox, other_location, other_yaw, static_cast<int>(Random::Uniform(1.0, 12.0)))});
+  }
+
+  for (const auto &pair : pairs) {
+    const auto expected = get_distances(CompareGeometryBoost(pair[0u], pair[1u], pair[2u], pair[3u]));
+    const auto result = get_distances(CompareGeometry(pair[0u], pair[1u], pair[2u], pair[3u]));
+    for (auto i = 0u; i < expected.size(); ++i) {
+      ASSERT_NEAR(result[i], expected[i], 1e-3);
+      ASSERT_EQ(result[i] == 0.0, expected[i] == 0.0);
+    }
+  }
+
+  double checksum = 0.0;
+  carla::StopWatch boost_watch;
+  for (const auto &pair : pairs) {
+    checksum += CompareGeometryBoost(pair[0u], pair[1u], pair[2u], pair[3u]).inter_geodesic_distance;
+  }
+  const auto boost_time = boost_watch.GetElapsedTime<std::chrono::microseconds>();
+  carla::StopWatch kernel_watch;
+  for (const auto &pair : pairs) {
+    checksum -= CompareGeometry(pair[0u], pair[1u], pair[2u], pair[3u]).inter_geodesic_distance;
+  }
+  const auto kernel_time = kernel_watch.GetElapsedTime<std::chrono::microseconds>();
+  ASSERT_NEAR(checksum, 0.0, 1.0);
+  carla::logging::log(
+      "collision geometry of", pairs.size(), "vehicle pairs: boost.geometry",
+      boost_time, "us, kernel", kernel_time, "us.");
+}
+
+// Waypoints not bound to any map, laid out as in the InMemoryMap's arena.
+static std::vector<SimpleWaypoint> make_waypoint_arena(size_t size) {
+  std::vector<SimpleWaypoint> arena;
+  arena.reserve(size);
+  for (auto i = 0u; i < size; ++i) {
+    arena.emplace_back(nullptr, static_cast<WaypointIndex>(i));
+  }
+  return arena;
+}
+
+TEST(trafficmanager, waypoint_buffer) {
+  auto arena = make_waypoint_arena(1000u);
+  Buffer buffer;
+  std::deque<SimpleWaypointPtr> expected;
+  for (auto i = 0u; i < 10'000u; ++i) {
+    const auto operation = Random::Uniform(0.0, 1.0);
+    if (operation < 0.6 || expected.empty()) {
+      auto waypoint = &arena[static_cast<size_t>(Random::Uniform(0.0, arena.size() - 1.0))];
+      buffer.push_back(waypoint);
+      expected.push_back(waypoint);
+    } else if (operation < 0.8) {
+      buffer.pop_front();
+      expected.pop_front();
+    } else {
+      buffer.pop_back();
+      expected.pop_back();
+    }
+    ASSERT_EQ(buffer.size(), expected.size());
+    if (!expected.empty()) {
+      ASSERT_EQ(buffer.front(), expected.front());
+      ASSERT_EQ(buffer.back(), expected.back());
+    }
+  }
+  ASSERT_GT(buffer.capacity(), 64u);
+  ASSERT_GT(buffer.allocations(), 1u);
+  ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), expected.begin(), expected.end()));
+  for (auto i = 0u; i < expected.size(); ++i) {
+    ASSERT_EQ(buffer.at(i), expected[i]);
+  }
+  ASSERT_THROW(buffer.at(expected.size()), std::out_of_range);
+
+  const Buffer copy = buffer;
+  ASSERT_TRUE(std::equal(copy.begin(), copy.end(), expected.begin(), expected.end()));
+  buffer.clear();
+  ASSERT_TRUE(buffer.empty());
+  ASSERT_EQ(copy.size(), expected.size());
+
+  // Refilling a cleared buffer reuses its ring.
+  const auto allocations = buffer.allocations();
+  buffer = copy;
+  ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), expected.begin(), expected.end()));
+  ASSERT_EQ(buffer.allocations(), allocations);
+}
+
+TEST(trafficmanager, waypoint_buffer_benchmark) {
+  constexpr auto number_of_vehicles = 1000u;
+  constexpr auto buffer_size = 40u;
+  constexpr auto cycles = 200u;
+  constexpr auto route_length = buffer_size + cycles;
+
+  // Each vehicle advances one waypoint per cycle along its own route, and
+  // reads its whole buffer as the localization and collision stages do.
+  auto arena = make_waypoint_arena(number_of_vehicles * route_length);
+  std::vector<std::shared_ptr<SimpleWaypoint>> shared_waypoints;
+  for (auto i = 0u; i < arena.size(); ++i) {
+    shared_waypoints.push_back(std::make_shared<SimpleWaypoint>(nullptr, static_cast<WaypointIndex>(i)));
+  }
+
+  using SharedWaypoint = std::shared_ptr<SimpleWaypoint>;
+  using Deque = std::deque<SharedWaypoint, CountingAllocator<SharedWaypoint>>;
+  size_t deque_cycle_allocations = 0u;
+  std::vector<Deque> deque_buffers(
+      number_of_vehicles, Deque(CountingAllocator<SharedWaypoint>(&deque_cycle_allocations)));
+  std::vector<Buffer> buffers(number_of_vehicles);
+  for (auto i = 0u; i < number_of_vehicles; ++i) {
+    for (auto j = 0u; j < buffer_size; ++j) {
+      deque_buffers[i].push_back(shared_waypoints[i * route_length + j]);
+      buffers[i].push_back(&arena[i * route_length + j]);
+    }
+  }
+
+  size_t deque_checksum = 0u;
+  deque_cycle_allocations = 0u;
+  carla::StopWatch deque_watch;
+  for (auto cycle = 0u; cycle < cycles; ++cycle) {
+    for (auto i = 0u; i < number_of_vehicles; ++i) {
+      auto &buffer = deque_buffers[i];
+      buffer.pop_front();
+      buffer.push_back(shared_waypoints[i * route_length + buffer_size + cycle]);
+      for (const auto &waypoint : buffer) {
+        deque_checksum += waypoint->GetIndex();
+      }
+    }
+  }
+  const auto deque_time = deque_watch.GetElapsedTime<std::chrono::microseconds>();
+
+  // A waypoint buffer only allocates when it grows its ring.
+  size_t filled_allocations = 0u;
+  for (const auto &buffer : buffers) {
+    filled_allocations += buffer.allocations();
+  }
+  ASSERT_EQ(filled_allocations, number_of_vehicles);
+  size_t buffer_checksum = 0u;
+  carla::StopWatch buffer_watch;
+  for (auto cycle = 0u; cycle < cycles; ++cycle) {
+    for (auto i = 0u; i < number_of_vehicles; ++i) {
+      auto &buffer = buffers[i];
+      buffer.pop_front();
+      buffer.push_back(&arena[i * route_length + buffer_size + cycle]);
+      for (SimpleWaypointPtr waypoint : buffer) {
+        buffer_checksum += waypoint->GetIndex();
+      }
+    }
+  }
+  const auto buffer_time = buffer_watch.GetElapsedTime<std::chrono::microseconds>();
+  size_t buffer_cycle_allocations = 0u;
+  for (const auto &buffer : buffers) {
+    buffer_cycle_allocations += buffer.allocations();
+  }
+  buffer_cycle_allocations -= filled_allocations;
+
+  ASSERT_EQ(buffer_checksum, deque_checksum);
+  ASSERT_EQ(buffer_cycle_allocations, 0u);
+  carla::logging::log(
+      number_of_vehicles, "waypoint buffers of", buffer_size, "waypoints:",
+      "deque of shared pointers",
+      static_cast<double>(deque_time) / cycles, "us and",
+      static_cast<double>(deque_cycle_allocations) / cycles, "allocations per cycle,",
+      "index ring",
+      static_cast<double>(buffer_time) / cycles, "us and",
+      static_cast<double>(buffer_cycle_allocations) / cycles, "allocations per cycle.");
+}
+
+TEST(trafficmanager, waypoint_spatial_index) {
+  std::vector<SpatialIndexEntry> entries(1000u);
+  for (auto i = 0u; i < entries.size(); ++i) {
+    const auto location = Random::Location(-300.0f, 300.0f);
+    entries[i] = SpatialIndexEntry{location.x, location.y, location.z, i};
+  }
+  WaypointSpatialIndex index;
+  index.Build(entries);
+  ASSERT_TRUE(index.IsValid(entries.size()));
+  ASSERT_FALSE(index.IsValid(entries.size() - 1u));
+
+  // An index viewing the arrays of another answers the same queries.
+  WaypointSpatialIndex view;
+  view.View(index.GetEntries(), index.GetEntryCount(),
+      index.GetNodes(), index.GetNodeCount(), index.GetLeafCount());
+  ASSERT_TRUE(view.IsValid(entries.size()));
+
+  for (auto query = 0u; query < 200u; ++query) {
+    const auto location = Random::Location(-350.0f, 350.0f);
+    float best_distance = std::numeric_limits<float>::max();
+    for (const auto &entry : entries) {
+      const float distance = carla::geom::Math::DistanceSquared(Location(entry.x, entry.y, entry.z), location);
+      best_distance = std::min(best_distance, distance);
+    }
+    WaypointIndex nearest = 0u;
+    ASSERT_TRUE(view.Nearest(location, nearest));
+    const auto &entry = entries[nearest];
+    ASSERT_FLOAT_EQ(carla::geom::Math::DistanceSquared(Location(entry.x, entry.y, entry.z), location), best_distance);
+
+    const auto min = location - Location(40.0f, 40.0f, 40.0f);
+    const auto max = location + Location(40.0f, 40.0f, 40.0f);
+    std::vector<WaypointIndex> expected;
+    for (const auto &candidate : entries) {
+      if (candidate.x >= min.x && candidate.x <= max.x &&
+          candidate.y >= min.y && candidate.y <= max.y &&
+          candidate.z >= min.z && candidate.z <= max.z) {
+        expected.push_back(candidate.index);
+      }
+    }
+    std::vector<WaypointIndex> result;
+    view.Query(min, max, [&](WaypointIndex i) { result.push_back(i); return true; });
+    std::sort(result.begin(), result.end());
+    ASSERT_EQ(result, expected);
+  }
+
+  WaypointSpatialIndex empty;
+  WaypointIndex nearest = 0u;
+  ASSERT_FALSE(empty.Nearest(Location(), nearest));
+}
+
+static void expect_same_map(const InMemoryMap &lhs, const InMemoryMap &rhs) {
+  const auto &lhs_waypoints = lhs.GetDenseTopology();
+  const auto &rhs_waypoints = rhs.GetDenseTopology();
+  ASSERT_EQ(lhs_waypoints.size(), rhs_waypoints.size());
+  auto same_span = [](WaypointSpan a, WaypointSpan b) {
+    if (a.size() != b.size()) {
+      return false;
+    }
+    for (auto i = 0u; i < a.size(); ++i) {
+      if (a[i]->GetIndex() != b[i]->GetIndex()) {
+        return false;
+      }
+    }
+    return true;
+  };
+  auto index_of = [](SimpleWaypointPtr waypoint) {
+    return waypoint != nullptr ? static_cast<int64_t>(waypoint->GetIndex()) : -1;
+  };
+  for (auto i = 0u; i < lhs_waypoints.size(); ++i) {
+    const auto a = lhs_waypoints[i];
+    const auto b = rhs_waypoints[i];
+    ASSERT_EQ(a->GetInfo().id, b->GetInfo().id);
+    ASSERT_EQ(a->GetLocation(), b->GetLocation());
+    ASSERT_EQ(a->CheckJunction(), b->CheckJunction());
+    ASSERT_EQ(a->GetGeodesicGridId(), b->GetGeodesicGridId());
+    ASSERT_EQ(a->GetRoadOption(), b->GetRoadOption());
+    ASSERT_EQ(index_of(a->GetLeftWaypoint()), index_of(b->GetLeftWaypoint()));
+    ASSERT_EQ(index_of(a->GetRightWaypoint()), index_of(b->GetRightWaypoint()));
+    ASSERT_TRUE(same_span(a->GetNextWaypoint(), b->GetNextWaypoint()));
+    ASSERT_TRUE(same_span(a->GetPreviousWaypoint(), b->GetPreviousWaypoint()));
+  }
+}
+
+TEST(trafficmanager, in_memory_map_cache) {
+  const std::string file = "Town03.xodr";
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  if (std::find(files.begin(), files.end(), file) == files.end()) {
+    carla::logging::log("Skipping in memory map cache test,", file, "not found.");
+    return;
+  }
+  auto world_map = carla::MakeShared<carla::client::Map>("Town03", util::OpenDrive::Load(file));
+
+  carla::StopWatch setup_watch;
+  InMemoryMap map(world_map);
+  map.SetUp();
+  const auto setup_time = setup_watch.GetElapsedTime();
+
+  // The parallel build is deterministic, the cache cooked on one thread and
+  // the one cooked on several are the same byte for byte.
+  auto read_file = [](const std::string &filename) {
+    std::ifstream in(filename, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  };
+  const std::string serial_path = "in_memory_map_cache_serial_test.bin";
+  const std::string parallel_path = "in_memory_map_cache_parallel_test.bin";
+  const auto number_of_workers = std::max(4u, std::thread::hardware_concurrency());
+  InMemoryMap::Cook(world_map, serial_path, 1u);
+  InMemoryMap::Cook(world_map, parallel_path, number_of_workers);
+  const auto serial_cache = read_file(serial_path);
+  const auto parallel_cache = read_file(parallel_path);
+  std::remove(serial_path.c_str());
+  std::remove(parallel_path.c_str());
+  ASSERT_FALSE(serial_cache.empty());
+  ASSERT_EQ(serial_cache.size(), parallel_cache.size());
+  ASSERT_TRUE(serial_cache == parallel_cache);
+
+  // A cooked map loads back the same.
+  const std::string path = "in_memory_map_cache_test.bin";
+  InMemoryMap::Cook(world_map, path);
+  carla::StopWatch load_watch;
+  InMemoryMap loaded_map(world_map);
+  ASSERT_TRUE(loaded_map.Load(path));
+  const auto load_time = load_watch.GetElapsedTime();
+  expect_same_map(map, loaded_map);
+  for (auto i = 0u; i < 100u; ++i) {
+    const auto location = Random::Location(-150.0f, 150.0f);
+    ASSERT_EQ(map.GetWaypoint(location)->GetIndex(), loaded_map.GetWaypoint(location)->GetIndex());
+  }
+  std::remove(path.c_str());
+
+  // A cache cooked from another OpenDRIVE is rejected, here the same roads
+  // with a trailing comment so no other map is needed.
+  auto other_world_map = carla::MakeShared<carla::client::Map>(
+      "Town03", util::OpenDrive::Load(file) + "\n<!-- edited -->\n");
+  InMemoryMap::Cook(other_world_map, path);
+  InMemoryMap stale_map(world_map);
+  ASSERT_FALSE(stale_map.Load(path));
+  std::remove(path.c_str());
+
+  carla::logging::log(
+      file, map.GetDenseTopology().size(), "waypoints:",
+      "set up in", setup_time, "ms, loaded from the cache in", load_time, "ms.");
+}
+
+TEST(trafficmanager, stage_profiler) {
+  using namespace std::chrono;
+  StageProfiler profiler;
+  const auto begin = StageProfiler::Clock::now();
+
+  // Nothing is recorded while disabled.
+  profiler.BeginCycle(2u);
+  ASSERT_FALSE(profiler.IsActive());
+  profiler.Record(ProfiledSection::Cycle, begin, begin + milliseconds(1));
+
+  profiler.SetEnabled(true);
+  for (auto cycle = 1u; cycle <= 100u; ++cycle) {
+    profiler.BeginCycle(2u);
+    ASSERT_TRUE(profiler.IsActive());
+    profiler.Record(ProfiledSection::Cycle, begin, begin + microseconds(100u * cycle));
+    profiler.Record(ProfiledSection::LocalizationVehicle, begin, begin + microseconds(10), 0u);
+    profiler.Record(ProfiledSection::LocalizationVehicle, begin, begin + microseconds(30), 1u);
+    profiler.RecordDuration(ProfiledSection::MotionPlan, microseconds(50));
+    profiler.AddCount(ProfiledCounter::CollisionGeometryHits, 3u);
+    profiler.SetCount(ProfiledCounter::CollisionGeometryEntries, cycle);
+  }
+  profiler.BeginCycle(2u);
+
+  const auto report = profiler.GetReport();
+  ASSERT_TRUE(report.enabled);
+  ASSERT_EQ(report.sections.size(), StageProfiler::SECTION_COUNT);
+  auto find = [&](ProfiledSection section) {
+    const auto &result = report.sections[static_cast<size_t>(section)];
+    EXPECT_EQ(result.name, StageProfiler::GetSectionName(section));
+    return result;
+  };
+  const auto cycle = find(ProfiledSection::Cycle);
+  ASSERT_EQ(cycle.count, 100u);
+  ASSERT_NEAR(cycle.total, 0.1 * 5050.0, 1e-6);
+  ASSERT_NEAR(cycle.min, 0.1, 1e-9);
+  ASSERT_NEAR(cycle.max, 10.0, 1e-9);
+  ASSERT_NEAR(cycle.p50, 5.0, 5.0 * 0.07);
+  ASSERT_NEAR(cycle.p90, 9.0, 9.0 * 0.07);
+  ASSERT_NEAR(cycle.p99, 9.9, 9.9 * 0.07);
+  const auto vehicle = find(ProfiledSection::LocalizationVehicle);
+  ASSERT_EQ(vehicle.count, 200u);
+  ASSERT_NEAR(vehicle.mean, 0.02, 1e-9);
+  ASSERT_NEAR(find(ProfiledSection::MotionPlan).total, 5.0, 1e-6);
+  ASSERT_EQ(find(ProfiledSection::Collision).count, 0u);
+  ASSERT_EQ(report.counters.size(), StageProfiler::COUNTER_COUNT);
+  ASSERT_EQ(report.counters[static_cast<size_t>(ProfiledCounter::CollisionGeometryHits)].value, 300u);
+  ASSERT_EQ(report.counters[static_cast<size_t>(ProfiledCounter::CollisionGeometryEntries)].value, 100u);
+  ASSERT_EQ(report.counters[static_cast<size_t>(ProfiledCounter::CollisionGeometryMisses)].value, 0u);
+
+  const std::string path = "stage_profiler_test.json";
+  ASSERT_TRUE(profiler.ExportTrace(path));
+  std::ifstream trace(path);
+  const std::string content((std::istreambuf_iterator<char>(trace)), std::istreambuf_iterator<char>());
+  std::remove(path.c_str());
+  // Only the per-cycle spans go to the trace.
+  size_t events = 0u;
+  for (auto i = content.find("\"ph\":\"X\""); i != std::string::npos; i = content.find("\"ph\":\"X\"", i + 1u)) {
+    ++events;
+  }
+  ASSERT_EQ(events, 100u);
+  ASSERT_EQ(content.find("localization_vehicle"), std::string::npos);
+
+  profiler.Reset();
+  profiler.BeginCycle(2u);
+  ASSERT_EQ(profiler.GetReport().sections[0u].count, 0u);
+  ASSERT_EQ(profiler.GetReport().counters[0u].value, 0u);
+}
+
+// A queue of stopped vehicles on one lane, with the state the collision stage reads.
+struct CollisionScene {
+  std::vector<ActorId> vehicle_id_list;
+  SimulationState simulation_state;
+  BufferMap buffer_map;
+  TrackTraffic track_traffic;
+  Parameters parameters;
+  CollisionFrame output_array;
+  RandomGeneratorMap random_devices;
+
+  CollisionScene(SimpleWaypointPtr waypoint, unsigned vehicles) {
+    for (ActorId actor_id = 1u; actor_id <= vehicles && waypoint != nullptr; ++actor_id) {
+      Buffer &buffer = buffer_map[actor_id];
+      SimpleWaypointPtr next = waypoint;
+      for (auto i = 0u; i < 40u && next != nullptr; ++i) {
+        buffer.push_back(next);
+        next = next->GetNextWaypoint().empty() ? nullptr : next->GetNextWaypoint()[0u];
+      }
+      const auto forward = waypoint->GetForwardVector();
+      const carla::geom::Rotation rotation(0.0f, std::atan2(forward.y, forward.x) * 180.0f / static_cast<float>(M_PI), 0.0f);
+      simulation_state.AddActor(
+          actor_id,
+          {waypoint->GetLocation(), rotation, carla::geom::Vector3D(), 30.0f, true, false},
+          {ActorType::Vehicle, 2.3f, 1.0f, 0.8f},
+          {carla::rpc::TrafficLightState::Green, false});
+      track_traffic.UpdateGridPosition(actor_id, buffer);
+      random_devices.insert({actor_id, RandomGenerator(actor_id)});
+      vehicle_id_list.push_back(actor_id);
+      // Next vehicle about 6 m behind.
+      for (auto i = 0u; i < 6u && waypoint != nullptr; ++i) {
+        waypoint = waypoint->GetPreviousWaypoint().empty() ? nullptr : waypoint->GetPreviousWaypoint()[0u];
+      }
+    }
+    std::sort(vehicle_id_list.begin(), vehicle_id_list.end());
+    simulation_state.AlignVehicles(vehicle_id_list);
+    output_array.resize(vehicle_id_list.size());
+  }
+
+  void Move(const carla::geom::Vector3D &offset) {
+    for (ActorId actor_id : vehicle_id_list) {
+      simulation_state.UpdateKinematicState(actor_id, {
+          simulation_state.GetLocation(actor_id) + carla::geom::Location(offset),
+          simulation_state.GetRotation(actor_id),
+          carla::geom::Vector3D(), 30.0f, true, false});
+    }
+  }
+
+  // Runs a parallel update cycle on the given number of workers, one worker after another.
+  std::vector<std::pair<bool, ActorId>> Run(CollisionStage &stage, unsigned workers) {
+    stage.PrepareParallelUpdate(workers);
+    const auto size = vehicle_id_list.size();
+    for (auto index = 0u; index < size; ++index) {
+      stage.Update(index, static_cast<unsigned>(index * workers / size));
+    }
+    stage.ClearCycleCache();
+    std::vector<std::pair<bool, ActorId>> hazards;
+    for (const auto &output : output_array) {
+      hazards.emplace_back(output.hazard, output.hazard_actor_id);
+    }
+    return hazards;
+  }
+};
+
+TEST(trafficmanager, collision_geometry_cache) {
+  const std::string file = "Town03.xodr";
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  if (std::find(files.begin(), files.end(), file) == files.end()) {
+    carla::logging::log("Skipping collision geometry cache test,", file, "not found.");
+    return;
+  }
+  auto world_map = carla::MakeShared<carla::client::Map>("Town03", util::OpenDrive::Load(file));
+  InMemoryMap map(world_map);
+  map.SetUp();
+  SimpleWaypointPtr start = nullptr;
+  for (SimpleWaypointPtr waypoint : map.GetDenseTopology()) {
+    if (!waypoint->CheckJunction() && waypoint->GetIndex() > 1000u) {
+      start = waypoint;
+      break;
+    }
+  }
+  ASSERT_NE(start, nullptr);
+
+  // The same queue updated on two and on three workers.
+  CollisionScene scene(start, 8u);
+  CollisionScene other_scene(start, 8u);
+  ASSERT_GT(scene.vehicle_id_list.size(), 2u);
+  CollisionStage stage(scene.vehicle_id_list, scene.simulation_state, scene.buffer_map,
+                       scene.track_traffic, scene.parameters, scene.output_array, scene.random_devices);
+  CollisionStage other_stage(other_scene.vehicle_id_list, other_scene.simulation_state, other_scene.buffer_map,
+                             other_scene.track_traffic, other_scene.parameters, other_scene.output_array,
+                             other_scene.random_devices);
+
+  auto hazards = scene.Run(stage, 2u);
+  ASSERT_EQ(hazards, other_scene.Run(other_stage, 3u));
+  const auto first = stage.GetGeometryCacheStatistics();
+  ASSERT_EQ(first.hits, 0u);
+  ASSERT_GT(first.misses, 0u);
+  // A pair can be computed by both of its workers, but is kept once.
+  ASSERT_GT(first.entries, 0u);
+  ASSERT_LE(first.entries, first.misses);
+
+  // Once the locks settle, nothing is recomputed while the vehicles stand still.
+  for (auto cycle = 0u; cycle < 5u; ++cycle) {
+    hazards = scene.Run(stage, 2u);
+    ASSERT_EQ(hazards, other_scene.Run(other_stage, 3u));
+  }
+  const auto settled = stage.GetGeometryCacheStatistics();
+  ASSERT_EQ(settled.misses, 0u);
+  ASSERT_GT(settled.hits, 0u);
+
+  // Moving below the tolerance keeps the cache, moving 1 m invalidates it.
+  scene.Move(carla::geom::Vector3D(0.001f, 0.0f, 0.0f));
+  other_scene.Move(carla::geom::Vector3D(0.001f, 0.0f, 0.0f));
+  ASSERT_EQ(scene.Run(stage, 2u), other_scene.Run(other_stage, 3u));
+  ASSERT_EQ(stage.GetGeometryCacheStatistics().misses, 0u);
+  scene.Move(carla::geom::Vector3D(1.0f, 0.0f, 0.0f));
+  other_scene.Move(carla::geom::Vector3D(1.0f, 0.0f, 0.0f));
+  ASSERT_EQ(scene.Run(stage, 2u), other_scene.Run(other_stage, 3u));
+  const auto moved = stage.GetGeometryCacheStatistics();
+  ASSERT_EQ(moved.hits, 0u);
+  ASSERT_GT(moved.invalidations, 0u);
+  ASSERT_EQ(moved.invalidations, moved.misses);
+
+  // Pairs no longer compared are evicted.
+  for (ActorId actor_id : scene.vehicle_id_list) {
+    scene.simulation_state.RemoveActor(actor_id);
+  }
+  for (auto cycle = 0u; cycle <= constants::Collision::GEOMETRY_CACHE_MAX_AGE; ++cycle) {
+    scene.Run(stage, 2u);
+  }
+  ASSERT_EQ(stage.GetGeometryCacheStatistics().entries, 0u);
+}
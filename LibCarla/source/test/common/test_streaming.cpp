@@ -10,12 +10,19 @@
 #include <carla/streaming/Client.h>
 #include <carla/streaming/Server.h>
 #include <carla/streaming/detail/Dispatcher.h>
+#include <carla/streaming/detail/SharedMemoryRing.h>
 #include <carla/streaming/detail/tcp/Client.h>
 #include <carla/streaming/detail/tcp/Server.h>
 #include <carla/streaming/low_level/Client.h>
 #include <carla/streaming/low_level/Server.h>
 
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cstring>
 
 using namespace std::chrono_literals;
 
@@ -259,3 +266,439 @@ TEST(streaming, multi_stream) {
     }
   }
 }
+
+TEST(streaming, shared_memory_ring) {
+  using namespace carla::streaming::detail;
+  if (!SharedMemoryRing::IsSupported()) {
+    carla::log_warning("shared memory not supported, skipping test");
+    return;
+  }
+  const auto no_wait = carla::time_duration::milliseconds(0u);
+
+  ASSERT_EQ(SharedMemoryRing::Create(2u * SharedMemoryRing::MAX_CAPACITY), nullptr);
+
+  auto writer = SharedMemoryRing::Create(16u * SharedMemoryRing::SLOT_SIZE);
+  ASSERT_NE(writer, nullptr);
+  auto reader = SharedMemoryRing::Open(writer->GetName());
+  ASSERT_NE(reader, nullptr);
+  reader->Unlink();
+  ASSERT_EQ(SharedMemoryRing::Open(writer->GetName()), nullptr);
+
+  carla::Buffer buffer;
+  ASSERT_EQ(reader->Read(buffer, no_wait), SharedMemoryRing::ReadResult::Timeout);
+
+  // Messages of every size up to the largest one wrap around the ring many
+  // times.
+  const size_t max_size = writer->GetMaxMessageSize();
+  std::vector<unsigned char> data(max_size + 1u);
+  for (size_t i = 0u; i < data.size(); ++i) {
+    data[i] = static_cast<unsigned char>(i * 7u);
+  }
+  for (size_t size = 1u; size <= max_size; size += 97u) {
+    ASSERT_EQ(
+        writer->Write(boost::asio::buffer(data.data(), size), no_wait),
+        SharedMemoryRing::WriteResult::Written);
+    ASSERT_EQ(reader->Read(buffer, no_wait), SharedMemoryRing::ReadResult::Message);
+    ASSERT_EQ(buffer.size(), size);
+    ASSERT_EQ(std::memcmp(buffer.data(), data.data(), size), 0);
+  }
+
+  ASSERT_EQ(
+      writer->Write(boost::asio::buffer(data), no_wait),
+      SharedMemoryRing::WriteResult::TooLarge);
+  while (writer->Write(boost::asio::buffer(data.data(), 100u), no_wait) ==
+         SharedMemoryRing::WriteResult::Written);
+  ASSERT_EQ(
+      writer->Write(boost::asio::buffer(data.data(), 100u), no_wait),
+      SharedMemoryRing::WriteResult::Full);
+  while (reader->Read(buffer, no_wait) == SharedMemoryRing::ReadResult::Message);
+
+  ASSERT_EQ(writer->WriteSwitch("next", no_wait), SharedMemoryRing::WriteResult::Written);
+  ASSERT_EQ(reader->Read(buffer, no_wait), SharedMemoryRing::ReadResult::Switch);
+  ASSERT_EQ(util::buffer::as_string(buffer), "next");
+
+  writer.reset();
+  ASSERT_EQ(reader->Read(buffer, no_wait), SharedMemoryRing::ReadResult::Closed);
+}
+
+static void stream_large_messages(bool server_shared_memory, bool client_shared_memory) {
+  using namespace carla::streaming;
+  constexpr size_t number_of_messages = 30u;
+
+  Server srv(TESTING_PORT);
+  srv.SetTimeout(1s);
+  srv.SetSynchronousMode(true);
+  srv.SetSharedMemory(server_shared_memory);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+
+  // Sizes grow past the default ring capacity so the server has to move to a
+  // larger ring on the way.
+  auto message_size = [](size_t i) { return 1u + i * (1u << 19u); };
+  auto message_byte = [](size_t i, size_t j) { return static_cast<unsigned char>(i + j); };
+
+  std::atomic_size_t messages_received{0u};
+  std::atomic_bool all_valid{true};
+  {
+    Client c;
+    c.SetSharedMemory(client_shared_memory);
+    c.AsyncRun(2u);
+    c.Subscribe(stream.token(), [&](carla::Buffer buffer) {
+      const size_t i = messages_received;
+      bool valid = buffer.size() == message_size(i);
+      for (size_t j = 0u; valid && j < buffer.size(); j += 4099u) {
+        valid = buffer.data()[j] == message_byte(i, j);
+      }
+      if (!valid) {
+        all_valid = false;
+      }
+      ++messages_received;
+    });
+    std::this_thread::sleep_for(200ms);
+
+    for (auto i = 0u; i < number_of_messages; ++i) {
+      std::vector<unsigned char> data(message_size(i));
+      for (size_t j = 0u; j < data.size(); ++j) {
+        data[j] = message_byte(i, j);
+      }
+      stream << carla::Buffer(data);
+    }
+    for (auto i = 0u; i < 100u && messages_received < number_of_messages; ++i) {
+      std::this_thread::sleep_for(20ms);
+    }
+  }
+  ASSERT_EQ(messages_received, number_of_messages);
+  ASSERT_TRUE(all_valid);
+}
+
+TEST(streaming, shared_memory_large_messages) {
+  stream_large_messages(true, true);
+}
+
+TEST(streaming, shared_memory_fallback_to_tcp) {
+  stream_large_messages(true, false);
+  stream_large_messages(false, true);
+}
+
+TEST(streaming, shared_memory_token_stays_tcp) {
+  using namespace carla::streaming;
+  using namespace carla::streaming::detail;
+
+  Server srv(TESTING_PORT);
+  srv.SetSharedMemory(true);
+  const Token offered = srv.MakeStream().token();
+  token_type token(offered);
+
+  // Clients built before shared memory only accept this protocol byte.
+  ASSERT_EQ(offered.data[sizeof(stream_id_type) + sizeof(uint16_t)], 1u);
+  ASSERT_TRUE(token.protocol_is_tcp());
+  ASSERT_EQ(token.has_shared_memory(), SharedMemoryRing::IsSupported());
+  token.set_address(boost::asio::ip::address_v4::loopback());
+  ASSERT_EQ(token.has_shared_memory(), SharedMemoryRing::IsSupported());
+  token.set_address(boost::asio::ip::address_v6::loopback());
+  ASSERT_FALSE(token.has_shared_memory());
+
+  srv.SetSharedMemory(false);
+  ASSERT_FALSE(token_type(srv.MakeStream().token()).has_shared_memory());
+}
+
+// Subscribes to the stream of @a token through a raw socket, as a client
+// that does not read anything until the test says so. If @a ring is given it
+// asks for shared memory and takes the offered ring, already unlinked.
+static void subscribe_raw(
+    boost::asio::ip::tcp::socket &socket,
+    const carla::streaming::detail::token_type &token,
+    std::shared_ptr<carla::streaming::detail::SharedMemoryRing> *ring = nullptr) {
+  using namespace carla::streaming::detail;
+  socket.connect(token.to_tcp_endpoint());
+  auto stream_id = token.get_stream_id();
+  if (ring != nullptr) {
+    stream_id |= SHARED_MEMORY_REQUEST;
+  }
+  boost::asio::write(socket, boost::asio::buffer(&stream_id, sizeof(stream_id)));
+  if (ring != nullptr) {
+    std::array<char, SharedMemoryRing::MAX_NAME_LENGTH> name;
+    boost::asio::read(socket, boost::asio::buffer(name));
+    *ring = SharedMemoryRing::Open(name.data());
+    ASSERT_NE(*ring, nullptr);
+    (*ring)->Unlink();
+    const uint8_t answer = 1u;
+    boost::asio::write(socket, boost::asio::buffer(&answer, sizeof(answer)));
+  }
+  std::this_thread::sleep_for(50ms);
+}
+
+TEST(streaming, send_queue_policies) {
+  using namespace carla::streaming;
+  using namespace carla::streaming::detail;
+  constexpr size_t number_of_messages = 40u;
+  constexpr size_t message_size = 1u << 20u;
+  constexpr uint32_t max_messages = 3u;
+
+  for (auto policy : {SendPolicy::Block, SendPolicy::DropOldest, SendPolicy::DropNewest, SendPolicy::KeepLatest}) {
+    Server srv(TESTING_PORT);
+    srv.SetSharedMemory(false);
+    SendQueueSettings settings;
+    settings.policy = policy;
+    settings.max_messages = max_messages;
+    settings.block_timeout = 0.01;
+    srv.SetSendQueue(settings);
+    srv.AsyncRun(2u);
+    auto stream = srv.MakeStream();
+    token_type token(stream.token());
+    token.set_address(make_localhost_address());
+
+    // A client that subscribes and does not read anything until all the
+    // messages were written.
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::socket socket(io_context);
+    ASSERT_NO_FATAL_FAILURE(subscribe_raw(socket, token));
+
+    for (auto i = 0u; i < number_of_messages; ++i) {
+      std::vector<unsigned char> data(message_size, static_cast<unsigned char>(i));
+      stream << carla::Buffer(data);
+      auto statistics = srv.GetStreamStatistics();
+      ASSERT_EQ(statistics.size(), 1u);
+      ASSERT_LE(statistics[0].queued_messages, policy == SendPolicy::KeepLatest ? 1u : max_messages);
+    }
+    std::this_thread::sleep_for(50ms);
+
+    auto statistics = srv.GetStreamStatistics()[0];
+    ASSERT_EQ(statistics.stream_id, token.get_stream_id());
+    ASSERT_EQ(statistics.sessions, 1u);
+    ASSERT_GT(statistics.dropped_messages, 0u);
+    // Some may be neither, being written.
+    ASSERT_LE(statistics.sent_messages + statistics.dropped_messages + statistics.queued_messages, number_of_messages);
+    ASSERT_EQ(statistics.dropped_bytes, statistics.dropped_messages * message_size);
+
+    // Read until the queue drains, the ones keeping the newest messages
+    // deliver the last one.
+    std::vector<unsigned char> received;
+    std::vector<unsigned char> body(message_size);
+    for (;;) {
+      message_size_type size = 0u;
+      boost::asio::read(socket, boost::asio::buffer(&size, sizeof(size)));
+      ASSERT_EQ(size, message_size);
+      boost::asio::read(socket, boost::asio::buffer(body));
+      ASSERT_TRUE(std::all_of(body.begin(), body.end(), [&](auto byte) { return byte == body[0]; }));
+      ASSERT_TRUE(received.empty() || received.back() < body[0]);
+      received.push_back(body[0]);
+      std::this_thread::sleep_for(10ms);
+      statistics = srv.GetStreamStatistics()[0];
+      if (statistics.sent_messages + statistics.dropped_messages == number_of_messages &&
+          statistics.sent_messages == received.size()) {
+        break;
+      }
+    }
+    ASSERT_EQ(statistics.queued_messages, 0u);
+    if (policy == SendPolicy::DropOldest || policy == SendPolicy::KeepLatest) {
+      ASSERT_EQ(received.back(), number_of_messages - 1u);
+    }
+    ASSERT_GT(statistics.mean_write_latency, 0.0);
+    ASSERT_GE(statistics.max_write_latency, statistics.mean_write_latency);
+  }
+}
+
+TEST(streaming, shared_memory_send_queue_policies) {
+  using namespace carla::streaming;
+  using namespace carla::streaming::detail;
+  if (!SharedMemoryRing::IsSupported()) {
+    carla::log_warning("shared memory not supported, skipping test");
+    return;
+  }
+  constexpr size_t number_of_messages = 40u;
+  constexpr size_t message_size = 1u << 20u;
+  constexpr uint32_t max_messages = 3u;
+  const auto no_wait = carla::time_duration::milliseconds(0u);
+
+  for (auto policy : {SendPolicy::Block, SendPolicy::DropOldest, SendPolicy::DropNewest, SendPolicy::KeepLatest}) {
+    Server srv(TESTING_PORT);
+    srv.SetSharedMemory(true);
+    SendQueueSettings settings;
+    settings.policy = policy;
+    settings.max_messages = max_messages;
+    settings.block_timeout = 0.01;
+    srv.SetSendQueue(settings);
+    srv.AsyncRun(2u);
+    auto stream = srv.MakeStream();
+    token_type token(stream.token());
+    token.set_address(make_localhost_address());
+
+    // A client that takes the ring and does not read anything until all the
+    // messages were written.
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::socket socket(io_context);
+    std::shared_ptr<SharedMemoryRing> ring;
+    ASSERT_NO_FATAL_FAILURE(subscribe_raw(socket, token, &ring));
+
+    // Neither the ring nor the queue in front of it grows, and writing never
+    // takes much longer than the block timeout.
+    for (auto i = 0u; i < number_of_messages; ++i) {
+      std::vector<unsigned char> data(message_size, static_cast<unsigned char>(i));
+      const auto begin = std::chrono::steady_clock::now();
+      stream << carla::Buffer(data);
+      ASSERT_LT(std::chrono::steady_clock::now() - begin, 500ms);
+      auto statistics = srv.GetStreamStatistics();
+      ASSERT_EQ(statistics.size(), 1u);
+      ASSERT_LE(statistics[0].queued_messages, policy == SendPolicy::KeepLatest ? 1u : max_messages);
+    }
+    std::this_thread::sleep_for(50ms);
+
+    auto statistics = srv.GetStreamStatistics()[0];
+    ASSERT_EQ(statistics.sessions, 1u);
+    ASSERT_GT(statistics.dropped_messages, 0u);
+    ASSERT_LE(statistics.sent_messages + statistics.dropped_messages + statistics.queued_messages, number_of_messages);
+
+    // Read until the queue drains through the ring.
+    std::vector<unsigned char> received;
+    carla::Buffer body;
+    for (auto i = 0u; i < 500u; ++i) {
+      for (;;) {
+        const auto result = ring->Read(body, no_wait);
+        if (result == SharedMemoryRing::ReadResult::Switch) {
+          // The offered ring only holds the switch to the one sized for the
+          // messages.
+          ring = SharedMemoryRing::Open(std::string(reinterpret_cast<const char *>(body.data()), body.size()));
+          ASSERT_NE(ring, nullptr);
+          ring->Unlink();
+          continue;
+        }
+        if (result != SharedMemoryRing::ReadResult::Message) {
+          break;
+        }
+        ASSERT_EQ(body.size(), message_size);
+        ASSERT_TRUE(received.empty() || received.back() < body.data()[0]);
+        received.push_back(body.data()[0]);
+      }
+      statistics = srv.GetStreamStatistics()[0];
+      if (statistics.sent_messages + statistics.dropped_messages == number_of_messages &&
+          statistics.sent_messages == received.size()) {
+        break;
+      }
+      std::this_thread::sleep_for(10ms);
+    }
+    ASSERT_EQ(statistics.sent_messages, received.size());
+    ASSERT_EQ(statistics.queued_messages, 0u);
+    if (policy == SendPolicy::DropOldest || policy == SendPolicy::KeepLatest) {
+      ASSERT_EQ(received.back(), number_of_messages - 1u);
+    }
+  }
+}
+
+TEST(streaming, shared_memory_client_moves_to_tcp) {
+  using namespace carla::streaming;
+  using namespace carla::streaming::detail;
+  if (!SharedMemoryRing::IsSupported()) {
+    carla::log_warning("shared memory not supported, skipping test");
+    return;
+  }
+  constexpr size_t number_of_messages = 5u;
+  constexpr size_t message_size = 1000u;
+  const auto timeout = carla::time_duration::seconds(1u);
+
+  Server srv(TESTING_PORT);
+  srv.SetSharedMemory(true);
+  srv.SetSynchronousMode(true);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+  token_type token(stream.token());
+  token.set_address(make_localhost_address());
+
+  // A client that takes the ring but cannot open the one the server moves to.
+  boost::asio::io_context io_context;
+  boost::asio::ip::tcp::socket socket(io_context);
+  std::shared_ptr<SharedMemoryRing> ring;
+  ASSERT_NO_FATAL_FAILURE(subscribe_raw(socket, token, &ring));
+
+  // The first message goes to a ring sized for it, which is lost with it.
+  stream << carla::Buffer(std::vector<unsigned char>(message_size, 0u));
+  carla::Buffer body;
+  ASSERT_EQ(ring->Read(body, timeout), SharedMemoryRing::ReadResult::Switch);
+  ASSERT_GT(body.size(), 0u);
+  boost::asio::write(socket, boost::asio::buffer(&TCP_FALLBACK_REQUEST, sizeof(TCP_FALLBACK_REQUEST)));
+  std::this_thread::sleep_for(50ms);
+
+  for (auto i = 1u; i < number_of_messages; ++i) {
+    stream << carla::Buffer(std::vector<unsigned char>(message_size, static_cast<unsigned char>(i)));
+  }
+  for (auto i = 1u; i < number_of_messages; ++i) {
+    message_size_type size = 0u;
+    boost::asio::read(socket, boost::asio::buffer(&size, sizeof(size)));
+    ASSERT_EQ(size, message_size);
+    std::vector<unsigned char> data(size);
+    boost::asio::read(socket, boost::asio::buffer(data));
+    ASSERT_EQ(data.front(), i);
+    ASSERT_EQ(data.back(), i);
+  }
+  // Counted once the write handler runs, maybe after the data was read.
+  auto statistics = srv.GetStreamStatistics()[0];
+  for (auto i = 0u; i < 100u && statistics.sent_messages < number_of_messages; ++i) {
+    std::this_thread::sleep_for(10ms);
+    statistics = srv.GetStreamStatistics()[0];
+  }
+  ASSERT_EQ(statistics.sessions, 1u);
+  ASSERT_EQ(statistics.sent_messages, number_of_messages);
+}
+
+TEST(streaming, rate_limited_subscriber) {
+  using namespace carla::streaming;
+  using namespace util::buffer;
+  constexpr size_t number_of_messages = 100u;
+  const std::string message = "Hi y'all!";
+
+  Server srv(TESTING_PORT);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+
+  std::atomic_size_t all_received{0u};
+  std::atomic_size_t limited_received{0u};
+  Client all;
+  all.AsyncRun(1u);
+  all.Subscribe(stream.token(), [&](auto) { ++all_received; });
+  Client limited;
+  limited.AsyncRun(1u);
+  limited.Subscribe(stream.token(), [&](auto buffer) {
+    ASSERT_EQ(as_string(buffer), message);
+    ++limited_received;
+  }, 10.0);
+  std::this_thread::sleep_for(100ms);
+
+  // 100 messages at about 100 Hz, the limited one should get about 10. The
+  // sleeps may take much longer on a loaded machine, so the expected count is
+  // derived from the times the messages were actually sent.
+  using clock = std::chrono::steady_clock;
+  clock::time_point first_send;
+  clock::time_point last_send;
+  clock::duration largest_gap{0};
+  clock::time_point previous_before;
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    std::this_thread::sleep_for(10ms);
+    const auto before = clock::now();
+    stream << message;
+    const auto after = clock::now();
+    if (i == 0u) {
+      first_send = before;
+    } else {
+      largest_gap = std::max(largest_gap, after - previous_before);
+    }
+    previous_before = before;
+    last_send = after;
+  }
+  for (auto i = 0u; i < 100u && all_received < number_of_messages; ++i) {
+    std::this_thread::sleep_for(10ms);
+  }
+  std::this_thread::sleep_for(50ms);
+
+  // The first message goes through, the next one at least half an interval
+  // later and every other one at least an interval after the previous one;
+  // none is more than an interval plus the gap between two sends later.
+  using seconds = std::chrono::duration<double>;
+  constexpr double interval = 1.0 / 10.0;
+  const double elapsed = seconds(last_send - first_send).count();
+  const double gap = seconds(largest_gap).count();
+  const auto most = static_cast<size_t>(elapsed / interval + 1.5);
+  const auto least = static_cast<size_t>(elapsed / (interval + gap)) + 1u;
+  ASSERT_GE(all_received, number_of_messages - 3u);
+  ASSERT_GE(limited_received, least);
+  ASSERT_LE(limited_received, most);
+}
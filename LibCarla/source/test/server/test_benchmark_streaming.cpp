@@ -12,6 +12,9 @@
 #include <boost/asio/post.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 
 using namespace carla::streaming;
 using namespace std::chrono_literals;
@@ -163,3 +166,144 @@ TEST(benchmark_streaming, image_800x600_mt) {
 TEST(benchmark_streaming, image_1920x1080_mt) {
   benchmark_image(1920u * 1080u, get_max_concurrency(), 0.9);
 }
+
+/// Measures one stream of @a message_size bytes messages to a client on this
+/// host: the median time from writing a message to receiving it, one message
+/// at a time, and the throughput writing them back to back.
+static void benchmark_transport(const size_t message_size, const bool shared_memory) {
+  using clock = std::chrono::steady_clock;
+  constexpr auto number_of_pings = 200u;
+  constexpr auto number_of_messages = 500u;
+
+  Server server(TESTING_PORT);
+  server.SetSynchronousMode(true);
+  server.SetSharedMemory(shared_memory);
+  server.AsyncRun(2u);
+  Stream stream = server.MakeStream();
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t received = 0u;
+
+  Client client;
+  client.SetSharedMemory(shared_memory);
+  client.AsyncRun(2u);
+  client.Subscribe(stream.token(), [&](carla::Buffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++received;
+    condition.notify_one();
+  });
+  std::this_thread::sleep_for(1s);
+
+  const carla::Buffer message = make_special_message(message_size);
+  auto wait_for = [&](size_t count) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return condition.wait_for(lock, 5s, [&]() { return received >= count; });
+  };
+
+  std::vector<double> latencies;
+  for (auto i = 0u; i < number_of_pings; ++i) {
+    const auto begin = clock::now();
+    stream << message.buffer();
+    ASSERT_TRUE(wait_for(i + 1u));
+    latencies.push_back(std::chrono::duration<double, std::micro>(clock::now() - begin).count());
+  }
+  std::nth_element(latencies.begin(), latencies.begin() + latencies.size() / 2u, latencies.end());
+
+  const auto begin = clock::now();
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    stream << message.buffer();
+  }
+  const bool all_received = wait_for(number_of_pings + number_of_messages);
+  const double seconds = std::chrono::duration<double>(clock::now() - begin).count();
+  const double megabytes = static_cast<double>(received - number_of_pings) *
+      static_cast<double>(message_size) / (1024.0 * 1024.0);
+
+  carla::logging::log(
+      shared_memory ? "shared memory:" : "tcp:          ",
+      message_size, "bytes, median latency", latencies[latencies.size() / 2u], "us,",
+      static_cast<double>(received - number_of_pings) / seconds, "messages/s,",
+      megabytes / seconds, "MB/s");
+  ASSERT_TRUE(all_received);
+}
+
+static void benchmark_transports(const size_t message_size) {
+  benchmark_transport(message_size, false);
+  benchmark_transport(message_size, true);
+}
+
+TEST(benchmark_streaming, transport_200x200) {
+  benchmark_transports(4u * 200u * 200u);
+}
+
+TEST(benchmark_streaming, transport_800x600) {
+  benchmark_transports(4u * 800u * 600u);
+}
+
+TEST(benchmark_streaming, transport_1920x1080) {
+  benchmark_transports(4u * 1920u * 1080u);
+}
+
+/// One stream with @a number_of_clients subscribers, each with its own
+/// client as separate processes would: time the server spends writing each
+/// message to all of them, and the time until every client received them
+/// all. One more subscriber at 10 Hz is not waited for.
+static void benchmark_fan_out(const size_t number_of_clients, const size_t message_size) {
+  using clock = std::chrono::steady_clock;
+  constexpr auto number_of_messages = 200u;
+
+  Server server(TESTING_PORT);
+  server.SetSynchronousMode(true);
+  server.AsyncRun(std::max<size_t>(2u, number_of_clients));
+  Stream stream = server.MakeStream();
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t received = 0u;
+  std::atomic_size_t rate_limited_received{0u};
+
+  std::vector<std::unique_ptr<Client>> clients;
+  for (auto i = 0u; i < number_of_clients; ++i) {
+    clients.emplace_back(std::make_unique<Client>());
+    clients.back()->AsyncRun(1u);
+    clients.back()->Subscribe(stream.token(), [&](carla::Buffer) {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++received;
+      condition.notify_one();
+    });
+  }
+  clients.emplace_back(std::make_unique<Client>());
+  clients.back()->AsyncRun(1u);
+  clients.back()->Subscribe(stream.token(), [&](carla::Buffer) { ++rate_limited_received; }, 10.0);
+  std::this_thread::sleep_for(1s);
+
+  const carla::Buffer message = make_special_message(message_size);
+  clock::duration writing{0};
+  const auto begin = clock::now();
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    const auto write_begin = clock::now();
+    stream << message.buffer();
+    writing += clock::now() - write_begin;
+  }
+  bool all_received = false;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    all_received = condition.wait_for(lock, 10s, [&]() {
+      return received >= number_of_clients * number_of_messages;
+    });
+  }
+  const double seconds = std::chrono::duration<double>(clock::now() - begin).count();
+
+  carla::logging::log(
+      "fan-out to", number_of_clients, "clients:", message_size, "bytes,",
+      std::chrono::duration<double, std::micro>(writing).count() / number_of_messages, "us per write,",
+      static_cast<double>(received) / seconds, "messages/s delivered,",
+      rate_limited_received, "to the 10 Hz client");
+  ASSERT_TRUE(all_received);
+}
+
+TEST(benchmark_streaming, fan_out_800x600) {
+  for (size_t clients : {1u, 2u, 4u, 8u}) {
+    benchmark_fan_out(clients, 4u * 800u * 600u);
+  }
+}
@@ -9,6 +9,7 @@
 #include "carla/client/World.h"
 #include "carla/Logging.h"
 #include "carla/rpc/ActorId.h"
+#include "carla/streaming/SendQueue.h"
 #include "carla/trafficmanager/TrafficManager.h"
 
 #include <thread>
@@ -38,6 +39,14 @@ static auto GetRequiredFiles(const carla::client::Client &self, const std::strin
   return result;
 }
 
+static auto GetStreamingStatistics(const carla::client::Client &self) {
+  boost::python::list result;
+  for (const auto &statistics : self.GetStreamingStatistics()) {
+    result.append(statistics);
+  }
+  return result;
+}
+
 static void ApplyBatchCommands(
     const carla::client::Client &self,
     const boost::python::object &commands,
@@ -181,6 +190,33 @@ void export_client() {
     .def_readwrite("enable_pedestrian_navigation", &rpc::OpendriveGenerationParameters::enable_pedestrian_navigation)
   ;
 
+  enum_<carla::streaming::SendPolicy>("SendPolicy")
+    .value("Block", carla::streaming::SendPolicy::Block)
+    .value("DropOldest", carla::streaming::SendPolicy::DropOldest)
+    .value("DropNewest", carla::streaming::SendPolicy::DropNewest)
+    .value("KeepLatest", carla::streaming::SendPolicy::KeepLatest)
+  ;
+
+  class_<carla::streaming::SendQueueSettings>("SendQueueSettings")
+    .def_readwrite("policy", &carla::streaming::SendQueueSettings::policy)
+    .def_readwrite("max_messages", &carla::streaming::SendQueueSettings::max_messages)
+    .def_readwrite("max_bytes", &carla::streaming::SendQueueSettings::max_bytes)
+    .def_readwrite("block_timeout", &carla::streaming::SendQueueSettings::block_timeout)
+  ;
+
+  class_<carla::streaming::StreamStatistics>("StreamStatistics", no_init)
+    .def_readonly("stream_id", &carla::streaming::StreamStatistics::stream_id)
+    .def_readonly("sessions", &carla::streaming::StreamStatistics::sessions)
+    .def_readonly("queued_messages", &carla::streaming::StreamStatistics::queued_messages)
+    .def_readonly("queued_bytes", &carla::streaming::StreamStatistics::queued_bytes)
+    .def_readonly("sent_messages", &carla::streaming::StreamStatistics::sent_messages)
+    .def_readonly("sent_bytes", &carla::streaming::StreamStatistics::sent_bytes)
+    .def_readonly("dropped_messages", &carla::streaming::StreamStatistics::dropped_messages)
+    .def_readonly("dropped_bytes", &carla::streaming::StreamStatistics::dropped_bytes)
+    .def_readonly("mean_write_latency", &carla::streaming::StreamStatistics::mean_write_latency)
+    .def_readonly("max_write_latency", &carla::streaming::StreamStatistics::max_write_latency)
+  ;
+
   class_<cc::Client>("Client",
       init<std::string, uint16_t, size_t>((arg("host"), arg("port"), arg("worker_threads")=0u)))
     .def("set_timeout", &::SetTimeout, (arg("seconds")))
@@ -205,6 +241,8 @@ void export_client() {
     .def("stop_replayer", &cc::Client::StopReplayer, (arg("keep_actors")))
     .def("set_replayer_time_factor", &cc::Client::SetReplayerTimeFactor, (arg("time_factor")))
     .def("set_replayer_ignore_hero", &cc::Client::SetReplayerIgnoreHero, (arg("ignore_hero")))
+    .def("get_streaming_statistics", &GetStreamingStatistics)
+    .def("set_streaming_send_queue", &cc::Client::SetStreamingSendQueue, (arg("settings")))
     .def("apply_batch", &ApplyBatchCommands, (arg("commands"), arg("do_tick")=false))
     .def("apply_batch_sync", &ApplyBatchCommandsSync, (arg("commands"), arg("do_tick")=false))
     .def("get_trafficmanager", CONST_CALL_WITHOUT_GIL_1(cc::Client, GetInstanceTM, uint16_t), (arg("port")=ctm::TM_DEFAULT_PORT))
@@ -10,8 +10,8 @@
 #include <carla/client/Sensor.h>
 #include <carla/client/ServerSideSensor.h>
 
-static void SubscribeToStream(carla::client::Sensor &self, boost::python::object callback) {
-  self.Listen(MakeCallback(std::move(callback)));
+static void SubscribeToStream(carla::client::Sensor &self, boost::python::object callback, double max_rate) {
+  self.Listen(MakeCallback(std::move(callback)), max_rate);
 }
 
 void export_sensor() {
@@ -20,7 +20,7 @@ void export_sensor() {
 
   class_<cc::Sensor, bases<cc::Actor>, boost::noncopyable, boost::shared_ptr<cc::Sensor>>("Sensor", no_init)
     .add_property("is_listening", &cc::Sensor::IsListening)
-    .def("listen", &SubscribeToStream, (arg("callback")))
+    .def("listen", &SubscribeToStream, (arg("callback"), arg("max_rate")=0.0))
     .def("stop", &cc::Sensor::Stop)
     .def(self_ns::str(self_ns::self))
   ;
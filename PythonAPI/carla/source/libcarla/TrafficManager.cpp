@@ -78,6 +78,26 @@ boost::python::list InterGetActionBuffer(carla::traffic_manager::TrafficManager&
   return l;
 }
 
+boost::python::dict InterGetProfilerReport(carla::traffic_manager::TrafficManager& self) {
+  boost::python::dict report;
+  const carla::traffic_manager::ProfilerReport profiler_report = self.GetProfilerReport();
+  for (auto &section : profiler_report.sections) {
+    boost::python::dict timings;
+    timings["count"] = section.count;
+    timings["total"] = section.total;
+    timings["mean"] = section.mean;
+    timings["min"] = section.min;
+    timings["max"] = section.max;
+    timings["p50"] = section.p50;
+    timings["p90"] = section.p90;
+    timings["p99"] = section.p99;
+    report[section.name] = timings;
+  }
+  for (auto &counter : profiler_report.counters) {
+    report[counter.name] = counter.value;
+  }
+  return report;
+}
 
 void export_trafficmanager() {
   namespace cc = carla::client;
@@ -106,6 +126,12 @@ void export_trafficmanager() {
     .def("set_hybrid_physics_radius", &ctm::TrafficManager::SetHybridPhysicsRadius)
     .def("set_random_device_seed", &ctm::TrafficManager::SetRandomDeviceSeed)
     .def("set_osm_mode", &carla::traffic_manager::TrafficManager::SetOSMMode)
+    .def("set_parallel_workers", &carla::traffic_manager::TrafficManager::SetParallelWorkers)
+    .def("set_fast_collision_geometry", &carla::traffic_manager::TrafficManager::SetFastCollisionGeometry)
+    .def("set_profiling", &carla::traffic_manager::TrafficManager::SetProfiling)
+    .def("reset_profiler", &carla::traffic_manager::TrafficManager::ResetProfiler)
+    .def("get_profiler_report", &InterGetProfilerReport)
+    .def("export_profiler_trace", &carla::traffic_manager::TrafficManager::ExportProfilerTrace)
     .def("set_path", &InterSetCustomPath, (arg("empty_buffer") = true))
     .def("set_route", &InterSetImportedRoute, (arg("empty_buffer") = true))
     .def("set_respawn_dormant_vehicles", &carla::traffic_manager::TrafficManager::SetRespawnDormantVehicles)
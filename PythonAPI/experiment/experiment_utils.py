@@ -9,6 +9,7 @@ import traceback
 
 import zmq
 import socket
+import struct
 import msgpack as serializer
 from msgpack import loads
 import pandas as pd
@@ -167,6 +168,15 @@ class HardwareSuite:
             HardwareSuite.hardware_socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
             HardwareSuite.hardware_address = ('127.0.0.1', 5558)
 
+    # Eye-tracker sample datagram: on_surf, confidence, norm_pos x, norm_pos y, pupil timestamp (see EyeTrackerSamples.h)
+    sample_format = struct.Struct("<Bfffd")
+
+    @staticmethod
+    def pack_gaze_sample(gaze):
+        x, y = gaze.get("norm_pos", (0.0, 0.0))
+        return HardwareSuite.sample_format.pack(1 if gaze["on_surf"] else 0, float(gaze.get("confidence", 1.0)),
+                                                float(x), float(y), float(gaze.get("timestamp", 0.0)))
+
     @staticmethod
     def send_hardware_data():
         """
@@ -176,16 +186,13 @@ class HardwareSuite:
         if (HardwareSuite.hardware_socket == None or HardwareSuite.hardware_address == None):
             HardwareSuite.establish_publish_connection()
 
-        # Retrieve the hardware data
-        HUD_OnSurf = HardwareSuite.retrieve_eye_tracking_data()
+        # Retrieve the hardware data (every gaze sample received since the last call)
+        gaze_samples = HardwareSuite.retrieve_eye_tracking_data()
 
-        if HUD_OnSurf is None:
-            return # Exit if no data is received
-
-        # Send the hardware data (for now, just send the HUD_OnSurf data)
+        # Send one datagram per sample, so the carla server sees the full eye-tracker rate
         try:
-            message = b'\x01' if HUD_OnSurf else b'\x00'
-            HardwareSuite.hardware_socket.sendto(message, HardwareSuite.hardware_address)
+            for gaze in gaze_samples:
+                HardwareSuite.hardware_socket.sendto(HardwareSuite.pack_gaze_sample(gaze), HardwareSuite.hardware_address)
         except socket.error as e:
             print(f"Socket error: {e}")
         except Exception as e:
@@ -207,25 +214,22 @@ class HardwareSuite:
         if (HardwareSuite.pupil_context == None or HardwareSuite.pupil_socket == None):
             HardwareSuite.establish_eye_tracking_connection()
 
-        latest_gaze_position = None
+        gaze_samples = []
 
-        try:
-            topic = HardwareSuite.pupil_socket.recv_string(flags=zmq.NOBLOCK)
-            msg = HardwareSuite.pupil_socket.recv(flags=zmq.NOBLOCK)  # bytes
-            surfaces = loads(msg, raw=False)
-            surface_data = {
-                k: v for k, v in surfaces.items()
-            }
+        # Drain every pending surface message (each one may carry several gaze positions)
+        while True:
+            try:
+                topic = HardwareSuite.pupil_socket.recv_string(flags=zmq.NOBLOCK)
+                msg = HardwareSuite.pupil_socket.recv(flags=zmq.NOBLOCK)  # bytes
+            except Exception as e:  # zmq.Again: nothing left to read
+                break
             try:
-                # note that we may have more than one gaze position data point (this is expected behavior)
-                gaze_positions = surface_data["gaze_on_surfaces"]
-                latest_gaze_position = gaze_positions[-1]["on_surf"]
+                surfaces = loads(msg, raw=False)
+                gaze_samples.extend(surfaces["gaze_on_surfaces"])
             except Exception as e:
                 pass
-        except Exception as e:
-            pass
 
-        return latest_gaze_position
+        return gaze_samples
 
 
 class VehicleBehaviourSuite:
@@ -312,6 +316,20 @@ class VehicleBehaviourSuite:
         # Send the the message
         VehicleBehaviourSuite.publisher_socket.send(serialized_message)
 
+    @staticmethod
+    def _decode_carla_vehicle_status(message):
+        # carla sends either the JSON dict (VehicleStatusWireFormat="Compat") or a msgpack
+        # [status_code, unix_time_ms] array (VehicleStatusWireFormat="Compact")
+        if message[:1] == b"{":
+            return json.loads(message)
+        status_code, unix_time_ms = serializer.unpackb(message)
+        if not 0 <= status_code < len(VehicleBehaviourSuite.ordered_vehicle_status):
+            raise ValueError(f"Invalid vehicle status code from carla: {status_code}")
+        timestamp = datetime.datetime.fromtimestamp(unix_time_ms / 1000.0)
+        return {"from": "carla",
+                "timestamp": timestamp.strftime("%d/%m/%Y %H:%M:%S.%f")[:-3],
+                "vehicle_status": VehicleBehaviourSuite.ordered_vehicle_status[status_code]}
+
     @staticmethod
     def receive_carla_vehicle_status():
         # Create ZMQ socket if not created
@@ -319,7 +337,7 @@ class VehicleBehaviourSuite:
             VehicleBehaviourSuite._establish_vehicle_status_connection()
         try:
             message = VehicleBehaviourSuite.carla_subscriber_socket.recv()
-            message_dict = json.loads(message)
+            message_dict = VehicleBehaviourSuite._decode_carla_vehicle_status(message)
             # print("Received message:", message_dict)
         except zmq.Again:  # This exception is raised on timeout
             # print(f"Didn't receive any message from carla server at {datetime.datetime.now().strftime('%d/%m/%Y %H:%M:%S.%f')[:-3]}")
@@ -0,0 +1,60 @@
+"""
+Local stand-in for the pupil core -> carla server eye-tracker stream
+Sends gaze-on-HUD samples over UDP in the same datagram layout as HardwareSuite.send_hardware_data,
+at the eye-tracker rate and in bursts, to test the ingestion on the carla server without the eye tracker
+"""
+import argparse
+import math
+import random
+import socket
+import struct
+import time
+
+sample_format = struct.Struct("<Bfffd")  # on_surf, confidence, norm_pos x, norm_pos y, device timestamp
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument("--host", default="127.0.0.1", help="carla server address")
+parser.add_argument("--port", type=int, default=5558, help="eye-tracker UDP port of the carla server")
+parser.add_argument("--rate", type=float, default=200.0, help="samples per second")
+parser.add_argument("--burst", type=int, default=1, help="samples sent together (pupil sends several per surface message)")
+parser.add_argument("--period", type=float, default=4.0, help="seconds between looking at the HUD and away from it")
+parser.add_argument("--blink-rate", type=float, default=0.2, help="blinks per second (low confidence, off surface)")
+parser.add_argument("--clock-offset", type=float, default=1000.0, help="device clock minus local clock (seconds)")
+parser.add_argument("--legacy", action="store_true", help="send the old 1 byte OnSurf datagrams")
+args = parser.parse_args()
+
+sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+address = (args.host, args.port)
+interval = 1.0 / args.rate
+start = time.monotonic()
+next_time = start
+blink_until = 0.0
+sent = 0
+
+while True:
+    samples = []
+    for _ in range(args.burst):
+        now = next_time - start
+        on_surf = math.fmod(now, args.period) < args.period / 2
+        confidence = random.uniform(0.8, 1.0)
+        if now >= blink_until and random.random() < args.blink_rate * interval:
+            blink_until = now + 0.15
+        if now < blink_until:
+            on_surf, confidence = False, random.uniform(0.0, 0.3)
+        x = 0.5 + 0.3 * math.cos(now) if on_surf else -0.5
+        y = 0.5 + 0.3 * math.sin(now) if on_surf else -0.5
+        if args.legacy:
+            samples.append(b'\x01' if on_surf else b'\x00')
+        else:
+            samples.append(sample_format.pack(on_surf, confidence, x, y, now + args.clock_offset))
+        next_time += interval
+
+    # wait until the last sample of the burst is due, then send them all at once
+    delay = next_time - interval - time.monotonic()
+    if delay > 0:
+        time.sleep(delay)
+    for datagram in samples:
+        sock.sendto(datagram, address)
+    sent += len(samples)
+    if sent % int(args.rate * 5) < len(samples):
+        print(f"sent {sent} samples")
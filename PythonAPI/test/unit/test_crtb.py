@@ -0,0 +1,64 @@
+# Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+import os
+import shutil
+import struct
+import sys
+import tempfile
+import unittest
+
+import numpy as np
+
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'util'))
+
+import crtb
+
+
+class TestCRTB(unittest.TestCase):
+    def setUp(self):
+        self.folder = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.folder)
+
+    def test_round_trip(self):
+        table = {
+            'frame': np.array([1, 2, 3], dtype=np.uint64),
+            'id': np.array([7, 8, 4000000000], dtype=np.uint32),
+            'delta': np.array([-1, 0, 1], dtype=np.int64),
+            'x': np.array([0.5, -1.25, 3.0], dtype=np.float32),
+            'time': np.array([0.0, 0.016, 1e9], dtype=np.float64),
+            'alive': np.array([True, False, True]),
+            'type_id': np.array(['vehicle.tesla.model3', '', u'walker.\xe9'], dtype=object),
+        }
+        path = os.path.join(self.folder, 'a.crtb')
+        crtb.write_table(path, table)
+        read = crtb.read_table(path)
+        self.assertEqual(set(read.keys()), set(table.keys()))
+        for name, values in table.items():
+            self.assertEqual(read[name].dtype, values.dtype, name)
+            self.assertEqual(list(read[name]), list(values), name)
+
+    def test_server_layout(self):
+        # two rows, one uint32 and one string column, byte by byte as CarlaRecorderTable::Save writes them
+        data = struct.pack('<IHQI', 0x42545243, 1, 2, 2)
+        data += struct.pack('<H', 2) + b'id' + b'I' + struct.pack('<Q', 8) + struct.pack('<II', 5, 6)
+        data += struct.pack('<H', 4) + b'name' + b'S' + struct.pack('<Q', 24 + 3) + struct.pack('<QQQ', 0, 2, 3) + b'abc'
+        path = os.path.join(self.folder, 'b.crtb')
+        with open(path, 'wb') as f:
+            f.write(data)
+        read = crtb.read_table(path)
+        self.assertEqual(list(read.keys()), ['id', 'name'])
+        self.assertEqual(list(read['id']), [5, 6])
+        self.assertEqual(list(read['name']), ['ab', 'c'])
+
+    def test_bad_magic(self):
+        path = os.path.join(self.folder, 'c.crtb')
+        with open(path, 'wb') as f:
+            f.write(struct.pack('<IHQI', 0, 1, 0, 0))
+        with self.assertRaises(ValueError):
+            crtb.read_table(path)
@@ -0,0 +1,133 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""
+Traffic manager map cache builder.
+
+Cooks the traffic manager's map cache of every OpenDRIVE map found under the
+given content folders, so the traffic manager does not have to build it the
+first time it runs on a map. The cache of "<folder>/OpenDrive/<map>.xodr" is
+written to "<folder>/TM/<map>.bin", which is where the server looks for it.
+Caches newer than their OpenDRIVE are kept unless --force is given.
+
+    python build_tm_cache.py
+    python build_tm_cache.py --map Town10HD --force
+    python build_tm_cache.py /path/to/CarlaUE4/Content
+"""
+
+from __future__ import print_function
+
+import argparse
+import glob
+import io
+import os
+import sys
+import time
+
+try:
+    sys.path.append(glob.glob('../carla/dist/carla-*%d.%d-%s.egg' % (
+        sys.version_info.major,
+        sys.version_info.minor,
+        'win-amd64' if os.name == 'nt' else 'linux-x86_64'))[0])
+except IndexError:
+    pass
+
+import carla
+
+
+CARLA_ROOT_PATH = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..'))
+
+# Content folder of a source build and of a package, in that order.
+DEFAULT_CONTENT_FOLDERS = [
+    os.path.join(CARLA_ROOT_PATH, 'Unreal', 'CarlaUE4', 'Content'),
+    os.path.join(CARLA_ROOT_PATH, 'CarlaUE4', 'Content')]
+
+
+def find_maps(content_folders, names):
+    """Returns the (xodr path, cache path) of every map found, sorted by path."""
+    maps = []
+    for content_folder in content_folders:
+        for root, _, files in os.walk(content_folder):
+            if os.path.basename(root) != 'OpenDrive':
+                continue
+            for file_name in files:
+                name, extension = os.path.splitext(file_name)
+                if extension != '.xodr' or (names and name not in names):
+                    continue
+                cache_path = os.path.join(os.path.dirname(root), 'TM', name + '.bin')
+                maps.append((os.path.join(root, file_name), cache_path))
+    return sorted(maps)
+
+
+def is_up_to_date(xodr_path, cache_path):
+    return os.path.isfile(cache_path) and os.path.getmtime(cache_path) >= os.path.getmtime(xodr_path)
+
+
+def build_cache(xodr_path, cache_path):
+    # Read the OpenDRIVE as the server does (no BOM, line endings untouched), so the
+    # content hash stored in the cache matches the one the server computes.
+    with io.open(xodr_path, 'r', encoding='utf-8-sig', newline='') as xodr_file:
+        data = xodr_file.read()
+    if sys.version_info < (3, 0):
+        data = data.encode('utf-8')
+    cache_folder = os.path.dirname(cache_path)
+    if not os.path.exists(cache_folder):
+        os.makedirs(cache_folder)
+    name = os.path.splitext(os.path.basename(xodr_path))[0]
+    carla.Map(str(name), data).cook_in_memory_map(str(cache_path))
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    argparser.add_argument(
+        'content',
+        nargs='*',
+        help='content folders to search for maps (default: the ones of this build or package)')
+    argparser.add_argument(
+        '-m', '--map',
+        metavar='NAME',
+        nargs='+',
+        default=[],
+        help='only build the cache of these maps')
+    argparser.add_argument(
+        '-f', '--force',
+        action='store_true',
+        help='rebuild caches that are already up to date')
+    args = argparser.parse_args()
+
+    content_folders = args.content or [f for f in DEFAULT_CONTENT_FOLDERS if os.path.isdir(f)]
+    if not content_folders:
+        print('No content folder found, pass the path of one.')
+        sys.exit(1)
+
+    maps = find_maps(content_folders, set(args.map))
+    if not maps:
+        print('No OpenDRIVE map found in', ', '.join(content_folders))
+        sys.exit(1)
+
+    failed = []
+    for xodr_path, cache_path in maps:
+        if not args.force and is_up_to_date(xodr_path, cache_path):
+            print('Up to date  %s' % cache_path)
+            continue
+        start = time.time()
+        try:
+            build_cache(xodr_path, cache_path)
+        except RuntimeError as error:
+            print('Failed      %s: %s' % (xodr_path, error))
+            failed.append(xodr_path)
+            continue
+        print('Built       %s in %.1f s' % (cache_path, time.time() - start))
+
+    if failed:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+
+    main()
@@ -0,0 +1,152 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""
+Reader for the typed columnar tables written by the ExportRecording
+commandlet ("<recording>.frames.crtb" and "<recording>.actors.crtb").
+
+    import crtb
+    frames = crtb.read_table('p01.frames.crtb')      # {column: numpy array}
+    actors = crtb.read_dataframe('p01.actors.crtb')  # pandas.DataFrame
+
+Run as a script it converts tables to CSV next to them:
+
+    python crtb.py p01.frames.crtb p01.actors.crtb
+"""
+
+from __future__ import print_function
+
+import argparse
+import collections
+import os
+import struct
+
+import numpy as np
+
+
+MAGIC = 0x42545243  # "CRTB"
+VERSION = 1
+
+# column type code -> numpy dtype ('S' strings are read into object arrays)
+DTYPES = {
+    'B': np.dtype(np.bool_),
+    'q': np.dtype('<i8'),
+    'I': np.dtype('<u4'),
+    'Q': np.dtype('<u8'),
+    'f': np.dtype('<f4'),
+    'd': np.dtype('<f8'),
+}
+
+_HEADER = struct.Struct('<IHQI')
+_U16 = struct.Struct('<H')
+_U64 = struct.Struct('<Q')
+
+
+def _type_code(array):
+    for code, dtype in DTYPES.items():
+        if array.dtype.newbyteorder('<') == dtype:
+            return code
+    if array.dtype.kind in ('O', 'U', 'S'):
+        return 'S'
+    raise ValueError('unsupported column dtype %s' % array.dtype)
+
+
+def read_table(path):
+    """Returns the columns of a .crtb file as an ordered {name: numpy array}."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if len(data) < _HEADER.size:
+        raise ValueError('%s: not a CRTB table (too short)' % path)
+    magic, version, rows, columns = _HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError('%s: not a CRTB table' % path)
+    if version != VERSION:
+        raise ValueError('%s: unsupported CRTB version %d' % (path, version))
+    offset = _HEADER.size
+    table = collections.OrderedDict()
+    for _ in range(columns):
+        name_length, = _U16.unpack_from(data, offset)
+        offset += _U16.size
+        name = data[offset:offset + name_length].decode('utf-8')
+        offset += name_length
+        code = data[offset:offset + 1].decode('ascii')
+        offset += 1
+        size, = _U64.unpack_from(data, offset)
+        offset += _U64.size
+        if offset + size > len(data):
+            raise ValueError('%s: column "%s" is truncated' % (path, name))
+        if code == 'S':
+            ends = np.frombuffer(data, dtype='<u8', count=rows + 1, offset=offset)
+            chars = data[offset + (rows + 1) * _U64.size:offset + size]
+            column = np.empty(rows, dtype=object)
+            for i in range(rows):
+                column[i] = chars[ends[i]:ends[i + 1]].decode('utf-8')
+        elif code in DTYPES:
+            dtype = DTYPES[code]
+            if size != rows * dtype.itemsize:
+                raise ValueError('%s: column "%s" has %d bytes for %d rows' % (path, name, size, rows))
+            column = np.frombuffer(data, dtype=dtype, count=rows, offset=offset).copy()
+        else:
+            raise ValueError('%s: column "%s" has unknown type "%s"' % (path, name, code))
+        table[name] = column
+        offset += size
+    return table
+
+
+def read_dataframe(path):
+    """Returns a .crtb file as a pandas.DataFrame (requires pandas)."""
+    import pandas as pd
+    return pd.DataFrame(read_table(path))
+
+
+def write_table(path, table):
+    """Writes {name: array} in the layout of CarlaRecorderTable::Save (all columns of the same length)."""
+    columns = [(name, np.asarray(values)) for name, values in table.items()]
+    rows = len(columns[0][1]) if columns else 0
+    with open(path, 'wb') as f:
+        f.write(_HEADER.pack(MAGIC, VERSION, rows, len(columns)))
+        for name, values in columns:
+            if len(values) != rows:
+                raise ValueError('column "%s" has %d rows, expected %d' % (name, len(values), rows))
+            code = _type_code(values)
+            encoded_name = name.encode('utf-8')
+            f.write(_U16.pack(len(encoded_name)))
+            f.write(encoded_name)
+            f.write(code.encode('ascii'))
+            if code == 'S':
+                chars = [v if isinstance(v, bytes) else str(v).encode('utf-8') for v in values]
+                ends = np.cumsum([0] + [len(c) for c in chars]).astype('<u8')
+                payload = ends.tobytes() + b''.join(chars)
+            else:
+                payload = values.astype(DTYPES[code]).tobytes()
+            f.write(_U64.pack(len(payload)))
+            f.write(payload)
+
+
+def write_csv(table, path):
+    names = list(table.keys())
+    with open(path, 'w') as f:
+        f.write(','.join(names) + '\n')
+        for row in zip(*[table[name] for name in names]):
+            f.write(','.join(str(value) for value in row) + '\n')
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    argparser.add_argument('tables', nargs='+', help='.crtb files to convert to .csv')
+    args = argparser.parse_args()
+    for path in args.tables:
+        table = read_table(path)
+        output = os.path.splitext(path)[0] + '.csv'
+        write_csv(table, output)
+        rows = len(next(iter(table.values()))) if table else 0
+        print('%s: %d rows, %d columns -> %s' % (path, rows, len(table), output))
+
+
+if __name__ == '__main__':
+    main()
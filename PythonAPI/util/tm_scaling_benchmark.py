@@ -0,0 +1,197 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""
+Traffic manager scaling benchmark.
+
+Spawns an increasing number of autopilot vehicles and measures the time of a
+synchronous tick (which waits for the traffic manager cycle) for every number
+of traffic manager stage workers. Every run reloads the world and uses the same
+traffic manager seed, so the vehicle locations at the end of the runs can be
+compared to check the parallel stages are deterministic. A single worker runs
+the stages interleaved per vehicle like the original traffic manager, so its
+locations are not comparable and the first run with more than one worker is
+the reference of the deviation column. The speedup is relative to the first
+run.
+
+    python tm_scaling_benchmark.py --vehicles 50 100 250 500 1000 2000 --workers 1 2 4 8
+"""
+
+import glob
+import os
+import sys
+import argparse
+import math
+import time
+
+try:
+    sys.path.append(glob.glob('../carla/dist/carla-*%d.%d-%s.egg' % (
+        sys.version_info.major,
+        sys.version_info.minor,
+        'win-amd64' if os.name == 'nt' else 'linux-x86_64'))[0])
+except IndexError:
+    pass
+
+import carla
+
+
+def get_spawn_transforms(world, number_of_vehicles, spacing):
+    """Map spawn points first, then lane waypoints when there are not enough of them."""
+    transforms = list(world.get_map().get_spawn_points())
+    if len(transforms) < number_of_vehicles:
+        for waypoint in world.get_map().generate_waypoints(spacing):
+            if waypoint.is_junction or waypoint.lane_type != carla.LaneType.Driving:
+                continue
+            transform = waypoint.transform
+            transform.location.z += 0.5
+            transforms.append(transform)
+    return transforms[:number_of_vehicles]
+
+
+def run(client, args, number_of_vehicles, workers):
+    world = client.reload_world(False)
+    traffic_manager = client.get_trafficmanager(args.tm_port)
+    traffic_manager.set_synchronous_mode(True)
+    traffic_manager.set_random_device_seed(args.seed)
+    traffic_manager.set_hybrid_physics_mode(args.hybrid)
+    traffic_manager.set_parallel_workers(workers)
+
+    settings = world.get_settings()
+    settings.synchronous_mode = True
+    settings.fixed_delta_seconds = 0.05
+    world.apply_settings(settings)
+
+    blueprints = sorted(world.get_blueprint_library().filter('vehicle.*'), key=lambda bp: bp.id)
+    blueprints = [bp for bp in blueprints if int(bp.get_attribute('number_of_wheels')) == 4]
+
+    batch = []
+    for i, transform in enumerate(get_spawn_transforms(world, number_of_vehicles, args.spacing)):
+        blueprint = blueprints[i % len(blueprints)]
+        if blueprint.has_attribute('color'):
+            blueprint.set_attribute('color', blueprint.get_attribute('color').recommended_values[0])
+        blueprint.set_attribute('role_name', 'autopilot')
+        batch.append(carla.command.SpawnActor(blueprint, transform)
+            .then(carla.command.SetAutopilot(carla.command.FutureActor, True, args.tm_port)))
+    # Spawn index of every vehicle, actor ids are not reused after reloading the world.
+    spawned = {}
+    for index, response in enumerate(client.apply_batch_sync(batch, True)):
+        if not response.error:
+            spawned[response.actor_id] = index
+    vehicles = list(spawned)
+
+    try:
+        for _ in range(args.warmup):
+            world.tick()
+
+        tick_times = []
+        for _ in range(args.frames):
+            start = time.perf_counter()
+            world.tick()
+            tick_times.append(time.perf_counter() - start)
+
+        locations = {}
+        for actor in world.get_actors(vehicles):
+            locations[spawned[actor.id]] = actor.get_location()
+    finally:
+        client.apply_batch_sync([carla.command.DestroyActor(x) for x in vehicles], True)
+        settings.synchronous_mode = False
+        settings.fixed_delta_seconds = None
+        world.apply_settings(settings)
+        traffic_manager.set_synchronous_mode(False)
+        traffic_manager.set_parallel_workers(1)
+
+    tick_times.sort()
+    mean = sum(tick_times) / len(tick_times)
+    p95 = tick_times[min(len(tick_times) - 1, int(0.95 * len(tick_times)))]
+    return len(vehicles), mean, p95, locations
+
+
+def max_deviation(reference, locations):
+    deviation = 0.0
+    for index, location in locations.items():
+        if index in reference:
+            deviation = max(deviation, location.distance(reference[index]))
+    return deviation
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__)
+    argparser.add_argument(
+        '--host', metavar='H', default='127.0.0.1',
+        help='IP of the host server (default: 127.0.0.1)')
+    argparser.add_argument(
+        '-p', '--port', metavar='P', default=2000, type=int,
+        help='TCP port to listen to (default: 2000)')
+    argparser.add_argument(
+        '--tm-port', metavar='P', default=8000, type=int,
+        help='Port to communicate with TM (default: 8000)')
+    argparser.add_argument(
+        '--vehicles', metavar='N', default=[50, 100, 250, 500, 1000, 2000], type=int, nargs='+',
+        help='Numbers of vehicles to benchmark (default: 50 100 250 500 1000 2000)')
+    argparser.add_argument(
+        '--workers', metavar='W', default=[1, 2, 4, 8], type=int, nargs='+',
+        help='Numbers of TM stage workers to benchmark (default: 1 2 4 8)')
+    argparser.add_argument(
+        '--frames', metavar='F', default=200, type=int,
+        help='Measured frames per run (default: 200)')
+    argparser.add_argument(
+        '--warmup', metavar='F', default=50, type=int,
+        help='Frames before measuring (default: 50)')
+    argparser.add_argument(
+        '-s', '--seed', metavar='S', default=42, type=int,
+        help='TM random device seed (default: 42)')
+    argparser.add_argument(
+        '--spacing', metavar='D', default=12.0, type=float,
+        help='Distance between extra spawn waypoints when the map has not enough spawn points (default: 12.0)')
+    argparser.add_argument(
+        '--tolerance', metavar='D', default=0.0, type=float,
+        help='Largest deviation [m] from the reference locations accepted as deterministic (default: 0.0)')
+    argparser.add_argument(
+        '--hybrid', action='store_true',
+        help='Enable TM hybrid physics mode')
+    args = argparser.parse_args()
+
+    client = carla.Client(args.host, args.port)
+    client.set_timeout(60.0)
+
+    print('%8s %8s %12s %12s %10s %14s' % ('vehicles', 'workers', 'mean [ms]', 'p95 [ms]', 'speedup', 'deviation [m]'))
+    deterministic = True
+    try:
+        for number_of_vehicles in args.vehicles:
+            baseline = None
+            reference = None
+            for workers in args.workers:
+                spawned, mean, p95, locations = run(client, args, number_of_vehicles, workers)
+                if baseline is None:
+                    baseline = mean
+                if workers > 1 and reference is None:
+                    reference = locations
+                if workers > 1:
+                    deviation = max_deviation(reference, locations)
+                    flag = ''
+                    if deviation > args.tolerance:
+                        deterministic = False
+                        flag = '  <- not deterministic'
+                    deviation = '%14.4f%s' % (deviation, flag)
+                else:
+                    deviation = '%14s' % '-'
+                print('%8d %8d %12.2f %12.2f %10.2f %s' % (
+                    spawned, workers, 1000.0 * mean, 1000.0 * p95,
+                    baseline / mean if mean > 0.0 else math.nan,
+                    deviation))
+    except KeyboardInterrupt:
+        pass
+
+    if not deterministic:
+        print('error: the vehicle locations depend on the number of workers')
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+
+    main()
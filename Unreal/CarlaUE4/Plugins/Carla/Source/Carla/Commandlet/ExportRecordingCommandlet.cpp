@@ -0,0 +1,113 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "ExportRecordingCommandlet.h"
+
+#include "Carla/Recorder/CarlaRecorderExporter.h"
+#include "Carla/Recorder/CarlaRecorderHelpers.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+#include <algorithm>
+#include <thread>
+
+UExportRecordingCommandlet::UExportRecordingCommandlet()
+{
+  IsClient = false;
+  IsEditor = false;
+  IsServer = false;
+  LogToConsole = true;
+}
+
+int32 UExportRecordingCommandlet::Main(const FString &Params)
+{
+  FString Recordings;
+  FParse::Value(*Params, TEXT("Recordings="), Recordings, false);
+  TArray<FString> Filenames;
+  Recordings.ParseIntoArray(Filenames, TEXT(";"), true);
+  if (Filenames.Num() == 0)
+  {
+    UE_LOG(LogCarla, Error, TEXT("Usage: -run=ExportRecording -Recordings=\"a.rec;b.rec\" "
+                                 "[-Output=<dir>] [-Threads=<n>] [-Benchmark] [-Repeat=<n>]"));
+    return 1;
+  }
+
+  FString OutputDir = FPaths::ProjectSavedDir() / TEXT("ExportedRecordings");
+  FParse::Value(*Params, TEXT("Output="), OutputDir);
+  int32 Threads = 0;
+  FParse::Value(*Params, TEXT("Threads="), Threads);
+  int32 Repeat = 3;
+  FParse::Value(*Params, TEXT("Repeat="), Repeat);
+  const bool bBenchmark = FParse::Param(*Params, TEXT("Benchmark"));
+
+  int32 Failed = 0;
+  for (const FString &Filename : Filenames)
+  {
+    const bool bOk = bBenchmark ? Benchmark(Filename, Repeat) : Export(Filename, OutputDir, Threads);
+    if (!bOk)
+    {
+      ++Failed;
+    }
+  }
+  return Failed == 0 ? 0 : 1;
+}
+
+bool UExportRecordingCommandlet::Export(const FString &Filename, const FString &OutputDir, int32 Threads) const
+{
+  const std::string Path = GetRecorderFilename(TCHAR_TO_UTF8(*Filename));
+  const auto Exported = CarlaRecorderExporter::Export(Path, std::max(Threads, 0));
+  if (!Exported.Error.empty())
+  {
+    UE_LOG(LogCarla, Error, TEXT("%s"), UTF8_TO_TCHAR(Exported.Error.c_str()));
+    return false;
+  }
+
+  IFileManager::Get().MakeDirectory(*OutputDir, true);
+  const FString Prefix = OutputDir / FPaths::GetBaseFilename(UTF8_TO_TCHAR(Path.c_str()));
+  if (!CarlaRecorderExporter::Save(Exported, TCHAR_TO_UTF8(*Prefix)))
+  {
+    UE_LOG(LogCarla, Error, TEXT("Could not write %s.*.crtb"), *Prefix);
+    return false;
+  }
+
+  UE_LOG(LogCarla, Log, TEXT("Exported %s: %llu frames, %llu actor rows (%.1f MB/s) to %s.*.crtb"),
+      UTF8_TO_TCHAR(Path.c_str()), Exported.Frames.GetRows(), Exported.Actors.GetRows(),
+      Exported.Bytes / 1.0e6 / std::max(Exported.Seconds, 1.0e-9), *Prefix);
+  return true;
+}
+
+bool UExportRecordingCommandlet::Benchmark(const FString &Filename, int32 Repeat) const
+{
+  const std::string Path = GetRecorderFilename(TCHAR_TO_UTF8(*Filename));
+  const unsigned MaxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  // the first export maps the file and builds (or loads) the frame index
+  const auto Warmup = CarlaRecorderExporter::Export(Path, 1);
+  if (!Warmup.Error.empty())
+  {
+    UE_LOG(LogCarla, Error, TEXT("%s"), UTF8_TO_TCHAR(Warmup.Error.c_str()));
+    return false;
+  }
+  UE_LOG(LogCarla, Log, TEXT("Benchmark %s: %.1f MB, %llu frames"),
+      UTF8_TO_TCHAR(Path.c_str()), Warmup.Bytes / 1.0e6, Warmup.Frames.GetRows());
+
+  for (unsigned Threads = 1; ; Threads = std::min(Threads * 2, MaxThreads))
+  {
+    double Best = 0.0;
+    for (int32 i = 0; i < std::max(Repeat, 1); ++i)
+    {
+      const auto Exported = CarlaRecorderExporter::Export(Path, Threads);
+      Best = std::max(Best, Exported.Bytes / 1.0e6 / std::max(Exported.Seconds, 1.0e-9));
+    }
+    UE_LOG(LogCarla, Log, TEXT("  %2u threads: %8.1f MB/s"), Threads, Best);
+    if (Threads == MaxThreads)
+    {
+      break;
+    }
+  }
+  return true;
+}
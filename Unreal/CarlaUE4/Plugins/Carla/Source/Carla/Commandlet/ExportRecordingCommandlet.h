@@ -0,0 +1,45 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "ExportRecordingCommandlet.generated.h"
+
+/// Exports recordings to typed columnar tables (see CarlaRecorderExporter)
+/// without loading a map or replaying them:
+///
+///   UE4Editor CarlaUE4 -run=ExportRecording -Recordings="p01.rec;p02.rec"
+///       [-Output=<dir>] [-Threads=<n>] [-Benchmark] [-Repeat=<n>]
+///
+/// Relative recording names are resolved like the replayer does. With
+/// -Benchmark nothing is written; every recording is decoded with 1, 2, 4, ...
+/// threads and the best throughput (MB/s of recording) is logged. The tables
+/// are read with PythonAPI/util/crtb.py.
+UCLASS()
+class CARLA_API UExportRecordingCommandlet
+  : public UCommandlet
+{
+  GENERATED_BODY()
+
+public:
+
+  /// Default constructor.
+  UExportRecordingCommandlet();
+
+  /// Main method and entry of the commandlet, taking as input parameters @a
+  /// Params.
+  virtual int32 Main(const FString &Params) override;
+
+private:
+
+  /// Exports @a Filename into @a OutputDir, returns false on error.
+  bool Export(const FString &Filename, const FString &OutputDir, int32 Threads) const;
+
+  /// Logs the decoding throughput of @a Filename for an increasing number of threads.
+  bool Benchmark(const FString &Filename, int32 Repeat) const;
+};
@@ -0,0 +1,93 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "QueryRecordingCommandlet.h"
+
+#include "Carla/Recorder/CarlaRecorderQuery.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include <string>
+#include <vector>
+
+UQueryRecordingCommandlet::UQueryRecordingCommandlet()
+{
+  IsClient = false;
+  IsEditor = false;
+  IsServer = false;
+  LogToConsole = true;
+}
+
+int32 UQueryRecordingCommandlet::Main(const FString &Params)
+{
+  FString Recordings;
+  FParse::Value(*Params, TEXT("Recordings="), Recordings, false);
+  TArray<FString> Filenames;
+  Recordings.ParseIntoArray(Filenames, TEXT(";"), true);
+  if (Filenames.Num() == 0)
+  {
+    UE_LOG(LogCarla, Error, TEXT("Usage: -run=QueryRecording -Recordings=\"a.rec;b.rec\" [-Output=<dir>] "
+                                 "[-ShowAll] [-Category1=<c>] [-Category2=<c>] [-MinTime=<s>] [-MinDistance=<m>]"));
+    return 1;
+  }
+
+  FString OutputDir = FPaths::ProjectSavedDir() / TEXT("RecordingQueries");
+  FParse::Value(*Params, TEXT("Output="), OutputDir);
+
+  // same defaults and category letters as client.show_recorder_collisions / show_recorder_actors_blocked
+  CarlaRecorderQuery::ReportOptions Options;
+  Options.bShowAll = FParse::Param(*Params, TEXT("ShowAll"));
+  FString Category;
+  if (FParse::Value(*Params, TEXT("Category1="), Category) && !Category.IsEmpty())
+  {
+    Options.Category1 = static_cast<char>(Category[0]);
+  }
+  if (FParse::Value(*Params, TEXT("Category2="), Category) && !Category.IsEmpty())
+  {
+    Options.Category2 = static_cast<char>(Category[0]);
+  }
+  float MinTime = Options.MinTime;
+  FParse::Value(*Params, TEXT("MinTime="), MinTime);
+  Options.MinTime = MinTime;
+  float MinDistance = Options.MinDistance;
+  FParse::Value(*Params, TEXT("MinDistance="), MinDistance);
+  Options.MinDistance = MinDistance;
+
+  std::vector<std::string> Paths;
+  for (const FString &Filename : Filenames)
+  {
+    Paths.emplace_back(TCHAR_TO_UTF8(*Filename));
+  }
+  const auto Reports = CarlaRecorderQuery::QueryBatch(Paths, Options);
+
+  IFileManager::Get().MakeDirectory(*OutputDir, true);
+  int32 Failed = 0;
+  for (const auto &Report : Reports)
+  {
+    if (!Report.bOk)
+    {
+      UE_LOG(LogCarla, Error, TEXT("Could not query %s: %s"), UTF8_TO_TCHAR(Report.Filename.c_str()),
+             *FString(UTF8_TO_TCHAR(Report.Info.c_str())).TrimEnd());
+      ++Failed;
+      continue;
+    }
+    const FString Prefix = OutputDir / FPaths::GetBaseFilename(UTF8_TO_TCHAR(Report.Filename.c_str()));
+    const bool bOk =
+        FFileHelper::SaveStringToFile(UTF8_TO_TCHAR(Report.Info.c_str()), *(Prefix + TEXT(".info.txt"))) &&
+        FFileHelper::SaveStringToFile(UTF8_TO_TCHAR(Report.Collisions.c_str()), *(Prefix + TEXT(".collisions.txt"))) &&
+        FFileHelper::SaveStringToFile(UTF8_TO_TCHAR(Report.Blocked.c_str()), *(Prefix + TEXT(".blocked.txt")));
+    if (!bOk)
+    {
+      UE_LOG(LogCarla, Error, TEXT("Could not write %s.*.txt"), *Prefix);
+      ++Failed;
+      continue;
+    }
+    UE_LOG(LogCarla, Log, TEXT("Queried %s to %s.*.txt"), UTF8_TO_TCHAR(Report.Filename.c_str()), *Prefix);
+  }
+  return Failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "QueryRecordingCommandlet.generated.h"
+
+/// Runs the info, collisions and blocked-actors queries of the recorder on
+/// recordings (see CarlaRecorderQuery::QueryBatch), without loading a map:
+///
+///   UE4Editor CarlaUE4 -run=QueryRecording -Recordings="p01.rec;p02.rec"
+///       [-Output=<dir>] [-ShowAll] [-Category1=<c>] [-Category2=<c>]
+///       [-MinTime=<s>] [-MinDistance=<m>]
+///
+/// Every recording is read once for its three queries and the recordings are
+/// queried in parallel. The reports are written to
+/// <dir>/<recording>.{info,collisions,blocked}.txt.
+UCLASS()
+class CARLA_API UQueryRecordingCommandlet
+  : public UCommandlet
+{
+  GENERATED_BODY()
+
+public:
+
+  /// Default constructor.
+  UQueryRecordingCommandlet();
+
+  /// Main method and entry of the commandlet, taking as input parameters @a
+  /// Params.
+  virtual int32 Main(const FString &Params) override;
+};
@@ -280,15 +280,21 @@ void ACarlaRecorder::AddActorBoundingBox(FCarlaActor *CarlaActor)
 
 void ACarlaRecorder::AddDReyeVRData()
 {
+  const ADReyeVRSensor *Sensor = ADReyeVRSensor::GetDReyeVRSensor(GetWorld());
+  if (Sensor == nullptr)
+  {
+    return;
+  }
+
   static bool bAddedConfigFile;
   if (!bAddedConfigFile) {
     // add DReyeVR config files (only once at the beginning of recording)
-    DReyeVRConfigFileData.Add(ADReyeVRSensor::ConfigFile);
+    DReyeVRConfigFileData.Add(&Sensor->GetConfigFile());
     bAddedConfigFile = true;
   }
 
-  // Add the latest instance of the DReyeVR snapshot to our data
-  DReyeVRAggData.Add(DReyeVRDataRecorder<DReyeVR::AggregateData>(ADReyeVRSensor::Data));
+  // Add the latest published DReyeVR snapshot to our data
+  DReyeVRAggData.Add(DReyeVRDataRecorder<DReyeVR::AggregateData>(Sensor->GetData().Get()));
 
   for (auto &ActiveCAs : ADReyeVRCustomActor::ActiveCustomActors)
   {
@@ -369,9 +375,8 @@ std::string ACarlaRecorder::Start(std::string Name, FString MapName, bool Additi
   // get the final path + filename
   std::string Filename = GetRecorderFilename(Name);
 
-  // binary file
-  File.open(Filename, std::ios::binary);
-  if (!File.is_open())
+  // binary file (written by a background thread)
+  if (!Writer.Open(Filename))
   {
     return "";
   }
@@ -383,9 +388,11 @@ std::string ACarlaRecorder::Start(std::string Name, FString MapName, bool Additi
   Info.Mapfile = MapName;
 
   // write general info
-  Info.Write(File);
+  Info.Write(Writer.BeginFrame());
+  Writer.EndFrame();
 
   Frames.Reset();
+  FrameIndex.Reset();
   PlatformTime.SetStartTime();
 
   Enable();
@@ -405,9 +412,18 @@ void ACarlaRecorder::Stop(void)
 {
   Disable();
 
-  if (File)
+  if (Writer.IsOpen())
   {
-    File.close();
+    // append the frame index so the replayer can seek without scanning the file
+    if (FrameIndex.IsValid())
+    {
+      FrameIndex.WriteFooter(Writer.BeginFrame(), Writer.GetFrameOffset());
+      Writer.EndFrame();
+    }
+    FrameIndex.Reset();
+
+    // flushes the frames that are still queued
+    Writer.Close();
   }
 
   Clear();
@@ -441,8 +457,28 @@ void ACarlaRecorder::Write(double DeltaSeconds)
   // update this frame data
   Frames.SetFrame(DeltaSeconds);
 
+  // serialize the whole frame in memory, the writer thread puts it on disk
+  CarlaRecorderBuffer &File = Writer.BeginFrame();
+
   // start
-  Frames.WriteStart(File);
+  Frames.WriteStart(File, Writer.GetPreviousFrame());
+
+  // index this frame and the events that change the set of actors
+  FrameIndex.AddFrame(Frames.GetFrame().Id, Frames.GetFrame().Elapsed, Writer.GetFrameOffset());
+  for (const auto &Event : EventsAdd.GetEvents())
+    FrameIndex.AddEvent(Event);
+  for (const auto &Event : EventsDel.GetEvents())
+    FrameIndex.AddEvent(Event.DatabaseId);
+  for (const auto &Event : EventsParent.GetEvents())
+    FrameIndex.AddEvent(Event);
+  for (const auto &Weather : Weathers.GetWeathers())
+    FrameIndex.AddWeather(Weather);
+  for (const auto &Light : LightScenes.GetLights())
+    FrameIndex.AddLightScene(Light);
+  for (const auto &Light : LightVehicles.GetLightVehicles())
+    FrameIndex.AddLightVehicle(Light);
+  for (const auto &State : States.GetStates())
+    FrameIndex.AddTrafficLight(State);
 
   // events
   EventsAdd.Write(File);
@@ -490,6 +526,9 @@ void ACarlaRecorder::Write(double DeltaSeconds)
   // end
   Frames.WriteEnd(File);
 
+  Writer.EndFrame();
+  FrameIndex.EndFrame();
+
   Clear();
 }
 
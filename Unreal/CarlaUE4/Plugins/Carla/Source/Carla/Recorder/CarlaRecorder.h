@@ -25,11 +25,13 @@
 #include "CarlaRecorderEventDel.h"
 #include "CarlaRecorderEventParent.h"
 #include "CarlaRecorderFrames.h"
+#include "CarlaRecorderFrameIndex.h"
 #include "CarlaRecorderInfo.h"
 #include "CarlaRecorderPosition.h"
 #include "CarlaRecorderQuery.h"
 #include "CarlaRecorderState.h"
 #include "CarlaRecorderWeather.h"
+#include "CarlaRecorderWriter.h"
 #include "CarlaReplayer.h"
 
 // DReyeVR includes
@@ -48,6 +50,7 @@ class ATrafficLightBase;
 #define DREYEVR_PACKET_ID 139
 #define DREYEVR_CUSTOM_ACTOR_PACKET_ID 140
 #define DREYEVR_CONFIG_FILE_PACKET_ID 141
+#define FRAME_INDEX_PACKET_ID 142
 
 enum class CarlaRecorderPacketId : uint8_t
 {
@@ -73,7 +76,8 @@ enum class CarlaRecorderPacketId : uint8_t
   // "We suggest to use id over 100 for user custom packets, because this list will keep growing in the future"
   DReyeVR = DREYEVR_PACKET_ID,                         // our custom DReyeVR packet (for raw sensor data)
   DReyeVRCustomActor = DREYEVR_CUSTOM_ACTOR_PACKET_ID, // custom DReyeVR actors (not raw sensor data)
-  DReyeVRConfigFile = DREYEVR_CONFIG_FILE_PACKET_ID    // DReyeVR configuration files (parameters)
+  DReyeVRConfigFile = DREYEVR_CONFIG_FILE_PACKET_ID,   // DReyeVR configuration files (parameters)
+  FrameIndex = FRAME_INDEX_PACKET_ID                   // frame offsets + keyframes, appended when recording stops
 };
 
 /// Recorder for the simulation
@@ -180,14 +184,15 @@ private:
 
   uint32_t NextCollisionId = 0;
 
-  // files
-  std::ofstream File;
+  // file (serialized per frame, written on a background thread)
+  CarlaRecorderWriter Writer;
 
   UCarlaEpisode *Episode = nullptr;
 
   // structures
   CarlaRecorderInfo Info;
   CarlaRecorderFrames Frames;
+  CarlaRecorderFrameIndex FrameIndex;
   CarlaRecorderEventsAdd EventsAdd;
   CarlaRecorderEventsDel EventsDel;
   CarlaRecorderEventsParent EventsParent;
@@ -8,7 +8,7 @@
 #include "CarlaRecorderAnimVehicle.h"
 #include "CarlaRecorderHelpers.h"
 
-void CarlaRecorderAnimVehicle::Write(std::ofstream &OutFile)
+void CarlaRecorderAnimVehicle::Write(CarlaRecorderBuffer &OutFile)
 {
   // database id
   WriteValue<uint32_t>(OutFile, this->DatabaseId);
@@ -18,7 +18,7 @@ void CarlaRecorderAnimVehicle::Write(std::ofstream &OutFile)
   WriteValue<bool>(OutFile, this->bHandbrake);
   WriteValue<int32_t>(OutFile, this->Gear);
 }
-void CarlaRecorderAnimVehicle::Read(std::ifstream &InFile)
+void CarlaRecorderAnimVehicle::Read(CarlaRecorderCursor &InFile)
 {
   // database id
   ReadValue<uint32_t>(InFile, this->DatabaseId);
@@ -41,15 +41,13 @@ void CarlaRecorderAnimVehicles::Add(const CarlaRecorderAnimVehicle &Vehicle)
   Vehicles.push_back(Vehicle);
 }
 
-void CarlaRecorderAnimVehicles::Write(std::ofstream &OutFile)
+void CarlaRecorderAnimVehicles::Write(CarlaRecorderBuffer &OutFile)
 {
   // write the packet id
   WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::AnimVehicle));
 
-  std::streampos PosStart = OutFile.tellp();
-
-  // write a dummy packet size
-  uint32_t Total = 0;
+  // write the packet size
+  uint32_t Total = 2 + Vehicles.size() * (sizeof(uint32_t) + 3 * sizeof(float) + sizeof(bool) + sizeof(int32_t));
   WriteValue<uint32_t>(OutFile, Total);
 
   // write total records
@@ -58,11 +56,4 @@ void CarlaRecorderAnimVehicles::Write(std::ofstream &OutFile)
 
   for (uint16_t i=0; i<Total; ++i)
     Vehicles[i].Write(OutFile);
-
-  // write the real packet size
-  std::streampos PosEnd = OutFile.tellp();
-  Total = PosEnd - PosStart - sizeof(uint32_t);
-  OutFile.seekp(PosStart, std::ios::beg);
-  WriteValue<uint32_t>(OutFile, Total);
-  OutFile.seekp(PosEnd, std::ios::beg);
 }
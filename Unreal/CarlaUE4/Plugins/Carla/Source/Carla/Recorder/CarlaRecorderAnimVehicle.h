@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 
@@ -19,9 +21,9 @@ struct CarlaRecorderAnimVehicle
   bool bHandbrake;
   int32_t Gear;
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 
 };
 #pragma pack(pop)
@@ -34,7 +36,7 @@ public:
 
   void Clear(void);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 
 private:
 
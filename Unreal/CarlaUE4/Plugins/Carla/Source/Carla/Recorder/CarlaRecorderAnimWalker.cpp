@@ -8,13 +8,13 @@
 #include "CarlaRecorderAnimWalker.h"
 #include "CarlaRecorderHelpers.h"
 
-void CarlaRecorderAnimWalker::Write(std::ofstream &OutFile)
+void CarlaRecorderAnimWalker::Write(CarlaRecorderBuffer &OutFile)
 {
   // database id
   WriteValue<uint32_t>(OutFile, this->DatabaseId);
   WriteValue<float>(OutFile, this->Speed);
 }
-void CarlaRecorderAnimWalker::Read(std::ifstream &InFile)
+void CarlaRecorderAnimWalker::Read(CarlaRecorderCursor &InFile)
 {
   // database id
   ReadValue<uint32_t>(InFile, this->DatabaseId);
@@ -33,7 +33,7 @@ void CarlaRecorderAnimWalkers::Add(const CarlaRecorderAnimWalker &Walker)
   Walkers.push_back(Walker);
 }
 
-void CarlaRecorderAnimWalkers::Write(std::ofstream &OutFile)
+void CarlaRecorderAnimWalkers::Write(CarlaRecorderBuffer &OutFile)
 {
   // write the packet id
   WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::AnimWalker));
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 
@@ -15,9 +17,9 @@ struct CarlaRecorderAnimWalker
   uint32_t DatabaseId;
   float Speed;
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 
 };
 #pragma pack(pop)
@@ -30,7 +32,7 @@ public:
 
   void Clear(void);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 
 private:
 
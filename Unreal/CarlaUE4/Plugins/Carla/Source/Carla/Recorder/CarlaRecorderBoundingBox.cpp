@@ -8,25 +8,25 @@
 #include "CarlaRecorder.h"
 #include "CarlaRecorderHelpers.h"
 
-void CarlaRecorderBoundingBox::Write(std::ofstream &OutFile)
+void CarlaRecorderBoundingBox::Write(CarlaRecorderBuffer &OutFile)
 {
   WriteFVector(OutFile, this->Origin);
   WriteFVector(OutFile, this->Extension);
 }
 
-void CarlaRecorderBoundingBox::Read(std::ifstream &InFile)
+void CarlaRecorderBoundingBox::Read(CarlaRecorderCursor &InFile)
 {
   ReadFVector(InFile, this->Origin);
   ReadFVector(InFile, this->Extension);
 }
 
-void CarlaRecorderActorBoundingBox::Write(std::ofstream &OutFile)
+void CarlaRecorderActorBoundingBox::Write(CarlaRecorderBuffer &OutFile)
 {
   WriteValue<uint32_t>(OutFile, this->DatabaseId);
   BoundingBox.Write(OutFile);
 }
 
-void CarlaRecorderActorBoundingBox::Read(std::ifstream &InFile)
+void CarlaRecorderActorBoundingBox::Read(CarlaRecorderCursor &InFile)
 {
   ReadValue<uint32_t>(InFile, this->DatabaseId);
   BoundingBox.Read(InFile);
@@ -45,7 +45,7 @@ void CarlaRecorderActorBoundingBoxes::Add(const CarlaRecorderActorBoundingBox &I
   Boxes.push_back(InObj);
 }
 
-void CarlaRecorderActorBoundingBoxes::Write(std::ofstream &OutFile)
+void CarlaRecorderActorBoundingBoxes::Write(CarlaRecorderBuffer &OutFile)
 {
   // write the packet id
   WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::BoundingBox));
@@ -75,7 +75,7 @@ void CarlaRecorderActorTriggerVolumes::Add(const CarlaRecorderActorBoundingBox &
   Boxes.push_back(InObj);
 }
 
-void CarlaRecorderActorTriggerVolumes::Write(std::ofstream &OutFile)
+void CarlaRecorderActorTriggerVolumes::Write(CarlaRecorderBuffer &OutFile)
 {
   if (Boxes.size() == 0)
   {
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 
@@ -15,9 +17,9 @@ struct CarlaRecorderBoundingBox
   FVector Origin;
   FVector Extension;
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 };
 #pragma pack(pop)
 
@@ -27,9 +29,9 @@ struct CarlaRecorderActorBoundingBox
   uint32_t DatabaseId;
   CarlaRecorderBoundingBox BoundingBox;
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 };
 #pragma pack(pop)
 
@@ -41,7 +43,7 @@ class CarlaRecorderActorBoundingBoxes
 
   void Clear(void);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 
 private:
 
@@ -56,7 +58,7 @@ class CarlaRecorderActorTriggerVolumes
 
   void Clear(void);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 
 private:
 
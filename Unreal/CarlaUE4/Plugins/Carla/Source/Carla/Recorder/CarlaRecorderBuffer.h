@@ -0,0 +1,61 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstring>
+#include <ios>
+#include <vector>
+
+// in-memory arena where a whole recorder frame is serialized before it is
+// handed to the writer thread (see CarlaRecorderWriter)
+class CarlaRecorderBuffer
+{
+
+public:
+
+  // same signature as std::ostream::write, so the packet writers are
+  // unchanged apart from their parameter type
+  void write(const char *Data, std::streamsize Size)
+  {
+    const size_t Offset = Bytes.size();
+    Bytes.resize(Offset + static_cast<size_t>(Size));
+    std::memcpy(Bytes.data() + Offset, Data, static_cast<size_t>(Size));
+  }
+
+  // current write position (relative to the start of this buffer)
+  size_t Tell() const
+  {
+    return Bytes.size();
+  }
+
+  // overwrite an already written value (in memory, nothing is seeked on disk)
+  template <typename T>
+  void Patch(size_t Offset, const T &InObj)
+  {
+    std::memcpy(Bytes.data() + Offset, &InObj, sizeof(T));
+  }
+
+  const char *Data() const
+  {
+    return Bytes.data();
+  }
+
+  size_t Size() const
+  {
+    return Bytes.size();
+  }
+
+  // keeps the capacity, so a reused buffer does not allocate again
+  void Clear()
+  {
+    Bytes.clear();
+  }
+
+private:
+
+  std::vector<char> Bytes;
+};
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 #include <unordered_set>
@@ -19,8 +21,8 @@ struct CarlaRecorderCollision
     bool IsActor1Hero;
     bool IsActor2Hero;
 
-    void Read(std::ifstream &InFile);
-    void Write(std::ofstream &OutFile) const;
+    void Read(CarlaRecorderCursor &InFile);
+    void Write(CarlaRecorderBuffer &OutFile) const;
     // define operator == needed for the 'unordered_set'
     bool operator==(const CarlaRecorderCollision &Other) const;
 };
@@ -47,7 +49,7 @@ class CarlaRecorderCollisions{
     public:
     void Add(const CarlaRecorderCollision &Collision);
     void Clear(void);
-    void Write(std::ofstream &OutFile);
+    void Write(CarlaRecorderBuffer &OutFile);
 
     private:
     std::unordered_set<CarlaRecorderCollision> Collisions;
@@ -0,0 +1,111 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "Carla.h"
+#include "CarlaRecorderCursor.h"
+
+#include <fstream>
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <windows.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // PLATFORM_WINDOWS
+
+// map the whole file read-only (nullptr if the platform could not do it)
+static void *MapFile(const std::string &Filename, size_t &OutLength)
+{
+#if PLATFORM_WINDOWS
+  HANDLE Handle = CreateFileW(UTF8_TO_TCHAR(Filename.c_str()), GENERIC_READ, FILE_SHARE_READ,
+      nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (Handle == INVALID_HANDLE_VALUE)
+  {
+    return nullptr;
+  }
+  void *View = nullptr;
+  LARGE_INTEGER FileSize;
+  if (GetFileSizeEx(Handle, &FileSize) && FileSize.QuadPart > 0)
+  {
+    HANDLE Mapping = CreateFileMappingW(Handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (Mapping != nullptr)
+    {
+      View = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+      // the view keeps the mapping alive
+      CloseHandle(Mapping);
+      OutLength = static_cast<size_t>(FileSize.QuadPart);
+    }
+  }
+  CloseHandle(Handle);
+  return View;
+#else
+  const int Descriptor = open(Filename.c_str(), O_RDONLY);
+  if (Descriptor < 0)
+  {
+    return nullptr;
+  }
+  void *View = nullptr;
+  struct stat Status;
+  if (fstat(Descriptor, &Status) == 0 && Status.st_size > 0)
+  {
+    View = mmap(nullptr, static_cast<size_t>(Status.st_size), PROT_READ, MAP_PRIVATE, Descriptor, 0);
+    if (View == MAP_FAILED)
+    {
+      View = nullptr;
+    }
+    else
+    {
+      // packets are read front to back
+      madvise(View, static_cast<size_t>(Status.st_size), MADV_SEQUENTIAL);
+      OutLength = static_cast<size_t>(Status.st_size);
+    }
+  }
+  // the mapping stays valid after closing the descriptor
+  close(Descriptor);
+  return View;
+#endif // PLATFORM_WINDOWS
+}
+
+std::shared_ptr<const CarlaRecorderMappedFile> CarlaRecorderMappedFile::Open(const std::string &Filename)
+{
+  std::shared_ptr<CarlaRecorderMappedFile> Result(new CarlaRecorderMappedFile());
+  Result->Mapping = MapFile(Filename, Result->Length);
+  if (Result->Mapping != nullptr)
+  {
+    Result->Bytes = static_cast<const char *>(Result->Mapping);
+    return Result;
+  }
+
+  // could not map it (empty file, or not supported): read it instead
+  std::ifstream File(Filename, std::ios::binary | std::ios::ate);
+  if (!File.is_open())
+  {
+    return nullptr;
+  }
+  Result->Copy.resize(static_cast<size_t>(File.tellg()));
+  File.seekg(0, std::ios::beg);
+  File.read(Result->Copy.data(), Result->Copy.size());
+  Result->Bytes = Result->Copy.data();
+  Result->Length = Result->Copy.size();
+  return Result;
+}
+
+CarlaRecorderMappedFile::~CarlaRecorderMappedFile()
+{
+  if (Mapping == nullptr)
+  {
+    return;
+  }
+#if PLATFORM_WINDOWS
+  UnmapViewOfFile(Mapping);
+#else
+  munmap(Mapping, Length);
+#endif // PLATFORM_WINDOWS
+}
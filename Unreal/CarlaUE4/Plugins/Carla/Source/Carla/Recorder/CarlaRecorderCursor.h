@@ -0,0 +1,195 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <memory>
+#include <string>
+#include <vector>
+
+// read-only view of a whole recording (memory mapped, or read into memory if
+// the platform cannot map it); shared by every cursor opened on it
+class CarlaRecorderMappedFile
+{
+
+public:
+
+  static std::shared_ptr<const CarlaRecorderMappedFile> Open(const std::string &Filename);
+
+  ~CarlaRecorderMappedFile();
+
+  CarlaRecorderMappedFile(const CarlaRecorderMappedFile &) = delete;
+  CarlaRecorderMappedFile &operator=(const CarlaRecorderMappedFile &) = delete;
+
+  const char *Data() const
+  {
+    return Bytes;
+  }
+
+  size_t Size() const
+  {
+    return Length;
+  }
+
+private:
+
+  CarlaRecorderMappedFile() = default;
+
+  const char *Bytes = nullptr;
+  size_t Length = 0;
+  void *Mapping = nullptr; // platform handle of the mapping (nullptr if copied)
+  std::vector<char> Copy;  // fallback when the file could not be mapped
+};
+
+// Read side of the recorder (the counterpart of CarlaRecorderBuffer): a cursor
+// over a CarlaRecorderMappedFile with the subset of the std::ifstream interface
+// the packet readers use, so reading a field is a memcpy and skipping a packet
+// is an addition. Payloads can also be viewed in place (View), without copying.
+//
+// Unlike std::ifstream, eof() is true as soon as the position reaches the end
+// of the data, so the packet loops stop right after the last packet.
+class CarlaRecorderCursor
+{
+
+public:
+
+  CarlaRecorderCursor() = default;
+
+  explicit CarlaRecorderCursor(std::shared_ptr<const CarlaRecorderMappedFile> InFile)
+  {
+    Open(std::move(InFile));
+  }
+
+  bool open(const std::string &Filename, std::ios::openmode = std::ios::binary)
+  {
+    return Open(CarlaRecorderMappedFile::Open(Filename));
+  }
+
+  // another cursor over an already opened recording
+  bool Open(std::shared_ptr<const CarlaRecorderMappedFile> InFile)
+  {
+    File = std::move(InFile);
+    Begin = File ? File->Data() : nullptr;
+    End = File ? Begin + File->Size() : nullptr;
+    Pos = Begin;
+    bFailed = (File == nullptr);
+    return is_open();
+  }
+
+  bool is_open() const
+  {
+    return File != nullptr;
+  }
+
+  void close()
+  {
+    File.reset();
+    Begin = End = Pos = nullptr;
+    bFailed = true;
+  }
+
+  const std::shared_ptr<const CarlaRecorderMappedFile> &GetFile() const
+  {
+    return File;
+  }
+
+  // same signature as std::istream::read
+  void read(char *Data, std::streamsize Size)
+  {
+    const size_t Available = Remaining();
+    const size_t Wanted = static_cast<size_t>(Size);
+    if (Wanted > Available)
+    {
+      if (Available > 0)
+      {
+        std::memcpy(Data, Pos, Available);
+      }
+      Pos = End;
+      bFailed = true;
+      return;
+    }
+    std::memcpy(Data, Pos, Wanted);
+    Pos += Wanted;
+  }
+
+  // Size bytes in place (valid while the file is open), nullptr if there are not enough
+  const char *View(size_t Size)
+  {
+    if (Size > Remaining())
+    {
+      Pos = End;
+      bFailed = true;
+      return nullptr;
+    }
+    const char *Result = Pos;
+    Pos += Size;
+    return Result;
+  }
+
+  void seekg(std::streamoff Offset, std::ios::seekdir Dir = std::ios::beg)
+  {
+    if (Begin == nullptr)
+    {
+      return;
+    }
+    const char *Base = (Dir == std::ios::beg ? Begin : (Dir == std::ios::end ? End : Pos));
+    const std::streamoff Target = (Base - Begin) + Offset;
+    if (Target < 0 || Target > static_cast<std::streamoff>(End - Begin))
+    {
+      Pos = (Target < 0 ? Begin : End);
+      bFailed = true;
+      return;
+    }
+    Pos = Begin + Target;
+  }
+
+  uint64_t tellg() const
+  {
+    return static_cast<uint64_t>(Pos - Begin);
+  }
+
+  bool eof() const
+  {
+    return Pos >= End;
+  }
+
+  void clear()
+  {
+    bFailed = (File == nullptr);
+  }
+
+  bool good() const
+  {
+    return !bFailed;
+  }
+
+  explicit operator bool() const
+  {
+    return !bFailed;
+  }
+
+  size_t Size() const
+  {
+    return static_cast<size_t>(End - Begin);
+  }
+
+  size_t Remaining() const
+  {
+    return static_cast<size_t>(End - Pos);
+  }
+
+private:
+
+  std::shared_ptr<const CarlaRecorderMappedFile> File;
+  const char *Begin = nullptr;
+  const char *End = nullptr;
+  const char *Pos = nullptr;
+  bool bFailed = true;
+};
@@ -8,7 +8,7 @@
 #include "CarlaRecorderEventAdd.h"
 #include "CarlaRecorderHelpers.h"
 
-void CarlaRecorderEventAdd::Write(std::ofstream &OutFile) const
+void CarlaRecorderEventAdd::Write(CarlaRecorderBuffer &OutFile) const
 {
     // database id
     WriteValue<uint32_t>(OutFile, this->DatabaseId);
@@ -34,7 +34,7 @@ void CarlaRecorderEventAdd::Write(std::ofstream &OutFile) const
     }
 }
 
-void CarlaRecorderEventAdd::Read(std::ifstream &InFile)
+void CarlaRecorderEventAdd::Read(CarlaRecorderCursor &InFile)
 {
     // database id
     ReadValue<uint32_t>(InFile, this->DatabaseId);
@@ -77,12 +77,12 @@ void CarlaRecorderEventsAdd::Add(const CarlaRecorderEventAdd &Event)
     Events.push_back(std::move(Event));
 }
 
-void CarlaRecorderEventsAdd::Write(std::ofstream &OutFile)
+void CarlaRecorderEventsAdd::Write(CarlaRecorderBuffer &OutFile)
 {
     // write the packet id
     WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::EventAdd));
 
-    std::streampos PosStart = OutFile.tellp();
+    const size_t PosStart = OutFile.Tell();
 
     // write a dummy packet size
     uint32_t Total = 0;
@@ -95,10 +95,7 @@ void CarlaRecorderEventsAdd::Write(std::ofstream &OutFile)
     for (uint16_t i=0; i<Total; ++i)
         Events[i].Write(OutFile);
 
-    // write the real packet size
-    std::streampos PosEnd = OutFile.tellp();
-    Total = PosEnd - PosStart - sizeof(uint32_t);
-    OutFile.seekp(PosStart, std::ios::beg);
-    WriteValue<uint32_t>(OutFile, Total);
-    OutFile.seekp(PosEnd, std::ios::beg);
+    // write the real packet size (patched in the frame buffer, not on disk)
+    Total = OutFile.Tell() - PosStart - sizeof(uint32_t);
+    OutFile.Patch<uint32_t>(PosStart, Total);
 }
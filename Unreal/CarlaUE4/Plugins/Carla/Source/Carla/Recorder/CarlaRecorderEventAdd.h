@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 
@@ -31,8 +33,8 @@ struct CarlaRecorderEventAdd
     FVector Rotation;
     CarlaRecorderActorDescription Description;
 
-    void Read(std::ifstream &InFile);
-    void Write(std::ofstream &OutFile) const;
+    void Read(CarlaRecorderCursor &InFile);
+    void Write(CarlaRecorderBuffer &OutFile) const;
 };
 
 class CarlaRecorderEventsAdd
@@ -41,7 +43,12 @@ class CarlaRecorderEventsAdd
     public:
     void Add(const CarlaRecorderEventAdd &Event);
     void Clear(void);
-    void Write(std::ofstream &OutFile);
+    void Write(CarlaRecorderBuffer &OutFile);
+
+    const std::vector<CarlaRecorderEventAdd>& GetEvents() const
+    {
+        return Events;
+    }
 
     private:
     std::vector<CarlaRecorderEventAdd> Events;
@@ -8,12 +8,12 @@
 #include "CarlaRecorderEventDel.h"
 #include "CarlaRecorderHelpers.h"
 
-void CarlaRecorderEventDel::Read(std::ifstream &InFile)
+void CarlaRecorderEventDel::Read(CarlaRecorderCursor &InFile)
 {
     // database id
     ReadValue<uint32_t>(InFile, this->DatabaseId);
 }
-void CarlaRecorderEventDel::Write(std::ofstream &OutFile) const
+void CarlaRecorderEventDel::Write(CarlaRecorderBuffer &OutFile) const
 {
     // database id
     WriteValue<uint32_t>(OutFile, this->DatabaseId);
@@ -31,15 +31,13 @@ void CarlaRecorderEventsDel::Add(const CarlaRecorderEventDel &Event)
     Events.push_back(std::move(Event));
 }
 
-void CarlaRecorderEventsDel::Write(std::ofstream &OutFile)
+void CarlaRecorderEventsDel::Write(CarlaRecorderBuffer &OutFile)
 {
     // write the packet id
     WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::EventDel));
 
-    std::streampos PosStart = OutFile.tellp();
-
-    // write a dummy packet size
-    uint32_t Total = 0;
+    // write the packet size
+    uint32_t Total = 2 + Events.size() * (sizeof(uint32_t));
     WriteValue<uint32_t>(OutFile, Total);
 
     // write total records
@@ -50,11 +48,4 @@ void CarlaRecorderEventsDel::Write(std::ofstream &OutFile)
     {
         Events[i].Write(OutFile);
     }
-
-    // write the real packet size
-    std::streampos PosEnd = OutFile.tellp();
-    Total = PosEnd - PosStart - sizeof(uint32_t);
-    OutFile.seekp(PosStart, std::ios::beg);
-    WriteValue<uint32_t>(OutFile, Total);
-    OutFile.seekp(PosEnd, std::ios::beg);
 }
\ No newline at end of file
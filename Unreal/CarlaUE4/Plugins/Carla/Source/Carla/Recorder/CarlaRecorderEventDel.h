@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 
@@ -13,8 +15,8 @@ struct CarlaRecorderEventDel
 {
     uint32_t DatabaseId;
 
-    void Read(std::ifstream &InFile);
-    void Write(std::ofstream &OutFile) const;
+    void Read(CarlaRecorderCursor &InFile);
+    void Write(CarlaRecorderBuffer &OutFile) const;
 };
 
 class CarlaRecorderEventsDel
@@ -23,7 +25,12 @@ class CarlaRecorderEventsDel
     public:
     void Add(const CarlaRecorderEventDel &Event);
     void Clear(void);
-    void Write(std::ofstream &OutFile);
+    void Write(CarlaRecorderBuffer &OutFile);
+
+    const std::vector<CarlaRecorderEventDel>& GetEvents() const
+    {
+        return Events;
+    }
 
     private:
     std::vector<CarlaRecorderEventDel> Events;
@@ -9,14 +9,14 @@
 #include "CarlaRecorderHelpers.h"
 
 
-void CarlaRecorderEventParent::Read(std::ifstream &InFile)
+void CarlaRecorderEventParent::Read(CarlaRecorderCursor &InFile)
 {
     // database id
     ReadValue<uint32_t>(InFile, this->DatabaseId);
     // database id parent
     ReadValue<uint32_t>(InFile, this->DatabaseIdParent);
 }
-void CarlaRecorderEventParent::Write(std::ofstream &OutFile) const
+void CarlaRecorderEventParent::Write(CarlaRecorderBuffer &OutFile) const
 {
     // database id
     WriteValue<uint32_t>(OutFile, this->DatabaseId);
@@ -36,15 +36,13 @@ void CarlaRecorderEventsParent::Add(const CarlaRecorderEventParent &Event)
     Events.push_back(std::move(Event));
 }
 
-void CarlaRecorderEventsParent::Write(std::ofstream &OutFile)
+void CarlaRecorderEventsParent::Write(CarlaRecorderBuffer &OutFile)
 {
     // write the packet id
     WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::EventParent));
 
-    std::streampos PosStart = OutFile.tellp();
-
-    // write a dummy packet size
-    uint32_t Total = 0;
+    // write the packet size
+    uint32_t Total = 2 + Events.size() * (2 * sizeof(uint32_t));
     WriteValue<uint32_t>(OutFile, Total);
 
     // write total records
@@ -55,11 +53,4 @@ void CarlaRecorderEventsParent::Write(std::ofstream &OutFile)
     {
         Events[i].Write(OutFile);
     }
-
-    // write the real packet size
-    std::streampos PosEnd = OutFile.tellp();
-    Total = PosEnd - PosStart - sizeof(uint32_t);
-    OutFile.seekp(PosStart, std::ios::beg);
-    WriteValue<uint32_t>(OutFile, Total);
-    OutFile.seekp(PosEnd, std::ios::beg);
 }
\ No newline at end of file
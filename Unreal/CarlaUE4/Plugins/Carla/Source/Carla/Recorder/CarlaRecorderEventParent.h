@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 
@@ -14,8 +16,8 @@ struct CarlaRecorderEventParent
     uint32_t DatabaseId;
     uint32_t DatabaseIdParent;
 
-    void Read(std::ifstream &InFile);
-    void Write(std::ofstream &OutFile) const;
+    void Read(CarlaRecorderCursor &InFile);
+    void Write(CarlaRecorderBuffer &OutFile) const;
 };
 
 class CarlaRecorderEventsParent
@@ -24,7 +26,12 @@ class CarlaRecorderEventsParent
     public:
     void Add(const CarlaRecorderEventParent &Event);
     void Clear(void);
-    void Write(std::ofstream &OutFile);
+    void Write(CarlaRecorderBuffer &OutFile);
+
+    const std::vector<CarlaRecorderEventParent>& GetEvents() const
+    {
+        return Events;
+    }
 
     private:
     std::vector<CarlaRecorderEventParent> Events;
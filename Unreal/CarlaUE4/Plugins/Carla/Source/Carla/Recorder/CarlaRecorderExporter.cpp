@@ -0,0 +1,257 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "CarlaRecorder.h"
+#include "CarlaRecorderExporter.h"
+#include "CarlaRecorderFrameIndex.h"
+#include "CarlaRecorderHelpers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+
+  void AddVector(CarlaRecorderTable &Table, const std::string &Name, const FVector &Value)
+  {
+    Table.Add((Name + "X").c_str(), Value.X);
+    Table.Add((Name + "Y").c_str(), Value.Y);
+    Table.Add((Name + "Z").c_str(), Value.Z);
+  }
+
+  void AddRotator(CarlaRecorderTable &Table, const std::string &Name, const FRotator &Value)
+  {
+    Table.Add((Name + "Pitch").c_str(), Value.Pitch);
+    Table.Add((Name + "Yaw").c_str(), Value.Yaw);
+    Table.Add((Name + "Roll").c_str(), Value.Roll);
+  }
+
+  void AddGaze(CarlaRecorderTable &Table, const std::string &Name, const DReyeVR::AggregateData &Data,
+      DReyeVR::Gaze Index)
+  {
+    AddVector(Table, Name + "GazeDir", Data.GetGazeDir(Index));
+    AddVector(Table, Name + "GazeOrigin", Data.GetGazeOrigin(Index));
+    Table.Add((Name + "GazeValid").c_str(), Data.GetGazeValidity(Index));
+  }
+
+  void AddEye(CarlaRecorderTable &Table, const std::string &Name, const DReyeVR::AggregateData &Data,
+      DReyeVR::Eye Index)
+  {
+    Table.Add((Name + "EyeOpenness").c_str(), Data.GetEyeOpenness(Index));
+    Table.Add((Name + "EyeOpennessValid").c_str(), Data.GetEyeOpennessValidity(Index));
+    Table.Add((Name + "PupilDiameter").c_str(), Data.GetPupilDiameter(Index));
+    Table.Add((Name + "PupilPositionX").c_str(), Data.GetPupilPosition(Index).X);
+    Table.Add((Name + "PupilPositionY").c_str(), Data.GetPupilPosition(Index).Y);
+    Table.Add((Name + "PupilPositionValid").c_str(), Data.GetPupilPositionValidity(Index));
+  }
+
+  // one row of the frames table (this is also its schema)
+  void AddFrameRow(CarlaRecorderTable &Table, const CarlaRecorderFrame &Frame, bool bHasData,
+      const DReyeVR::AggregateData &Data)
+  {
+    Table.BeginRow();
+    Table.Add("FrameId", static_cast<uint64_t>(Frame.Id));
+    Table.Add("Elapsed", static_cast<double>(Frame.Elapsed));
+    Table.Add("HasDReyeVR", bHasData);
+    Table.Add("TimestampCarla", static_cast<int64_t>(Data.GetTimestampCarla()));
+    Table.Add("TimestampDevice", static_cast<int64_t>(Data.GetTimestampDevice()));
+    Table.Add("FrameSequence", static_cast<int64_t>(Data.GetFrameSequence()));
+    AddGaze(Table, "Combined", Data, DReyeVR::Gaze::COMBINED);
+    AddGaze(Table, "Left", Data, DReyeVR::Gaze::LEFT);
+    AddGaze(Table, "Right", Data, DReyeVR::Gaze::RIGHT);
+    AddEye(Table, "Left", Data, DReyeVR::Eye::LEFT);
+    AddEye(Table, "Right", Data, DReyeVR::Eye::RIGHT);
+    AddVector(Table, "VehicleLocation", Data.GetVehicleLocation());
+    AddRotator(Table, "VehicleRotation", Data.GetVehicleRotation());
+    Table.Add("VehicleVelocity", Data.GetVehicleVelocity());
+    AddVector(Table, "CameraLocation", Data.GetCameraLocation());
+    AddRotator(Table, "CameraRotation", Data.GetCameraRotation());
+    AddVector(Table, "CameraLocationAbs", Data.GetCameraLocationAbs());
+    AddRotator(Table, "CameraRotationAbs", Data.GetCameraRotationAbs());
+    Table.Add("FocusActorName", std::string(TCHAR_TO_UTF8(*Data.GetFocusActorName())));
+    AddVector(Table, "FocusActorPoint", Data.GetFocusActorPoint());
+    Table.Add("FocusActorDistance", Data.GetFocusActorDistance());
+    const DReyeVR::UserInputs &Inputs = Data.GetUserInputs();
+    Table.Add("Throttle", Inputs.Throttle);
+    Table.Add("Steering", Inputs.Steering);
+    Table.Add("Brake", Inputs.Brake);
+    Table.Add("ToggledReverse", Inputs.ToggledReverse);
+    Table.Add("TurnSignalLeft", Inputs.TurnSignalLeft);
+    Table.Add("TurnSignalRight", Inputs.TurnSignalRight);
+    Table.Add("HoldHandbrake", Inputs.HoldHandbrake);
+  }
+
+  void AddActorRow(CarlaRecorderTable &Table, const CarlaRecorderFrame &Frame, const CarlaRecorderPosition &Position)
+  {
+    Table.BeginRow();
+    Table.Add("FrameId", static_cast<uint64_t>(Frame.Id));
+    Table.Add("Elapsed", static_cast<double>(Frame.Elapsed));
+    Table.Add("ActorId", Position.DatabaseId);
+    AddVector(Table, "Location", Position.Location);
+    AddVector(Table, "Rotation", Position.Rotation);
+  }
+
+  struct Chunk
+  {
+    uint64_t Begin; // offset of its first FrameStart packet
+    uint64_t End;   // offset of the next chunk (or end of file)
+    CarlaRecorderTable Frames;
+    CarlaRecorderTable Actors;
+  };
+
+  void DecodeChunk(CarlaRecorderCursor &File, Chunk &Out)
+  {
+    const DReyeVR::AggregateData Empty = DReyeVR::AggregateData();
+    DReyeVRDataRecorder<DReyeVR::AggregateData> Data;
+    CarlaRecorderFrame Frame;
+    CarlaRecorderPosition Position;
+    bool bInFrame = false;
+    bool bHasData = false;
+
+    File.clear();
+    File.seekg(Out.Begin, std::ios::beg);
+    while (File && File.tellg() < Out.End)
+    {
+      const uint64_t Offset = File.tellg();
+      char Id;
+      uint32_t Size;
+      uint16_t Total;
+      ReadValue<char>(File, Id);
+      ReadValue<uint32_t>(File, Size);
+      if (!File)
+      {
+        break;
+      }
+
+      switch (Id)
+      {
+        case static_cast<char>(CarlaRecorderPacketId::FrameStart):
+          if (bInFrame)
+          {
+            AddFrameRow(Out.Frames, Frame, bHasData, bHasData ? Data.Data : Empty);
+          }
+          Frame.Read(File);
+          bInFrame = true;
+          bHasData = false;
+          break;
+
+        case static_cast<char>(CarlaRecorderPacketId::Position):
+          ReadValue<uint16_t>(File, Total);
+          for (uint16_t i = 0; i < Total && File; ++i)
+          {
+            Position.Read(File);
+            AddActorRow(Out.Actors, Frame, Position);
+          }
+          break;
+
+        case static_cast<char>(CarlaRecorderPacketId::DReyeVR):
+          // one snapshot per frame (the last one wins if there are more)
+          ReadValue<uint16_t>(File, Total);
+          for (uint16_t i = 0; i < Total && File; ++i)
+          {
+            Data.Read(File);
+            bHasData = true;
+          }
+          break;
+
+        default:
+          break;
+      }
+
+      // continue from the packet size (also skips the packets we do not export)
+      File.seekg(Offset + sizeof(char) + sizeof(uint32_t) + Size, std::ios::beg);
+    }
+    if (bInFrame)
+    {
+      AddFrameRow(Out.Frames, Frame, bHasData, bHasData ? Data.Data : Empty);
+    }
+  }
+
+} // namespace
+
+CarlaRecorderExporter::Result CarlaRecorderExporter::Export(const std::string &Filename, unsigned Threads)
+{
+  Result Exported;
+
+  CarlaRecorderCursor File;
+  if (!File.open(Filename))
+  {
+    Exported.Error = "File " + Filename + " not found";
+    return Exported;
+  }
+  Exported.Bytes = File.Size();
+
+  CarlaRecorderInfo Info;
+  Info.Read(File);
+  if (!File || Info.Magic != "CARLA_RECORDER")
+  {
+    Exported.Error = "File " + Filename + " is not a CARLA recorder";
+    return Exported;
+  }
+
+  // frame boundaries to split the work at
+  CarlaRecorderFrameIndex Index;
+  if (!Index.Load(File, Filename))
+  {
+    Exported.Error = "File " + Filename + " has no frames";
+    return Exported;
+  }
+  const auto &Frames = Index.GetFrames();
+
+  const auto Start = std::chrono::steady_clock::now();
+
+  if (Threads == 0)
+  {
+    Threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  // a few chunks per thread, so a slow chunk does not leave the others idle
+  const size_t TotalChunks = std::min<size_t>(Frames.size(), Threads * 4u);
+  std::vector<Chunk> Chunks(TotalChunks);
+  for (size_t i = 0; i < TotalChunks; ++i)
+  {
+    const size_t First = Frames.size() * i / TotalChunks;
+    const size_t Next = Frames.size() * (i + 1) / TotalChunks;
+    Chunks[i].Begin = Frames[First].Offset;
+    Chunks[i].End = (Next < Frames.size() ? Frames[Next].Offset : File.Size());
+  }
+
+  std::atomic<size_t> NextChunk{0};
+  auto Work = [&]() {
+    CarlaRecorderCursor ChunkFile(File.GetFile());
+    for (size_t i = NextChunk++; i < Chunks.size(); i = NextChunk++)
+    {
+      DecodeChunk(ChunkFile, Chunks[i]);
+    }
+  };
+  std::vector<std::thread> Workers;
+  for (unsigned i = 1; i < std::min<size_t>(Threads, TotalChunks); ++i)
+  {
+    Workers.emplace_back(Work);
+  }
+  Work();
+  for (auto &Worker : Workers)
+  {
+    Worker.join();
+  }
+
+  // chunks are in file order
+  for (auto &Decoded : Chunks)
+  {
+    Exported.Frames.Append(std::move(Decoded.Frames));
+    Exported.Actors.Append(std::move(Decoded.Actors));
+  }
+
+  Exported.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+  return Exported;
+}
+
+bool CarlaRecorderExporter::Save(const Result &Exported, const std::string &OutputPrefix)
+{
+  return Exported.Frames.Save(OutputPrefix + ".frames.crtb") &&
+         Exported.Actors.Save(OutputPrefix + ".actors.crtb");
+}
@@ -0,0 +1,41 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "CarlaRecorderCursor.h"
+#include "CarlaRecorderTable.h"
+
+#include <string>
+
+// Decodes a recording into tables without replaying it in the engine:
+//   Frames: one row per frame (frame id, elapsed time and the DReyeVR
+//           AggregateData of that frame: eye tracker, ego variables, focus and
+//           user inputs; HasDReyeVR is false for frames without it)
+//   Actors: one row per recorded actor position (frame id, actor id, transform)
+//
+// The recording is split at frame boundaries (from its frame index) and the
+// chunks are decoded in parallel, each with its own cursor over the mapped file.
+class CarlaRecorderExporter
+{
+
+public:
+
+  struct Result
+  {
+    CarlaRecorderTable Frames;
+    CarlaRecorderTable Actors;
+    uint64_t Bytes = 0;   // size of the recording
+    double Seconds = 0.0; // decoding time (not counting the mapping of the file)
+    std::string Error;    // empty on success
+  };
+
+  // Threads = 0 uses one thread per core
+  static Result Export(const std::string &Filename, unsigned Threads = 0);
+
+  // writes <OutputPrefix>.frames.crtb and <OutputPrefix>.actors.crtb
+  static bool Save(const Result &Exported, const std::string &OutputPrefix);
+};
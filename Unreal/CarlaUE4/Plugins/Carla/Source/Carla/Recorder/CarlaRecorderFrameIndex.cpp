@@ -0,0 +1,465 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "CarlaRecorder.h"
+#include "CarlaRecorderFrameIndex.h"
+#include "CarlaRecorderHelpers.h"
+
+#include <algorithm>
+
+constexpr uint32_t CarlaRecorderFrameIndex::Magic;
+constexpr uint16_t CarlaRecorderFrameIndex::Version;
+constexpr double CarlaRecorderFrameIndex::KeyframeInterval;
+
+template <typename T>
+static void WriteRecords(CarlaRecorderBuffer &OutFile, const std::vector<T> &Records)
+{
+  WriteValue<uint32_t>(OutFile, Records.size());
+  for (const auto &Record : Records)
+  {
+    Record.Write(OutFile);
+  }
+}
+
+template <typename T>
+static void ReadRecords(CarlaRecorderCursor &InFile, std::vector<T> &Records)
+{
+  uint32_t Total = 0;
+  ReadValue<uint32_t>(InFile, Total);
+  Records.clear();
+  for (uint32_t i = 0; i < Total && InFile; ++i)
+  {
+    T Record;
+    Record.Read(InFile);
+    Records.push_back(std::move(Record));
+  }
+}
+
+void CarlaRecorderKeyframe::Read(CarlaRecorderCursor &InFile)
+{
+  ReadValue<uint32_t>(InFile, Frame);
+  ReadRecords(InFile, Actors);
+  ReadRecords(InFile, Parents);
+  ReadRecords(InFile, Weather);
+  ReadRecords(InFile, Lights);
+  ReadRecords(InFile, VehicleLights);
+  ReadRecords(InFile, TrafficLights);
+}
+
+void CarlaRecorderKeyframe::Write(CarlaRecorderBuffer &OutFile) const
+{
+  WriteValue<uint32_t>(OutFile, Frame);
+  WriteRecords(OutFile, Actors);
+  WriteRecords(OutFile, Parents);
+  WriteRecords(OutFile, Weather);
+  WriteRecords(OutFile, Lights);
+  WriteRecords(OutFile, VehicleLights);
+  WriteRecords(OutFile, TrafficLights);
+}
+
+// ---------------------------------------------
+
+void CarlaRecorderFrameIndex::Reset()
+{
+  Frames.clear();
+  Keyframes.clear();
+  Alive.clear();
+  Parents.clear();
+  LastWeather.clear();
+  LastLights.clear();
+  LastVehicleLights.clear();
+  LastTrafficLights.clear();
+  bFrameHasEvents = false;
+}
+
+void CarlaRecorderFrameIndex::AddFrame(uint64_t Id, double Elapsed, uint64_t Offset)
+{
+  Frames.push_back({Id, Elapsed, Offset});
+  bFrameHasEvents = false;
+}
+
+void CarlaRecorderFrameIndex::AddEvent(const CarlaRecorderEventAdd &Event)
+{
+  Alive[Event.DatabaseId] = Event;
+  bFrameHasEvents = true;
+}
+
+void CarlaRecorderFrameIndex::AddEvent(uint32_t DeletedDatabaseId)
+{
+  Alive.erase(DeletedDatabaseId);
+  Parents.erase(DeletedDatabaseId);
+  LastVehicleLights.erase(DeletedDatabaseId);
+  LastTrafficLights.erase(DeletedDatabaseId);
+  bFrameHasEvents = true;
+}
+
+void CarlaRecorderFrameIndex::AddEvent(const CarlaRecorderEventParent &Event)
+{
+  Parents[Event.DatabaseId] = Event;
+  bFrameHasEvents = true;
+}
+
+void CarlaRecorderFrameIndex::AddWeather(const CarlaRecorderWeather &Weather)
+{
+  LastWeather.assign(1, Weather);
+}
+
+void CarlaRecorderFrameIndex::AddLightScene(const CarlaRecorderLightScene &Light)
+{
+  LastLights[Light.LightId] = Light;
+}
+
+void CarlaRecorderFrameIndex::AddLightVehicle(const CarlaRecorderLightVehicle &Light)
+{
+  LastVehicleLights[Light.DatabaseId] = Light;
+}
+
+void CarlaRecorderFrameIndex::AddTrafficLight(const CarlaRecorderStateTrafficLight &State)
+{
+  LastTrafficLights[State.DatabaseId] = State;
+}
+
+void CarlaRecorderFrameIndex::EndFrame()
+{
+  if (Frames.empty() || bFrameHasEvents)
+  {
+    return;
+  }
+  const double Elapsed = Frames.back().Elapsed;
+  if (!Keyframes.empty() && Elapsed - Frames[Keyframes.back().Frame].Elapsed < KeyframeInterval)
+  {
+    return;
+  }
+
+  CarlaRecorderKeyframe Keyframe;
+  Keyframe.Frame = Frames.size() - 1;
+  Keyframe.Actors.reserve(Alive.size());
+  for (const auto &Actor : Alive)
+  {
+    Keyframe.Actors.push_back(Actor.second);
+  }
+  for (const auto &Parent : Parents)
+  {
+    Keyframe.Parents.push_back(Parent.second);
+  }
+  Keyframe.Weather = LastWeather;
+  for (const auto &Light : LastLights)
+  {
+    Keyframe.Lights.push_back(Light.second);
+  }
+  for (const auto &Light : LastVehicleLights)
+  {
+    Keyframe.VehicleLights.push_back(Light.second);
+  }
+  for (const auto &State : LastTrafficLights)
+  {
+    Keyframe.TrafficLights.push_back(State.second);
+  }
+  Keyframes.emplace_back(std::move(Keyframe));
+}
+
+size_t CarlaRecorderFrameIndex::FindFrame(double Time) const
+{
+  auto It = std::upper_bound(Frames.begin(), Frames.end(), Time,
+      [](double T, const CarlaRecorderFrameIndexEntry &Entry) { return T < Entry.Elapsed; });
+  return It == Frames.begin() ? 0 : static_cast<size_t>(It - Frames.begin()) - 1;
+}
+
+const CarlaRecorderKeyframe *CarlaRecorderFrameIndex::FindKeyframe(double Time) const
+{
+  auto It = std::upper_bound(Keyframes.begin(), Keyframes.end(), Time,
+      [this](double T, const CarlaRecorderKeyframe &Keyframe) { return T < Frames[Keyframe.Frame].Elapsed; });
+  return It == Keyframes.begin() ? nullptr : &*(It - 1);
+}
+
+// ---------------------------------------------
+
+void CarlaRecorderFrameIndex::WritePayload(CarlaRecorderBuffer &OutFile) const
+{
+  WriteValue<uint16_t>(OutFile, Version);
+  WriteValue<uint32_t>(OutFile, Frames.size());
+  OutFile.write(reinterpret_cast<const char *>(Frames.data()),
+      Frames.size() * sizeof(CarlaRecorderFrameIndexEntry));
+  WriteValue<uint32_t>(OutFile, Keyframes.size());
+  for (const auto &Keyframe : Keyframes)
+  {
+    Keyframe.Write(OutFile);
+  }
+}
+
+bool CarlaRecorderFrameIndex::ReadPayload(CarlaRecorderCursor &InFile, uint64_t PayloadEnd)
+{
+  uint16_t FileVersion = 0;
+  ReadValue<uint16_t>(InFile, FileVersion);
+  if (!InFile || FileVersion != Version)
+  {
+    return false;
+  }
+  uint32_t Total = 0;
+  ReadValue<uint32_t>(InFile, Total);
+  // a corrupt count must not allocate past the data there is (the caller
+  // falls back to scanning the file)
+  const uint64_t Position = InFile.tellg();
+  if (!InFile || Position > PayloadEnd ||
+      static_cast<uint64_t>(Total) * sizeof(CarlaRecorderFrameIndexEntry) > PayloadEnd - Position)
+  {
+    return false;
+  }
+  Frames.resize(Total);
+  InFile.read(reinterpret_cast<char *>(Frames.data()), Total * sizeof(CarlaRecorderFrameIndexEntry));
+  ReadValue<uint32_t>(InFile, Total);
+  Keyframes.clear();
+  for (uint32_t i = 0; i < Total && InFile; ++i)
+  {
+    CarlaRecorderKeyframe Keyframe;
+    Keyframe.Read(InFile);
+    if (Keyframe.Frame >= Frames.size())
+    {
+      return false;
+    }
+    Keyframes.emplace_back(std::move(Keyframe));
+  }
+  return static_cast<bool>(InFile);
+}
+
+void CarlaRecorderFrameIndex::WriteFooter(CarlaRecorderBuffer &OutFile, uint64_t PacketOffset) const
+{
+  // write the packet id
+  WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::FrameIndex));
+
+  const size_t PosStart = OutFile.Tell();
+
+  // write a dummy packet size
+  uint32_t Total = 0;
+  WriteValue<uint32_t>(OutFile, Total);
+
+  WritePayload(OutFile);
+
+  // trailer, always the last bytes of the file
+  WriteValue<uint64_t>(OutFile, PacketOffset);
+  WriteValue<uint32_t>(OutFile, Magic);
+
+  // write the real packet size (patched in the frame buffer, not on disk)
+  Total = OutFile.Tell() - PosStart - sizeof(uint32_t);
+  OutFile.Patch<uint32_t>(PosStart, Total);
+}
+
+bool CarlaRecorderFrameIndex::ReadFooter(CarlaRecorderCursor &File)
+{
+  constexpr uint64_t TrailerSize = sizeof(uint64_t) + sizeof(uint32_t);
+  File.clear();
+  File.seekg(0, std::ios::end);
+  const uint64_t FileSize = File.tellg();
+  if (FileSize < TrailerSize)
+  {
+    return false;
+  }
+  File.seekg(FileSize - TrailerSize, std::ios::beg);
+  uint64_t PacketOffset = 0;
+  uint32_t FileMagic = 0;
+  ReadValue<uint64_t>(File, PacketOffset);
+  ReadValue<uint32_t>(File, FileMagic);
+  if (!File || FileMagic != Magic || PacketOffset >= FileSize - TrailerSize)
+  {
+    return false;
+  }
+
+  File.seekg(PacketOffset, std::ios::beg);
+  char Id = 0;
+  uint32_t Size = 0;
+  ReadValue<char>(File, Id);
+  ReadValue<uint32_t>(File, Size);
+  if (!File || Id != static_cast<char>(CarlaRecorderPacketId::FrameIndex))
+  {
+    return false;
+  }
+  const uint64_t PacketEnd = PacketOffset + sizeof(char) + sizeof(uint32_t) + Size;
+  return ReadPayload(File, std::min(PacketEnd, FileSize - TrailerSize));
+}
+
+bool CarlaRecorderFrameIndex::Rebuild(CarlaRecorderCursor &File)
+{
+  Reset();
+
+  File.clear();
+  File.seekg(0, std::ios::beg);
+  CarlaRecorderInfo Info;
+  Info.Read(File);
+
+  bool bInFrame = false;
+  while (File)
+  {
+    const uint64_t Offset = File.tellg();
+    char Id;
+    uint32_t Size;
+    ReadValue<char>(File, Id);
+    ReadValue<uint32_t>(File, Size);
+    if (!File)
+    {
+      break;
+    }
+
+    uint16_t Total;
+    switch (Id)
+    {
+      case static_cast<char>(CarlaRecorderPacketId::FrameStart):
+      {
+        if (bInFrame)
+        {
+          EndFrame();
+        }
+        CarlaRecorderFrame Frame;
+        Frame.Read(File);
+        AddFrame(Frame.Id, Frame.Elapsed, Offset);
+        bInFrame = true;
+        break;
+      }
+
+      case static_cast<char>(CarlaRecorderPacketId::EventAdd):
+        ReadValue<uint16_t>(File, Total);
+        for (uint16_t i = 0; i < Total && File; ++i)
+        {
+          CarlaRecorderEventAdd Event;
+          Event.Read(File);
+          AddEvent(Event);
+        }
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::EventDel):
+        ReadValue<uint16_t>(File, Total);
+        for (uint16_t i = 0; i < Total && File; ++i)
+        {
+          CarlaRecorderEventDel Event;
+          Event.Read(File);
+          AddEvent(Event.DatabaseId);
+        }
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::EventParent):
+        ReadValue<uint16_t>(File, Total);
+        for (uint16_t i = 0; i < Total && File; ++i)
+        {
+          CarlaRecorderEventParent Event;
+          Event.Read(File);
+          AddEvent(Event);
+        }
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::Weather):
+        ReadValue<uint16_t>(File, Total);
+        for (uint16_t i = 0; i < Total && File; ++i)
+        {
+          CarlaRecorderWeather Weather;
+          Weather.Read(File);
+          AddWeather(Weather);
+        }
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::SceneLight):
+        ReadValue<uint16_t>(File, Total);
+        for (uint16_t i = 0; i < Total && File; ++i)
+        {
+          CarlaRecorderLightScene Light;
+          Light.Read(File);
+          AddLightScene(Light);
+        }
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::VehicleLight):
+        ReadValue<uint16_t>(File, Total);
+        for (uint16_t i = 0; i < Total && File; ++i)
+        {
+          CarlaRecorderLightVehicle Light;
+          Light.Read(File);
+          AddLightVehicle(Light);
+        }
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::State):
+        ReadValue<uint16_t>(File, Total);
+        for (uint16_t i = 0; i < Total && File; ++i)
+        {
+          CarlaRecorderStateTrafficLight State;
+          State.Read(File);
+          AddTrafficLight(State);
+        }
+        break;
+
+      default:
+        break;
+    }
+
+    // continue from the packet size (also skips packets we do not need)
+    File.seekg(Offset + sizeof(char) + sizeof(uint32_t) + Size, std::ios::beg);
+  }
+  if (bInFrame)
+  {
+    EndFrame();
+  }
+  return IsValid();
+}
+
+bool CarlaRecorderFrameIndex::ReadCache(const std::string &CacheFilename, uint64_t RecordingSize)
+{
+  CarlaRecorderCursor Cache;
+  if (!Cache.open(CacheFilename))
+  {
+    return false;
+  }
+  uint32_t FileMagic = 0;
+  uint64_t CachedSize = 0;
+  ReadValue<uint32_t>(Cache, FileMagic);
+  ReadValue<uint64_t>(Cache, CachedSize);
+  // the recording changed (or is still being written) since the cache was made
+  if (!Cache || FileMagic != Magic || CachedSize != RecordingSize)
+  {
+    return false;
+  }
+  return ReadPayload(Cache, Cache.Size());
+}
+
+void CarlaRecorderFrameIndex::WriteCache(const std::string &CacheFilename, uint64_t RecordingSize) const
+{
+  CarlaRecorderBuffer Buffer;
+  WriteValue<uint32_t>(Buffer, Magic);
+  WriteValue<uint64_t>(Buffer, RecordingSize);
+  WritePayload(Buffer);
+  std::ofstream Cache(CacheFilename, std::ios::binary);
+  if (Cache.is_open())
+  {
+    Cache.write(Buffer.Data(), Buffer.Size());
+  }
+}
+
+bool CarlaRecorderFrameIndex::Load(CarlaRecorderCursor &File, const std::string &Filename)
+{
+  const uint64_t Current = File.tellg();
+
+  Reset();
+  bool bLoaded = ReadFooter(File);
+  if (!bLoaded)
+  {
+    const uint64_t RecordingSize = File.Size();
+    const std::string CacheFilename = Filename + ".frameindex";
+    bLoaded = ReadCache(CacheFilename, RecordingSize);
+    if (!bLoaded)
+    {
+      bLoaded = Rebuild(File);
+      if (bLoaded)
+      {
+        WriteCache(CacheFilename, RecordingSize);
+      }
+    }
+  }
+  if (!bLoaded)
+  {
+    Reset();
+  }
+
+  File.clear();
+  File.seekg(Current, std::ios::beg);
+  return bLoaded;
+}
@@ -0,0 +1,130 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "CarlaRecorderBuffer.h"
+#include "CarlaRecorderEventAdd.h"
+#include "CarlaRecorderEventParent.h"
+#include "CarlaRecorderLightScene.h"
+#include "CarlaRecorderLightVehicle.h"
+#include "CarlaRecorderState.h"
+#include "CarlaRecorderWeather.h"
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#pragma pack(push, 1)
+struct CarlaRecorderFrameIndexEntry
+{
+  uint64_t Id;
+  double Elapsed;
+  uint64_t Offset; // position of the FrameStart packet in the file
+};
+#pragma pack(pop)
+
+// state needed to start replaying at a frame without processing the file
+// from the beginning (taken at frames without add/del/parent events, so it is
+// the same before and after the frame)
+struct CarlaRecorderKeyframe
+{
+  uint32_t Frame; // position in the frame table
+  std::vector<CarlaRecorderEventAdd> Actors;
+  std::vector<CarlaRecorderEventParent> Parents;
+  std::vector<CarlaRecorderWeather> Weather;   // last weather (if any)
+  std::vector<CarlaRecorderLightScene> Lights; // last state of each changed light
+  std::vector<CarlaRecorderLightVehicle> VehicleLights;      // last lights of each vehicle alive
+  std::vector<CarlaRecorderStateTrafficLight> TrafficLights; // last state of each traffic light alive
+
+  void Read(CarlaRecorderCursor &InFile);
+
+  void Write(CarlaRecorderBuffer &OutFile) const;
+};
+
+// Frame offsets (and periodic keyframes) of a recording, so the replayer can
+// seek in O(log n) instead of parsing the file from the beginning.
+//
+// The recorder appends it as a FrameIndex packet when it stops (older readers
+// skip it as an unknown packet). The last 12 bytes of that packet are the
+// packet offset and a magic number, so it is found from the end of the file.
+// For recordings without it, the index is rebuilt with one scan of the file
+// and cached next to it (<recording>.frameindex).
+class CarlaRecorderFrameIndex
+{
+
+public:
+
+  static constexpr uint32_t Magic = 0x58495243; // "CRIX"
+  static constexpr uint16_t Version = 2;
+  static constexpr double KeyframeInterval = 10.0; // seconds of recording
+
+  void Reset();
+
+  // building (from the recorder, or from the packets of an existing file)
+  void AddFrame(uint64_t Id, double Elapsed, uint64_t Offset);
+  void AddEvent(const CarlaRecorderEventAdd &Event);
+  void AddEvent(uint32_t DeletedDatabaseId);
+  void AddEvent(const CarlaRecorderEventParent &Event);
+  void AddWeather(const CarlaRecorderWeather &Weather);
+  void AddLightScene(const CarlaRecorderLightScene &Light);
+  void AddLightVehicle(const CarlaRecorderLightVehicle &Light);
+  void AddTrafficLight(const CarlaRecorderStateTrafficLight &State);
+  void EndFrame();
+
+  // the FrameIndex packet, PacketOffset is where it starts in the file
+  void WriteFooter(CarlaRecorderBuffer &OutFile, uint64_t PacketOffset) const;
+
+  // read the footer, or the cache, or rebuild (and cache) the index; the file
+  // position is restored
+  bool Load(CarlaRecorderCursor &File, const std::string &Filename);
+
+  bool IsValid() const
+  {
+    return !Frames.empty();
+  }
+
+  const std::vector<CarlaRecorderFrameIndexEntry> &GetFrames() const
+  {
+    return Frames;
+  }
+
+  double GetTotalTime() const
+  {
+    return Frames.empty() ? 0.0 : Frames.back().Elapsed;
+  }
+
+  // last frame starting at or before Time
+  size_t FindFrame(double Time) const;
+
+  // last keyframe at or before Time (nullptr if none)
+  const CarlaRecorderKeyframe *FindKeyframe(double Time) const;
+
+private:
+
+  void WritePayload(CarlaRecorderBuffer &OutFile) const;
+  // PayloadEnd is where the payload has to end in InFile, the frame table is
+  // rejected if it does not fit before it
+  bool ReadPayload(CarlaRecorderCursor &InFile, uint64_t PayloadEnd);
+
+  bool ReadFooter(CarlaRecorderCursor &File);
+  bool Rebuild(CarlaRecorderCursor &File);
+  bool ReadCache(const std::string &CacheFilename, uint64_t RecordingSize);
+  void WriteCache(const std::string &CacheFilename, uint64_t RecordingSize) const;
+
+  std::vector<CarlaRecorderFrameIndexEntry> Frames;
+  std::vector<CarlaRecorderKeyframe> Keyframes;
+
+  // state while building
+  std::map<uint32_t, CarlaRecorderEventAdd> Alive;
+  std::map<uint32_t, CarlaRecorderEventParent> Parents;
+  std::vector<CarlaRecorderWeather> LastWeather;
+  std::map<int, CarlaRecorderLightScene> LastLights;
+  std::map<uint32_t, CarlaRecorderLightVehicle> LastVehicleLights;
+  std::map<uint32_t, CarlaRecorderStateTrafficLight> LastTrafficLights;
+  bool bFrameHasEvents = false;
+};
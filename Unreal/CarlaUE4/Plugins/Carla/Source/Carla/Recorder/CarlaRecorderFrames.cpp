@@ -8,12 +8,12 @@
 #include "CarlaRecorderFrames.h"
 #include "CarlaRecorderHelpers.h"
 
-void CarlaRecorderFrame::Read(std::ifstream &InFile)
+void CarlaRecorderFrame::Read(CarlaRecorderCursor &InFile)
 {
   ReadValue<CarlaRecorderFrame>(InFile, *this);
 }
 
-void CarlaRecorderFrame::Write(std::ofstream &OutFile)
+void CarlaRecorderFrame::Write(CarlaRecorderBuffer &OutFile)
 {
   WriteValue<CarlaRecorderFrame>(OutFile, *this);
 }
@@ -49,9 +49,9 @@ void CarlaRecorderFrames::SetFrame(double DeltaSeconds)
   ++Frame.Id;
 }
 
-void CarlaRecorderFrames::WriteStart(std::ofstream &OutFile)
+void CarlaRecorderFrames::WriteStart(CarlaRecorderBuffer &OutFile, CarlaRecorderBuffer *PreviousFrame)
 {
-  std::streampos Pos, Offset;
+  size_t Offset;
   double Dummy = -1.0f;
 
   // write the packet id
@@ -63,24 +63,22 @@ void CarlaRecorderFrames::WriteStart(std::ofstream &OutFile)
 
   // write frame record
   WriteValue<uint64_t>(OutFile, Frame.Id);
-  Offset = OutFile.tellp();
+  Offset = OutFile.Tell();
   WriteValue<double>(OutFile, Dummy);
   WriteValue<double>(OutFile, Frame.Elapsed);
 
   // we need to write this duration to previous frame
-  if (OffsetPreviousFrame > 0)
+  // (which is still in memory, the writer only gets it after this)
+  if (OffsetPreviousFrame > 0 && PreviousFrame != nullptr)
   {
-    Pos = OutFile.tellp();
-    OutFile.seekp(OffsetPreviousFrame, std::ios::beg);
-    WriteValue<double>(OutFile, Frame.DurationThis);
-    OutFile.seekp(Pos, std::ios::beg);
+    PreviousFrame->Patch<double>(OffsetPreviousFrame, Frame.DurationThis);
   }
 
   // save position for next actualization
   OffsetPreviousFrame = Offset;
 }
 
-void CarlaRecorderFrames::WriteEnd(std::ofstream &OutFile)
+void CarlaRecorderFrames::WriteEnd(CarlaRecorderBuffer &OutFile)
 {
   // write the packet id
   WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::FrameEnd));
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 
 #pragma pack(push, 1)
@@ -15,9 +17,9 @@ struct CarlaRecorderFrame
   double DurationThis;
   double Elapsed;
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 
 };
 #pragma pack(pop)
@@ -32,11 +34,17 @@ public:
 
   void SetFrame(double DeltaSeconds);
 
-  void WriteStart(std::ofstream &OutFile);
-  void WriteEnd(std::ofstream &OutFile);
+  const CarlaRecorderFrame &GetFrame() const
+  {
+    return Frame;
+  }
+
+  // PreviousFrame is the buffer of the last frame, to fill in its duration
+  void WriteStart(CarlaRecorderBuffer &OutFile, CarlaRecorderBuffer *PreviousFrame);
+  void WriteEnd(CarlaRecorderBuffer &OutFile);
 
 private:
 
   CarlaRecorderFrame Frame;
-  std::streampos OffsetPreviousFrame;
+  size_t OffsetPreviousFrame; // offset of DurationThis inside the previous frame buffer
 };
@@ -9,9 +9,6 @@
 #include "UnrealString.h"
 #include "CarlaRecorderHelpers.h"
 
-// create a temporal buffer to convert from and to FString and bytes
-static std::vector<uint8_t> CarlaRecorderHelperBuffer;
-
 // get the final path + filename
 std::string GetRecorderFilename(std::string Filename)
 {
@@ -34,7 +31,7 @@ std::string GetRecorderFilename(std::string Filename)
 // ------
 
 // write binary data from FVector
-void WriteFVector(std::ofstream &OutFile, const FVector &InObj)
+void WriteFVector(CarlaRecorderBuffer &OutFile, const FVector &InObj)
 {
   WriteValue<float>(OutFile, InObj.X);
   WriteValue<float>(OutFile, InObj.Y);
@@ -42,7 +39,7 @@ void WriteFVector(std::ofstream &OutFile, const FVector &InObj)
 }
 
 // write binary data from FRotator
-void WriteFRotator(std::ofstream &OutFile, const FRotator &InObj)
+void WriteFRotator(CarlaRecorderBuffer &OutFile, const FRotator &InObj)
 {
   WriteValue<float>(OutFile, InObj.Pitch);
   WriteValue<float>(OutFile, InObj.Roll);
@@ -50,14 +47,14 @@ void WriteFRotator(std::ofstream &OutFile, const FRotator &InObj)
 }
 
 // write binary data from FVector2D
-void WriteFVector2D(std::ofstream &OutFile, const FVector2D &InObj)
+void WriteFVector2D(CarlaRecorderBuffer &OutFile, const FVector2D &InObj)
 {
   WriteValue<float>(OutFile, InObj.X);
   WriteValue<float>(OutFile, InObj.Y);
 }
 
 // write binary data to FLinearColor
-void WriteFLinearColor(std::ofstream &InFile, const FLinearColor &InObj)
+void WriteFLinearColor(CarlaRecorderBuffer &InFile, const FLinearColor &InObj)
 {
   WriteValue<float>(InFile, InObj.A);
   WriteValue<float>(InFile, InObj.B);
@@ -66,13 +63,13 @@ void WriteFLinearColor(std::ofstream &InFile, const FLinearColor &InObj)
 }
 
 // write binary data from FTransform
-// void WriteFTransform(std::ofstream &OutFile, const FTransform &InObj){
+// void WriteFTransform(CarlaRecorderBuffer &OutFile, const FTransform &InObj){
 // WriteFVector(OutFile, InObj.GetTranslation());
 // WriteFVector(OutFile, InObj.GetRotation().Euler());
 // }
 
 // write binary data from FString (length + text)
-void WriteFString(std::ofstream &OutFile, const FString &InObj)
+void WriteFString(CarlaRecorderBuffer &OutFile, const FString &InObj)
 {
   // encode the string to UTF8 to know the final length
   FTCHARToUTF8 EncodedString(*InObj);
@@ -87,7 +84,7 @@ void WriteFString(std::ofstream &OutFile, const FString &InObj)
 // -----
 
 // read binary data to FVector
-void ReadFVector(std::ifstream &InFile, FVector &OutObj)
+void ReadFVector(CarlaRecorderCursor &InFile, FVector &OutObj)
 {
   ReadValue<float>(InFile, OutObj.X);
   ReadValue<float>(InFile, OutObj.Y);
@@ -95,7 +92,7 @@ void ReadFVector(std::ifstream &InFile, FVector &OutObj)
 }
 
 // read binary data to FRotator
-void ReadFRotator(std::ifstream &InFile, FRotator &OutObj)
+void ReadFRotator(CarlaRecorderCursor &InFile, FRotator &OutObj)
 {
   ReadValue<float>(InFile, OutObj.Pitch);
   ReadValue<float>(InFile, OutObj.Roll);
@@ -103,14 +100,14 @@ void ReadFRotator(std::ifstream &InFile, FRotator &OutObj)
 }
 
 // read binary data to FVector2D
-void ReadFVector2D(std::ifstream &InFile, FVector2D &OutObj)
+void ReadFVector2D(CarlaRecorderCursor &InFile, FVector2D &OutObj)
 {
   ReadValue<float>(InFile, OutObj.X);
   ReadValue<float>(InFile, OutObj.Y);
 }
 
 // read binary data to FLinearColor
-void ReadFLinearColor(std::ifstream &InFile, FLinearColor &OutObj)
+void ReadFLinearColor(CarlaRecorderCursor &InFile, FLinearColor &OutObj)
 {
   ReadValue<float>(InFile, OutObj.A);
   ReadValue<float>(InFile, OutObj.B);
@@ -119,7 +116,7 @@ void ReadFLinearColor(std::ifstream &InFile, FLinearColor &OutObj)
 }
 
 // read binary data to FTransform
-// void ReadFTransform(std::ifstream &InFile, FTransform &OutObj){
+// void ReadFTransform(CarlaRecorderCursor &InFile, FTransform &OutObj){
 // FVector Vec;
 // ReadFVector(InFile, Vec);
 // OutObj.SetTranslation(Vec);
@@ -128,20 +125,17 @@ void ReadFLinearColor(std::ifstream &InFile, FLinearColor &OutObj)
 // }
 
 // read binary data to FString (length + text)
-void ReadFString(std::ifstream &InFile, FString &OutObj)
+void ReadFString(CarlaRecorderCursor &InFile, FString &OutObj)
 {
   uint16_t Length;
   ReadValue<uint16_t>(InFile, Length);
-  // make room in vector buffer
-  if (CarlaRecorderHelperBuffer.capacity() < Length + 1)
+  // convert from UTF8 to FString, straight from the file data
+  const char *Text = InFile.View(Length);
+  if (Text == nullptr)
   {
-    CarlaRecorderHelperBuffer.reserve(Length + 1);
+    OutObj.Empty();
+    return;
   }
-  CarlaRecorderHelperBuffer.clear();
-  // initialize the vector space with 0
-  CarlaRecorderHelperBuffer.resize(Length + 1);
-  // read
-  InFile.read(reinterpret_cast<char *>(CarlaRecorderHelperBuffer.data()), Length);
-  // convert from UTF8 to FString
-  OutObj = FString(UTF8_TO_TCHAR(CarlaRecorderHelperBuffer.data()));
+  FUTF8ToTCHAR Converted(Text, Length);
+  OutObj = FString(Converted.Length(), Converted.Get());
 }
@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+#include "CarlaRecorderCursor.h"
+
 #include <fstream>
 #include <vector>
 
@@ -18,13 +21,13 @@ std::string GetRecorderFilename(std::string Filename);
 
 // write binary data (using sizeof())
 template <typename T>
-void WriteValue(std::ofstream &OutFile, const T &InObj)
+void WriteValue(CarlaRecorderBuffer &OutFile, const T &InObj)
 {
   OutFile.write(reinterpret_cast<const char *>(&InObj), sizeof(T));
 }
 
 template <typename T>
-void WriteStdVector(std::ofstream &OutFile, const std::vector<T> &InVec)
+void WriteStdVector(CarlaRecorderBuffer &OutFile, const std::vector<T> &InVec)
 {
   WriteValue<uint32_t>(OutFile, InVec.size());
   for (const auto& InObj : InVec)
@@ -34,7 +37,7 @@ void WriteStdVector(std::ofstream &OutFile, const std::vector<T> &InVec)
 }
 
 template <typename T>
-void WriteTArray(std::ofstream &OutFile, const TArray<T> &InVec)
+void WriteTArray(CarlaRecorderBuffer &OutFile, const TArray<T> &InVec)
 {
   WriteValue<uint32_t>(OutFile, InVec.Num());
   for (const auto& InObj : InVec)
@@ -44,21 +47,21 @@ void WriteTArray(std::ofstream &OutFile, const TArray<T> &InVec)
 }
 
 // write binary data from FVector
-void WriteFVector(std::ofstream &OutFile, const FVector &InObj);
+void WriteFVector(CarlaRecorderBuffer &OutFile, const FVector &InObj);
 
 // write binary data from FRotator
-void WriteFRotator(std::ofstream &OutFile, const FRotator &InObj);
+void WriteFRotator(CarlaRecorderBuffer &OutFile, const FRotator &InObj);
 
 // write binary data from FVector2D
-void WriteFVector2D(std::ofstream &OutFile, const FVector2D &InObj);
+void WriteFVector2D(CarlaRecorderBuffer &OutFile, const FVector2D &InObj);
 
 // write binary data from FLinearColor
-void WriteFLinearColor(std::ofstream &OutFile, const FLinearColor &InObj);
+void WriteFLinearColor(CarlaRecorderBuffer &OutFile, const FLinearColor &InObj);
 
 // write binary data from FTransform
-// void WriteFTransform(std::ofstream &OutFile, const FTransform &InObj);
+// void WriteFTransform(CarlaRecorderBuffer &OutFile, const FTransform &InObj);
 // write binary data from FString (length + text)
-void WriteFString(std::ofstream &OutFile, const FString &InObj);
+void WriteFString(CarlaRecorderBuffer &OutFile, const FString &InObj);
 
 // ---------
 // replayer
@@ -66,13 +69,13 @@ void WriteFString(std::ofstream &OutFile, const FString &InObj);
 
 // read binary data (using sizeof())
 template <typename T>
-void ReadValue(std::ifstream &InFile, T &OutObj)
+void ReadValue(CarlaRecorderCursor &InFile, T &OutObj)
 {
   InFile.read(reinterpret_cast<char *>(&OutObj), sizeof(T));
 }
 
 template <typename T>
-void ReadStdVector(std::ifstream &InFile, std::vector<T> &OutVec)
+void ReadStdVector(CarlaRecorderCursor &InFile, std::vector<T> &OutVec)
 {
   uint32_t VecSize;
   ReadValue<uint32_t>(InFile, VecSize);
@@ -86,7 +89,7 @@ void ReadStdVector(std::ifstream &InFile, std::vector<T> &OutVec)
 }
 
 template <typename T>
-void ReadTArray(std::ifstream &InFile, TArray<T> &OutVec)
+void ReadTArray(CarlaRecorderCursor &InFile, TArray<T> &OutVec)
 {
   uint32_t VecSize;
   ReadValue<uint32_t>(InFile, VecSize);
@@ -100,19 +103,19 @@ void ReadTArray(std::ifstream &InFile, TArray<T> &OutVec)
 }
 
 // read binary data from FVector
-void ReadFVector(std::ifstream &InFile, FVector &OutObj);
+void ReadFVector(CarlaRecorderCursor &InFile, FVector &OutObj);
 
 // read binary data from FRotator
-void ReadFRotator(std::ifstream &InFile, FRotator &OutObj);
+void ReadFRotator(CarlaRecorderCursor &InFile, FRotator &OutObj);
 
 // read binary data from FVector2D
-void ReadFVector2D(std::ifstream &InFile, FVector2D &OutObj);
+void ReadFVector2D(CarlaRecorderCursor &InFile, FVector2D &OutObj);
 
 // read binary data from FLinearColor
-void ReadFLinearColor(std::ifstream &OutFile, FLinearColor &OutObj);
+void ReadFLinearColor(CarlaRecorderCursor &OutFile, FLinearColor &OutObj);
 
 
 // read binary data from FTransform
-// void ReadTransform(std::ifstream &InFile, FTransform &OutObj);
+// void ReadTransform(CarlaRecorderCursor &InFile, FTransform &OutObj);
 // read binary data from FString (length + text)
-void ReadFString(std::ifstream &InFile, FString &OutObj);
+void ReadFString(CarlaRecorderCursor &InFile, FString &OutObj);
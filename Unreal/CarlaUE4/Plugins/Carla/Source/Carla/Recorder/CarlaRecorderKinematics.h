@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 
@@ -16,9 +18,9 @@ struct CarlaRecorderKinematics
   FVector LinearVelocity;
   FVector AngularVelocity;
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 };
 #pragma pack(pop)
 
@@ -30,7 +32,7 @@ class CarlaRecorderActorsKinematics
 
   void Clear(void);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 
 private:
 
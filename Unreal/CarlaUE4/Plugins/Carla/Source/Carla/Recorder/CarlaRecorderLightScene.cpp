@@ -9,7 +9,7 @@
 #include "CarlaRecorderHelpers.h"
 
 
-void CarlaRecorderLightScene::Write(std::ofstream &OutFile)
+void CarlaRecorderLightScene::Write(CarlaRecorderBuffer &OutFile) const
 {
   WriteValue<int>(OutFile, this->LightId);
   WriteValue<float>(OutFile, this->Intensity);
@@ -17,7 +17,7 @@ void CarlaRecorderLightScene::Write(std::ofstream &OutFile)
   WriteValue<bool>(OutFile, this->bOn);
   WriteValue<uint8>(OutFile, this->Type);
 }
-void CarlaRecorderLightScene::Read(std::ifstream &InFile)
+void CarlaRecorderLightScene::Read(CarlaRecorderCursor &InFile)
 {
   ReadValue<int>(InFile, this->LightId);
   ReadValue<float>(InFile, this->Intensity);
@@ -38,7 +38,7 @@ void CarlaRecorderLightScenes::Add(const CarlaRecorderLightScene &Vehicle)
   Lights.push_back(Vehicle);
 }
 
-void CarlaRecorderLightScenes::Write(std::ofstream &OutFile)
+void CarlaRecorderLightScenes::Write(CarlaRecorderBuffer &OutFile)
 {
   if (Lights.size() == 0)
   {
@@ -47,9 +47,7 @@ void CarlaRecorderLightScenes::Write(std::ofstream &OutFile)
   // write the packet id
   WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::SceneLight));
 
-  std::streampos PosStart = OutFile.tellp();
-
-  // write a dummy packet size
+  // write the packet size
   uint32_t Total = 2 + Lights.size() * sizeof(CarlaRecorderLightScene);
   WriteValue<uint32_t>(OutFile, Total);
 
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 #include <type_traits>
@@ -20,9 +22,9 @@ struct CarlaRecorderLightScene
   bool bOn;
   uint8 Type;
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile) const;
 };
 #pragma pack(pop)
 
@@ -34,7 +36,12 @@ public:
 
   void Clear(void);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
+
+  const std::vector<CarlaRecorderLightScene>& GetLights() const
+  {
+    return Lights;
+  }
 
 private:
 
@@ -9,13 +9,13 @@
 #include "CarlaRecorderHelpers.h"
 
 
-void CarlaRecorderLightVehicle::Write(std::ofstream &OutFile)
+void CarlaRecorderLightVehicle::Write(CarlaRecorderBuffer &OutFile) const
 {
   // database id
   WriteValue<uint32_t>(OutFile, this->DatabaseId);
   WriteValue<VehicleLightStateType>(OutFile, this->State);
 }
-void CarlaRecorderLightVehicle::Read(std::ifstream &InFile)
+void CarlaRecorderLightVehicle::Read(CarlaRecorderCursor &InFile)
 {
   // database id
   ReadValue<uint32_t>(InFile, this->DatabaseId);
@@ -34,7 +34,7 @@ void CarlaRecorderLightVehicles::Add(const CarlaRecorderLightVehicle &Vehicle)
   Vehicles.push_back(Vehicle);
 }
 
-void CarlaRecorderLightVehicles::Write(std::ofstream &OutFile)
+void CarlaRecorderLightVehicles::Write(CarlaRecorderBuffer &OutFile)
 {
   // write the packet id
   WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::VehicleLight));
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 #include <type_traits>
@@ -19,9 +21,9 @@ struct CarlaRecorderLightVehicle
   uint32_t DatabaseId;
   VehicleLightStateType State;
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile) const;
 };
 #pragma pack(pop)
 
@@ -33,7 +35,12 @@ public:
 
   void Clear(void);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
+
+  const std::vector<CarlaRecorderLightVehicle>& GetLightVehicles() const
+  {
+    return Vehicles;
+  }
 
 private:
 
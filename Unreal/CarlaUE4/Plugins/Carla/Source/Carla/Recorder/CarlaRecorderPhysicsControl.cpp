@@ -13,7 +13,7 @@
 #include <compiler/enable-ue4-macros.h>
 
 
-void CarlaRecorderPhysicsControl::Write(std::ofstream &OutFile)
+void CarlaRecorderPhysicsControl::Write(CarlaRecorderBuffer &OutFile)
 {
   carla::rpc::VehiclePhysicsControl RPCPhysicsControl(VehiclePhysicsControl);
   WriteValue<uint32_t>(OutFile, this->DatabaseId);
@@ -42,7 +42,7 @@ void CarlaRecorderPhysicsControl::Write(std::ofstream &OutFile)
   WriteStdVector(OutFile, RPCPhysicsControl.wheels);
 }
 
-void CarlaRecorderPhysicsControl::Read(std::ifstream &InFile)
+void CarlaRecorderPhysicsControl::Read(CarlaRecorderCursor &InFile)
 {
   carla::rpc::VehiclePhysicsControl RPCPhysicsControl;
   ReadValue<uint32_t>(InFile, this->DatabaseId);
@@ -85,7 +85,7 @@ void CarlaRecorderPhysicsControls::Add(const CarlaRecorderPhysicsControl &InObj)
   PhysicsControls.push_back(InObj);
 }
 
-void CarlaRecorderPhysicsControls::Write(std::ofstream &OutFile)
+void CarlaRecorderPhysicsControls::Write(CarlaRecorderBuffer &OutFile)
 {
   if (PhysicsControls.size() == 0)
   {
@@ -94,7 +94,7 @@ void CarlaRecorderPhysicsControls::Write(std::ofstream &OutFile)
   // write the packet id
   WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::PhysicsControl));
 
-  std::streampos PosStart = OutFile.tellp();
+  const size_t PosStart = OutFile.Tell();
   // write dummy packet size
   uint32_t Total = 0;
   WriteValue<uint32_t>(OutFile, Total);
@@ -109,10 +109,7 @@ void CarlaRecorderPhysicsControls::Write(std::ofstream &OutFile)
     PhysicsControl.Write(OutFile);
   }
 
-  // write the real packet size
-  std::streampos PosEnd = OutFile.tellp();
-  Total = PosEnd - PosStart - sizeof(uint32_t);
-  OutFile.seekp(PosStart, std::ios::beg);
-  WriteValue<uint32_t>(OutFile, Total);
-  OutFile.seekp(PosEnd, std::ios::beg);
+  // write the real packet size (patched in the frame buffer, not on disk)
+  Total = OutFile.Tell() - PosStart - sizeof(uint32_t);
+  OutFile.Patch<uint32_t>(PosStart, Total);
 }
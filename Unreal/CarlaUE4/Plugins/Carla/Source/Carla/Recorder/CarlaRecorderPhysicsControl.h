@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 
@@ -17,9 +19,9 @@ struct CarlaRecorderPhysicsControl
   uint32_t DatabaseId;
   FVehiclePhysicsControl VehiclePhysicsControl;
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 };
 #pragma pack(pop)
 
@@ -31,7 +33,7 @@ class CarlaRecorderPhysicsControls
 
   void Clear(void);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 
 private:
 
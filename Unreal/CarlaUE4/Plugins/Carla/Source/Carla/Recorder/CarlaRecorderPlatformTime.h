@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <chrono>
 
@@ -21,9 +23,9 @@ struct CarlaRecorderPlatformTime
   void SetStartTime();
   void UpdateTime();
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
 
 };
 #pragma pack(pop)
@@ -6,7 +6,10 @@
 
 #include "CarlaRecorderHelpers.h"
 
+#include <algorithm>
+#include <atomic>
 #include <ctime>
+#include <mutex>
 #include <sstream>
 #include <string>
 
@@ -33,6 +36,26 @@ inline void CarlaRecorderQuery::SkipPacket(void)
   File.seekg(Header.Size, std::ios::cur);
 }
 
+inline bool CarlaRecorderQuery::OpenFile(const std::string &Filename, std::stringstream &Info)
+{
+  // recording already mapped by QueryAll
+  if (Recording)
+  {
+    return File.Open(Recording);
+  }
+
+  // get the final path + filename
+  std::string Filename2 = GetRecorderFilename(Filename);
+
+  File.open(Filename2, std::ios::binary);
+  if (!File.is_open())
+  {
+    Info << "File " << Filename2 << " not found on server\n";
+    return false;
+  }
+  return true;
+}
+
 inline bool CarlaRecorderQuery::CheckFileInfo(std::stringstream &Info)
 {
   // read Info
@@ -48,9 +71,14 @@ inline bool CarlaRecorderQuery::CheckFileInfo(std::stringstream &Info)
   // show general Info
   Info << "Version: " << RecInfo.Version << std::endl;
   Info << "Map: " << TCHAR_TO_UTF8(*RecInfo.Mapfile) << std::endl;
-  tm *TimeInfo = localtime(&RecInfo.Date);
   char DateStr[100];
-  strftime(DateStr, sizeof(DateStr), "%x %X", TimeInfo);
+  {
+    // localtime uses a shared buffer and queries can run in parallel
+    static std::mutex LocalTimeMutex;
+    std::lock_guard<std::mutex> Lock(LocalTimeMutex);
+    tm *TimeInfo = localtime(&RecInfo.Date);
+    strftime(DateStr, sizeof(DateStr), "%x %X", TimeInfo);
+  }
   Info << "Date: " << DateStr << std::endl << std::endl;
 
   return true;
@@ -60,14 +88,9 @@ std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
 {
   std::stringstream Info;
 
-  // get the final path + filename
-  std::string Filename2 = GetRecorderFilename(Filename);
-
   // try to open
-  File.open(Filename2, std::ios::binary);
-  if (!File.is_open())
+  if (!OpenFile(Filename, Info))
   {
-    Info << "File " << Filename2 << " not found on server\n";
     return Info.str();
   }
 
@@ -648,14 +671,9 @@ std::string CarlaRecorderQuery::QueryCollisions(std::string Filename, char Categ
 {
   std::stringstream Info;
 
-  // get the final path + filename
-  std::string Filename2 = GetRecorderFilename(Filename);
-
   // try to open
-  File.open(Filename2, std::ios::binary);
-  if (!File.is_open())
+  if (!OpenFile(Filename, Info))
   {
-    Info << "File " << Filename2 << " not found on server\n";
     return Info.str();
   }
 
@@ -828,14 +846,9 @@ std::string CarlaRecorderQuery::QueryBlocked(std::string Filename, double MinTim
 {
   std::stringstream Info;
 
-  // get the final path + filename
-  std::string Filename2 = GetRecorderFilename(Filename);
-
   // try to open
-  File.open(Filename2, std::ios::binary);
-  if (!File.is_open())
+  if (!OpenFile(Filename, Info))
   {
-    Info << "File " << Filename2 << " not found on server\n";
     return Info.str();
   }
 
@@ -992,3 +1005,96 @@ std::string CarlaRecorderQuery::QueryBlocked(std::string Filename, double MinTim
 
   return Info.str();
 }
+
+CarlaRecorderQuery::Report CarlaRecorderQuery::QueryAll(std::string Filename, const ReportOptions &Options, bool bConcurrent)
+{
+  Report Result;
+  Result.Filename = Filename;
+
+  // read (map) the file only once for the three queries
+  std::string Filename2 = GetRecorderFilename(Filename);
+  auto Mapped = CarlaRecorderMappedFile::Open(Filename2);
+  if (!Mapped)
+  {
+    Result.Info = "File " + Filename2 + " not found on server\n";
+    Result.Collisions = Result.Info;
+    Result.Blocked = Result.Info;
+    return Result;
+  }
+  CarlaRecorderCursor Header;
+  CarlaRecorderInfo HeaderInfo;
+  if (Header.Open(Mapped))
+  {
+    HeaderInfo.Read(Header);
+  }
+  if (!Header || HeaderInfo.Magic != "CARLA_RECORDER")
+  {
+    Result.Info = "File " + Filename2 + " is not a CARLA recorder\n";
+    Result.Collisions = Result.Info;
+    Result.Blocked = Result.Info;
+    return Result;
+  }
+  Result.bOk = true;
+
+  // each query keeps its own parsing state, so each one needs its own instance
+  CarlaRecorderQuery CollisionsQuery, BlockedQuery;
+  Recording = Mapped;
+  CollisionsQuery.Recording = Mapped;
+  BlockedQuery.Recording = Mapped;
+
+  auto RunCollisions = [&]() {
+    Result.Collisions = CollisionsQuery.QueryCollisions(Filename, Options.Category1, Options.Category2);
+  };
+  auto RunBlocked = [&]() {
+    Result.Blocked = BlockedQuery.QueryBlocked(Filename, Options.MinTime, Options.MinDistance);
+  };
+  if (bConcurrent)
+  {
+    std::thread CollisionsThread(RunCollisions);
+    std::thread BlockedThread(RunBlocked);
+    Result.Info = QueryInfo(Filename, Options.bShowAll);
+    CollisionsThread.join();
+    BlockedThread.join();
+  }
+  else
+  {
+    Result.Info = QueryInfo(Filename, Options.bShowAll);
+    RunCollisions();
+    RunBlocked();
+  }
+
+  Recording.reset();
+  return Result;
+}
+
+std::vector<CarlaRecorderQuery::Report> CarlaRecorderQuery::QueryBatch(
+    const std::vector<std::string> &Filenames,
+    const ReportOptions &Options)
+{
+  std::vector<Report> Results(Filenames.size());
+  const size_t Workers = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), Filenames.size());
+
+  // each worker takes the next recording (the three queries of a recording run
+  // one after the other, the parallelism is across recordings)
+  std::atomic<size_t> Next{0};
+  auto Work = [&]() {
+    CarlaRecorderQuery Query;
+    for (size_t i = Next++; i < Filenames.size(); i = Next++)
+    {
+      Results[i] = Query.QueryAll(Filenames[i], Options, false);
+    }
+  };
+
+  std::vector<std::thread> Threads;
+  for (size_t i = 1; i < Workers; ++i)
+  {
+    Threads.emplace_back(Work);
+  }
+  Work();
+  for (auto &Thread : Threads)
+  {
+    Thread.join();
+  }
+  return Results;
+}
@@ -6,7 +6,9 @@
 
 #pragma once
 
-#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "CarlaRecorderTraficLightTime.h"
 #include "CarlaRecorderPhysicsControl.h"
@@ -47,9 +49,37 @@ public:
   // get info about blocked actors
   std::string QueryBlocked(std::string Filename, double MinTime = 30, double MinDistance = 10);
 
+  struct ReportOptions
+  {
+    bool bShowAll = false;
+    char Category1 = 'a';
+    char Category2 = 'a';
+    double MinTime = 30;
+    double MinDistance = 10;
+  };
+
+  struct Report
+  {
+    std::string Filename;
+    std::string Info;
+    std::string Collisions;
+    std::string Blocked;
+    bool bOk = false; // false if the recording is missing or not a CARLA recording (the texts say why)
+  };
+
+  // the three queries over a single read of the file (concurrently, each with its own cursor)
+  Report QueryAll(std::string Filename, const ReportOptions &Options = ReportOptions(), bool bConcurrent = true);
+
+  // QueryAll over many recordings (e.g. all the participants of an experiment), in parallel
+  static std::vector<Report> QueryBatch(
+      const std::vector<std::string> &Filenames,
+      const ReportOptions &Options = ReportOptions());
+
 private:
 
-  std::ifstream File;
+  CarlaRecorderCursor File;
+  // recording shared with the other queries of QueryAll (nullptr otherwise)
+  std::shared_ptr<const CarlaRecorderMappedFile> Recording;
   Header Header;
   CarlaRecorderInfo RecInfo;
   CarlaRecorderFrame Frame;
@@ -74,6 +104,9 @@ private:
   DReyeVRDataRecorder<DReyeVR::CustomActorData> DReyeVRCustomActorDataInstance;
   DReyeVRDataRecorder<DReyeVR::ConfigFileData> DReyeVRConfigFileDataInstance;
 
+  // open the recording (or a new cursor on the shared one)
+  bool OpenFile(const std::string &Filename, std::stringstream &Info);
+
   // read next header packet
   bool ReadHeader(void);
 
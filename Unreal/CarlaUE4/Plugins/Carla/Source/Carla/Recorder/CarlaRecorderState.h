@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 
 #pragma pack(push, 1)
@@ -17,9 +19,9 @@ struct CarlaRecorderStateTrafficLight
   float ElapsedTime;
   char State;
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile) const;
 
 };
 
@@ -34,7 +36,12 @@ public:
 
   void Clear(void);
 
-  void Write(std::ofstream &OutFile);
+  void Write(CarlaRecorderBuffer &OutFile);
+
+  const std::vector<CarlaRecorderStateTrafficLight>& GetStates() const
+  {
+    return StatesTrafficLights;
+  }
 
 private:
 
@@ -0,0 +1,100 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "Carla.h"
+#include "CarlaRecorderTable.h"
+
+#include <fstream>
+
+constexpr uint32_t CarlaRecorderTable::Magic;
+constexpr uint16_t CarlaRecorderTable::Version;
+
+CarlaRecorderTable::ColumnData &CarlaRecorderTable::NextColumn(const char *Name, char Type)
+{
+  // the first row declares the columns
+  if (Column == Columns.size())
+  {
+    check(Rows == 1);
+    Columns.push_back({Name, Type, {}, {}});
+  }
+  check(Column < Columns.size() && Columns[Column].Type == Type);
+  return Columns[Column++];
+}
+
+void CarlaRecorderTable::Add(const char *Name, const std::string &Value)
+{
+  auto &Data = NextColumn(Name, 'S');
+  Data.Bytes.insert(Data.Bytes.end(), Value.begin(), Value.end());
+  Data.Offsets.push_back(Data.Bytes.size());
+}
+
+void CarlaRecorderTable::Append(CarlaRecorderTable &&Other)
+{
+  if (Other.Rows == 0)
+  {
+    return;
+  }
+  if (Rows == 0)
+  {
+    *this = std::move(Other);
+    return;
+  }
+  check(Columns.size() == Other.Columns.size());
+  for (size_t i = 0; i < Columns.size(); ++i)
+  {
+    auto &Data = Columns[i];
+    auto &OtherData = Other.Columns[i];
+    const uint64_t Base = Data.Bytes.size();
+    Data.Bytes.insert(Data.Bytes.end(), OtherData.Bytes.begin(), OtherData.Bytes.end());
+    for (uint64_t Offset : OtherData.Offsets)
+    {
+      Data.Offsets.push_back(Base + Offset);
+    }
+  }
+  Rows += Other.Rows;
+  Other = CarlaRecorderTable();
+}
+
+bool CarlaRecorderTable::Save(const std::string &Filename) const
+{
+  std::ofstream File(Filename, std::ios::binary);
+  if (!File.is_open())
+  {
+    return false;
+  }
+
+  auto Write = [&File](const void *Data, size_t Size) {
+    File.write(reinterpret_cast<const char *>(Data), Size);
+  };
+  const uint32_t Total = Columns.size();
+  Write(&Magic, sizeof(Magic));
+  Write(&Version, sizeof(Version));
+  Write(&Rows, sizeof(Rows));
+  Write(&Total, sizeof(Total));
+  for (const auto &Data : Columns)
+  {
+    const uint16_t NameLength = Data.Name.size();
+    Write(&NameLength, sizeof(NameLength));
+    Write(Data.Name.data(), NameLength);
+    Write(&Data.Type, sizeof(Data.Type));
+    if (Data.Type == 'S')
+    {
+      // offsets (starting with 0) then the characters
+      const uint64_t Bytes = (Data.Offsets.size() + 1) * sizeof(uint64_t) + Data.Bytes.size();
+      const uint64_t Zero = 0;
+      Write(&Bytes, sizeof(Bytes));
+      Write(&Zero, sizeof(Zero));
+      Write(Data.Offsets.data(), Data.Offsets.size() * sizeof(uint64_t));
+    }
+    else
+    {
+      const uint64_t Bytes = Data.Bytes.size();
+      Write(&Bytes, sizeof(Bytes));
+    }
+    Write(Data.Bytes.data(), Data.Bytes.size());
+  }
+  return File.good();
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Typed columnar table (one row per frame / record, one column per field)
+// produced by CarlaRecorderExporter.
+//
+// The columns are declared by the first row: each Add() call of a row goes to
+// the next column, so the code that fills a row is also its schema.
+//
+// File layout (little endian):
+//   uint32 magic "CRTB", uint16 version, uint64 rows, uint32 columns
+//   per column: uint16 name length, name (utf8), char type, uint64 bytes, data
+// Types are 'B' bool (1 byte), 'q' int64, 'I' uint32, 'Q' uint64, 'f' float,
+// 'd' double (rows * size bytes each) and 'S' utf8 string, stored as
+// uint64 offsets[rows + 1] followed by the characters.
+// PythonAPI/util/crtb.py reads them into numpy arrays or a pandas DataFrame.
+class CarlaRecorderTable
+{
+
+public:
+
+  static constexpr uint32_t Magic = 0x42545243; // "CRTB"
+  static constexpr uint16_t Version = 1;
+
+  void BeginRow()
+  {
+    Column = 0;
+    ++Rows;
+  }
+
+  void Add(const char *Name, bool Value)         { AddValue(Name, 'B', Value); }
+  void Add(const char *Name, int64_t Value)      { AddValue(Name, 'q', Value); }
+  void Add(const char *Name, uint32_t Value)     { AddValue(Name, 'I', Value); }
+  void Add(const char *Name, uint64_t Value)     { AddValue(Name, 'Q', Value); }
+  void Add(const char *Name, float Value)        { AddValue(Name, 'f', Value); }
+  void Add(const char *Name, double Value)       { AddValue(Name, 'd', Value); }
+  void Add(const char *Name, const std::string &Value);
+
+  uint64_t GetRows() const
+  {
+    return Rows;
+  }
+
+  size_t GetColumns() const
+  {
+    return Columns.size();
+  }
+
+  // rows of Other after the rows of this table (same columns)
+  void Append(CarlaRecorderTable &&Other);
+
+  bool Save(const std::string &Filename) const;
+
+private:
+
+  struct ColumnData
+  {
+    std::string Name;
+    char Type;
+    std::vector<char> Bytes;
+    std::vector<uint64_t> Offsets; // only for strings (end of each row)
+  };
+
+  ColumnData &NextColumn(const char *Name, char Type);
+
+  template <typename T>
+  void AddValue(const char *Name, char Type, T Value)
+  {
+    auto &Data = NextColumn(Name, Type).Bytes;
+    const size_t Offset = Data.size();
+    Data.resize(Offset + sizeof(T));
+    std::memcpy(Data.data() + Offset, &Value, sizeof(T));
+  }
+
+  std::vector<ColumnData> Columns;
+  uint64_t Rows = 0;
+  size_t Column = 0;
+};
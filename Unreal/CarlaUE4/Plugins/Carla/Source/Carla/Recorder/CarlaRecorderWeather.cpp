@@ -9,7 +9,7 @@
 #include "CarlaRecorderHelpers.h"
 
 
-void CarlaRecorderWeather::Write(std::ofstream &OutFile) const
+void CarlaRecorderWeather::Write(CarlaRecorderBuffer &OutFile) const
 {
   WriteValue<float>(OutFile, this->Params.Cloudiness);
   WriteValue<float>(OutFile, this->Params.Precipitation);
@@ -26,7 +26,7 @@ void CarlaRecorderWeather::Write(std::ofstream &OutFile) const
   WriteValue<float>(OutFile, this->Params.RayleighScatteringScale);
 }
 
-void CarlaRecorderWeather::Read(std::ifstream &InFile)
+void CarlaRecorderWeather::Read(CarlaRecorderCursor &InFile)
 {
   ReadValue<float>(InFile, this->Params.Cloudiness);
   ReadValue<float>(InFile, this->Params.Precipitation);
@@ -62,7 +62,7 @@ void CarlaRecorderWeathers::Add(const CarlaRecorderWeather &Weather)
   Weathers.push_back(Weather);
 }
 
-void CarlaRecorderWeathers::Write(std::ofstream &OutFile) const
+void CarlaRecorderWeathers::Write(CarlaRecorderBuffer &OutFile) const
 {
   if (Weathers.size() == 0)
   {
@@ -71,9 +71,7 @@ void CarlaRecorderWeathers::Write(std::ofstream &OutFile) const
   // write the packet id
   WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::Weather));
 
-  std::streampos PosStart = OutFile.tellp();
-
-  // write a dummy packet size
+  // write the packet size
   uint32_t Total = 2 + Weathers.size() * sizeof(CarlaRecorderWeather);
   WriteValue<uint32_t>(OutFile, Total);
 
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "CarlaRecorderBuffer.h"
+
 #include <fstream>
 #include <vector>
 #include "Carla/Weather/WeatherParameters.h"
@@ -16,9 +18,9 @@ struct CarlaRecorderWeather
 
   FWeatherParameters Params;
 
-  void Read(std::ifstream &InFile);
+  void Read(CarlaRecorderCursor &InFile);
 
-  void Write(std::ofstream &OutFile) const;
+  void Write(CarlaRecorderBuffer &OutFile) const;
 
   std::string Print() const;
 };
@@ -32,7 +34,12 @@ public:
 
   void Clear(void);
 
-  void Write(std::ofstream &OutFile) const;
+  void Write(CarlaRecorderBuffer &OutFile) const;
+
+  const std::vector<CarlaRecorderWeather>& GetWeathers() const
+  {
+    return Weathers;
+  }
 
 private:
 
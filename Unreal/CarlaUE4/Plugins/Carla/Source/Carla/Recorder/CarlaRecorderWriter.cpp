@@ -0,0 +1,190 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "Carla.h"
+#include "CarlaRecorderWriter.h"
+
+#include <algorithm>
+
+constexpr size_t CarlaRecorderWriter::MaxQueuedBytes;
+constexpr size_t CarlaRecorderWriter::FileBufferBytes;
+constexpr double CarlaRecorderWriter::LateFrameSeconds;
+
+CarlaRecorderWriter::~CarlaRecorderWriter()
+{
+  Close();
+}
+
+bool CarlaRecorderWriter::Open(const std::string &Filename)
+{
+  Close();
+
+  // a large stream buffer turns the many small frames into big sequential writes
+  // (needs to be set before opening the file)
+  FileBuffer.resize(FileBufferBytes);
+  File.rdbuf()->pubsetbuf(FileBuffer.data(), FileBuffer.size());
+  File.clear();
+  File.open(Filename, std::ios::binary);
+  if (!File.is_open())
+  {
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    bStop = false;
+    QueuedBytes = 0;
+    Statistics = Stats();
+  }
+  EndedBytes = 0;
+  Thread = std::thread(&CarlaRecorderWriter::Run, this);
+  return true;
+}
+
+void CarlaRecorderWriter::Close()
+{
+  if (!IsOpen())
+  {
+    return;
+  }
+
+  // the last frame keeps its placeholder duration, as it always did
+  if (Previous)
+  {
+    Submit(std::move(Previous));
+  }
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    bStop = true;
+  }
+  WakeWriter.notify_one();
+  Thread.join();
+  File.close();
+
+  const Stats Final = GetStats();
+  UE_LOG(LogCarla, Log,
+      TEXT("Recorder: wrote %llu frames (%llu bytes), %llu dropped, %llu late (max %.3f s queued), "
+           "%llu stalls, peak queue %llu bytes"),
+      Final.FramesWritten, Final.BytesWritten, Final.FramesDropped, Final.LateFrames,
+      Final.MaxQueueSeconds, Final.Stalls, static_cast<uint64_t>(Final.PeakQueuedBytes));
+}
+
+CarlaRecorderBuffer &CarlaRecorderWriter::BeginFrame()
+{
+  if (!Current)
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!FreeBuffers.empty())
+    {
+      Current = std::move(FreeBuffers.back());
+      FreeBuffers.pop_back();
+    }
+  }
+  if (!Current)
+  {
+    Current = std::make_unique<CarlaRecorderBuffer>();
+  }
+  Current->Clear();
+  return *Current;
+}
+
+void CarlaRecorderWriter::EndFrame()
+{
+  if (Previous)
+  {
+    Submit(std::move(Previous));
+  }
+  EndedBytes += Current->Size();
+  Previous = std::move(Current);
+}
+
+CarlaRecorderWriter::Stats CarlaRecorderWriter::GetStats() const
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return Statistics;
+}
+
+void CarlaRecorderWriter::Submit(std::unique_ptr<CarlaRecorderBuffer> Buffer)
+{
+  const size_t Size = Buffer->Size();
+  {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    // bound the memory held by frames waiting to be written
+    if (QueuedBytes > 0 && QueuedBytes + Size > MaxQueuedBytes)
+    {
+      ++Statistics.Stalls;
+      WakeGame.wait(Lock, [&] { return QueuedBytes == 0 || QueuedBytes + Size <= MaxQueuedBytes; });
+    }
+    QueuedBytes += Size;
+    Statistics.PeakQueuedBytes = std::max(Statistics.PeakQueuedBytes, QueuedBytes);
+    Queue.push_back({std::move(Buffer), std::chrono::steady_clock::now()});
+  }
+  WakeWriter.notify_one();
+}
+
+void CarlaRecorderWriter::Run()
+{
+  std::vector<QueuedFrame> Batch;
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      WakeWriter.wait(Lock, [this] { return bStop || !Queue.empty(); });
+      if (Queue.empty())
+      {
+        break; // stopping and everything is written
+      }
+      for (auto &Frame : Queue)
+      {
+        Batch.emplace_back(std::move(Frame));
+      }
+      Queue.clear();
+    }
+
+    const auto Now = std::chrono::steady_clock::now();
+    uint64_t Written = 0, WrittenBytes = 0, Dropped = 0, Late = 0;
+    size_t ReleasedBytes = 0;
+    double MaxQueueSeconds = 0.0;
+    for (auto &Frame : Batch)
+    {
+      const double QueueSeconds = std::chrono::duration<double>(Now - Frame.QueueTime).count();
+      MaxQueueSeconds = std::max(MaxQueueSeconds, QueueSeconds);
+      if (QueueSeconds > LateFrameSeconds)
+      {
+        ++Late;
+      }
+      File.write(Frame.Buffer->Data(), Frame.Buffer->Size());
+      if (File.good())
+      {
+        ++Written;
+        WrittenBytes += Frame.Buffer->Size();
+      }
+      else
+      {
+        ++Dropped;
+      }
+      ReleasedBytes += Frame.Buffer->Size();
+    }
+
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      for (auto &Frame : Batch)
+      {
+        FreeBuffers.emplace_back(std::move(Frame.Buffer));
+      }
+      QueuedBytes -= ReleasedBytes;
+      Statistics.FramesWritten += Written;
+      Statistics.BytesWritten += WrittenBytes;
+      Statistics.FramesDropped += Dropped;
+      Statistics.LateFrames += Late;
+      Statistics.MaxQueueSeconds = std::max(Statistics.MaxQueueSeconds, MaxQueueSeconds);
+    }
+    Batch.clear();
+    WakeGame.notify_all();
+  }
+  File.flush();
+}
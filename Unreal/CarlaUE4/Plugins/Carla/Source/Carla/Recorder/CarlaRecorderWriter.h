@@ -0,0 +1,118 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "CarlaRecorderBuffer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Back end of the recorder: each frame is serialized by the game thread into
+// its own CarlaRecorderBuffer and a dedicated thread writes the finished
+// frames to disk in order, so the game thread never waits on the file.
+//
+// The last finished frame is kept on the game thread until the next one
+// starts, because its duration is only known then (see
+// CarlaRecorderFrames::WriteStart). The bytes on disk are exactly the ones the
+// old std::ofstream path produced.
+//
+// Memory is bounded by MaxQueuedBytes: when the writer falls that far behind
+// the game thread waits for it (counted as a stall) instead of dropping data,
+// since a missing frame would break the replay.
+class CarlaRecorderWriter
+{
+
+public:
+
+  struct Stats
+  {
+    uint64_t FramesWritten = 0;
+    uint64_t BytesWritten = 0;
+    uint64_t FramesDropped = 0; // frames that could not be written (I/O error)
+    uint64_t LateFrames = 0;    // frames that waited in the queue more than LateFrameSeconds
+    uint64_t Stalls = 0;        // times the game thread had to wait for the writer
+    size_t PeakQueuedBytes = 0;
+    double MaxQueueSeconds = 0.0;
+  };
+
+  static constexpr size_t MaxQueuedBytes = 64u * 1024u * 1024u;
+  static constexpr size_t FileBufferBytes = 1024u * 1024u; // size of the sequential writes
+  static constexpr double LateFrameSeconds = 0.5;
+
+  CarlaRecorderWriter() = default;
+  ~CarlaRecorderWriter();
+
+  bool Open(const std::string &Filename);
+
+  bool IsOpen() const
+  {
+    return Thread.joinable();
+  }
+
+  // writes everything still pending (including the held frame) and joins the thread
+  void Close();
+
+  // buffer for the next frame (or for the file header)
+  CarlaRecorderBuffer &BeginFrame();
+
+  // the last finished frame, not yet handed to the writer (nullptr if none)
+  CarlaRecorderBuffer *GetPreviousFrame()
+  {
+    return Previous.get();
+  }
+
+  // hands the previous frame to the writer and keeps this one
+  void EndFrame();
+
+  // position in the file of the frame returned by BeginFrame
+  uint64_t GetFrameOffset() const
+  {
+    return EndedBytes;
+  }
+
+  Stats GetStats() const;
+
+private:
+
+  struct QueuedFrame
+  {
+    std::unique_ptr<CarlaRecorderBuffer> Buffer;
+    std::chrono::steady_clock::time_point QueueTime;
+  };
+
+  void Submit(std::unique_ptr<CarlaRecorderBuffer> Buffer);
+
+  void Run();
+
+  // only used by the game thread
+  std::unique_ptr<CarlaRecorderBuffer> Current;
+  std::unique_ptr<CarlaRecorderBuffer> Previous;
+  uint64_t EndedBytes = 0;
+
+  // shared, guarded by Mutex
+  mutable std::mutex Mutex;
+  std::condition_variable WakeWriter;
+  std::condition_variable WakeGame;
+  std::deque<QueuedFrame> Queue;
+  std::vector<std::unique_ptr<CarlaRecorderBuffer>> FreeBuffers;
+  size_t QueuedBytes = 0;
+  bool bStop = false;
+  Stats Statistics;
+
+  // only used by the writer thread (after Open)
+  std::ofstream File;
+  std::vector<char> FileBuffer;
+
+  std::thread Thread;
+};
@@ -79,63 +79,92 @@ void CarlaReplayer::Rewind(void)
   RecInfo.Read(File);
 }
 
-// read last frame in File and return the Total time recorded
+// Total time recorded (start of the last frame, from the frame index)
 double CarlaReplayer::GetTotalTime(void)
 {
-  std::streampos Current = File.tellg();
+  return FrameIndex.GetTotalTime();
+}
 
-  // parse only frames
-  while (File)
+// collect the start times of all the frames
+void CarlaReplayer::GetFrameStartTimes()
+{
+  FrameStartTimes.clear();
+  FrameStartTimes.reserve(FrameIndex.GetFrames().size());
+  for (const auto &Entry : FrameIndex.GetFrames())
   {
-    // get header
-    if (!ReadHeader())
-    {
-      break;
-    }
-
-    // check for a frame packet
-    switch (Header.Id)
-    {
-      case static_cast<char>(CarlaRecorderPacketId::FrameStart):
-        Frame.Read(File);
-        break;
-      default:
-        SkipPacket();
-        break;
-    }
+    FrameStartTimes.push_back(Entry.Elapsed);
   }
-
-  File.clear();
-  File.seekg(Current, std::ios::beg);
-  return Frame.Elapsed;
 }
 
-// Read all the frames and collect their start times
-void CarlaReplayer::GetFrameStartTimes()
+bool CarlaReplayer::SeekToKeyframe(double Time)
 {
-  std::streampos Current = File.tellg();
+  const CarlaRecorderKeyframe *Keyframe = FrameIndex.FindKeyframe(Time);
+  if (Keyframe == nullptr)
+  {
+    return false;
+  }
+  const CarlaRecorderFrameIndexEntry &Entry = FrameIndex.GetFrames()[Keyframe->Frame];
 
-  while (File)
+  // remove the replayed actors that do not exist at the keyframe
+  std::unordered_set<uint32_t> KeyframeActors;
+  for (const auto &Actor : Keyframe->Actors)
   {
-    if (!ReadHeader())
+    KeyframeActors.insert(Actor.DatabaseId);
+  }
+  for (auto It = MappedId.begin(); It != MappedId.end();)
+  {
+    if (KeyframeActors.find(It->first) == KeyframeActors.end())
     {
-      break;
+      Helper.ProcessReplayerEventDel(It->second);
+      It = MappedId.erase(It);
     }
+    else
+    {
+      ++It;
+    }
+  }
 
-    switch (Header.Id)
+  // create (or reuse) the actors alive at the keyframe and restore their state
+  for (const auto &Actor : Keyframe->Actors)
+  {
+    ProcessEventAdd(Actor);
+  }
+  for (const auto &Parent : Keyframe->Parents)
+  {
+    Helper.ProcessReplayerEventParent(MappedId[Parent.DatabaseId], MappedId[Parent.DatabaseIdParent]);
+  }
+  for (const auto &Weather : Keyframe->Weather)
+  {
+    Helper.ProcessReplayerWeather(Weather);
+  }
+  for (const auto &Light : Keyframe->Lights)
+  {
+    Helper.ProcessReplayerLightScene(Light);
+  }
+  for (auto Light : Keyframe->VehicleLights)
+  {
+    Light.DatabaseId = MappedId[Light.DatabaseId];
+    if (!(IgnoreHero && IsHeroMap[Light.DatabaseId]))
     {
-      case static_cast<char>(CarlaRecorderPacketId::FrameStart):
-        Frame.Read(File);
-        FrameStartTimes.push_back(Frame.Elapsed); // add this time to the global container
-        break;
-      default:
-        SkipPacket();
-        break;
+      Helper.ProcessReplayerLightVehicle(Light);
     }
   }
+  for (auto State : Keyframe->TrafficLights)
+  {
+    State.DatabaseId = MappedId[State.DatabaseId];
+    Helper.ProcessReplayerStateTrafficLight(State);
+  }
 
+  // continue reading from the keyframe
   File.clear();
-  File.seekg(Current, std::ios::beg); // return to original position
+  File.seekg(Entry.Offset, std::ios::beg);
+  Frame.Elapsed = -1.0f;
+  Frame.DurationThis = 0.0f;
+  CurrentTime = Entry.Elapsed;
+  CurrPos.clear();
+  PrevPos.clear();
+  ProcessToTime(Time - CurrentTime, true);
+  return true;
 }
 
 std::string CarlaReplayer::ReplayFile(std::string Filename, double TimeStart, double Duration,
@@ -173,6 +202,10 @@ std::string CarlaReplayer::ReplayFile(std::string Filename, double TimeStart, do
   // from start
   Rewind();
 
+  // frame offsets (from the footer, the cache or a single scan of the file)
+  FrameIndex.Load(File, Filename2);
+  FrameStartTimes.clear();
+
   // check to load map if different
   if (Episode->GetMapName() != RecInfo.Mapfile)
   {
@@ -225,8 +258,9 @@ std::string CarlaReplayer::ReplayFile(std::string Filename, double TimeStart, do
   if (!Autoplay.Enabled)
   {
     Helper.RemoveStaticProps();
-    // process all events until the time
-    ProcessToTime(TimeStart, true);
+    // process all events until the time (starting from the nearest keyframe if any)
+    if (!SeekToKeyframe(TimeStart))
+      ProcessToTime(TimeStart, true);
     // mark as enabled
     Enabled = true;
   }
@@ -260,6 +294,10 @@ void CarlaReplayer::CheckPlayAfterMapLoaded(void)
   // from start
   Rewind();
 
+  // frame offsets (from the footer, the cache or a single scan of the file)
+  FrameIndex.Load(File, Autoplay.Filename);
+  FrameStartTimes.clear();
+
   // get Total time of recorder
   TotalTime = GetTotalTime();
 
@@ -288,8 +326,9 @@ void CarlaReplayer::CheckPlayAfterMapLoaded(void)
 
   Helper.RemoveStaticProps();
 
-  // process all events until the time
-  ProcessToTime(TimeStart, true);
+  // process all events until the time (starting from the nearest keyframe if any)
+  if (!SeekToKeyframe(TimeStart))
+    ProcessToTime(TimeStart, true);
 
   // mark as enabled
   Enabled = true;
@@ -550,49 +589,53 @@ void CarlaReplayer::ProcessEventsAdd(void)
   for (i = 0; i < Total; ++i)
   {
     EventAdd.Read(File);
+    ProcessEventAdd(EventAdd);
+  }
+}
 
-    // auto Result = CallbackEventAdd(
-    auto Result = Helper.ProcessReplayerEventAdd(
-        EventAdd.Location,
-        EventAdd.Rotation,
-        EventAdd.Description,
-        EventAdd.DatabaseId,
-        IgnoreHero,
-        bReplaySensors);
-
-    switch (Result.first)
-    {
-      // actor not created
-      case 0:
-        UE_LOG(LogCarla, Log, TEXT("actor could not be created"));
-        break;
+void CarlaReplayer::ProcessEventAdd(const CarlaRecorderEventAdd &EventAdd)
+{
+  // auto Result = CallbackEventAdd(
+  auto Result = Helper.ProcessReplayerEventAdd(
+      EventAdd.Location,
+      EventAdd.Rotation,
+      EventAdd.Description,
+      EventAdd.DatabaseId,
+      IgnoreHero,
+      bReplaySensors);
+
+  switch (Result.first)
+  {
+    // actor not created
+    case 0:
+      UE_LOG(LogCarla, Log, TEXT("actor could not be created"));
+      break;
 
-      // actor created but with different id
-      case 1:
-        // mapping id (recorded Id is a new Id in replayer)
-        MappedId[EventAdd.DatabaseId] = Result.second;
-        break;
+    // actor created but with different id
+    case 1:
+      // mapping id (recorded Id is a new Id in replayer)
+      MappedId[EventAdd.DatabaseId] = Result.second;
+      break;
 
-      // actor reused from existing
-      case 2:
-        // mapping id (say desired Id is mapped to what)
-        MappedId[EventAdd.DatabaseId] = Result.second;
-        break;
-    }
+    // actor reused from existing
+    case 2:
+      // mapping id (say desired Id is mapped to what)
+      MappedId[EventAdd.DatabaseId] = Result.second;
+      break;
+  }
 
-    // check to mark if actor is a hero vehicle or not
-    if (Result.first > 0)
+  // check to mark if actor is a hero vehicle or not
+  if (Result.first > 0)
+  {
+    // init
+    IsHeroMap[Result.second] = false;
+    for (const auto &Item : EventAdd.Description.Attributes)
     {
-      // init
-      IsHeroMap[Result.second] = false;
-      for (const auto &Item : EventAdd.Description.Attributes)
+      if (Item.Id == "role_name" && Item.Value == "hero")
       {
-        if (Item.Id == "role_name" && Item.Value == "hero")
-        {
-          // mark as hero
-          IsHeroMap[Result.second] = true;
-          break;
-        }
+        // mark as hero
+        IsHeroMap[Result.second] = true;
+        break;
       }
     }
   }
@@ -904,9 +947,10 @@ void CarlaReplayer::Advance(const float Amnt)
   // forward in time (easy)
   else if (Amnt > 0) 
   {
-    /// TODO: verify that this correctly places all actors
-    // else can use the Restart+ProcessToTime hack similar to backwards
-    ProcessToTime(Amnt, false);
+    // jump to a keyframe when there is one between here and the destination
+    const CarlaRecorderKeyframe *Keyframe = FrameIndex.FindKeyframe(DesiredTime);
+    if (Keyframe == nullptr || Keyframe->Frame <= FrameIndex.FindFrame(CurrentTime) || !SeekToKeyframe(DesiredTime))
+      ProcessToTime(Amnt, false);
   }
   // backwards in time (harder)
   else
@@ -924,6 +968,9 @@ void CarlaReplayer::Advance(const float Amnt)
     // UE_LOG(LogTemp, Log, TEXT("Now the time is: %.3f"), Frame.Elapsed);
     // // back to negative
     // ProcessToTime(Amnt, false);
+    // restore the nearest keyframe before the destination if the recording has one
+    if (SeekToKeyframe(DesiredTime))
+      return;
     Stop(true); // stops the replaying while keeping actors (dosen't destroy & respawn)
     Restart();
     ProcessToTime(DesiredTime, true);
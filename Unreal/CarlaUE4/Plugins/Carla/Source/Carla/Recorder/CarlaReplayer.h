@@ -15,6 +15,7 @@
 #include <functional>
 #include "CarlaRecorderInfo.h"
 #include "CarlaRecorderFrames.h"
+#include "CarlaRecorderFrameIndex.h"
 #include "CarlaRecorderEventAdd.h"
 #include "CarlaRecorderEventDel.h"
 #include "CarlaRecorderEventParent.h"
@@ -116,10 +117,12 @@ private:
   bool Paused = false;
   UCarlaEpisode *Episode = nullptr;
   // binary file reader
-  std::ifstream File;
+  CarlaRecorderCursor File;
   Header Header;
   CarlaRecorderInfo RecInfo;
   CarlaRecorderFrame Frame;
+  // frame offsets and keyframes (to seek without parsing the whole file)
+  CarlaRecorderFrameIndex FrameIndex;
   // positions (to be able to interpolate)
   std::vector<CarlaRecorderPosition> CurrPos;
   std::vector<CarlaRecorderPosition> PrevPos;
@@ -152,6 +155,7 @@ private:
   void ProcessToTime(double Time, bool IsFirstTime = false);
 
   void ProcessEventsAdd(void);
+  void ProcessEventAdd(const CarlaRecorderEventAdd &EventAdd);
   void ProcessEventsDel(void);
   void ProcessEventsParent(void);
 
@@ -190,6 +194,9 @@ private:
   void GetFrameStartTimes();
   void ProcessFrameByFrame();
 
+  // restore the nearest keyframe before Time and process from there (false if there is none)
+  bool SeekToKeyframe(double Time);
+
   // positions
   void UpdatePositions(double Per, double DeltaTime);
 
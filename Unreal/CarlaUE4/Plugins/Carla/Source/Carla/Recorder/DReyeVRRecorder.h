@@ -16,11 +16,11 @@ template <typename T> struct DReyeVRDataRecorder
         Data = (*DataIn);
     }
     T Data;
-    void Read(std::ifstream &InFile)
+    void Read(CarlaRecorderCursor &InFile)
     {
         Data.Read(InFile);
     }
-    void Write(std::ofstream &OutFile) const
+    void Write(CarlaRecorderBuffer &OutFile) const
     {
         Data.Write(OutFile);
     }
@@ -49,11 +49,11 @@ template <typename T, uint8_t N> class DReyeVRDataRecorders
     {
         AllData.clear();
     }
-    void Write(std::ofstream &OutFile)
+    void Write(CarlaRecorderBuffer &OutFile)
     {
         // write the packet id
         WriteValue<char>(OutFile, static_cast<char>(PacketId));
-        std::streampos PosStart = OutFile.tellp();
+        const size_t PosStart = OutFile.Tell();
 
         // write a dummy packet size
         uint32_t Total = 0;
@@ -66,12 +66,9 @@ template <typename T, uint8_t N> class DReyeVRDataRecorders
         for (auto &Snapshot : AllData)
             Snapshot.Write(OutFile);
 
-        // write the real packet size
-        std::streampos PosEnd = OutFile.tellp();
-        Total = PosEnd - PosStart - sizeof(uint32_t);
-        OutFile.seekp(PosStart, std::ios::beg);
-        WriteValue<uint32_t>(OutFile, Total);
-        OutFile.seekp(PosEnd, std::ios::beg);
+        // write the real packet size (patched in the frame buffer, not on disk)
+        Total = OutFile.Tell() - PosStart - sizeof(uint32_t);
+        OutFile.Patch<uint32_t>(PosStart, Total);
     }
 
   private:
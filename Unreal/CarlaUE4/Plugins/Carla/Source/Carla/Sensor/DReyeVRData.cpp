@@ -8,14 +8,14 @@ namespace DReyeVR
 /// ----------------:EYEDATA:----------------- ///
 /// ========================================== ///
 
-void EyeData::Read(std::ifstream &InFile)
+void EyeData::Read(CarlaRecorderCursor &InFile)
 {
     ReadFVector(InFile, GazeDir);
     ReadFVector(InFile, GazeOrigin);
     ReadValue<bool>(InFile, GazeValid);
 }
 
-void EyeData::Write(std::ofstream &OutFile) const
+void EyeData::Write(CarlaRecorderBuffer &OutFile) const
 {
     WriteFVector(OutFile, GazeDir);
     WriteFVector(OutFile, GazeOrigin);
@@ -35,13 +35,13 @@ FString EyeData::ToString() const
 /// ------------:COMBINEDEYEDATA:------------- ///
 /// ========================================== ///
 
-void CombinedEyeData::Read(std::ifstream &InFile)
+void CombinedEyeData::Read(CarlaRecorderCursor &InFile)
 {
     EyeData::Read(InFile);
     ReadValue<float>(InFile, Vergence);
 }
 
-void CombinedEyeData::Write(std::ofstream &OutFile) const
+void CombinedEyeData::Write(CarlaRecorderBuffer &OutFile) const
 {
     EyeData::Write(OutFile);
     WriteValue<float>(OutFile, Vergence);
@@ -58,7 +58,7 @@ FString CombinedEyeData::ToString() const
 /// -------------:SINGLEEYEDATA:-------------- ///
 /// ========================================== ///
 
-void SingleEyeData::Read(std::ifstream &InFile)
+void SingleEyeData::Read(CarlaRecorderCursor &InFile)
 {
     EyeData::Read(InFile);
     ReadValue<float>(InFile, EyeOpenness);
@@ -68,7 +68,7 @@ void SingleEyeData::Read(std::ifstream &InFile)
     ReadValue<bool>(InFile, PupilPositionValid);
 }
 
-void SingleEyeData::Write(std::ofstream &OutFile) const
+void SingleEyeData::Write(CarlaRecorderBuffer &OutFile) const
 {
     EyeData::Write(OutFile);
     WriteValue<float>(OutFile, EyeOpenness);
@@ -93,7 +93,7 @@ FString SingleEyeData::ToString() const
 /// --------------:EGOVARIABLES:-------------- ///
 /// ========================================== ///
 
-void EgoVariables::Read(std::ifstream &InFile)
+void EgoVariables::Read(CarlaRecorderCursor &InFile)
 {
     ReadFVector(InFile, CameraLocation);
     ReadFRotator(InFile, CameraRotation);
@@ -104,7 +104,7 @@ void EgoVariables::Read(std::ifstream &InFile)
     ReadValue<float>(InFile, Velocity);
 }
 
-void EgoVariables::Write(std::ofstream &OutFile) const
+void EgoVariables::Write(CarlaRecorderBuffer &OutFile) const
 {
     WriteFVector(OutFile, CameraLocation);
     WriteFRotator(OutFile, CameraRotation);
@@ -132,7 +132,7 @@ FString EgoVariables::ToString() const
 /// --------------:USERINPUTS:---------------- ///
 /// ========================================== ///
 
-void UserInputs::Read(std::ifstream &InFile)
+void UserInputs::Read(CarlaRecorderCursor &InFile)
 {
     ReadValue<float>(InFile, Throttle);
     ReadValue<float>(InFile, Steering);
@@ -143,7 +143,7 @@ void UserInputs::Read(std::ifstream &InFile)
     ReadValue<bool>(InFile, HoldHandbrake);
 }
 
-void UserInputs::Write(std::ofstream &OutFile) const
+void UserInputs::Write(CarlaRecorderBuffer &OutFile) const
 {
     WriteValue<float>(OutFile, Throttle);
     WriteValue<float>(OutFile, Steering);
@@ -171,7 +171,7 @@ FString UserInputs::ToString() const
 /// ---------------:FOCUSINFO:---------------- ///
 /// ========================================== ///
 
-void FocusInfo::Read(std::ifstream &InFile)
+void FocusInfo::Read(CarlaRecorderCursor &InFile)
 {
     ReadFString(InFile, ActorNameTag);
     ReadValue<bool>(InFile, bDidHit);
@@ -180,7 +180,7 @@ void FocusInfo::Read(std::ifstream &InFile)
     ReadValue<float>(InFile, Distance);
 }
 
-void FocusInfo::Write(std::ofstream &OutFile) const
+void FocusInfo::Write(CarlaRecorderBuffer &OutFile) const
 {
     WriteFString(OutFile, ActorNameTag);
     WriteValue<bool>(OutFile, bDidHit);
@@ -204,7 +204,7 @@ FString FocusInfo::ToString() const
 /// ---------------:EYETRACKER:--------------- ///
 /// ========================================== ///
 
-void EyeTracker::Read(std::ifstream &InFile)
+void EyeTracker::Read(CarlaRecorderCursor &InFile)
 {
     ReadValue<int64_t>(InFile, TimestampDevice);
     ReadValue<int64_t>(InFile, FrameSequence);
@@ -213,7 +213,7 @@ void EyeTracker::Read(std::ifstream &InFile)
     Right.Read(InFile);
 }
 
-void EyeTracker::Write(std::ofstream &OutFile) const
+void EyeTracker::Write(CarlaRecorderBuffer &OutFile) const
 {
     WriteValue<int64_t>(OutFile, TimestampDevice);
     WriteValue<int64_t>(OutFile, FrameSequence);
@@ -242,12 +242,12 @@ void ConfigFileData::Set(const std::string &Contents)
     StringContents = FString(Contents.c_str());
 }
 
-void ConfigFileData::Read(std::ifstream &InFile)
+void ConfigFileData::Read(CarlaRecorderCursor &InFile)
 {
     ReadFString(InFile, StringContents);
 }
 
-void ConfigFileData::Write(std::ofstream &OutFile) const
+void ConfigFileData::Write(CarlaRecorderBuffer &OutFile) const
 {
     WriteFString(OutFile, StringContents);
 }
@@ -477,7 +477,7 @@ void AggregateData::Update(int64_t NewTimestamp, const struct EyeTracker &NewEye
     Inputs = NewInputs;
 }
 
-void AggregateData::Read(std::ifstream &InFile)
+void AggregateData::Read(CarlaRecorderCursor &InFile)
 {
     /// CAUTION: make sure the order of writes/reads is the same
     ReadValue<int64_t>(InFile, TimestampCarlaUE4);
@@ -487,7 +487,7 @@ void AggregateData::Read(std::ifstream &InFile)
     Inputs.Read(InFile);
 }
 
-void AggregateData::Write(std::ofstream &OutFile) const
+void AggregateData::Write(CarlaRecorderBuffer &OutFile) const
 {
     /// CAUTION: make sure the order of writes/reads is the same
     WriteValue<int64_t>(OutFile, GetTimestampCarla());
@@ -544,7 +544,7 @@ void CustomActorData::MaterialParamsStruct::Apply(class UMaterialInstanceDynamic
     }
 }
 
-void CustomActorData::MaterialParamsStruct::Read(std::ifstream &InFile)
+void CustomActorData::MaterialParamsStruct::Read(CarlaRecorderCursor &InFile)
 {
     ReadValue<float>(InFile, Metallic);
     ReadValue<float>(InFile, Specular);
@@ -556,7 +556,7 @@ void CustomActorData::MaterialParamsStruct::Read(std::ifstream &InFile)
     ReadFString(InFile, MaterialPath);
 }
 
-void CustomActorData::MaterialParamsStruct::Write(std::ofstream &OutFile) const
+void CustomActorData::MaterialParamsStruct::Write(CarlaRecorderBuffer &OutFile) const
 {
     WriteValue<float>(OutFile, Metallic);
     WriteValue<float>(OutFile, Specular);
@@ -589,7 +589,7 @@ FString CustomActorData::MaterialParamsStruct::ToString() const
     return Print;
 }
 
-void CustomActorData::Read(std::ifstream &InFile)
+void CustomActorData::Read(CarlaRecorderCursor &InFile)
 {
     // 9 dof
     ReadFVector(InFile, Location);
@@ -604,7 +604,7 @@ void CustomActorData::Read(std::ifstream &InFile)
     ReadFString(InFile, Name);
 }
 
-void CustomActorData::Write(std::ofstream &OutFile) const
+void CustomActorData::Write(CarlaRecorderBuffer &OutFile) const
 {
     // 9 dof
     WriteFVector(OutFile, Location);
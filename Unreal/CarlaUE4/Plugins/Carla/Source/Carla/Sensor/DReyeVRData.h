@@ -18,8 +18,8 @@ struct CARLA_API DataSerializer
     DataSerializer() = default;
     virtual ~DataSerializer() = default;
 
-    virtual void Read(std::ifstream &InFile) = 0;
-    virtual void Write(std::ofstream &OutFile) const = 0;
+    virtual void Read(CarlaRecorderCursor &InFile) = 0;
+    virtual void Write(CarlaRecorderBuffer &OutFile) const = 0;
     virtual FString ToString() const = 0;
 };
 
@@ -29,8 +29,8 @@ struct CARLA_API EyeData : public DataSerializer
     FVector GazeOrigin = FVector::ZeroVector;
     bool GazeValid = false;
 
-    void Read(std::ifstream &InFile) override;
-    void Write(std::ofstream &OutFile) const override;
+    void Read(CarlaRecorderCursor &InFile) override;
+    void Write(CarlaRecorderBuffer &OutFile) const override;
     FString ToString() const override;
 };
 
@@ -38,8 +38,8 @@ struct CARLA_API CombinedEyeData : EyeData
 {
     float Vergence = 0.f; // in cm (default UE4 units)
 
-    void Read(std::ifstream &InFile) override;
-    void Write(std::ofstream &OutFile) const override;
+    void Read(CarlaRecorderCursor &InFile) override;
+    void Write(CarlaRecorderBuffer &OutFile) const override;
     FString ToString() const override;
 };
 
@@ -51,8 +51,8 @@ struct CARLA_API SingleEyeData : EyeData
     FVector2D PupilPosition = FVector2D::ZeroVector;
     bool PupilPositionValid = false;
 
-    void Read(std::ifstream &InFile) override;
-    void Write(std::ofstream &OutFile) const override;
+    void Read(CarlaRecorderCursor &InFile) override;
+    void Write(CarlaRecorderBuffer &OutFile) const override;
     FString ToString() const override;
 };
 
@@ -70,8 +70,8 @@ struct CARLA_API EgoVariables : public DataSerializer
     // Ego variables
     float Velocity = 0.f; // note this is in cm/s (default UE4 units)
 
-    void Read(std::ifstream &InFile) override;
-    void Write(std::ofstream &OutFile) const override;
+    void Read(CarlaRecorderCursor &InFile) override;
+    void Write(CarlaRecorderBuffer &OutFile) const override;
     FString ToString() const override;
 };
 
@@ -87,8 +87,8 @@ struct CARLA_API UserInputs : public DataSerializer
     bool HoldHandbrake = false;
     // Add more inputs here!
 
-    void Read(std::ifstream &InFile) override;
-    void Write(std::ofstream &OutFile) const override;
+    void Read(CarlaRecorderCursor &InFile) override;
+    void Write(CarlaRecorderBuffer &OutFile) const override;
     FString ToString() const override;
 };
 
@@ -102,8 +102,8 @@ struct CARLA_API FocusInfo : public DataSerializer
     float Distance;
     bool bDidHit;
 
-    void Read(std::ifstream &InFile) override;
-    void Write(std::ofstream &OutFile) const override;
+    void Read(CarlaRecorderCursor &InFile) override;
+    void Write(CarlaRecorderBuffer &OutFile) const override;
     FString ToString() const override;
 };
 
@@ -115,8 +115,8 @@ struct CARLA_API EyeTracker : public DataSerializer
     SingleEyeData Left;
     SingleEyeData Right;
 
-    void Read(std::ifstream &InFile) override;
-    void Write(std::ofstream &OutFile) const override;
+    void Read(CarlaRecorderCursor &InFile) override;
+    void Write(CarlaRecorderBuffer &OutFile) const override;
     FString ToString() const override;
 };
 
@@ -140,8 +140,8 @@ class CARLA_API ConfigFileData : public DataSerializer
     FString StringContents; // all the config files, concatenated
   public:
     void Set(const std::string &Contents);
-    void Read(std::ifstream &InFile) override;
-    void Write(std::ofstream &OutFile) const override;
+    void Read(CarlaRecorderCursor &InFile) override;
+    void Write(CarlaRecorderBuffer &OutFile) const override;
     FString ToString() const override;
 };
 
@@ -188,8 +188,8 @@ class CARLA_API AggregateData : public DataSerializer
                 const struct FocusInfo &NewFocus, const struct UserInputs &NewInputs);
 
     ////////////////////:SERIALIZATION://////////////////////
-    void Read(std::ifstream &InFile) override;
-    void Write(std::ofstream &OutFile) const override;
+    void Read(CarlaRecorderCursor &InFile) override;
+    void Write(CarlaRecorderBuffer &OutFile) const override;
     FString ToString() const override;
 
   private:
@@ -226,8 +226,8 @@ class CARLA_API CustomActorData : public DataSerializer
         FString MaterialPath;
         void Apply(class UMaterialInstanceDynamic *Material) const;
 
-        void Read(std::ifstream &InFile) override;
-        void Write(std::ofstream &OutFile) const override;
+        void Read(CarlaRecorderCursor &InFile) override;
+        void Write(CarlaRecorderBuffer &OutFile) const override;
         FString ToString() const override;
     };
     MaterialParamsStruct MaterialParams;
@@ -236,8 +236,8 @@ class CARLA_API CustomActorData : public DataSerializer
 
     CustomActorData() = default;
 
-    void Read(std::ifstream &InFile) override;
-    void Write(std::ofstream &OutFile) const override;
+    void Read(CarlaRecorderCursor &InFile) override;
+    void Write(CarlaRecorderBuffer &OutFile) const override;
     FString ToString() const override;
     std::string GetUniqueName() const;
 };
@@ -12,18 +12,12 @@
 #include "carla/geom/Vector3D.h"
 #include "carla/sensor/s11n/DReyeVRSerializer.h" // DReyeVRSerializer::Data
 
-class DReyeVR::AggregateData *ADReyeVRSensor::Data = nullptr;
-class DReyeVR::ConfigFileData *ADReyeVRSensor::ConfigFile = nullptr;
 bool ADReyeVRSensor::bIsReplaying = false; // initially not replaying
 
 ADReyeVRSensor::ADReyeVRSensor(const FObjectInitializer &ObjectInitializer) : Super(ObjectInitializer)
 {
     // no need for any other initialization
     PrimaryActorTick.bCanEverTick = true;
-    if (ADReyeVRSensor::Data == nullptr)
-        ADReyeVRSensor::Data = new DReyeVR::AggregateData();
-    if (ADReyeVRSensor::ConfigFile == nullptr)
-        ADReyeVRSensor::ConfigFile = new DReyeVR::ConfigFileData();
 }
 
 FActorDefinition ADReyeVRSensor::GetSensorDefinition()
@@ -81,6 +75,7 @@ void ADReyeVRSensor::PostPhysTick(UWorld *W, ELevelTick TickType, float DeltaSec
     if (!this->bStreamData) // param for enabling or disabling the data streaming
         return;
     auto Stream = GetDataStream(*this);
+    const DataReader Data = GetData(); // the same snapshot for every field
 
     struct // overloaded lambdas to convert UE4 types to carla::geom types
     {
@@ -152,47 +147,47 @@ void ADReyeVRSensor::UpdateData(const DReyeVR::AggregateData &RecorderData, cons
 {
     // update global values
     ADReyeVRSensor::bIsReplaying = true; // Replay has started
-    if (ADReyeVRSensor::Data != nullptr)
+    // starts as a copy of the last published data, which is what we interpolate from
+    DReyeVR::AggregateData &Next = BeginDataUpdate();
+    // update local values but first interpolate camera and vehicle pose (Location & Rotation)
+    if (Per != 0.0)
     {
-        // update local values but first interpolate camera and vehicle pose (Location & Rotation)
-        if (Per != 0.0)
-        {
-            // interp Camera
-            FVector NewCameraLoc;
-            FRotator NewCameraRot;
-            InterpPositionAndRotation(ADReyeVRSensor::Data->GetCameraLocation(), // old location
-                                      ADReyeVRSensor::Data->GetCameraRotation(), // old rotation
-                                      RecorderData.GetCameraLocation(),          // new location
-                                      RecorderData.GetCameraRotation(),          // new rotation
-                                      Per, NewCameraLoc, NewCameraRot);
-            // interp Camera (absolute)
-            FVector NewCameraLocAbs;
-            FRotator NewCameraRotAbs;
-            InterpPositionAndRotation(ADReyeVRSensor::Data->GetCameraLocationAbs(), // old location
-                                      ADReyeVRSensor::Data->GetCameraRotationAbs(), // old rotation
-                                      RecorderData.GetCameraLocationAbs(),          // new location
-                                      RecorderData.GetCameraRotationAbs(),          // new rotation
-                                      Per, NewCameraLocAbs, NewCameraRotAbs);
-            // interp vehicle
-            FVector NewVehicleLoc;
-            FRotator NewVehicleRot;
-            InterpPositionAndRotation(ADReyeVRSensor::Data->GetVehicleLocation(), // old location
-                                      ADReyeVRSensor::Data->GetVehicleRotation(), // old rotation
-                                      RecorderData.GetVehicleLocation(),          // new location
-                                      RecorderData.GetVehicleRotation(),          // new rotation
-                                      Per, NewVehicleLoc, NewVehicleRot);
-            (*ADReyeVRSensor::Data) = RecorderData;
-            // update camera positions to the interpolated ones
-            ADReyeVRSensor::Data->UpdateCamera(NewCameraLoc, NewCameraRot);
-            ADReyeVRSensor::Data->UpdateCameraAbs(NewCameraLocAbs, NewCameraRotAbs);
-            ADReyeVRSensor::Data->UpdateVehicle(NewVehicleLoc, NewVehicleRot);
-        }
-        else
-        {
-            // assign updated DReyeVR data without interpolation
-            (*ADReyeVRSensor::Data) = RecorderData;
-        }
+        // interp Camera
+        FVector NewCameraLoc;
+        FRotator NewCameraRot;
+        InterpPositionAndRotation(Next.GetCameraLocation(),         // old location
+                                  Next.GetCameraRotation(),         // old rotation
+                                  RecorderData.GetCameraLocation(), // new location
+                                  RecorderData.GetCameraRotation(), // new rotation
+                                  Per, NewCameraLoc, NewCameraRot);
+        // interp Camera (absolute)
+        FVector NewCameraLocAbs;
+        FRotator NewCameraRotAbs;
+        InterpPositionAndRotation(Next.GetCameraLocationAbs(),         // old location
+                                  Next.GetCameraRotationAbs(),         // old rotation
+                                  RecorderData.GetCameraLocationAbs(), // new location
+                                  RecorderData.GetCameraRotationAbs(), // new rotation
+                                  Per, NewCameraLocAbs, NewCameraRotAbs);
+        // interp vehicle
+        FVector NewVehicleLoc;
+        FRotator NewVehicleRot;
+        InterpPositionAndRotation(Next.GetVehicleLocation(),         // old location
+                                  Next.GetVehicleRotation(),         // old rotation
+                                  RecorderData.GetVehicleLocation(), // new location
+                                  RecorderData.GetVehicleRotation(), // new rotation
+                                  Per, NewVehicleLoc, NewVehicleRot);
+        Next = RecorderData;
+        // update camera positions to the interpolated ones
+        Next.UpdateCamera(NewCameraLoc, NewCameraRot);
+        Next.UpdateCameraAbs(NewCameraLocAbs, NewCameraRotAbs);
+        Next.UpdateVehicle(NewVehicleLoc, NewVehicleRot);
+    }
+    else
+    {
+        // assign updated DReyeVR data without interpolation
+        Next = RecorderData;
     }
+    PublishData();
 }
 
 void ADReyeVRSensor::UpdateData(const class DReyeVR::ConfigFileData &RecorderData, const double Per)
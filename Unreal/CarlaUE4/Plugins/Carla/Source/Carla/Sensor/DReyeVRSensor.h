@@ -5,6 +5,7 @@
 #include "Carla/Game/CarlaEpisode.h"      // UCarlaEpisode
 #include "Carla/Sensor/Sensor.h"          // ASensor
 #include "DReyeVRData.h"                  // AggregateData, CustomActorData
+#include "DReyeVRSnapshot.h"              // SnapshotChannel
 #include <cstdint>                        // int64_t
 #include <string>
 #include <vector>
@@ -29,20 +30,25 @@ class CARLA_API ADReyeVRSensor : public ASensor
 
     virtual void PostPhysTick(UWorld *W, ELevelTick TickType, float DeltaSeconds) override;
 
-    // everything stored in the sensor is held in this struct
-    /// TODO: make this non-static and use a smarter scheme for cross-class communication
-    static class DReyeVR::AggregateData *Data;
-    static class DReyeVR::ConfigFileData *ConfigFile;
+    using DataReader = DReyeVR::SnapshotChannel<DReyeVR::AggregateData>::Reader;
 
-    class DReyeVR::AggregateData *GetData()
+    // latest AggregateData published by this sensor (once per tick), readable from any thread without locks
+    // (the recorder, the PythonAPI stream, the HUD...); the snapshot does not change while the reader is held
+    DataReader GetData() const
     {
-        return ADReyeVRSensor::Data;
+        return DataChannel.Read();
     }
 
-    const class DReyeVR::AggregateData *GetData() const
+    // number of AggregateData snapshots published so far
+    uint64_t GetDataSequence() const
     {
-        // read-only variant of GetData
-        return const_cast<const class DReyeVR::AggregateData *>(ADReyeVRSensor::Data);
+        return DataChannel.GetSequence();
+    }
+
+    // all the config files of this session (set once, when the EgoVehicle is assigned)
+    const class DReyeVR::ConfigFileData &GetConfigFile() const
+    {
+        return ConfigFile;
     }
 
     bool IsReplaying() const;
@@ -63,6 +69,21 @@ class CARLA_API ADReyeVRSensor : public ASensor
     void BeginPlay() override;
     void BeginDestroy() override;
 
+    // producer side (a single producer at a time): fill the slot returned by BeginDataUpdate (which starts as
+    // a copy of the latest snapshot) and make it visible to the readers with PublishData
+    class DReyeVR::AggregateData &BeginDataUpdate()
+    {
+        return DataChannel.BeginWrite();
+    }
+
+    void PublishData()
+    {
+        DataChannel.Publish();
+    }
+
+    DReyeVR::SnapshotChannel<DReyeVR::AggregateData> DataChannel;
+    class DReyeVR::ConfigFileData ConfigFile;
+
     class UWorld *World;
     static class UWorld *sWorld; // to get info about the world: time, frames, etc.
 
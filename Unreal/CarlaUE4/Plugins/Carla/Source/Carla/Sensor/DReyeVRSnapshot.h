@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>  // std::atomic
+#include <cstdint> // int32_t, uint64_t
+#include <thread>  // std::this_thread::yield
+#include <utility> // std::swap
+
+namespace DReyeVR
+{
+
+// Single-producer, multi-consumer channel for per-tick sensor data.
+//
+// The producer fills a free slot (BeginWrite, initialised with the latest snapshot so partial updates keep
+// the other fields) and makes it the latest one (Publish). Consumers on any thread pin the latest slot with
+// Read() and see a consistent snapshot for as long as they hold the returned handle, without taking locks.
+// A slot is only reused by the producer once it is neither the latest nor pinned by any reader, so as long
+// as fewer than NumSlots - 1 readers hold a snapshot at the same time the producer never waits either.
+template <typename T, int32_t NumSlots = 4> class SnapshotChannel
+{
+    static_assert(NumSlots >= 3, "need the latest slot, a slot being written and one for a reader");
+
+    struct alignas(64) Slot
+    {
+        T Value;
+        std::atomic<int32_t> Readers{0};
+    };
+
+  public:
+    class Reader
+    {
+      public:
+        Reader() = default;
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+        Reader(Reader &&Other)
+        {
+            std::swap(Pinned, Other.Pinned);
+        }
+        Reader &operator=(Reader &&Other)
+        {
+            std::swap(Pinned, Other.Pinned);
+            return *this;
+        }
+        ~Reader()
+        {
+            if (Pinned != nullptr)
+                Pinned->Readers.fetch_sub(1);
+        }
+
+        const T &operator*() const
+        {
+            return Pinned->Value;
+        }
+        const T *operator->() const
+        {
+            return &Pinned->Value;
+        }
+        const T *Get() const
+        {
+            return Pinned != nullptr ? &Pinned->Value : nullptr;
+        }
+
+      private:
+        friend class SnapshotChannel;
+        explicit Reader(Slot *InPinned) : Pinned(InPinned)
+        {
+        }
+        Slot *Pinned = nullptr;
+    };
+
+    SnapshotChannel() = default;
+    SnapshotChannel(const SnapshotChannel &) = delete;
+    SnapshotChannel &operator=(const SnapshotChannel &) = delete;
+
+    /// NOTE: only one producer may write at a time (BeginWrite ... Publish)
+    T &BeginWrite()
+    {
+        const int32_t Current = Latest.load();
+        for (;;)
+        {
+            for (int32_t i = 0; i < NumSlots; i++)
+            {
+                // readers pin a slot before checking it is still the latest, so a free slot stays free
+                if (i != Current && Slots[i].Readers.load() == 0)
+                {
+                    Writing = i;
+                    Slots[i].Value = Slots[Current].Value;
+                    return Slots[i].Value;
+                }
+            }
+            std::this_thread::yield(); // every other slot is pinned by a reader
+        }
+    }
+
+    void Publish()
+    {
+        if (Writing < 0)
+            return;
+        Latest.store(Writing);
+        Writing = -1;
+        Sequence.fetch_add(1);
+    }
+
+    Reader Read() const
+    {
+        for (;;)
+        {
+            const int32_t Current = Latest.load();
+            Slot &Pinned = Slots[Current];
+            Pinned.Readers.fetch_add(1);
+            // if the slot stopped being the latest in between, the producer may already be rewriting it
+            if (Latest.load() == Current)
+                return Reader(&Pinned);
+            Pinned.Readers.fetch_sub(1);
+        }
+    }
+
+    T Copy() const
+    {
+        return *Read();
+    }
+
+    // number of snapshots published so far
+    uint64_t GetSequence() const
+    {
+        return Sequence.load();
+    }
+
+  private:
+    mutable Slot Slots[NumSlots];
+    std::atomic<int32_t> Latest{0};
+    std::atomic<uint64_t> Sequence{0};
+    int32_t Writing = -1; // only used by the producer
+};
+
+} // namespace DReyeVR
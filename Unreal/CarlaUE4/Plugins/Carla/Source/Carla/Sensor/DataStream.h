@@ -50,6 +50,20 @@ public:
     return (*Stream).token();
   }
 
+  /// Return the number of clients that subscribed to this stream, it changes
+  /// whenever a new one subscribes.
+  uint64_t GetNumberOfConnections() const
+  {
+    return Stream.has_value() ? (*Stream).GetNumberOfConnections() : 0u;
+  }
+
+  /// Return the number of messages dropped by the sessions of this stream
+  /// since it was created.
+  uint64_t GetNumberOfDroppedMessages() const
+  {
+    return Stream.has_value() ? (*Stream).GetStatistics().dropped_messages : 0u;
+  }
+
 private:
 
   boost::optional<StreamType> Stream;
@@ -7,6 +7,7 @@
 #include "Carla.h"
 #include "Carla/Sensor/WorldObserver.h"
 #include "Carla/Actor/ActorData.h"
+#include "Carla/Game/CarlaEngine.h"
 
 #include "Carla/Traffic/TrafficLightBase.h"
 #include "Carla/Traffic/TrafficLightComponent.h"
@@ -18,6 +19,8 @@
 
 #include "CoreGlobals.h"
 
+#include <algorithm>
+
 #include <compiler/disable-ue4-macros.h>
 #include <carla/rpc/String.h>
 #include <carla/sensor/SensorRegistry.h>
@@ -259,8 +262,8 @@ static carla::geom::Vector3D FWorldObserver_GetAcceleration(
   return {Acceleration.X, Acceleration.Y, Acceleration.Z};
 }
 
-static carla::Buffer FWorldObserver_Serialize(
-    carla::Buffer &&buffer,
+static carla::sensor::s11n::EpisodeStateSerializer::Header FWorldObserver_CollectActors(
+    std::vector<carla::sensor::data::ActorDynamicState> &Actors,
     const UCarlaEpisode &Episode,
     float DeltaSeconds,
     bool MapChange,
@@ -274,20 +277,9 @@ static carla::Buffer FWorldObserver_Serialize(
 
   const FActorRegistry &Registry = Episode.GetActorRegistry();
 
-  auto total_size = sizeof(Serializer::Header) + sizeof(ActorDynamicState) * Registry.Num();
-  auto current_size = 0;
-  // Set up buffer for writing.
-  buffer.reset(total_size);
-  auto write_data = [&current_size, &buffer](const auto &data)
-  {
-    auto begin = buffer.begin() + current_size;
-    std::memcpy(begin, &data, sizeof(data));
-    current_size += sizeof(data);
-  };
-
   constexpr float TO_METERS = 1e-2;
 
-  // Write header.
+  // Header.
   Serializer::Header header;
   header.episode_id = Episode.GetId();
   header.platform_timestamp = FPlatformTime::Seconds();
@@ -301,9 +293,9 @@ static carla::Buffer FWorldObserver_Serialize(
 
   header.simulation_state = static_cast<SimulationState>(simulation_state);
 
-  write_data(header);
-
-  // Write every actor.
+  // Collect every actor.
+  Actors.clear();
+  Actors.reserve(Registry.Num());
   for (auto& It : Registry)
   {
     const FCarlaActor* View = It.Value.Get();
@@ -347,15 +339,19 @@ static carla::Buffer FWorldObserver_Serialize(
       Acceleration,
       State,
     };
-    write_data(info);
+    Actors.emplace_back(info);
   }
 
-  // Shrink buffer
-  buffer.resize(current_size);
-
-  check(buffer.size() == current_size);
+  // Sort the actors by id so clients can look them up without indexing them,
+  // and the encoder can compare them with the keyframe. The registry is
+  // almost always in id order already.
+  auto ById = [](const ActorDynamicState &Lhs, const ActorDynamicState &Rhs) { return Lhs.id < Rhs.id; };
+  if (!std::is_sorted(Actors.begin(), Actors.end(), ById))
+  {
+    std::sort(Actors.begin(), Actors.end(), ById);
+  }
 
-  return std::move(buffer);
+  return header;
 }
 
 void FWorldObserver::BroadcastTick(
@@ -367,12 +363,40 @@ void FWorldObserver::BroadcastTick(
   TRACE_CPUPROFILER_EVENT_SCOPE_STR(__FUNCTION__);
   auto AsyncStream = Stream.MakeAsyncDataStream(*this, Episode.GetElapsedGameTime());
 
-  carla::Buffer buffer = FWorldObserver_Serialize(
-      AsyncStream.PopBufferFromPool(),
+  const auto Header = FWorldObserver_CollectActors(
+      Actors,
       Episode,
       DeltaSecond,
       MapChange,
       PendingLightUpdates);
+  const uint64_t Frame = FCarlaEngine::GetFrameCounter();
 
+  // A client that subscribed since the last tick has no keyframe yet, and a
+  // dropped message may have been one.
+  const uint64_t Connections = Stream.GetNumberOfConnections();
+  const uint64_t DroppedMessages = Stream.GetNumberOfDroppedMessages();
+  if ((Connections != NumberOfConnections) || (DroppedMessages != NumberOfDroppedMessages))
+  {
+    NumberOfConnections = Connections;
+    NumberOfDroppedMessages = DroppedMessages;
+    Encoder.ForceKeyframe();
+  }
+
+  // Write the full state or the changes since the keyframe.
+  carla::Buffer buffer = AsyncStream.PopBufferFromPool();
+  Encoder.Encode(Frame, Header, Actors, buffer);
   AsyncStream.Send(*this, std::move(buffer));
+
+  // A client that subscribed while the tick was being written only got a
+  // delta it cannot apply, and in synchronous mode it waits for this very
+  // frame. Send the frame again in full.
+  if (Stream.GetNumberOfConnections() != NumberOfConnections)
+  {
+    NumberOfConnections = Stream.GetNumberOfConnections();
+    Encoder.ForceKeyframe();
+    auto KeyframeStream = Stream.MakeAsyncDataStream(*this, Episode.GetElapsedGameTime());
+    carla::Buffer Keyframe = KeyframeStream.PopBufferFromPool();
+    Encoder.Encode(Frame, Header, Actors, Keyframe);
+    KeyframeStream.Send(*this, std::move(Keyframe));
+  }
 }
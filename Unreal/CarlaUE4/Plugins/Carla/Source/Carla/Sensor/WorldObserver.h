@@ -8,6 +8,13 @@
 
 #include "Carla/Sensor/DataStream.h"
 
+#include <compiler/disable-ue4-macros.h>
+#include <carla/sensor/data/ActorDynamicState.h>
+#include <carla/sensor/s11n/EpisodeStateEncoder.h>
+#include <compiler/enable-ue4-macros.h>
+
+#include <vector>
+
 class UCarlaEpisode;
 
 /// Serializes and sends all the actors in the current UCarlaEpisode.
@@ -30,6 +37,13 @@ public:
     return Stream.GetToken();
   }
 
+  /// Ticks from one full world state to the next, the ticks in between only
+  /// send the actors that changed. 0 or 1 sends every tick in full.
+  void SetKeyframeInterval(uint32 Interval)
+  {
+    Encoder.SetKeyframeInterval(Interval);
+  }
+
   /// Send a message to every connected client with the info about the given @a
   /// Episode.
   void BroadcastTick(
@@ -47,4 +61,17 @@ public:
 private:
 
   FDataMultiStream Stream;
+
+  carla::sensor::s11n::EpisodeStateEncoder Encoder;
+
+  /// Connections to the stream seen at the last tick, a new client gets a
+  /// keyframe right away.
+  uint64_t NumberOfConnections = 0u;
+
+  /// Messages the stream dropped up to the last tick, a drop may have lost a
+  /// keyframe so the next tick is one.
+  uint64_t NumberOfDroppedMessages = 0u;
+
+  /// Reused every tick.
+  std::vector<carla::sensor::data::ActorDynamicState> Actors;
 };
@@ -59,6 +59,7 @@
 #include <carla/rpc/WalkerControl.h>
 #include <carla/rpc/VehicleWheels.h>
 #include <carla/rpc/WeatherParameters.h>
+#include <carla/streaming/SendQueue.h>
 #include <carla/streaming/Server.h>
 #include <carla/rpc/Texture.h>
 #include <carla/rpc/MaterialParameter.h>
@@ -526,6 +527,22 @@ void FCarlaServer::FPimpl::BindActions()
     return FCarlaEngine::GetFrameCounter();
   };
 
+  BIND_SYNC(get_streaming_statistics) << [this]() -> R<std::vector<carla::streaming::StreamStatistics>>
+  {
+    return StreamingServer.GetStreamStatistics();
+  };
+
+  BIND_SYNC(set_streaming_send_queue) << [this](
+      const carla::streaming::SendQueueSettings &settings) -> R<void>
+  {
+    if (settings.max_messages == 0u || settings.block_timeout < 0.0)
+    {
+      RESPOND_ERROR("invalid streaming send queue settings");
+    }
+    StreamingServer.SetSendQueue(settings);
+    return R<void>::Success();
+  };
+
   BIND_SYNC(get_actor_definitions) << [this]() -> R<std::vector<cr::ActorDefinition>>
   {
     REQUIRE_CARLA_EPISODE();
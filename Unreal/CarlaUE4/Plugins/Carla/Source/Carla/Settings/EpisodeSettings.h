@@ -37,4 +37,6 @@ struct CARLA_API FEpisodeSettings
 
   float ActorActiveDistance = 200000.f; // 3km
 
+  uint32 WorldStateKeyframeInterval = 0u;
+
 };
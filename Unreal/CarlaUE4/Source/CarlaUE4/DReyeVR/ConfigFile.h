@@ -1,9 +1,16 @@
 #pragma once
-#include <fstream> // std::ifstream
-#include <istream> // std::istream
-#include <sstream> // std::istringstream
+#include "HAL/FileManager.h" // IFileManager (file timestamps for hot-reload)
+#include <atomic>     // std::atomic
+#include <fstream>    // std::ifstream
+#include <functional> // std::function
+#include <istream>    // std::istream
+#include <memory>     // std::unique_ptr
+#include <sstream>    // std::istringstream
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+template <typename T> class ConfigParam; // typed handle to a bound (section, variable) pair, defined below
 
 const static FString CarlaUE4Path = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
 
@@ -12,7 +19,6 @@ struct ConfigFile
     ConfigFile() = default; // empty constructor (no params yet)
     ConfigFile(const FString &Path, bool bVerbose = true) : FilePath(Path)
     {
-        /// TODO: add feature to "hot-reload" new params during runtime
         bSuccessfulUpdate = ReadFile(bVerbose); // ensures all the variables are updated upon construction
 
         // simple sanity check to ensure exporting and importing the same config file works as intended
@@ -21,6 +27,69 @@ struct ConfigFile
         ensureMsgf(bSanityCheck, TEXT("Sanity check for ConfigFile import/export failed!"));
     }
 
+    // copies take the params but not the bindings (handles stay tied to the ConfigFile that created them)
+    ConfigFile(const ConfigFile &Other)
+        : FilePath(Other.FilePath), FileTimestamp(Other.FileTimestamp), bSuccessfulUpdate(Other.bSuccessfulUpdate),
+          Sections(Other.Sections)
+    {
+    }
+
+    ConfigFile &operator=(const ConfigFile &Other)
+    {
+        if (this != &Other)
+        {
+            FilePath = Other.FilePath;
+            FileTimestamp = Other.FileTimestamp;
+            bSuccessfulUpdate = Other.bSuccessfulUpdate;
+            Sections = Other.Sections;
+            Publish(); // handles bound to this ConfigFile now see the new values
+        }
+        return *this;
+    }
+
+    /// Bind a (section, variable) pair once and get a typed handle to its parsed value.
+    /// Reading the handle is a single atomic load with no string hashing or parsing, so it is meant for the
+    /// per-frame/per-sample code paths. Handles keep following this ConfigFile across Reload().
+    /// Binding the same pair and type again returns the existing handle (and ignores the new default).
+    /// A new handle can only be read after PublishBindings(), so bind everything at start-up and publish once.
+    /// Binding, publishing and reloading must happen on the game thread, handles can be read from any thread.
+    template <typename T> ConfigParam<T> Bind(const FString &Section, const FString &Variable, const T &Default = T());
+
+    // make the handles bound since the last publish readable (no-op if there are none)
+    void PublishBindings()
+    {
+        if (Compiled->Bindings.size() != Compiled->NumPublished)
+            Publish();
+    }
+
+    // re-read the file from disk and publish the new values to every bound handle (keeps the old values on failure)
+    bool Reload(bool bVerbose = false)
+    {
+        if (FilePath.IsEmpty() || FilePath.Contains(";")) // imported or merged (Insert) configs have no single file
+            return false;
+        ConfigFile Fresh(FilePath, bVerbose);
+        if (!Fresh.bIsValid())
+            return false;
+        Sections = std::move(Fresh.Sections);
+        FileTimestamp = Fresh.FileTimestamp;
+        bSuccessfulUpdate = true;
+        Publish();
+        return true;
+    }
+
+    // cheap check (file timestamp) for the "hot-reload" of params edited during runtime
+    bool ReloadIfModified()
+    {
+        if (FilePath.IsEmpty() || FilePath.Contains(";"))
+            return false;
+        const FDateTime Timestamp = IFileManager::Get().GetTimeStamp(*FilePath);
+        if (Timestamp == FDateTime::MinValue() || Timestamp == FileTimestamp)
+            return false;
+        LOG("Detected changes in %s, reloading", *FilePath);
+        return Reload();
+    }
+
+    // Get parses the raw sections (replaced on Reload) so it is game-thread only, other threads use bound handles
     template <typename T> bool Get(const FString &Section, const FString &Variable, T &Value) const
     {
         const std::string SectionStdStr(TCHAR_TO_UTF8(*Section));
@@ -176,6 +245,7 @@ struct ConfigFile
         {
             LOG("Reading config from %s", *FilePath);
         }
+        FileTimestamp = IFileManager::Get().GetTimeStamp(*FilePath);
         std::ifstream MatchingFile(TCHAR_TO_ANSI(*FilePath), std::ios::in);
         if (MatchingFile)
         {
@@ -325,11 +395,137 @@ struct ConfigFile
         return true; // found successfully!
     }
 
+  private:
+    // compiled (pre-parsed) values of all the bound params, republished as a whole on every reload
+    struct CompiledValue
+    {
+        virtual ~CompiledValue() = default;
+    };
+    template <typename T> struct TypedValue : CompiledValue
+    {
+        TypedValue(const T &InValue) : Value(InValue)
+        {
+        }
+        const T Value;
+    };
+    struct CompiledSnapshot
+    {
+        std::vector<std::unique_ptr<CompiledValue>> Values; // indexed by ConfigParam::Index
+    };
+    struct Binding
+    {
+        std::string Section, Variable;
+        const void *Type; // TypeTag<T>(), so the same pair bound as another type gets its own slot
+        std::function<std::unique_ptr<CompiledValue>(const ConfigFile &)> Compile;
+    };
+    struct CompiledParams
+    {
+        std::vector<Binding> Bindings;
+        size_t NumPublished = 0; // bindings covered by the active snapshot
+        std::unique_ptr<const CompiledSnapshot> Current;
+        // readers may still hold references into a replaced snapshot, so it lives as long as the ConfigFile
+        // (one small snapshot per reload or publish, and those only happen when the file is edited or at start-up)
+        std::vector<std::unique_ptr<const CompiledSnapshot>> Retired;
+        std::atomic<const CompiledSnapshot *> Active{nullptr};
+    };
+    template <typename T> friend class ConfigParam;
+
+    template <typename T> static const void *TypeTag()
+    {
+        static const char Tag = 0;
+        return &Tag;
+    }
+
+    void Publish()
+    {
+        if (Compiled->Bindings.empty())
+            return;
+        auto Snapshot = std::make_unique<CompiledSnapshot>();
+        Snapshot->Values.reserve(Compiled->Bindings.size());
+        for (const Binding &Bound : Compiled->Bindings)
+            Snapshot->Values.push_back(Bound.Compile(*this));
+        Compiled->Active.store(Snapshot.get(), std::memory_order_release);
+        Compiled->NumPublished = Compiled->Bindings.size();
+        if (Compiled->Current != nullptr)
+            Compiled->Retired.push_back(std::move(Compiled->Current));
+        Compiled->Current = std::move(Snapshot);
+    }
+
   private:
     FString FilePath; // const except for overwrite
+    FDateTime FileTimestamp = FDateTime::MinValue(); // modification time of FilePath when it was last read
     bool bSuccessfulUpdate = false;
     std::unordered_map<std::string, IniSection> Sections;
+    std::unique_ptr<CompiledParams> Compiled = std::make_unique<CompiledParams>(); // stable address for the handles
 };
 
-static ConfigFile GeneralParams(FPaths::Combine(CarlaUE4Path, TEXT("Config/DReyeVRConfig.ini")));
-static ConfigFile ExperimentParams(FPaths::Combine(CarlaUE4Path, TEXT("Config/ExperimentConfig.ini")));
\ No newline at end of file
+template <typename T> class ConfigParam
+{
+  public:
+    ConfigParam() = default; // unbound, needs to be assigned from ConfigFile::Bind before use
+
+    // the reference stays valid (with the value it had when read) as long as the bound ConfigFile, even across reloads
+    const T &Get() const
+    {
+        check(Params != nullptr);
+        const auto *Snapshot = Params->Active.load(std::memory_order_acquire);
+        checkf(Snapshot != nullptr && Index < Snapshot->Values.size(), TEXT("ConfigParam read before PublishBindings()"));
+        return static_cast<const ConfigFile::TypedValue<T> &>(*Snapshot->Values[Index]).Value;
+    }
+
+    operator const T &() const
+    {
+        return Get();
+    }
+
+    bool IsBound() const
+    {
+        return Params != nullptr;
+    }
+
+  private:
+    friend struct ConfigFile;
+    ConfigParam(const ConfigFile::CompiledParams *InParams, size_t InIndex) : Params(InParams), Index(InIndex)
+    {
+    }
+    const ConfigFile::CompiledParams *Params = nullptr;
+    size_t Index = 0;
+};
+
+template <typename T>
+ConfigParam<T> ConfigFile::Bind(const FString &Section, const FString &Variable, const T &Default)
+{
+    const std::string SectionStdStr(TCHAR_TO_UTF8(*Section));
+    const std::string VariableStdStr(TCHAR_TO_UTF8(*Variable));
+    for (size_t i = 0; i < Compiled->Bindings.size(); i++)
+    {
+        const Binding &Bound = Compiled->Bindings[i];
+        if (Bound.Type == TypeTag<T>() && Bound.Section == SectionStdStr && Bound.Variable == VariableStdStr)
+            return ConfigParam<T>(Compiled.get(), i);
+    }
+    auto Compile = [SectionStdStr, VariableStdStr, Default](const ConfigFile &Config) {
+        T Value = Default; // missing entries (logged by Find) fall back to the default
+        Config.GetValue(SectionStdStr, VariableStdStr, Value);
+        return std::unique_ptr<CompiledValue>(new TypedValue<T>(Value));
+    };
+    Compiled->Bindings.push_back({SectionStdStr, VariableStdStr, TypeTag<T>(), Compile});
+    return ConfigParam<T>(Compiled.get(), Compiled->Bindings.size() - 1);
+}
+
+// One instance per file shared by every translation unit (so a reload is seen everywhere)
+inline ConfigFile &GetGeneralParams()
+{
+    static ConfigFile Params(
+        FPaths::Combine(FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()), TEXT("Config/DReyeVRConfig.ini")));
+    return Params;
+}
+
+inline ConfigFile &GetExperimentParams()
+{
+    static ConfigFile Params(
+        FPaths::Combine(FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()), TEXT("Config/ExperimentConfig.ini")));
+    return Params;
+}
+
+static ConfigFile &GeneralParams = GetGeneralParams();
+static ConfigFile &ExperimentParams = GetExperimentParams();
\ No newline at end of file
@@ -58,6 +58,7 @@ ADReyeVRGameMode::ADReyeVRGameMode(FObjectInitializer const &FO) : Super(FO)
     AmbientVolumePercent = GeneralParams.Get<float>("Sound", "AmbientVolumePercent");
     bDoSpawnEgoVehicleTransform = GeneralParams.Get<bool>("Game", "DoSpawnEgoVehicleTransform");
     SpawnEgoVehicleTransform = GeneralParams.Get<FTransform>("Game", "SpawnEgoVehicleTransform");
+    GeneralParams.Get("Game", "ConfigHotReloadInterval", ConfigHotReloadInterval);
 
     // Recorder/replayer
     bUseCarlaSpectator = GeneralParams.Get<bool>("Replayer", "UseCarlaSpectator");
@@ -287,6 +288,15 @@ void ADReyeVRGameMode::Tick(float DeltaSeconds)
     }
 
     DrawBBoxes();
+
+    // pick up edits to the config files (bound ConfigParam handles see the new values on the next read)
+    const double Now = FPlatformTime::Seconds();
+    if (ConfigHotReloadInterval > 0.f && Now - LastConfigReloadCheck >= ConfigHotReloadInterval)
+    {
+        LastConfigReloadCheck = Now;
+        GeneralParams.ReloadIfModified();
+        ExperimentParams.ReloadIfModified();
+    }
 }
 
 void ADReyeVRGameMode::SetupPlayerInputComponent()
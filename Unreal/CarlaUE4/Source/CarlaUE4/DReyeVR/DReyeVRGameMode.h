@@ -86,6 +86,10 @@ class ADReyeVRGameMode : public ACarlaGameModeBase
     bool bDoSpawnEgoVehicleTransform = false; // whether or not to use provided SpawnEgoVehicleTransform
     FTransform SpawnEgoVehicleTransform;
 
+    // for hot-reloading the config files
+    float ConfigHotReloadInterval = 1.f; // seconds between file timestamp checks (<= 0 disables)
+    double LastConfigReloadCheck = 0.0;
+
     // for recorder/replayer params
     const double AmntPlaybackIncr = 0.25; // how much the playback speed changes (multiplicative, ex: 1x + 0.1 = 1.1x)
     double ReplayTimeFactor = 1.0;        // same as CarlaReplayer.h::TimeFactor (but local)
@@ -23,9 +23,6 @@ ADReyeVRPawn::ADReyeVRPawn(const FObjectInitializer &ObjectInitializer) : Super(
     // spawn and construct the first person camera
     ConstructCamera();
 
-    // Inializing logging operator
-    //Logger = new DataLogger(); // This is now being handled by client side
-
     // log
     LOG("Spawning DReyeVR pawn for player0");
 }
@@ -53,6 +50,7 @@ void ADReyeVRPawn::ReadConfigVariables()
     // wheel hardware
     GeneralParams.Get("Hardware", "DeviceIdx", WheelDeviceIdx);
     GeneralParams.Get("Hardware", "LogUpdates", bLogLogitechWheel);
+    GeneralParams.Get("Hardware", "LogTrialData", bLogTrialData);
     GeneralParams.Get("Hardware", "ForceFeedbackMagnitude", SaturationPercentage);
     GeneralParams.Get("Hardware", "DeltaInputThreshold", LogiThresh);
 }
@@ -77,6 +75,10 @@ void ADReyeVRPawn::BeginPlay()
     World = GetWorld();
     ensure(World != nullptr);
     FirstPersonCam->RegisterComponentWithWorld(World);
+
+    // the logger owns a writer thread, so it is only created for spawned pawns (not the CDO)
+    if (bLogTrialData)
+        Logger = MakeUnique<DataLogger>();
 }
 
 void ADReyeVRPawn::BeginPlayer(APlayerController *PlayerIn)
@@ -109,6 +111,9 @@ void ADReyeVRPawn::BeginDestroy()
     if (bIsLogiConnected)
         DestroyLogiWheel(false);
 
+    // drains the trials that were already handed to the writer thread
+    Logger.Reset();
+
     LOG("DReyeVRPawn has been destroyed");
 }
 
@@ -305,8 +310,7 @@ void ADReyeVRPawn::DrawFlatHUD(float DeltaSeconds)
     FIntPoint ViewSize;
     Player->GetViewportSize(ViewSize.X, ViewSize.Y);
 
-    const auto *SensorData = EgoVehicle->GetSensor()->GetData();
-    check(SensorData != nullptr);
+    const ADReyeVRSensor::DataReader SensorData = EgoVehicle->GetSensor()->GetData();
 
     // Draw elements of the HUD
     if (bDrawFlatReticle) // Draw reticle on flat-screen HUD
@@ -500,6 +504,8 @@ void ADReyeVRPawn::LogitechWheelUpdate()
     ensure(WheelState != nullptr);
     if (bLogLogitechWheel)
         LogLogitechPluginStruct(WheelState);
+    if (Logger)
+        TickTrialLogger(*WheelState);
     /// NOTE: obtained these from LogitechWheelInputDevice.cpp:~111
     // -32768 to 32767. -32768 = all the way to the left. 32767 = all the way to the right.
     const float WheelRotation = FMath::Clamp(float(WheelState->lX), -32767.0f, 32767.0f) / 32767.0f; // (-1, 1)
@@ -554,6 +560,36 @@ void ADReyeVRPawn::LogitechWheelUpdate()
     ManageButtonPresses(*WheelState);
 }
 
+void ADReyeVRPawn::TickTrialLogger(const DIJOYSTATE2 &WheelState)
+{
+    // a trial is one take-over request: from the TOR being issued until the driver leaves TakeOverManual
+    const AEgoVehicle::VehicleStatus Status = EgoVehicle->GetCurrVehicleStatus();
+    const bool bInTOR = (Status == AEgoVehicle::VehicleStatus::TakeOver ||
+                         Status == AEgoVehicle::VehicleStatus::TakeOverManual);
+    if (bInTOR && !bInLoggedTOR)
+    {
+        Logger->EraseData(); // nothing before the TOR belongs to this trial
+        TORIssuanceTime = FDateTime::Now();
+        bInLoggedTOR = true;
+        // if the status jumped straight to TakeOverManual there was no request to react to
+        bTORTakenOver = (Status == AEgoVehicle::VehicleStatus::TakeOverManual);
+    }
+    if (!bInLoggedTOR)
+        return;
+    if (!bInTOR)
+    {
+        Logger->WriteData(); // hands the trial off to the writer thread
+        bInLoggedTOR = false;
+        return;
+    }
+    if (Status == AEgoVehicle::VehicleStatus::TakeOverManual && !bTORTakenOver)
+    {
+        Logger->LogReactionTime(TORIssuanceTime);
+        bTORTakenOver = true;
+    }
+    Logger->LogLogitechData(&WheelState);
+}
+
 void ADReyeVRPawn::ManageButtonPresses(const DIJOYSTATE2 &WheelState)
 {
     const bool bABXY_A = static_cast<bool>(WheelState.rgbButtons[0]);
@@ -136,6 +136,7 @@ class ADReyeVRPawn : public APawn
     void LogitechWheelUpdate();                              // for logitech wheel integration
     void ManageButtonPresses(const DIJOYSTATE2 &WheelState); // for managing button presses
     void ApplyForceFeedback() const;                         // for logitech wheel integration
+    void TickTrialLogger(const DIJOYSTATE2 &WheelState);     // log the wheel & pedals during take-over requests
     float WheelRotationLast, AccelerationPedalLast, BrakePedalLast;
 #endif
     bool bIsLogiConnected = false; // check if Logi device is connected (on BeginPlay)
@@ -147,5 +148,9 @@ class ADReyeVRPawn : public APawn
 
 private:
     ////////////////:LOGGING:////////////////
-    //DataLogger *Logger; // DataLogger Object to run logging operations; now handled by client side
+    TUniquePtr<DataLogger> Logger; // only created (on BeginPlay) when [Hardware] LogTrialData is enabled
+    bool bLogTrialData = false;
+    bool bInLoggedTOR = false;     // a take-over request is being logged
+    bool bTORTakenOver = false;    // the reaction time of the current take-over request was logged
+    FDateTime TORIssuanceTime;
 };
@@ -4,6 +4,192 @@
 
 #include "DReyeVRUtils.h"
 #include "DataLogger.h"
+#include "HAL/Event.h"              // FEvent
+#include "HAL/PlatformProcess.h"    // GetSynchEventFromPool
+#include "HAL/RunnableThread.h"     // FRunnableThread
+#include "Serialization/MemoryReader.h" // FMemoryReader
+
+namespace
+{
+	// "DRLG" in little endian, followed by a format version (bump when the chunk layout changes)
+	constexpr uint32 TrialFileMagic = 0x474C5244;
+	constexpr uint32 TrialFileVersion = 1;
+
+	template <typename T> void SerializeColumn(FArchive &Ar, TArray<T> &Column, int32 Num)
+	{
+		// columns are stored raw (no per-element framing), their length is the chunk's row count
+		if (Ar.IsLoading())
+		{
+			Column.SetNumUninitialized(Num);
+		}
+		check(Column.Num() >= Num);
+		Ar.Serialize(Column.GetData(), Num * sizeof(T));
+	}
+}
+
+/// ========================================== ///
+/// ---------------:BLOCKS:------------------- ///
+/// ========================================== ///
+
+FDataLoggerBlock::FDataLoggerBlock()
+{
+	TimestampTicks.Reserve(Capacity);
+	SteeringWheelAngles.Reserve(Capacity);
+	SteeringWheelVelocities.Reserve(Capacity);
+	AccelerationInputs.Reserve(Capacity);
+	BrakingInputs.Reserve(Capacity);
+}
+
+void FDataLoggerBlock::Reset()
+{
+	TimestampTicks.Reset();
+	SteeringWheelAngles.Reset();
+	SteeringWheelVelocities.Reset();
+	AccelerationInputs.Reset();
+	BrakingInputs.Reset();
+}
+
+/// ========================================== ///
+/// ---------------:WRITER:------------------- ///
+/// ========================================== ///
+
+DataLogger::FWriter::FWriter(const FString &InFilePath) : FilePath(InFilePath)
+{
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	// low priority, this thread only ever waits on the disk
+	Thread = FRunnableThread::Create(this, TEXT("DataLoggerWriter"), 0, TPri_BelowNormal);
+}
+
+DataLogger::FWriter::~FWriter()
+{
+	if (Thread != nullptr)
+	{
+		Stop();
+		Thread->WaitForCompletion(); // Run() drains whatever is left in the queue before returning
+		delete Thread;
+		Thread = nullptr;
+	}
+	FDataLoggerBlock *Block;
+	while (FreeBlocks.Dequeue(Block))
+	{
+		delete Block;
+	}
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+void DataLogger::FWriter::Stop()
+{
+	bStop = true;
+	WakeEvent->Trigger();
+}
+
+void DataLogger::FWriter::Enqueue(const FDataLoggerChunk &Chunk)
+{
+	NumQueued.Increment();
+	Chunks.Enqueue(Chunk);
+	WakeEvent->Trigger();
+}
+
+FDataLoggerBlock *DataLogger::FWriter::AcquireBlock()
+{
+	FDataLoggerBlock *Block = nullptr;
+	if (FreeBlocks.Dequeue(Block))
+	{
+		return Block;
+	}
+	return new FDataLoggerBlock(); // only happens while the pool is warming up
+}
+
+void DataLogger::FWriter::Flush()
+{
+	while (NumQueued.GetValue() > 0)
+	{
+		WakeEvent->Trigger();
+		FPlatformProcess::Sleep(0.001f);
+	}
+}
+
+uint32 DataLogger::FWriter::Run()
+{
+	while (true)
+	{
+		const bool bShouldStop = bStop;
+		if (!Chunks.IsEmpty())
+		{
+			// append everything that is queued in one open/close of the file
+			TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*FilePath, EFileWrite::FILEWRITE_Append));
+			if (!Ar)
+			{
+				UE_LOG(LogTemp, Error, TEXT("Failed to open the trial data file: %s"), *FilePath);
+			}
+			FDataLoggerChunk Chunk;
+			while (Chunks.Dequeue(Chunk))
+			{
+				if (Ar && !Chunk.bDiscard)
+				{
+					WriteChunk(Chunk, *Ar);
+				}
+				Chunk.Block->Reset();
+				FreeBlocks.Enqueue(Chunk.Block);
+				NumQueued.Decrement();
+			}
+		}
+		if (bShouldStop)
+		{
+			break;
+		}
+		WakeEvent->Wait();
+	}
+	return 0;
+}
+
+void DataLogger::FWriter::WriteChunk(const FDataLoggerChunk &Chunk, FArchive &Ar) const
+{
+	// [Magic, Version, HeaderRow, ReactionTime, bIsFinalChunk, NumRows, Ticks[], Angles[], Velocities[], Accel[], Brake[]]
+	uint32 Magic = TrialFileMagic;
+	uint32 Version = TrialFileVersion;
+	TArray<FString> HeaderRow = Chunk.HeaderRow;
+	float RT = Chunk.ReactionTime;
+	uint8 bIsFinal = Chunk.bIsFinalChunk ? 1 : 0;
+	FDataLoggerBlock &Block = *Chunk.Block;
+	int32 NumRows = Block.Num();
+	Ar << Magic << Version << HeaderRow << RT << bIsFinal << NumRows;
+	SerializeColumn(Ar, Block.TimestampTicks, NumRows);
+	SerializeColumn(Ar, Block.SteeringWheelAngles, NumRows);
+	SerializeColumn(Ar, Block.SteeringWheelVelocities, NumRows);
+	SerializeColumn(Ar, Block.AccelerationInputs, NumRows);
+	SerializeColumn(Ar, Block.BrakingInputs, NumRows);
+}
+
+/// ========================================== ///
+/// ---------------:LOGGER:------------------- ///
+/// ========================================== ///
+
+DataLogger::DataLogger()
+{
+	Writer = MakeUnique<FWriter>(DefaultBinaryFilePath());
+	ActiveBlock = Writer->AcquireBlock();
+}
+
+DataLogger::~DataLogger()
+{
+	// anything not handed off through WriteData belongs to an unfinished trial and is discarded
+	for (FDataLoggerBlock *Block : PendingBlocks)
+	{
+		delete Block;
+	}
+	PendingBlocks.Empty();
+	delete ActiveBlock;
+	ActiveBlock = nullptr;
+	Writer->Flush();
+	Writer.Reset();
+}
+
+FString DataLogger::DefaultBinaryFilePath()
+{
+	return FPaths::Combine(CarlaUE4Path, TEXT("LoggedData/TrialData.bin"));
+}
 
 /* Have to seperately define a method for reaction time as it has to be as precise as possible */
 
@@ -23,37 +209,57 @@ void DataLogger::LogLogitechData(const struct DIJOYSTATE2* WheelState)
 	const float AccelerationPedal = fabs(((WheelState->lY - 32767.0f) / (65535.0f))); // (0, 1)
 	// -32768 to 32767. Higher value = less pressure on brake pedal
 	const float BrakePedal = fabs(((WheelState->lRz - 32767.0f) / (65535.0f))); // (0, 1)
+	const int64 Ticks = FDateTime::Now().GetTicks();
 
-	// Appending the values into the data arrays
-	Timestamps.Add(FDateTime::Now());
-	SteeringWheelAngles.Add(FString::Printf(TEXT("%f"), WheelRotation));
-	AccelerationInputs.Add(FString::Printf(TEXT("%f"), AccelerationPedal));
-	BrakingInputs.Add(FString::Printf(TEXT("%f"), BrakePedal));
-	if (Timestamps.Num() == 1)
+	// Wheel velocity (rad/s) from the previous raw sample, undefined for the first sample of a trial
+	float WheelVelocity = NAN;
+	if (bHasLastSample && Ticks != LastTicks)
 	{
-		SteeringWheelVelocities.Add("");
+		const float DeltaDegree = WheelRotation - LastWheelRotation;
+		const double DeltaTime = FTimespan(Ticks - LastTicks).GetTotalSeconds();
+		WheelVelocity = DeltaDegree * (M_PI / 180) / DeltaTime;
 	}
-	else {
-		float DeltaDegree = FCString::Atof(*SteeringWheelAngles[SteeringWheelAngles.Num() - 1]) - FCString::Atof(*SteeringWheelAngles[SteeringWheelAngles.Num() - 2]);
-		float DeltaTime = (Timestamps[Timestamps.Num() - 1] - Timestamps[Timestamps.Num() - 2]).GetTotalSeconds();
-		SteeringWheelVelocities.Add(FString::Printf(TEXT("%f"), (DeltaDegree * (M_PI / 180) / DeltaTime)));
+	LastTicks = Ticks;
+	LastWheelRotation = WheelRotation;
+	bHasLastSample = true;
+
+	// Appending the values into the (preallocated) columns
+	check(ActiveBlock != nullptr);
+	ActiveBlock->TimestampTicks.Add(Ticks);
+	ActiveBlock->SteeringWheelAngles.Add(WheelRotation);
+	ActiveBlock->SteeringWheelVelocities.Add(WheelVelocity);
+	ActiveBlock->AccelerationInputs.Add(AccelerationPedal);
+	ActiveBlock->BrakingInputs.Add(BrakePedal);
+	if (ActiveBlock->IsFull())
+	{
+		HandOffActiveBlock();
 	}
+}
 
-	// Check for data frequency synchrony
-	check(Timestamps.Num() == SteeringWheelAngles.Num() == SteeringWheelVelocities.Num() == AccelerationInputs.Num() == BrakingInputs.Num());
+void DataLogger::HandOffActiveBlock()
+{
+	PendingBlocks.Add(ActiveBlock);
+	ActiveBlock = Writer->AcquireBlock();
 }
 
 void DataLogger::EraseData()
 {
 	// Erase all the data (most likely for the next trial)
 	ReactionTime = -1.0f;
-	SteeringWheelAngles.Empty();
-	SteeringWheelVelocities.Empty();
-	AccelerationInputs.Empty();
-	BrakingInputs.Empty();
+	bHasLastSample = false;
+	ActiveBlock->Reset();
+	for (FDataLoggerBlock *Block : PendingBlocks)
+	{
+		// not written, give the block back through the writer so it is recycled
+		FDataLoggerChunk Discard;
+		Discard.bDiscard = true;
+		Discard.Block = Block;
+		Writer->Enqueue(Discard);
+	}
+	PendingBlocks.Reset();
 }
 
-void DataLogger::WriteData()
+TArray<FString> DataLogger::MakeTrialHeader() const
 {
 	// Preparing the Header file for the CSV files
 	// [ParticipantID, BlockNumber, TrialNumber, TaskType, TaskSetting, TrafficComplexity, Timestamp, DataPoint]
@@ -69,63 +275,126 @@ void DataLogger::WriteData()
 	HeaderRow.Add(ExperimentParams.Get<FString>(HeaderRow[1], "TaskType"));
 	HeaderRow.Add(ExperimentParams.Get<FString>(HeaderRow[1], "TaskSetting"));
 	HeaderRow.Add(ExperimentParams.Get<FString>(HeaderRow[1], "TrafficComplexity"));
+	return HeaderRow;
+}
 
-	// Logging the data into the CSV files
-	AppendArrayToCSV(ReturnHeaderRow("ReactionTime", false), HeaderRow, { FString::Printf(TEXT("%f"), ReactionTime) }, false);
-	AppendArrayToCSV(ReturnHeaderRow("SteeringWheelAngles", true), HeaderRow, SteeringWheelAngles, true);
-	AppendArrayToCSV(ReturnHeaderRow("SteeringWheelVelocities", true), HeaderRow, SteeringWheelVelocities, true);
-	AppendArrayToCSV(ReturnHeaderRow("AccelerationInputs", true), HeaderRow, AccelerationInputs, true);
-	AppendArrayToCSV(ReturnHeaderRow("BrakingInputs", true), HeaderRow, BrakingInputs, true);
+void DataLogger::WriteData()
+{
+	// Hand every block of this trial to the writer thread, the game thread never touches the disk here
+	const TArray<FString> HeaderRow = MakeTrialHeader();
+	HandOffActiveBlock();
+	for (int32 i = 0; i < PendingBlocks.Num(); i++)
+	{
+		FDataLoggerChunk Chunk;
+		Chunk.HeaderRow = HeaderRow;
+		Chunk.ReactionTime = ReactionTime;
+		Chunk.bIsFinalChunk = (i == PendingBlocks.Num() - 1);
+		Chunk.Block = PendingBlocks[i];
+		Writer->Enqueue(Chunk);
+	}
+	PendingBlocks.Reset();
 
 	// Lastly, clear the data variables for using it again
 	EraseData();
 }
 
+/// ========================================== ///
+/// ---------------:EXPORT:------------------- ///
+/// ========================================== ///
 
-/*
-* Note the header row does not have the timestamp element. So, it will have to be manually added in the function
-*/
-void DataLogger::AppendArrayToCSV(const TArray<FString>& HeaderNames, const TArray<FString>& HeaderData, const TArray<FString>& LoggedData, bool WithTimeStamp)
+bool DataLogger::ExportToCSV(const FString &BinaryFilePath, const FString &OutputDir)
 {
-	FString CSVFilePath = FPaths::Combine(CarlaUE4Path, FString::Printf(TEXT("LoggedData/%s"), *HeaderNames[HeaderNames.Num() - 1]));
-	// Check if the file exists
-	bool bFileExists = FPaths::FileExists(*CSVFilePath);
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *BinaryFilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to read the trial data file: %s"), *BinaryFilePath);
+		return false;
+	}
 
-	if (!bFileExists)
+	// one output buffer per datapoint, written with a single append each at the end
+	static const TArray<FString> DataPoints = {
+		"ReactionTime", "SteeringWheelAngles", "SteeringWheelVelocities", "AccelerationInputs", "BrakingInputs"
+	};
+	TMap<FString, FString> Outputs;
+	for (const FString &DataPoint : DataPoints)
 	{
-		// Create the CSV file and append the header row
-		FString HeaderRow = FString::Join(HeaderNames, TEXT(","));
-		HeaderRow.Append(TEXT("\n"));
-		bool bSuccess = FFileHelper::SaveStringToFile(HeaderRow, *CSVFilePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), EFileWrite::FILEWRITE_Append);
-		if (!bSuccess) {
-			UE_LOG(LogTemp, Error, TEXT("Failed to append to the CSV file: %s"), *CSVFilePath);
-		}
+		Outputs.Add(DataPoint, FString());
 	}
+	auto FormatValue = [](float Value) {
+		return FMath::IsNaN(Value) ? FString() : FString::Printf(TEXT("%f"), Value);
+	};
+
+	FMemoryReader Ar(Bytes);
+	FDataLoggerBlock Block;
+	while (!Ar.AtEnd())
+	{
+		uint32 Magic, Version;
+		TArray<FString> HeaderRow;
+		float RT;
+		uint8 bIsFinal;
+		int32 NumRows;
+		Ar << Magic << Version;
+		if (Magic != TrialFileMagic || Version != TrialFileVersion)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Corrupt or unsupported trial data file: %s (at byte %lld)"), *BinaryFilePath,
+				   Ar.Tell());
+			return false;
+		}
+		Ar << HeaderRow << RT << bIsFinal << NumRows;
+		SerializeColumn(Ar, Block.TimestampTicks, NumRows);
+		SerializeColumn(Ar, Block.SteeringWheelAngles, NumRows);
+		SerializeColumn(Ar, Block.SteeringWheelVelocities, NumRows);
+		SerializeColumn(Ar, Block.AccelerationInputs, NumRows);
+		SerializeColumn(Ar, Block.BrakingInputs, NumRows);
+		if (Ar.IsError())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Truncated trial data file: %s"), *BinaryFilePath);
+			return false;
+		}
 
-	// Open the CSV file in append mode
-	// Create a comma-separated string from the array elements
-	FString	HeaderDataString = FString::Join(HeaderData, TEXT(","));
-	if (WithTimeStamp) {
-		for (int32 i = 0; i < LoggedData.Num(); i++)
+		const FString HeaderDataString = FString::Join(HeaderRow, TEXT(","));
+		if (bIsFinal)
 		{
-			bool bSuccess = FFileHelper::SaveStringToFile(HeaderDataString + TEXT(",") + Timestamps[i].ToString() + TEXT(",") + LoggedData[i] + TEXT("\n"), *CSVFilePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), EFileWrite::FILEWRITE_Append);
-			if (!bSuccess) {
-				UE_LOG(LogTemp, Error, TEXT("Failed to append to the CSV file: %s"), *CSVFilePath);
-			}
+			Outputs["ReactionTime"] += HeaderDataString + TEXT(",") + FormatValue(RT) + TEXT("\n");
 		}
+		auto AppendColumn = [&](const FString &DataPoint, const TArray<float> &Column) {
+			FString &Out = Outputs[DataPoint];
+			for (int32 i = 0; i < NumRows; i++)
+			{
+				Out += HeaderDataString + TEXT(",") + FDateTime(Block.TimestampTicks[i]).ToString() + TEXT(",") +
+					   FormatValue(Column[i]) + TEXT("\n");
+			}
+		};
+		AppendColumn("SteeringWheelAngles", Block.SteeringWheelAngles);
+		AppendColumn("SteeringWheelVelocities", Block.SteeringWheelVelocities);
+		AppendColumn("AccelerationInputs", Block.AccelerationInputs);
+		AppendColumn("BrakingInputs", Block.BrakingInputs);
 	}
-	else
+
+	bool bSuccess = true;
+	for (const FString &DataPoint : DataPoints)
 	{
-		FString LoggedDataString = FString::Join(LoggedData, TEXT(","));
-		LoggedDataString.Append(TEXT("\n"));
-		bool bSuccess = FFileHelper::SaveStringToFile(HeaderDataString + TEXT(",") + LoggedDataString, *CSVFilePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), EFileWrite::FILEWRITE_Append);
-		if (!bSuccess) {
+		const FString CSVFilePath = FPaths::Combine(OutputDir, DataPoint);
+		FString Contents;
+		if (!FPaths::FileExists(*CSVFilePath))
+		{
+			// Create the CSV file with the header row
+			Contents = FString::Join(ReturnHeaderRow(DataPoint, DataPoint != "ReactionTime"), TEXT(","));
+			Contents.Append(TEXT("\n"));
+		}
+		Contents += Outputs[DataPoint];
+		if (!FFileHelper::SaveStringToFile(Contents, *CSVFilePath, FFileHelper::EEncodingOptions::AutoDetect,
+										   &IFileManager::Get(), EFileWrite::FILEWRITE_Append))
+		{
 			UE_LOG(LogTemp, Error, TEXT("Failed to append to the CSV file: %s"), *CSVFilePath);
+			bSuccess = false;
 		}
 	}
+	return bSuccess;
 }
 
 TArray<FString> DataLogger::ReturnHeaderRow(const FString& DataPoint, bool IncludeTimestamp) {
+	static const TArray<FString> FixedHeaderRow = { "ParticipantID", "BlockNumber", "TrialNumber", "TaskType", "TaskSetting", "TrafficComplexity", "Timestamp"};
 	// Make a copy of FixedHeaderRow
 	TArray<FString> TempArray = FixedHeaderRow;
 	if (!IncludeTimestamp) {
@@ -135,4 +404,4 @@ TArray<FString> DataLogger::ReturnHeaderRow(const FString& DataPoint, bool Inclu
 	TempArray.Add(DataPoint);
 	// Return the modified copy
 	return TempArray;
-}
\ No newline at end of file
+}
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Queue.h"       // TQueue
+#include "HAL/Runnable.h"           // FRunnable
+#include "HAL/ThreadSafeBool.h"     // FThreadSafeBool
 
 #ifndef _WIN32
 // can only use LogitechWheel plugin on Windows! :(
@@ -16,25 +19,89 @@
 
 /**
  * This code works in company with DReyeVRPawn
+ *
+ * Samples are stored as raw values in preallocated column blocks (no string formatting on the game thread).
+ * Filled blocks are handed to a background writer that appends them to a compact binary columnar file
+ * (LoggedData/TrialData.bin). ExportToCSV (-run=ExportTrialData) converts that file offline to the per-datapoint CSV layout
+ * ([FixedHeaderRow..., DataPoint]) that the analysis scripts expect.
  */
 
+// A fixed-capacity block of samples, stored column-wise
+struct FDataLoggerBlock
+{
+	static constexpr int32 Capacity = 4096; // ~45s of samples at 90Hz before the block is handed off
+
+	TArray<int64> TimestampTicks; // FDateTime::GetTicks()
+	TArray<float> SteeringWheelAngles;
+	TArray<float> SteeringWheelVelocities; // NaN for the first sample of a trial
+	TArray<float> AccelerationInputs;
+	TArray<float> BrakingInputs;
+
+	FDataLoggerBlock();
+	int32 Num() const { return TimestampTicks.Num(); }
+	bool IsFull() const { return Num() >= Capacity; }
+	void Reset(); // empties the columns but keeps the allocation
+};
+
+// Unit of work for the writer thread: one block of a trial plus the trial metadata
+struct FDataLoggerChunk
+{
+	TArray<FString> HeaderRow; // [ParticipantID, BlockNumber, TrialNumber, TaskType, TaskSetting, TrafficComplexity]
+	float ReactionTime = -1.0f;
+	bool bIsFinalChunk = false; // last chunk of a trial (carries the reaction time)
+	bool bDiscard = false;		// only recycle the block, nothing is written
+	FDataLoggerBlock *Block = nullptr;
+};
+
 class CARLAUE4_API DataLogger
 {
 private:
 	float ReactionTime = -1.0f;
-	TArray<FDateTime> Timestamps;
-	TArray<FString> SteeringWheelAngles;
-	TArray<FString> SteeringWheelVelocities;
-	TArray<FString> AccelerationInputs;
-	TArray<FString> BrakingInputs;
-	const TArray<FString> FixedHeaderRow = { "ParticipantID", "BlockNumber", "TrialNumber", "TaskType", "TaskSetting", "TrafficComplexity", "Timestamp"};
+	FDataLoggerBlock *ActiveBlock = nullptr; // block currently receiving samples
+	int64 LastTicks = 0;			// previous sample (for the wheel velocity)
+	float LastWheelRotation = 0.f;
+	bool bHasLastSample = false;
+	TArray<FDataLoggerBlock *> PendingBlocks; // filled blocks of the current (unfinished) trial
+
+	// Background writer that appends chunks to the binary trial file
+	class FWriter : public FRunnable
+	{
+	public:
+		FWriter(const FString &InFilePath);
+		virtual ~FWriter();
+		virtual uint32 Run() override;
+		virtual void Stop() override;
+		void Enqueue(const FDataLoggerChunk &Chunk);
+		FDataLoggerBlock *AcquireBlock(); // recycled block (or a fresh one if none are free)
+		void Flush();					  // block until the queue is drained (only used on shutdown)
+
+	private:
+		void WriteChunk(const FDataLoggerChunk &Chunk, class FArchive &Ar) const;
+		const FString FilePath;
+		TQueue<FDataLoggerChunk, EQueueMode::Spsc> Chunks;		   // game thread -> writer
+		TQueue<FDataLoggerBlock *, EQueueMode::Spsc> FreeBlocks;   // writer -> game thread
+		class FEvent *WakeEvent = nullptr;
+		FThreadSafeCounter NumQueued;
+		FThreadSafeBool bStop = false;
+		class FRunnableThread *Thread = nullptr;
+	};
+	TUniquePtr<FWriter> Writer;
+
+	TArray<FString> MakeTrialHeader() const;
+	void HandOffActiveBlock(); // move the active block to the pending list and grab another one
 
 public:
+	DataLogger();
+	~DataLogger();
+
 	enum class RTTimer{ Start, Stop };
-	TArray<FString> ReturnHeaderRow(const FString& DataPoint, bool IncludeTimestamp);
+	static TArray<FString> ReturnHeaderRow(const FString& DataPoint, bool IncludeTimestamp);
 	void LogReactionTime(const FDateTime& TORIssuanceTime);
 	void LogLogitechData(const struct DIJOYSTATE2* WheelState);	//	Will be called in every tick to append new data retrived from the logitech steering wheels
-	void AppendArrayToCSV(const TArray<FString>& HeaderNames, const TArray<FString>& HeaderData, const TArray<FString>& LoggedData, bool WithTimeStamp);
-	void WriteData();		// Finally write data once a TOR is finished
+	void WriteData();		// Hand the finished TOR off to the writer thread (does not block on disk)
 	void EraseData();	// Reset the raw data arrays, preparing for recording the next TOR performance
+
+	// Convert a binary trial file to the CSV layout in OutputDir (one file per datapoint, header row on creation)
+	static bool ExportToCSV(const FString &BinaryFilePath, const FString &OutputDir);
+	static FString DefaultBinaryFilePath();
 };
@@ -111,12 +111,13 @@ void AEgoSensor::ManualTick(float DeltaSeconds)
 
         // Update the internal sensor data that gets handed off to Carla (for recording/replaying/PythonAPI)
         const auto &Inputs = Vehicle.IsValid() ? Vehicle.Get()->GetVehicleInputs() : DReyeVR::UserInputs{};
-        GetData()->Update(Timestamp,     // TimestampCarla (ms)
-                          EyeSensorData, // EyeTrackerData
-                          EgoVars,       // EgoVehicleVariables
-                          FocusInfoData, // FocusData
-                          Inputs         // User inputs
+        BeginDataUpdate().Update(Timestamp,     // TimestampCarla (ms)
+                                 EyeSensorData, // EyeTrackerData
+                                 EgoVars,       // EgoVehicleVariables
+                                 FocusInfoData, // FocusData
+                                 Inputs         // User inputs
         );
+        PublishData(); // one consistent snapshot per tick for the recorder, PythonAPI and HUD
         TickFoveatedRender();
     }
     TickCount++;
@@ -287,10 +288,11 @@ void AEgoSensor::ComputeFocusInfo()
 bool AEgoSensor::ComputeGazeTrace(FHitResult &Hit, const ECollisionChannel TraceChannel, float TraceRadius) const
 {
     const float TraceLen = MaxTraceLenM * 100.f; // convert to m from cm
-    const FRotator &WorldRot = GetData()->GetCameraRotationAbs();
-    const FVector &WorldPos = GetData()->GetCameraLocationAbs();
-    const FVector GazeOrigin = WorldPos + WorldRot.RotateVector(GetData()->GetGazeOrigin());
-    const FVector GazeRay = TraceLen * WorldRot.RotateVector(GetData()->GetGazeDir()).GetSafeNormal();
+    const DataReader Data = GetData();
+    const FRotator &WorldRot = Data->GetCameraRotationAbs();
+    const FVector &WorldPos = Data->GetCameraLocationAbs();
+    const FVector GazeOrigin = WorldPos + WorldRot.RotateVector(Data->GetGazeOrigin());
+    const FVector GazeRay = TraceLen * WorldRot.RotateVector(Data->GetGazeDir()).GetSafeNormal();
     // Create collision information container.
     FCollisionQueryParams TraceParam;
     TraceParam = FCollisionQueryParams(FName("TraceParam"), true);
@@ -380,12 +382,9 @@ void AEgoSensor::SetEgoVehicle(class AEgoVehicle *NewEgoVehicle)
     Vehicle = NewEgoVehicle;
     check(Vehicle.IsValid());
 
-    // Also check that the ConfigFileData variable can be written to with Vehicle params
-    check(ConfigFile); // this is a static variable created in the parent (ADReyeVRSensor)
-
     // track both the VehicleParams and GeneralParams
     const auto ConfigFileStr = Vehicle.Get()->GetVehicleParams().Export() + GeneralParams.Export();
-    ConfigFile->Set(ConfigFileStr); // track this config file once
+    ConfigFile.Set(ConfigFileStr); // track this config file once
 
     // saved from some previous request to compare, but failed bc no EgoVehicle
     if (RecordingCF != nullptr)
@@ -559,14 +558,15 @@ void AEgoSensor::ConvertToEyeTrackerSpace(FVector &inVec) const
 void AEgoSensor::TickFoveatedRender()
 {
 #if USE_FOVEATED_RENDER
+    const DataReader Data = GetData();
     FEyeTrackerStereoGazeData F;
-    F.LeftEyeOrigin = GetData()->GetGazeOrigin(DReyeVR::Gaze::LEFT);
-    F.LeftEyeDirection = GetData()->GetGazeDir(DReyeVR::Gaze::LEFT);
+    F.LeftEyeOrigin = Data->GetGazeOrigin(DReyeVR::Gaze::LEFT);
+    F.LeftEyeDirection = Data->GetGazeDir(DReyeVR::Gaze::LEFT);
     ConvertToEyeTrackerSpace(F.LeftEyeDirection);
-    F.RightEyeOrigin = GetData()->GetGazeOrigin(DReyeVR::Gaze::RIGHT);
-    F.RightEyeDirection = GetData()->GetGazeDir(DReyeVR::Gaze::RIGHT);
+    F.RightEyeOrigin = Data->GetGazeOrigin(DReyeVR::Gaze::RIGHT);
+    F.RightEyeDirection = Data->GetGazeDir(DReyeVR::Gaze::RIGHT);
     ConvertToEyeTrackerSpace(F.RightEyeDirection);
-    F.FixationPoint = GetData()->GetFocusActorPoint();
+    F.FixationPoint = Data->GetFocusActorPoint();
     F.ConfidenceValue = 0.99f;
     UVariableRateShadingFunctionLibrary::UpdateStereoGazeDataToFoveatedRendering(F);
 #endif
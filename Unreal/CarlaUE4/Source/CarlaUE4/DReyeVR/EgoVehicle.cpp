@@ -9,6 +9,7 @@
 #include "GameFramework/Actor.h"                    // Destroy
 #include "Math/Rotator.h"                           // RotateVector, Clamp
 #include "Math/UnrealMathUtility.h"                 // Clamp
+#include "RetrieveDataRunnable.h"                   // RetrieveDataRunnable
 #include <DateTime.h>
 
 #include <algorithm>
@@ -105,7 +106,7 @@ void AEgoVehicle::ReadExperimentVariables()
     const FDateTime Now = FDateTime::Now();
 
     // This is done so that the updated file (by python API) is re-read
-    ExperimentParams = ConfigFile(FPaths::Combine(CarlaUE4Path, TEXT("Config/ExperimentConfig.ini")));
+    ExperimentParams.Reload(true);
 
     // Retrieve the interruption paradigm that will be used
     FString InterruptionParadigm;
@@ -181,6 +182,14 @@ void AEgoVehicle::ReadExperimentVariables()
 }
 
 
+void AEgoVehicle::BindConfigParams()
+{
+    EyeBlinkThreshold = GeneralParams.Bind("EyeTracker", "EyeBlinkThreshold", 0.15f);
+    EyeMinConfidence = GeneralParams.Bind("EyeTracker", "MinConfidence", 0.6f);
+    EyeEvaluationDelay = GeneralParams.Bind("EyeTracker", "MinEvaluationDelay", 0.01f);
+    bEnableHUDDebugger = GeneralParams.Bind("EgoVehicleHUD", "EnableHUDDebugger", false);
+}
+
 void AEgoVehicle::BeginPlay()
 {
     // Called when the game starts or when spawned
@@ -205,6 +214,8 @@ void AEgoVehicle::BeginPlay()
 
 
     // Initialize the thread to get data from the eye tracker and the client
+    // (it binds its own params and publishes all the start-up bindings before its thread starts)
+    BindConfigParams();
     GetDataRunnable = new RetrieveDataRunnable(this);
 
     // Start the NDRT on head-up display
@@ -259,6 +270,9 @@ void AEgoVehicle::Tick(float DeltaSeconds)
     // Get the current data from the AEgoSensor and use it
     UpdateSensor(DeltaSeconds);
 
+    // Consume the vehicle status & eye-tracker data received by the I/O thread
+    TickHardwareIO();
+
     // Update the positions based off replay data
     ReplayTick();
 
@@ -284,7 +298,7 @@ void AEgoVehicle::Tick(float DeltaSeconds)
     TickNDRT();
 
     // Tick HUD debugger
-    if (GeneralParams.Get<bool>("EgoVehicleHUD", "EnableHUDDebugger"))
+    if (bEnableHUDDebugger.Get())
     {
         HUDDebuggerTick();
     }
@@ -557,7 +571,7 @@ void AEgoVehicle::ReplayTick()
     if (bIsReplaying)
     {
         // this gets reached when the simulator is replaying data from a carla log
-        const DReyeVR::AggregateData *Replay = EgoSensor.Get()->GetData();
+        const ADReyeVRSensor::DataReader Replay = EgoSensor.Get()->GetData();
 
         // include positional update here, else there is lag/jitter between the camera and the vehicle
         // since the Carla Replayer tick differs from the EgoVehicle tick
@@ -896,7 +910,7 @@ void AEgoVehicle::UpdateDash()
     float XPH; // miles-per-hour or km-per-hour
     if (EgoSensor.IsValid() && EgoSensor.Get()->IsReplaying())
     {
-        const DReyeVR::AggregateData *Replay = EgoSensor.Get()->GetData();
+        const ADReyeVRSensor::DataReader Replay = EgoSensor.Get()->GetData();
         XPH = Replay->GetVehicleVelocity() * SpeedometerScale; // FwdSpeed is in cm/s
         const auto &ReplayInputs = Replay->GetUserInputs();
         if (ReplayInputs.ToggledReverse)
@@ -1154,7 +1168,7 @@ void AEgoVehicle::DebugLines() const
     if (bDrawDebugEditor && EgoSensor.IsValid())
     {
         // Calculate gaze data (in world space) using eye tracker data
-        const DReyeVR::AggregateData *Data = EgoSensor.Get()->GetData();
+        const ADReyeVRSensor::DataReader Data = EgoSensor.Get()->GetData();
         // Compute World positions and orientations
         const FRotator &WorldRot = FirstPersonCam->GetComponentRotation();
         const FVector &WorldPos = FirstPersonCam->GetComponentLocation();
@@ -14,10 +14,10 @@
 #include "DReyeVRGameMode.h"                          // ADReyeVRGameMode
 #include "DReyeVRUtils.h"                             // GeneralParams.Get
 #include "EgoSensor.h"                                // AEgoSensor
+#include "EyeTrackerSamples.h"                        // FEyeTrackerSampleBuffer
 #include "FlatHUD.h"                                  // ADReyeVRHUD
 #include "ImageUtils.h"                               // CreateTexture2D
 #include "WheeledVehicle.h"                           // VehicleMovementComponent
-#include "RetrieveDataRunnable.h"                     // Retreive all the data in parallel
 #include <zmq.hpp>                                    // ZeroMQ Plugin
 #include "Sockets.h"                                  // Socket programming
 #include "SocketSubsystem.h"						  // Socket programming
@@ -43,6 +43,7 @@ class CARLAUE4_API AEgoVehicle : public ACarlaWheeledVehicle
 
     void ReadConfigVariables();
     void ReadExperimentVariables();
+    void BindConfigParams(); // hot-reloadable params read every frame or off the game thread (on BeginPlay)
 
     virtual void Tick(float DeltaTime) override; // called automatically
 
@@ -272,7 +273,8 @@ class CARLAUE4_API AEgoVehicle : public ACarlaWheeledVehicle
     bool bInitializedAutopilotIndicator = false;
 
 public: // Thread to run all the ZMQ networking stuff
-    class RetrieveDataRunnable *GetDataRunnable;
+    class RetrieveDataRunnable *GetDataRunnable = nullptr;
+    void TickHardwareIO(); // Apply everything the I/O thread received since the last tick (game thread)
 
 public: // Game signaling
     enum class VehicleStatus { ManualDrive, Autopilot, PreAlertAutopilot, TakeOver, TakeOverManual, ResumedAutopilot, TrialOver, Unknown };
@@ -285,9 +287,10 @@ public: // Game signaling
      * TakeOverManual: Driver has given sufficient input, automation is turned off, and the vehicle is fully controlled by the driver.
      * Unknown: Status not known. This status has no functionality. Mainly used for error handling and waiting for status to be received.
      */
-    void UpdateVehicleStatus(VehicleStatus NewStatus); // Change the vehicle status by ensuring old status is robust and send to client
-    void SendCurrVehicleStatus(); // Send the locally stored current vehicle status
-    FDcResult RetrieveVehicleStatus(); // Update the vehicles status using ZeroMQ PUB-SUB
+    void UpdateVehicleStatus(VehicleStatus NewStatus); // Change the vehicle status locally and queue it to be sent to the client
+    void PublishVehicleStatus(class VehicleStatusCodec &Codec, VehicleStatus Status); // Send a vehicle status to the client (I/O thread only)
+    FDcResult RetrieveVehicleStatus(class VehicleStatusCodec &Codec, VehicleStatus &OutStatus); // Decode the pending vehicle status using ZeroMQ PUB-SUB (I/O thread only)
+    zmq::socket_t *GetVehicleStatusSubscriber(); // SUB socket for the I/O thread to poll on (nullptr if not connected)
     VehicleStatus GetCurrVehicleStatus();
     VehicleStatus GetOldVehicleStatus();
 
@@ -300,7 +303,7 @@ private: // Game signaling
     zmq::context_t* VehicleStatusSendContext;    // Stores the send context of the zmq process
     zmq::socket_t* VehicleStatusSubscriber; // Pointer to the receive socket to listen to python client
     zmq::socket_t* VehicleStatusPublisher; // Pointer to the send socket to listen to python client
-    FVehicleStatusData VehicleStatusData; // Stores the vehicle status dict sent by python client
+    zmq::message_t VehicleStatusMessage; // Receive buffer for the vehicle status sent by python client (reused)
 
 public:
     bool EstablishVehicleStatusConnection(); // Establish connection to Client ZMQ
@@ -410,18 +413,23 @@ private: // Eye-tracking
     bool bUDPEyeDataRetrieve = false; // True if data is retrieved from ZMQ
     FSocket* ListenSocket; // Used for UDP communication
     FIPv4Endpoint Endpoint; // Used for UDP communication
+    TArray<uint8> ReceivedData; // Datagram buffer reused by RetrieveEyeTrackerSamples (I/O thread only)
 
 public: // Eye-tracking
-    bool IsUserGazingOnHUD(); // Returns true if the gaze is on the HUD
+    bool IsUserGazingOnHUD(); // Returns true if the gaze is on the HUD (blink-debounced)
     float GazeOnHUDTime(); // Returns the time the user has been looking at the HUD
     bool EstablishEyeTrackerConnection(); // Establish connection to a TCP port for PUBLISH-SUBSCRIBE protocol communication
     bool TerminateEyeTrackerConnection(); // Terminate connection to a TCP port for PUBLISH-SUBSCRIBE protocol communication
-    void RetrieveOnSurf(); // Retrieved the OnSurf value from the python hardware stream client
+    int32 RetrieveEyeTrackerSamples(TArray<FEyeTrackerSample> &OutSamples); // Drain every pending datagram of the python hardware stream client (I/O thread only)
+    bool GetEyeTrackerSample(FEyeTrackerSample &OutSample) const; // Sample interpolated just behind the current frame time (by the transport delay), false if none was received yet
 private:
-    float GazeOnHUDTimestamp; // Store the timestamp at which the driver starts looking at the HUD
-    bool bLastOnSurfValue = false; // Stores the previous OnSurf value
-    bool bLatestOnSurfValue = false; // Stores the latest OnSurf value retrieved from the python hardware stream client
-    float GazeShiftThreshTimeStamp = 0; // For checking if the OnSurf value change time limit threshold has been reached.
+    FEyeTrackerSampleBuffer EyeTrackerSamples; // Every sample received by the I/O thread (game thread only)
+    double EyeTrackerFrameTime = 0.0; // FPlatformTime::Seconds() at the last TickHardwareIO
+    void TickEyeTracker(); // Debounce the samples received up to GetEyeTrackerTime()
+    double GetEyeTrackerTime() const; // EyeTrackerFrameTime behind by the evaluation delay, where the eye-tracker stream is read
+    ConfigParam<float> EyeBlinkThreshold;  // [EyeTracker] EyeBlinkThreshold
+    ConfigParam<float> EyeMinConfidence;   // [EyeTracker] MinConfidence
+    ConfigParam<float> EyeEvaluationDelay; // [EyeTracker] MinEvaluationDelay
     void SetHUDTimeThreshold(float Threshold); // Set the GazeOnHUDTimeConstraint
     float GazeOnHUDTimeConstraint = 2; // Time after which alert is displayed in sys-recommended and sys-initiated modes
 
@@ -435,6 +443,7 @@ private:
 public: // HUD Debugger
     void ConstructHUDDebugger();
     void HUDDebuggerTick();
+    ConfigParam<bool> bEnableHUDDebugger; // [EgoVehicleHUD] EnableHUDDebugger
     UPROPERTY(Category = "Dash", EditDefaultsOnly, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
     class UTextRenderComponent* OnSurfValue;
     class UTextRenderComponent* HUDGazeTime;
@@ -2,11 +2,8 @@
 #include "Carla/Game/CarlaStatics.h"                // GetCurrentEpisode
 #include <zmq.hpp>									// ZeroMQ plugin
 #include <string>									// Raw string for ZeroMQ
-#include "MsgPack/DcMsgPackReader.h"				// MsgPackReader
-#include "Property/DcPropertyDatum.h"				// Datum
-#include "Property/DcPropertyWriter.h"				// PropertyWriter
-#include "Deserialize/DcDeserializer.h"				// Deserializer
-#include "Deserialize/DcDeserializerSetup.h"		// EDcMsgPackDeserializeType
+#include "RetrieveDataRunnable.h"					// RetrieveDataRunnable
+#include "VehicleStatusCodec.h"						// VehicleStatusCodec
 
 bool AEgoVehicle::EstablishVehicleStatusConnection() {
 	try {
@@ -101,8 +98,14 @@ bool AEgoVehicle::TerminateVehicleStatusConnection() {
 }
 
 
-FDcResult AEgoVehicle::RetrieveVehicleStatus() {
+zmq::socket_t* AEgoVehicle::GetVehicleStatusSubscriber()
+{
+	return bZMQVehicleStatusConnection ? VehicleStatusSubscriber : nullptr;
+}
+
+FDcResult AEgoVehicle::RetrieveVehicleStatus(VehicleStatusCodec& Codec, VehicleStatus& OutStatus) {
 	// Note: using raw C++ types in the following code as it does not interact with UE interface
+	// NOTE: only called from the I/O thread once zmq_poll reported the SUB socket as readable
 
 	// Establish connection if not already
 	if (!bZMQVehicleStatusConnection && !EstablishVehicleStatusConnection()) {
@@ -110,195 +113,79 @@ FDcResult AEgoVehicle::RetrieveVehicleStatus() {
 		return FDcResult{ FDcResult::EStatus::Error };
 	}
 
-	// Receive a message from the server
-	zmq::message_t Message;
-	if (!VehicleStatusSubscriber->recv(&Message)) {
+	// Receive a message from the server (never blocks, the socket is already readable)
+	// the message buffer is reused across calls and decoded in place
+	if (!VehicleStatusSubscriber->recv(&VehicleStatusMessage, ZMQ_DONTWAIT)) {
 		bZMQVehicleStatusDataRetrieve = false;
 		return FDcResult{ FDcResult::EStatus::Error };
 	}
 
-	// Store the serialized data into a TArray
-	TArray<uint8> DataArray;
-	DataArray.Append(static_cast<uint8*>(Message.data()), Message.size());
-
-	// Create a deserializer
-	FDcDeserializer Deserializer;
-	DcSetupMsgPackDeserializeHandlers(Deserializer, EDcMsgPackDeserializeType::Default);
-
-	// Prepare context for this run
-	FDcPropertyDatum Datum(&VehicleStatusData);
-	FDcMsgPackReader Reader(FDcBlobViewData::From(DataArray));
-	FDcPropertyWriter Writer(Datum);
-
-	FDcDeserializeContext Ctx;
-	Ctx.Reader = &Reader;
-	Ctx.Writer = &Writer;
-	Ctx.Deserializer = &Deserializer;
-	DC_TRY(Ctx.Prepare());
-	DC_TRY(Deserializer.Deserialize(Ctx));
-	bZMQVehicleStatusDataRetrieve = true;
-
-	// Updating old and new status
-	OldVehicleStatus = CurrVehicleStatus;
-	if (VehicleStatusData.vehicle_status == "ManualDrive") {
-		CurrVehicleStatus = VehicleStatus::ManualDrive;
-	}
-	else if (VehicleStatusData.vehicle_status == "Autopilot") {
-		CurrVehicleStatus = VehicleStatus::Autopilot;
-	}
-	else if (VehicleStatusData.vehicle_status == "PreAlertAutopilot") {
-		CurrVehicleStatus = VehicleStatus::PreAlertAutopilot;
-	}
-	else if (VehicleStatusData.vehicle_status == "TakeOver") {
-		CurrVehicleStatus = VehicleStatus::TakeOver;
-
-	}
-	else if (VehicleStatusData.vehicle_status == "TakeOverManual") {
-		CurrVehicleStatus = VehicleStatus::TakeOverManual;
-	}
-	else if (VehicleStatusData.vehicle_status == "ResumedAutopilot") {
-		CurrVehicleStatus = VehicleStatus::ResumedAutopilot;
-	}
-	else if (VehicleStatusData.vehicle_status == "TrialOver") {
-		CurrVehicleStatus = VehicleStatus::TrialOver;
-	}
-	else {
-		CurrVehicleStatus = VehicleStatus::Unknown;
+	// Map the received status (the game thread applies it in TickHardwareIO)
+	if (!Codec.Decode(VehicleStatusMessage.data(), VehicleStatusMessage.size(), OutStatus)) {
+		bZMQVehicleStatusDataRetrieve = false;
+		return FDcResult{ FDcResult::EStatus::Error };
 	}
-
+	bZMQVehicleStatusDataRetrieve = true;
 	return DcOk();
 }
 
 void AEgoVehicle::UpdateVehicleStatus(VehicleStatus NewStatus)
 {
-	FString VehicleStatusString;
-	switch  (NewStatus) {
-	case VehicleStatus::ManualDrive:
-		VehicleStatusString = FString("ManualDrive");
-		break;
-	case VehicleStatus::Autopilot:
-		VehicleStatusString = FString("Autopilot");
-		break;
-	case VehicleStatus::PreAlertAutopilot:
-		VehicleStatusString = FString("PreAlertAutopilot");
-		break;
-	case VehicleStatus::TakeOver:
-		VehicleStatusString = FString("TakeOver");
-		break;
-	case VehicleStatus::TakeOverManual:
-		VehicleStatusString = FString("TakeOverManual");
-		break;
-	case VehicleStatus::ResumedAutopilot:
-		VehicleStatusString = FString("ResumedAutopilot");
-		break;
-	case VehicleStatus::TrialOver:
-		VehicleStatusString = FString("TrialOver");
-		break;
-	default:
-		VehicleStatusString = FString("Unknown");
-	}
+	// Change the local variables right away, the I/O thread sends the new status on its next wake
+	OldVehicleStatus = CurrVehicleStatus;
+	CurrVehicleStatus = NewStatus;
 
-	// Send the new status
-	if (!bZMQVehicleStatusConnection && !EstablishVehicleStatusConnection()) {
+	if (GetDataRunnable == nullptr) {
 		UE_LOG(LogTemp, Warning, TEXT("ZeroMQ: Publisher not initialized!"));
 		return;
 	}
-
-	FString From = TEXT("carla");
-
-	// Get the current timestamp.
-	FDateTime CurrentTime = FDateTime::Now();
-	FString TimestampWithoutMilliseconds = CurrentTime.ToString(TEXT("%d/%m/%Y %H:%M:%S"));
-	int32 Milliseconds = CurrentTime.GetMillisecond();
-	FString Timestamp = FString::Printf(TEXT("%s.%03d"), *TimestampWithoutMilliseconds, Milliseconds);
-
-	// Construct the "dictionary" as an FString.
-	FString DictFString = FString::Printf(TEXT("{ \"from\": \"%s\", \"timestamp\": \"%s\", \"vehicle_status\": \"%s\" }"), *From, *Timestamp, *VehicleStatusString);
-
-	// Convert the FString to a std::string to be used with ZeroMQ.
-	std::string DictStdString(TCHAR_TO_UTF8(*DictFString));
-
-	try {
-		// Send the message
-		zmq::message_t Message(DictStdString.size());
-		memcpy(Message.data(), DictStdString.c_str(), DictStdString.size());
-
-		VehicleStatusPublisher->send(Message);
-
-		UE_LOG(LogTemp, Display, TEXT("ZeroMQ: Sent message: %s"), *DictFString);
-
-	}
-	catch (...) {
-		UE_LOG(LogTemp, Error, TEXT("ZeroMQ: Failed to send message."));
-		return;
-	}
-
-	// Finally, if all successful, change the local variables
-	OldVehicleStatus = CurrVehicleStatus;
-	CurrVehicleStatus = NewStatus;
+	GetDataRunnable->RequestStatusPublish(NewStatus);
 }
 
-void AEgoVehicle::SendCurrVehicleStatus()
+void AEgoVehicle::PublishVehicleStatus(VehicleStatusCodec& Codec, VehicleStatus Status)
 {
-	FString VehicleStatusString;
-	switch (CurrVehicleStatus) {
-	case VehicleStatus::ManualDrive:
-		VehicleStatusString = FString("ManualDrive");
-		break;
-	case VehicleStatus::Autopilot:
-		VehicleStatusString = FString("Autopilot");
-		break;
-	case VehicleStatus::PreAlertAutopilot:
-		VehicleStatusString = FString("PreAlertAutopilot");
-		break;
-	case VehicleStatus::TakeOver:
-		VehicleStatusString = FString("TakeOver");
-		break;
-	case VehicleStatus::TakeOverManual:
-		VehicleStatusString = FString("TakeOverManual");
-		break;
-	case VehicleStatus::ResumedAutopilot:
-		VehicleStatusString = FString("ResumedAutopilot");
-		break;
-	case VehicleStatus::TrialOver:
-		VehicleStatusString = FString("TrialOver");
-		break;
-	default:
-		VehicleStatusString = FString("Unknown");
-	}
-
 	// Send the new status
 	if (!bZMQVehicleStatusConnection && !EstablishVehicleStatusConnection()) {
 		UE_LOG(LogTemp, Warning, TEXT("ZeroMQ: Publisher not initialized!"));
 		return;
 	}
 
-	FString From = TEXT("carla");
-
-	// Get the current timestamp.
-	FDateTime CurrentTime = FDateTime::Now();
-	FString TimestampWithoutMilliseconds = CurrentTime.ToString(TEXT("%d/%m/%Y %H:%M:%S"));
-	int32 Milliseconds = CurrentTime.GetMillisecond();
-	FString Timestamp = FString::Printf(TEXT("%s.%03d"), *TimestampWithoutMilliseconds, Milliseconds);
-
-	// Construct the "dictionary" as an FString.
-	FString DictFString = FString::Printf(TEXT("{ \"from\": \"%s\", \"timestamp\": \"%s\", \"vehicle_status\": \"%s\" }"), *From, *Timestamp, *VehicleStatusString);
-
-	// Convert the FString to a std::string to be used with ZeroMQ.
-	std::string DictStdString(TCHAR_TO_UTF8(*DictFString));
+	// Encoded into the codec's send buffer (no FString/std::string round trip). The compact format carries Unix time,
+	// so it needs UTC; the JSON layout keeps the local wall clock the python client writes too
+	const FDateTime Timestamp =
+		Codec.GetSendFormat() == VehicleStatusCodec::EWireFormat::Compact ? FDateTime::UtcNow() : FDateTime::Now();
+	const VehicleStatusCodec::FEncoded Encoded = Codec.Encode(Status, Timestamp);
 
 	try {
 		// Send the message
-		zmq::message_t Message(DictStdString.size());
-		memcpy(Message.data(), DictStdString.c_str(), DictStdString.size());
-
-		VehicleStatusPublisher->send(Message);
+		VehicleStatusPublisher->send(Encoded.Data, Encoded.Size);
 	}
 	catch (...) {
 		UE_LOG(LogTemp, Error, TEXT("ZeroMQ: Failed to send message."));
 	}
 }
 
+void AEgoVehicle::TickHardwareIO()
+{
+	EyeTrackerFrameTime = FPlatformTime::Seconds();
+	RetrieveDataRunnable::FInboxMessage Message;
+	while (GetDataRunnable != nullptr && GetDataRunnable->ConsumeInbox(Message)) {
+		switch (Message.Channel) {
+		case RetrieveDataRunnable::EChannel::VehicleStatusIn:
+			// Updating old and new status
+			OldVehicleStatus = CurrVehicleStatus;
+			CurrVehicleStatus = Message.Status;
+			break;
+		case RetrieveDataRunnable::EChannel::EyeTrackerIn:
+			EyeTrackerSamples.Push(Message.EyeSample);
+			break;
+		default:
+			break;
+		}
+	}
+	TickEyeTracker();
+}
+
 AEgoVehicle::VehicleStatus AEgoVehicle::GetCurrVehicleStatus()
 {
 	return CurrVehicleStatus;
@@ -0,0 +1,34 @@
+#include "ExportTrialDataCommandlet.h"
+#include "DataLogger.h"      // DataLogger::ExportToCSV
+#include "HAL/FileManager.h" // IFileManager
+#include "Misc/Paths.h"      // FPaths
+
+UExportTrialDataCommandlet::UExportTrialDataCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UExportTrialDataCommandlet::Main(const FString &Params)
+{
+    FString Input = DataLogger::DefaultBinaryFilePath();
+    FParse::Value(*Params, TEXT("Input="), Input);
+    FString OutputDir = FPaths::GetPath(DataLogger::DefaultBinaryFilePath());
+    FParse::Value(*Params, TEXT("Output="), OutputDir);
+
+    if (!FPaths::FileExists(Input))
+    {
+        UE_LOG(LogTemp, Error, TEXT("No trial data file at %s. Usage: -run=ExportTrialData [-Input=<file>] [-Output=<dir>]"),
+               *Input);
+        return 1;
+    }
+    IFileManager::Get().MakeDirectory(*OutputDir, true);
+    if (!DataLogger::ExportToCSV(Input, OutputDir))
+    {
+        return 1;
+    }
+    UE_LOG(LogTemp, Log, TEXT("Exported %s to %s"), *Input, *OutputDir);
+    return 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "ExportTrialDataCommandlet.generated.h"
+
+/**
+ * Converts the binary trial file written by DataLogger into the per-datapoint CSV files, offline:
+ *
+ *   UE4Editor CarlaUE4 -run=ExportTrialData [-Input=<TrialData.bin>] [-Output=<dir>]
+ *
+ * Defaults to LoggedData/TrialData.bin and the LoggedData directory. Rows are appended to existing CSV files.
+ */
+UCLASS()
+class CARLAUE4_API UExportTrialDataCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+  public:
+    UExportTrialDataCommandlet();
+    virtual int32 Main(const FString &Params) override;
+};
@@ -1,6 +1,5 @@
 #include "EgoVehicle.h"
 #include "Carla/Game/CarlaStatics.h"                // GetCurrentEpisode
-#include "Kismet/GameplayStatics.h"					// GetRealTimeSeconds
 #include <string>									// Raw string for ZeroMQ
 #include "MsgPack/DcMsgPackReader.h"				// MsgPackReader
 #include "Property/DcPropertyDatum.h"				// Datum
@@ -9,36 +8,39 @@
 #include "Deserialize/DcDeserializerSetup.h"		// EDcMsgPackDeserializeType
 
 // Eye-tracking data specific implementation
-bool AEgoVehicle::IsUserGazingOnHUD() {
-	// IMPORTANT: Need to be called very frequently in order to function properly.
+void AEgoVehicle::TickEyeTracker() {
+	// NOTE: 150 milliseconds (or 0.15f seconds) is the average blink time of a human
+	// Blinking causes the gaze mapper to go crazy, so we set this threshold, to prevent resetting the timer
+	// on a blink. The value only changes when it has been changed for more than the blink time, measured on
+	// the sample timestamps (every received sample is seen, not only the latest one of each frame).
+	// Debounced at the same delayed time the samples are evaluated at, the samples after it may not have arrived yet.
+	EyeTrackerSamples.Advance(GetEyeTrackerTime(), EyeBlinkThreshold.Get(), EyeMinConfidence.Get());
+}
 
-	if (bLastOnSurfValue == bLatestOnSurfValue) {
-		GazeShiftThreshTimeStamp = UGameplayStatics::GetRealTimeSeconds(GetWorld()); // Set the (latest) time the value was unchanged
-	}
-	else {
-		if (UGameplayStatics::GetRealTimeSeconds(GetWorld()) - GazeShiftThreshTimeStamp >= GeneralParams.Get<float>("EyeTracker", "EyeBlinkThreshold"))
-		{
-			// NOTE: 150 milliseconds (or 0.15f seconds) is the average blink time of a human
-			// Blinking causes the gaze mapper to go crazy, so we set this threshold, to prevent resetting the timer
-			// on a blink. Only changes, when the value has been changed for more than the blink time.
-			bLastOnSurfValue = bLatestOnSurfValue;
-		}
-	}
+double AEgoVehicle::GetEyeTrackerTime() const
+{
+	// samples arrive after their local time, so the frame time itself is always past the latest one
+	return EyeTrackerFrameTime - EyeTrackerSamples.GetEvaluationDelay(EyeEvaluationDelay.Get());
+}
 
-	return bLastOnSurfValue; // Return the current or updated value of OnSurf
+bool AEgoVehicle::IsUserGazingOnHUD() {
+	return EyeTrackerSamples.IsOnSurf();
 }
 
 float AEgoVehicle::GazeOnHUDTime()
 {
-	// IMPORTANT: Need to be called very frequently in order to function properly.
 	if (IsUserGazingOnHUD())
 	{
-		return UGameplayStatics::GetRealTimeSeconds(GetWorld()) - GazeOnHUDTimestamp;
+		return static_cast<float>(GetEyeTrackerTime() - EyeTrackerSamples.GetOnSurfChangeTime());
 	}
-	GazeOnHUDTimestamp = UGameplayStatics::GetRealTimeSeconds(GetWorld());
 	return 0;
 }
 
+bool AEgoVehicle::GetEyeTrackerSample(FEyeTrackerSample &OutSample) const
+{
+	return EyeTrackerSamples.Evaluate(GetEyeTrackerTime(), OutSample);
+}
+
 bool AEgoVehicle::EstablishEyeTrackerConnection() {
 	const FString SocketName = TEXT("EyeTrackerData");
 	const FString IP = TEXT("127.0.0.1");
@@ -53,7 +55,7 @@ bool AEgoVehicle::EstablishEyeTrackerConnection() {
 		.AsNonBlocking()
 		.AsReusable()
 		.BoundToEndpoint(Endpoint)
-		.WithReceiveBufferSize(2);
+		.WithReceiveBufferSize(1 << 20); // room for a burst of samples (200+ Hz) between two I/O thread wakes
 
 	if (!ListenSocket)
 	{
@@ -85,30 +87,34 @@ bool AEgoVehicle::TerminateEyeTrackerConnection() {
 	return true;
 }
 
-void AEgoVehicle::RetrieveOnSurf()
+int32 AEgoVehicle::RetrieveEyeTrackerSamples(TArray<FEyeTrackerSample> &OutSamples)
 {
 	// Note: using raw C++ types in the following code as it does not interact with UE interface
 
 	// Establish connection if not already
 	if (!bUDPEyeConnection && !EstablishEyeTrackerConnection()) {
 		UE_LOG(LogTemp, Display, TEXT("UDP: Connection not established!"));
-		return;
+		return 0;
 	}
 
+	// Drain every pending datagram, each one is a sample
+	// (a miss is the common case between eye-tracker samples, so it is not logged)
+	int32 Received = 0;
 	uint32 Size;
-	if (ListenSocket->HasPendingData(Size))
+	ReceivedData.SetNumUninitialized(65507, false); // max UDP payload, allocated once
+	while (ListenSocket->HasPendingData(Size))
 	{
-		TArray<uint8> ReceivedData;
-		ReceivedData.SetNumUninitialized(FMath::Min(Size, 65507u));
-
 		int32 BytesRead;
-		if (ListenSocket->Recv(ReceivedData.GetData(), ReceivedData.Num(), BytesRead))
+		if (!ListenSocket->Recv(ReceivedData.GetData(), FMath::Min(Size, 65507u), BytesRead) || BytesRead <= 0)
 		{
-			// Record the received boolean value
-			bLatestOnSurfValue = ReceivedData[0] != 0;
+			break;
+		}
+		FEyeTrackerSample Sample;
+		if (FEyeTrackerSample::Parse(ReceivedData.GetData(), BytesRead, FPlatformTime::Seconds(), Sample))
+		{
+			OutSamples.Add(Sample);
+			Received++;
 		}
-	} else
-	{
-		UE_LOG(LogTemp, Display, TEXT("UDP: Unable to retrieve the OnSurf value."));
 	}
-}
\ No newline at end of file
+	return Received;
+}
@@ -0,0 +1,168 @@
+// Copyright (c) 2023 Okanagan Visualization & Interaction (OVI) Lab at the University of British Columbia. This work is licensed under the terms of the MIT license. For a copy, see <https://opensource.org/lic
+
+#include "EyeTrackerSamples.h"
+#include <cstring> // std::memcpy
+
+constexpr int32 FEyeTrackerSample::LegacySize;
+constexpr int32 FEyeTrackerSample::SampleSize;
+
+namespace
+{
+// how fast the clock offset follows a growing latency (the lowest latency seen is taken immediately)
+constexpr double ClockOffsetRelax = 0.001;
+// how fast the late-arrival peak decays, and the weight of a new sample interval in the average
+constexpr double LateEstimateRelax = 0.01;
+constexpr double SampleIntervalWeight = 0.05;
+
+template <typename T> T ReadLE(const uint8 *Data)
+{
+    T Value;
+    std::memcpy(&Value, Data, sizeof(T)); // all supported platforms are little endian
+    return Value;
+}
+} // namespace
+
+bool FEyeTrackerSample::Parse(const uint8 *Data, int32 Size, double ReceiveTime, FEyeTrackerSample &Out)
+{
+    if (Data == nullptr || Size < LegacySize)
+    {
+        return false;
+    }
+    Out.bOnSurf = Data[0] != 0;
+    Out.ReceiveTime = ReceiveTime;
+    if (Size < SampleSize)
+    {
+        if (Size != LegacySize)
+        {
+            return false;
+        }
+        Out.Confidence = 1.f;
+        Out.GazePoint = FVector2D::ZeroVector;
+        Out.DeviceTime = ReceiveTime;
+        return true;
+    }
+    Out.Confidence = ReadLE<float>(Data + 1);
+    Out.GazePoint = FVector2D(ReadLE<float>(Data + 5), ReadLE<float>(Data + 9));
+    Out.DeviceTime = ReadLE<double>(Data + 13);
+    return FMath::IsFinite(Out.Confidence) && FMath::IsFinite(Out.DeviceTime);
+}
+
+FEyeTrackerSampleBuffer::FEyeTrackerSampleBuffer(int32 InCapacity)
+{
+    Samples.SetNum(FMath::Max(InCapacity, 2));
+}
+
+void FEyeTrackerSampleBuffer::Push(FEyeTrackerSample Sample)
+{
+    // the receive latency is the clock offset plus the (positive) transport delay, so its minimum is the best estimate
+    const double Observed = Sample.ReceiveTime - Sample.DeviceTime;
+    if (!bHasClockOffset || Observed < ClockOffset)
+    {
+        ClockOffset = Observed;
+        bHasClockOffset = true;
+    }
+    else
+    {
+        ClockOffset += (Observed - ClockOffset) * ClockOffsetRelax;
+    }
+    Sample.LocalTime = Sample.DeviceTime + ClockOffset;
+    if (Count > 0)
+    {
+        // keep the buffer ordered when the offset estimate moves
+        Sample.LocalTime = FMath::Max(Sample.LocalTime, At(Count - 1).LocalTime);
+        const double Interval = Sample.LocalTime - At(Count - 1).LocalTime;
+        SampleInterval = SampleInterval > 0.0 ? SampleInterval + (Interval - SampleInterval) * SampleIntervalWeight
+                                              : Interval;
+    }
+    const double Late = Sample.ReceiveTime - Sample.LocalTime;
+    LateEstimate = Late > LateEstimate ? Late : LateEstimate + (Late - LateEstimate) * LateEstimateRelax;
+
+    if (Count == Samples.Num())
+    {
+        // overwrite the oldest sample
+        Head = (Head + 1) % Samples.Num();
+        Count--;
+        Processed = FMath::Max(Processed - 1, 0);
+    }
+    Samples[(Head + Count) % Samples.Num()] = Sample;
+    Count++;
+    TotalSamples++;
+}
+
+void FEyeTrackerSampleBuffer::Advance(double Time, float BlinkThreshold, float MinConfidence)
+{
+    // the raw value held from PendingSince until Until, flip the debounced state if that is long enough
+    auto CheckPending = [this, BlinkThreshold](double Until) {
+        if (PendingSince >= 0.0 && Until - PendingSince >= BlinkThreshold)
+        {
+            bOnSurf = !bOnSurf;
+            OnSurfChangeTime = PendingSince + BlinkThreshold;
+            PendingSince = -1.0;
+        }
+    };
+
+    for (; Processed < Count && At(Processed).LocalTime <= Time; Processed++)
+    {
+        const FEyeTrackerSample &Sample = At(Processed);
+        CheckPending(Sample.LocalTime);
+        if (Sample.Confidence < MinConfidence)
+        {
+            continue;
+        }
+        if (Sample.bOnSurf == bOnSurf)
+        {
+            PendingSince = -1.0; // a blink (or noise), the debounced state is unchanged
+        }
+        else if (PendingSince < 0.0)
+        {
+            PendingSince = Sample.LocalTime;
+        }
+    }
+    // no newer sample, the last value still holds at Time
+    CheckPending(Time);
+}
+
+bool FEyeTrackerSampleBuffer::Evaluate(double Time, FEyeTrackerSample &Out) const
+{
+    if (Count == 0)
+    {
+        return false;
+    }
+    // last sample at or before Time
+    int32 Low = 0;
+    int32 High = Count;
+    while (Low < High)
+    {
+        const int32 Mid = (Low + High) / 2;
+        if (At(Mid).LocalTime <= Time)
+        {
+            Low = Mid + 1;
+        }
+        else
+        {
+            High = Mid;
+        }
+    }
+    if (Low == 0)
+    {
+        Out = At(0); // older than anything still buffered
+        return true;
+    }
+    const FEyeTrackerSample &Before = At(Low - 1);
+    Out = Before;
+    if (Low == Count)
+    {
+        return true; // no extrapolation past the latest sample
+    }
+    const FEyeTrackerSample &After = At(Low);
+    const double Span = After.LocalTime - Before.LocalTime;
+    if (Span > 0.0)
+    {
+        const float Alpha = static_cast<float>((Time - Before.LocalTime) / Span);
+        Out.Confidence = FMath::Lerp(Before.Confidence, After.Confidence, Alpha);
+        Out.GazePoint = FMath::Lerp(Before.GazePoint, After.GazePoint, Alpha);
+        Out.DeviceTime = FMath::Lerp(Before.DeviceTime, After.DeviceTime, static_cast<double>(Alpha));
+        Out.LocalTime = Time;
+    }
+    return true;
+}
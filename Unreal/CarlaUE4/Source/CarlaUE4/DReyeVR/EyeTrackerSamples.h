@@ -0,0 +1,107 @@
+// Copyright (c) 2023 Okanagan Visualization & Interaction (OVI) Lab at the University of British Columbia. This work is licensed under the terms of the MIT license. For a copy, see <https://opensource.org/lic
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * One gaze-on-surface sample from the python hardware stream client (eye-tracker UDP channel).
+ *
+ * Datagram layouts (little endian):
+ *  - Legacy: 1 byte, the OnSurf flag (what older clients send). Confidence is then 1, the gaze point is unknown and
+ *            the device time is the receive time.
+ *  - Sample: uint8 OnSurf, float32 Confidence, float32 GazeX, float32 GazeY, float64 DeviceTime (21 bytes), i.e.
+ *            struct.pack("<Bfffd", ...) with the gaze point normalized to the HUD surface and the Pupil timestamp.
+ */
+struct FEyeTrackerSample
+{
+    bool bOnSurf = false;
+    float Confidence = 0.f;
+    FVector2D GazePoint = FVector2D::ZeroVector; // normalized surface coordinates
+    double DeviceTime = 0.0;  // eye tracker clock (seconds)
+    double ReceiveTime = 0.0; // FPlatformTime::Seconds() when the datagram was read
+    double LocalTime = 0.0;   // DeviceTime mapped to FPlatformTime::Seconds() (set by FEyeTrackerSampleBuffer)
+
+    static constexpr int32 LegacySize = 1;
+    static constexpr int32 SampleSize = 21;
+
+    // Returns false if the datagram has none of the layouts above
+    static bool Parse(const uint8 *Data, int32 Size, double ReceiveTime, FEyeTrackerSample &Out);
+};
+
+/**
+ * Timestamped ring buffer of eye-tracker samples, owned by the game thread.
+ *
+ * The I/O thread drains every pending datagram and hands each sample over, so nothing is lost between ticks.
+ * Samples are placed on the local clock with an estimated device -> local clock offset (the lowest receive latency
+ * seen, slowly relaxed so clock drift is followed), and the game thread evaluates the stream at its own frame time:
+ *  - Evaluate(): the sample at a given local time, with the confidence and gaze point interpolated between the two
+ *    samples around it (OnSurf is taken from the earlier one). Since the offset comes from the fastest delivery, a
+ *    sample is only received after its local time, so the latest sample is always older than "now": evaluate at
+ *    now - GetEvaluationDelay() for the samples on both sides to have arrived
+ *  - Advance(): runs the blink debounce over every sample up to a given local time, so the on-HUD state and the time
+ *    it changed are measured in sample time instead of being quantized to the frame or I/O poll rate
+ */
+class CARLAUE4_API FEyeTrackerSampleBuffer
+{
+public:
+    explicit FEyeTrackerSampleBuffer(int32 InCapacity = 1024);
+
+    void Push(FEyeTrackerSample Sample);
+
+    // Debounce every sample up to Time: the OnSurf state only changes once it held for BlinkThreshold seconds, samples
+    // below MinConfidence are ignored (Pupil reports blinks and lost pupils with a low confidence)
+    void Advance(double Time, float BlinkThreshold, float MinConfidence);
+
+    // State at Time, false if no sample was received yet
+    bool Evaluate(double Time, FEyeTrackerSample &Out) const;
+
+    // How far behind the receive clock to evaluate: the transport delay beyond the fastest one (decaying peak) plus
+    // the sample interval, at least MinDelay
+    double GetEvaluationDelay(double MinDelay) const
+    {
+        return FMath::Max(MinDelay, LateEstimate + SampleInterval);
+    }
+    bool IsOnSurf() const
+    {
+        return bOnSurf;
+    }
+    double GetOnSurfChangeTime() const // local time the debounced OnSurf state last changed
+    {
+        return OnSurfChangeTime;
+    }
+    const FEyeTrackerSample *GetLatest() const
+    {
+        return Count > 0 ? &At(Count - 1) : nullptr;
+    }
+    double GetClockOffset() const // local - device time
+    {
+        return ClockOffset;
+    }
+    uint64 GetTotalSamples() const
+    {
+        return TotalSamples;
+    }
+
+private:
+    const FEyeTrackerSample &At(int32 Index) const // 0 is the oldest sample
+    {
+        return Samples[(Head + Index) % Samples.Num()];
+    }
+
+    TArray<FEyeTrackerSample> Samples;
+    int32 Head = 0;  // oldest sample
+    int32 Count = 0;
+    uint64 TotalSamples = 0;
+
+    bool bHasClockOffset = false;
+    double ClockOffset = 0.0;
+    double LateEstimate = 0.0;   // receive time - local time, peak that decays towards the recent values
+    double SampleInterval = 0.0; // average local time between two samples
+
+    // debounce state
+    int32 Processed = 0; // samples (from the oldest) already seen by Advance
+    bool bOnSurf = false;
+    double OnSurfChangeTime = 0.0;
+    double PendingSince = -1.0; // local time the raw OnSurf value started to differ (< 0 if it does not)
+};
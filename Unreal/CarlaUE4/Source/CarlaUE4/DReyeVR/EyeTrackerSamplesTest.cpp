@@ -0,0 +1,99 @@
+// Copyright (c) 2023 Okanagan Visualization & Interaction (OVI) Lab at the University of British Columbia. This work is licensed under the terms of the MIT license. For a copy, see <https://opensource.org/lic
+
+#include "EyeTrackerSamples.h"
+#include "Misc/AutomationTest.h" // IMPLEMENT_SIMPLE_AUTOMATION_TEST
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Run with "Automation RunTests DReyeVR.EyeTrackerSamples" (editor console or -ExecCmds)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEyeTrackerSamplesInterpolationTest, "DReyeVR.EyeTrackerSamples.Interpolation",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FEyeTrackerSamplesInterpolationTest::RunTest(const FString &Parameters)
+{
+    // 200Hz stream, 2-4ms of transport delay (jitter), device clock 1000s behind the local one
+    FEyeTrackerSampleBuffer Buffer;
+    const double Period = 0.005;
+    const double Offset = 1000.0;
+    double FrameTime = 0.0;
+    for (int32 i = 0; i < 400; i++)
+    {
+        FEyeTrackerSample Sample;
+        Sample.bOnSurf = true;
+        Sample.Confidence = (i % 2 == 0) ? 0.5f : 1.f;
+        Sample.GazePoint = FVector2D(i * 0.001f, 0.f);
+        Sample.DeviceTime = i * Period;
+        Sample.ReceiveTime = Offset + Sample.DeviceTime + 0.002 + 0.002 * ((i * 7) % 5) / 4.0;
+        Buffer.Push(Sample);
+        FrameTime = Sample.ReceiveTime; // a frame right after the latest sample arrived
+    }
+
+    // at the frame time itself nothing newer has arrived, that is only ever the latest sample
+    FEyeTrackerSample AtFrame;
+    TestTrue(TEXT("Evaluate at the frame time"), Buffer.Evaluate(FrameTime, AtFrame));
+    TestEqual(TEXT("Frame time gives the latest sample"), AtFrame.LocalTime, Buffer.GetLatest()->LocalTime);
+
+    // behind by the evaluation delay both neighbours are buffered, so the value is interpolated
+    const double Delay = Buffer.GetEvaluationDelay(0.0);
+    TestTrue(TEXT("Delay covers the jitter and one sample interval"), Delay >= 0.002 + Period * 0.9);
+    const double Time = FrameTime - Delay;
+    FEyeTrackerSample Delayed;
+    TestTrue(TEXT("Evaluate behind the frame time"), Buffer.Evaluate(Time, Delayed));
+    TestTrue(TEXT("Delayed time is before the latest sample"), Time < Buffer.GetLatest()->LocalTime);
+    TestEqual(TEXT("Interpolated sample is placed at the query time"), Delayed.LocalTime, Time);
+    TestTrue(TEXT("Confidence is between its neighbours"), Delayed.Confidence > 0.5f && Delayed.Confidence < 1.f);
+
+    // the configured minimum wins over a smaller measured delay
+    TestEqual(TEXT("Minimum delay"), Buffer.GetEvaluationDelay(1.0), 1.0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEyeTrackerSamplesDelayedDebounceTest, "DReyeVR.EyeTrackerSamples.DelayedDebounce",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FEyeTrackerSamplesDelayedDebounceTest::RunTest(const FString &Parameters)
+{
+    // same stream as above, off the HUD for 1.84s and then on it
+    FEyeTrackerSampleBuffer Buffer;
+    const double Period = 0.005;
+    const double Offset = 1000.0;
+    const float BlinkThreshold = 0.15f;
+    const double MinDelay = 0.05;
+    const int32 FirstOnSurf = 368;
+    double FrameTime = 0.0;
+    auto PushUntil = [&](int32 Begin, int32 End) {
+        for (int32 i = Begin; i < End; i++)
+        {
+            FEyeTrackerSample Sample;
+            Sample.bOnSurf = i >= FirstOnSurf;
+            Sample.Confidence = 1.f;
+            Sample.DeviceTime = i * Period;
+            Sample.ReceiveTime = Offset + Sample.DeviceTime + 0.002 + 0.002 * ((i * 7) % 5) / 4.0;
+            Buffer.Push(Sample);
+            FrameTime = Sample.ReceiveTime;
+        }
+    };
+
+    // the latest samples were on the HUD for longer than the blink time, but not yet at the delayed time the stream is read
+    PushUntil(0, 400);
+    double Time = FrameTime - Buffer.GetEvaluationDelay(MinDelay);
+    TestTrue(TEXT("Delay is at least the configured minimum"), Buffer.GetEvaluationDelay(MinDelay) >= MinDelay);
+    Buffer.Advance(Time, BlinkThreshold, 0.5f);
+    FEyeTrackerSample Sample;
+    TestTrue(TEXT("Evaluate behind the frame time"), Buffer.Evaluate(Time, Sample));
+    TestTrue(TEXT("Delayed time is between two buffered samples"), Time < Buffer.GetLatest()->LocalTime);
+    TestTrue(TEXT("Raw value at the delayed time is on the HUD"), Sample.bOnSurf);
+    TestFalse(TEXT("Not debounced before it held for the blink time at the delayed time"), Buffer.IsOnSurf());
+
+    // once it held long enough behind the frame time, it changed at the first on-HUD sample plus the blink time
+    PushUntil(400, 460);
+    Time = FrameTime - Buffer.GetEvaluationDelay(MinDelay);
+    Buffer.Advance(Time, BlinkThreshold, 0.5f);
+    TestTrue(TEXT("Debounced on the HUD"), Buffer.IsOnSurf());
+    const double FirstOnSurfTime = Offset + FirstOnSurf * Period + 0.002;
+    TestEqual(TEXT("Change time in sample time"), Buffer.GetOnSurfChangeTime(), FirstOnSurfTime + BlinkThreshold, 0.002);
+    TestTrue(TEXT("Change time is not ahead of the delayed time"), Buffer.GetOnSurfChangeTime() <= Time);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
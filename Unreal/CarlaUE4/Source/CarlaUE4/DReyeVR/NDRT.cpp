@@ -147,7 +147,7 @@ void AEgoVehicle::TerminateNDRT()
 	// Save all the NDRT performance data here if needed
 
 	// This is done so that the updated file (by python API) is re-read
-	ExperimentParams = ConfigFile(FPaths::Combine(CarlaUE4Path, TEXT("Config/ExperimentConfig.ini")));
+	ExperimentParams.Reload(true);
 
 	// Preparing the common row data
 	TArray<FString> CommonRowData = { ExperimentParams.Get<FString>("General", "ParticipantID") };
@@ -802,10 +802,12 @@ void AEgoVehicle::ConstructHUDDebugger()
 
 void AEgoVehicle::HUDDebuggerTick()
 {
-	// Set the OnSurf Value here
-	FString BoolAsString = bLatestOnSurfValue ? TEXT("True") : TEXT("False");
-	OnSurfValue->SetTextRenderColor(bLatestOnSurfValue ? FColor::Green : FColor::Red);
-	FString OnSurf = FString::Printf(TEXT("OnSurf: %s"), *BoolAsString);
+	// Set the OnSurf Value here (raw sample at the frame time, not debounced)
+	FEyeTrackerSample Sample;
+	const bool bOnSurf = GetEyeTrackerSample(Sample) && Sample.bOnSurf;
+	FString BoolAsString = bOnSurf ? TEXT("True") : TEXT("False");
+	OnSurfValue->SetTextRenderColor(bOnSurf ? FColor::Green : FColor::Red);
+	FString OnSurf = FString::Printf(TEXT("OnSurf: %s (%.2f)"), *BoolAsString, Sample.Confidence);
 	OnSurfValue->SetText(FText::FromString(OnSurf));
 
 	// Set the HUD Timer Value here
@@ -3,13 +3,41 @@
 
 #include "RetrieveDataRunnable.h"
 #include "EgoVehicle.h"
+#include <zmq.hpp>                  // zmq::poll
 
 
+void RetrieveDataRunnable::FChannelStats::Record(double LatencySeconds)
+{
+    const uint64 LatencyUs = static_cast<uint64>(FMath::Max(LatencySeconds, 0.0) * 1e6);
+    Messages.fetch_add(1, std::memory_order_relaxed);
+    LatencySumUs.fetch_add(LatencyUs, std::memory_order_relaxed);
+    uint64 PrevMax = LatencyMaxUs.load(std::memory_order_relaxed);
+    while (LatencyUs > PrevMax && !LatencyMaxUs.compare_exchange_weak(PrevMax, LatencyUs, std::memory_order_relaxed))
+    {
+    }
+}
+
 RetrieveDataRunnable::RetrieveDataRunnable(AEgoVehicle* InEgoVehicleInstance)
-    : EgoVehicle(InEgoVehicleInstance)
+    : EgoVehicle(InEgoVehicleInstance), StartTime(FPlatformTime::Seconds())
 {
+    // Read the reactor parameters before the thread starts
+    GeneralParams.Get("Hardware", "IOWakeIntervalMs", WakeIntervalMs);
+    float HeartbeatHz = 10.f;
+    GeneralParams.Get("Hardware", "StatusHeartbeatHz", HeartbeatHz);
+    HeartbeatInterval = HeartbeatHz > 0.f ? 1.0 / HeartbeatHz : 0.0;
+    float StatsInterval = 0.f;
+    GeneralParams.Get("Hardware", "IOStatsLogInterval", StatsInterval);
+    StatsLogInterval = StatsInterval;
+    WakeIntervalMs = FMath::Max(WakeIntervalMs, 0);
+    FString WireFormat = "Compat";
+    GeneralParams.Get("Hardware", "VehicleStatusWireFormat", WireFormat);
+    StatusCodec = MakeUnique<VehicleStatusCodec>(VehicleStatusCodec::ParseWireFormat(WireFormat));
+    BenchmarkStatusCodec = GeneralParams.Bind("Hardware", "BenchmarkStatusCodec", false);
+    GeneralParams.PublishBindings(); // the bindings made so far (EgoVehicle's too) must be readable by the thread
+
     // Now create the thread with the static ThreadStarter
-    Thread = FRunnableThread::Create(this, TEXT("RetrieveDataRunnable"), 0, TPri_TimeCritical);
+    // (the thread sleeps in zmq_poll, so it no longer needs to starve everything else of CPU time)
+    Thread = FRunnableThread::Create(this, TEXT("RetrieveDataRunnable"), 0, TPri_AboveNormal);
 }
 
 RetrieveDataRunnable::~RetrieveDataRunnable()
@@ -33,29 +61,109 @@ uint32 RetrieveDataRunnable::Run()
     // Initial wait before starting
     FPlatformProcess::Sleep(0.03);
 
+    // Optionally measure the status codec against the previous DataConfig/FString path (off the game thread)
+    if (BenchmarkStatusCodec.Get())
+    {
+        VehicleStatusCodec::RunBenchmark();
+    }
+
     // Establish connections with the required ports
-        
+
     EgoVehicle->EstablishEyeTrackerConnection();    // Establish connection with the eye-tracker
     EgoVehicle->EstablishVehicleStatusConnection(); // Establish vehicle status connection
 
     FPlatformProcess::Sleep(0.1); // Wait for sometime to ensure connection has been established
 
-    EgoVehicle->UpdateVehicleStatus(AEgoVehicle::VehicleStatus::ManualDrive); // Update the vehicle status to manual mode
-
+    double Now = FPlatformTime::Seconds();
+    Publish(AEgoVehicle::VehicleStatus::ManualDrive, Now); // Update the vehicle status to manual mode
+    {
+        // ...and locally: the game thread applies it through the inbox like any status from the client
+        FInboxMessage Message;
+        Message.Channel = EChannel::VehicleStatusIn;
+        Message.Status = AEgoVehicle::VehicleStatus::ManualDrive;
+        Message.ReceiveTime = Now;
+        Inbox.Enqueue(Message);
+    }
+    LastStatsLogTime = Now;
 
     // While not told to stop this thread and not yet finished processing
     while (StopTaskCounter.GetValue() == 0)
     {
-        if (EgoVehicle != nullptr)
+        if (EgoVehicle == nullptr)
+        {
+            break;
+        }
+
+        // Sleep until the python client sends something (or the wake interval passes)
+        bool bStatusReadable = false;
+        zmq::socket_t *Subscriber = EgoVehicle->GetVehicleStatusSubscriber();
+        if (Subscriber != nullptr)
+        {
+            zmq_pollitem_t Items[] = {{static_cast<void *>(*Subscriber), 0, ZMQ_POLLIN, 0}};
+            try
+            {
+                zmq::poll(Items, 1, WakeIntervalMs);
+                bStatusReadable = (Items[0].revents & ZMQ_POLLIN) != 0;
+            }
+            catch (const zmq::error_t &e)
+            {
+                UE_LOG(LogTemp, Error, TEXT("ZeroMQ: poll failed: %s"), ANSI_TO_TCHAR(e.what()));
+                FPlatformProcess::Sleep(WakeIntervalMs / 1000.f);
+            }
+        }
+        else
+        {
+            // reconnect on the next iteration without spinning
+            EgoVehicle->EstablishVehicleStatusConnection();
+            FPlatformProcess::Sleep(WakeIntervalMs / 1000.f);
+        }
+        Now = FPlatformTime::Seconds();
+
+        // Retrieve all the data from the pupil eye tracker (the UDP socket is drained on every wake)
+        EyeSamples.Reset();
+        EgoVehicle->RetrieveEyeTrackerSamples(EyeSamples);
+        for (const FEyeTrackerSample &Sample : EyeSamples)
         {
-			// Retrieve all the data from the pupil eye tracker
-            EgoVehicle->RetrieveOnSurf();
+            FInboxMessage Message;
+            Message.Channel = EChannel::EyeTrackerIn;
+            Message.EyeSample = Sample;
+            Message.ReceiveTime = Sample.ReceiveTime;
+            Inbox.Enqueue(Message);
+        }
 
-            // Send the current locally stored vehicle status
-            EgoVehicle->SendCurrVehicleStatus();
+        // Retrieve vehicle status from the client
+        AEgoVehicle::VehicleStatus ReceivedStatus;
+        if (bStatusReadable && EgoVehicle->RetrieveVehicleStatus(*StatusCodec, ReceivedStatus).Ok())
+        {
+            FInboxMessage Message;
+            Message.Channel = EChannel::VehicleStatusIn;
+            Message.Status = ReceivedStatus;
+            Message.ReceiveTime = Now;
+            Inbox.Enqueue(Message);
+            // the client's status is echoed back (as the locally stored current status)
+            PublishedStatus = ReceivedStatus;
+        }
+
+        // Send the status when the game thread changed it, otherwise at the heartbeat rate
+        FOutboxMessage Request;
+        bool bRequested = false;
+        while (Outbox.Dequeue(Request))
+        {
+            Stats[static_cast<int32>(EChannel::VehicleStatusOut)].Record(Now - Request.RequestTime);
+            bRequested = true;
+        }
+        if (bRequested)
+        {
+            Publish(Request.Status, Now);
+        }
+        else if (HeartbeatInterval > 0.0 && Now - LastPublishTime >= HeartbeatInterval)
+        {
+            Publish(PublishedStatus, Now);
+        }
 
-            // Retrieve vehicle status from the client
-            EgoVehicle->RetrieveVehicleStatus();
+        if (StatsLogInterval > 0.0 && Now - LastStatsLogTime >= StatsLogInterval)
+        {
+            LogStats(Now);
         }
     }
 
@@ -69,7 +177,77 @@ uint32 RetrieveDataRunnable::Run()
     return 0;
 }
 
+void RetrieveDataRunnable::Publish(AEgoVehicle::VehicleStatus Status, double Now)
+{
+    EgoVehicle->PublishVehicleStatus(*StatusCodec, Status);
+    PublishedStatus = Status;
+    LastPublishTime = Now;
+}
+
 void RetrieveDataRunnable::Stop()
 {
     StopTaskCounter.Increment();
 }
+
+void RetrieveDataRunnable::RequestStatusPublish(AEgoVehicle::VehicleStatus NewStatus)
+{
+    Outbox.Enqueue({NewStatus, FPlatformTime::Seconds()});
+}
+
+bool RetrieveDataRunnable::ConsumeInbox(FInboxMessage &Out)
+{
+    if (!Inbox.Dequeue(Out))
+    {
+        return false;
+    }
+    Stats[static_cast<int32>(Out.Channel)].Record(FPlatformTime::Seconds() - Out.ReceiveTime);
+    return true;
+}
+
+RetrieveDataRunnable::FChannelStatsSnapshot RetrieveDataRunnable::GetStats(EChannel Channel) const
+{
+    const FChannelStats &Counters = Stats[static_cast<int32>(Channel)];
+    FChannelStatsSnapshot Snapshot;
+    Snapshot.Messages = Counters.Messages.load(std::memory_order_relaxed);
+    if (Snapshot.Messages > 0)
+    {
+        Snapshot.AvgLatencyMs = Counters.LatencySumUs.load(std::memory_order_relaxed) / 1e3 / Snapshot.Messages;
+        Snapshot.MaxLatencyMs = Counters.LatencyMaxUs.load(std::memory_order_relaxed) / 1e3;
+    }
+    const double Elapsed = FPlatformTime::Seconds() - StartTime;
+    if (Elapsed > 0.0)
+    {
+        Snapshot.MessagesPerSecond = Snapshot.Messages / Elapsed;
+    }
+    return Snapshot;
+}
+
+const TCHAR *RetrieveDataRunnable::ChannelName(EChannel Channel)
+{
+    switch (Channel)
+    {
+    case EChannel::VehicleStatusIn:
+        return TEXT("VehicleStatusIn");
+    case EChannel::EyeTrackerIn:
+        return TEXT("EyeTrackerIn");
+    case EChannel::VehicleStatusOut:
+        return TEXT("VehicleStatusOut");
+    default:
+        return TEXT("Unknown");
+    }
+}
+
+void RetrieveDataRunnable::LogStats(double Now)
+{
+    for (int32 i = 0; i < static_cast<int32>(EChannel::Num); i++)
+    {
+        const EChannel Channel = static_cast<EChannel>(i);
+        const FChannelStatsSnapshot S = GetStats(Channel);
+        // rate over the last logging window rather than since start-up
+        const double Rate = (S.Messages - LastLoggedMessages[i]) / FMath::Max(Now - LastStatsLogTime, 1e-6);
+        LastLoggedMessages[i] = S.Messages;
+        UE_LOG(LogTemp, Display, TEXT("HardwareIO: %s %llu msgs (%.1f msg/s) latency avg %.3f ms, max %.3f ms"),
+               ChannelName(Channel), S.Messages, Rate, S.AvgLatencyMs, S.MaxLatencyMs);
+    }
+    LastStatsLogTime = Now;
+}
@@ -3,22 +3,92 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Queue.h"   // TQueue (lock-free SPSC mailboxes)
 #include "EgoVehicle.h"
+#include "VehicleStatusCodec.h" // VehicleStatusCodec
+#include <atomic>
 
 /**
- * 
+ * Hardware I/O reactor for the EgoVehicle.
+ *
+ * The thread sleeps in zmq_poll on the vehicle status SUB socket (up to IOWakeIntervalMs) instead of spinning, drains
+ * every pending eye-tracker UDP datagram on every wake (one inbox message per sample), and only touches the ZMQ/UDP
+ * sockets from this thread. Results are handed to the game thread through a lock-free single-producer/single-consumer
+ * mailbox (Inbox), and status changes requested by the game thread come back through a second one (Outbox). The status is published when it changes and otherwise at
+ * the StatusHeartbeatHz rate.
  */
 class CARLAUE4_API RetrieveDataRunnable : public FRunnable
 {
+public:
+    enum class EChannel : uint8 { VehicleStatusIn, EyeTrackerIn, VehicleStatusOut, Num };
+
+    // Message from the I/O thread to the game thread
+    struct FInboxMessage
+    {
+        EChannel Channel;
+        AEgoVehicle::VehicleStatus Status = AEgoVehicle::VehicleStatus::Unknown; // VehicleStatusIn
+        FEyeTrackerSample EyeSample;                                             // EyeTrackerIn (one message per sample)
+        double ReceiveTime = 0.0;                                                // FPlatformTime::Seconds()
+    };
+
+    // Counters are written by both threads, read with GetStats() from anywhere
+    struct FChannelStats
+    {
+        std::atomic<uint64> Messages{0};
+        std::atomic<uint64> LatencySumUs{0}; // receive -> consume (inbound) or request -> send (outbound)
+        std::atomic<uint64> LatencyMaxUs{0};
+        void Record(double LatencySeconds);
+    };
+
+    struct FChannelStatsSnapshot
+    {
+        uint64 Messages = 0;
+        double MessagesPerSecond = 0.0; // average since the thread started
+        double AvgLatencyMs = 0.0;
+        double MaxLatencyMs = 0.0;
+    };
+
 private:
     AEgoVehicle* EgoVehicle;    // Pointer required for calling data retrieve methods
     FRunnableThread* Thread;    // Thread to run the worker FRunnable on
     FThreadSafeCounter StopTaskCounter; // Stop this thread? Uses Thread Safe Counter
 
+    TQueue<FInboxMessage, EQueueMode::Spsc> Inbox; // I/O thread -> game thread
+    struct FOutboxMessage
+    {
+        AEgoVehicle::VehicleStatus Status;
+        double RequestTime;
+    };
+    TQueue<FOutboxMessage, EQueueMode::Spsc> Outbox; // game thread -> I/O thread
+
+    // Only touched by the I/O thread
+    TUniquePtr<VehicleStatusCodec> StatusCodec; // created once, reused for every message
+    TArray<FEyeTrackerSample> EyeSamples;       // drained eye-tracker samples, reused on every wake
+    ConfigParam<bool> BenchmarkStatusCodec;     // bound on the game thread, the I/O thread never parses the config
+    int32 WakeIntervalMs = 2;        // upper bound on how long zmq_poll may block
+    double HeartbeatInterval = 0.1;  // republish the (unchanged) status this often
+    double StatsLogInterval = 0.0;   // <= 0 disables the periodic stats log
+    AEgoVehicle::VehicleStatus PublishedStatus = AEgoVehicle::VehicleStatus::Unknown;
+    double LastPublishTime = 0.0;
+    double LastStatsLogTime = 0.0;
+    void Publish(AEgoVehicle::VehicleStatus Status, double Now);
+    uint64 LastLoggedMessages[static_cast<int32>(EChannel::Num)] = {};
+    void LogStats(double Now);
+
+    const double StartTime;
+    FChannelStats Stats[static_cast<int32>(EChannel::Num)];
+
 public:
     RetrieveDataRunnable(AEgoVehicle* InEgoVehicleInstance);
     virtual ~RetrieveDataRunnable();
 
     virtual uint32 Run() override;
     void Stop();
+
+    // game thread API
+    void RequestStatusPublish(AEgoVehicle::VehicleStatus NewStatus); // publish as soon as the I/O thread wakes
+    bool ConsumeInbox(FInboxMessage &Out);                          // pop one message (records the mailbox latency)
+
+    FChannelStatsSnapshot GetStats(EChannel Channel) const;
+    static const TCHAR *ChannelName(EChannel Channel);
 };
@@ -0,0 +1,452 @@
+// Copyright (c) 2023 Okanagan Visualization & Interaction (OVI) Lab at the University of British Columbia. This work is licensed under the terms of the MIT license. For a copy, see <https://opensource.org/lic
+
+#include "VehicleStatusCodec.h"
+#include "DataConfigDatatypes.h"                    // FVehicleStatusData (benchmark baseline)
+#include "Deserialize/DcDeserializer.h"             // Deserializer (benchmark baseline)
+#include "Deserialize/DcDeserializerSetup.h"        // EDcMsgPackDeserializeType (benchmark baseline)
+#include "MsgPack/DcMsgPackReader.h"                // MsgPackReader (benchmark baseline)
+#include "Property/DcPropertyDatum.h"               // Datum (benchmark baseline)
+#include "Property/DcPropertyWriter.h"              // PropertyWriter (benchmark baseline)
+#include <cstdio>                                   // snprintf
+#include <cstring>                                  // memcmp, strlen
+#include <string>                                   // benchmark baseline
+
+namespace
+{
+    // same order as ordered_vehicle_status in PythonAPI/experiment/experiment_utils.py
+    const char *const WireOrder[] = {"Unknown",  "ManualDrive",    "Autopilot",        "PreAlertAutopilot",
+                                     "TakeOver", "TakeOverManual", "ResumedAutopilot", "TrialOver"};
+    constexpr uint64 NumWireCodes = sizeof(WireOrder) / sizeof(WireOrder[0]);
+
+    constexpr char StatusKey[] = "vehicle_status";
+    constexpr size_t StatusKeyLength = sizeof(StatusKey) - 1;
+
+    // Minimal bounds-checked msgpack cursor, only what the vehicle status messages need
+    struct FMsgPackCursor
+    {
+        const uint8 *Ptr;
+        const uint8 *End;
+
+        bool Has(size_t N) const
+        {
+            return static_cast<size_t>(End - Ptr) >= N;
+        }
+
+        bool ReadBigEndian(size_t N, uint64 &Out)
+        {
+            if (!Has(N))
+                return false;
+            Out = 0;
+            for (size_t i = 0; i < N; i++)
+                Out = (Out << 8) | Ptr[i];
+            Ptr += N;
+            return true;
+        }
+
+        bool Skip(uint64 N)
+        {
+            if (!Has(N))
+                return false;
+            Ptr += N;
+            return true;
+        }
+
+        // reads a str header and returns a view of the (unterminated) characters
+        bool ReadStr(const char *&OutStr, size_t &OutLength)
+        {
+            if (!Has(1))
+                return false;
+            const uint8 Tag = *Ptr++;
+            uint64 Length;
+            bool bValidHeader = true;
+            if ((Tag & 0xe0) == 0xa0)
+                Length = Tag & 0x1f;
+            else if (Tag == 0xd9 || Tag == 0xc4)
+                bValidHeader = ReadBigEndian(1, Length);
+            else if (Tag == 0xda || Tag == 0xc5)
+                bValidHeader = ReadBigEndian(2, Length);
+            else if (Tag == 0xdb || Tag == 0xc6)
+                bValidHeader = ReadBigEndian(4, Length);
+            else
+                return false;
+            if (!bValidHeader || !Has(Length))
+                return false;
+            OutStr = reinterpret_cast<const char *>(Ptr);
+            OutLength = static_cast<size_t>(Length);
+            Ptr += Length;
+            return true;
+        }
+
+        bool ReadUInt(uint64 &Out)
+        {
+            if (!Has(1))
+                return false;
+            const uint8 Tag = *Ptr++;
+            if (Tag <= 0x7f)
+            {
+                Out = Tag;
+                return true;
+            }
+            switch (Tag)
+            {
+            case 0xcc:
+                return ReadBigEndian(1, Out);
+            case 0xcd:
+                return ReadBigEndian(2, Out);
+            case 0xce:
+                return ReadBigEndian(4, Out);
+            case 0xcf:
+                return ReadBigEndian(8, Out);
+            default:
+                return false;
+            }
+        }
+
+        bool ReadContainerSize(uint8 FixMask, uint8 Tag16, uint8 Tag32, uint64 &Out)
+        {
+            if (!Has(1))
+                return false;
+            const uint8 Tag = *Ptr++;
+            if ((Tag & 0xf0) == FixMask)
+            {
+                Out = Tag & 0x0f;
+                return true;
+            }
+            if (Tag == Tag16)
+                return ReadBigEndian(2, Out);
+            if (Tag == Tag32)
+                return ReadBigEndian(4, Out);
+            return false;
+        }
+
+        // skip over one complete value (recursing into containers)
+        bool SkipValue(int32 Depth = 0)
+        {
+            if (!Has(1) || Depth > 16)
+                return false;
+            const uint8 Tag = *Ptr;
+            uint64 N;
+            if (Tag <= 0x7f || Tag >= 0xe0 || Tag == 0xc0 || Tag == 0xc2 || Tag == 0xc3)
+                return Skip(1);
+            if ((Tag & 0xe0) == 0xa0 || Tag == 0xd9 || Tag == 0xda || Tag == 0xdb || Tag == 0xc4 || Tag == 0xc5 ||
+                Tag == 0xc6)
+            {
+                const char *Str;
+                size_t Length;
+                return ReadStr(Str, Length);
+            }
+            if ((Tag & 0xf0) == 0x90 || Tag == 0xdc || Tag == 0xdd)
+            {
+                if (!ReadContainerSize(0x90, 0xdc, 0xdd, N))
+                    return false;
+                for (uint64 i = 0; i < N; i++)
+                    if (!SkipValue(Depth + 1))
+                        return false;
+                return true;
+            }
+            if ((Tag & 0xf0) == 0x80 || Tag == 0xde || Tag == 0xdf)
+            {
+                if (!ReadContainerSize(0x80, 0xde, 0xdf, N))
+                    return false;
+                for (uint64 i = 0; i < 2 * N; i++)
+                    if (!SkipValue(Depth + 1))
+                        return false;
+                return true;
+            }
+            Ptr++;
+            switch (Tag)
+            {
+            case 0xcc:
+            case 0xd0:
+                return Skip(1);
+            case 0xcd:
+            case 0xd1:
+                return Skip(2);
+            case 0xca:
+            case 0xce:
+            case 0xd2:
+                return Skip(4);
+            case 0xcb:
+            case 0xcf:
+            case 0xd3:
+                return Skip(8);
+            case 0xd4:
+                return Skip(2);
+            case 0xd5:
+                return Skip(3);
+            case 0xd6:
+                return Skip(5);
+            case 0xd7:
+                return Skip(9);
+            case 0xd8:
+                return Skip(17);
+            case 0xc7:
+                return ReadBigEndian(1, N) && Skip(N + 1);
+            case 0xc8:
+                return ReadBigEndian(2, N) && Skip(N + 1);
+            case 0xc9:
+                return ReadBigEndian(4, N) && Skip(N + 1);
+            default:
+                return false;
+            }
+        }
+    };
+} // namespace
+
+/// ========================================== ///
+/// ----------------:STATUS:------------------ ///
+/// ========================================== ///
+
+uint8 VehicleStatusCodec::ToWireCode(AEgoVehicle::VehicleStatus Status)
+{
+    switch (Status)
+    {
+    case AEgoVehicle::VehicleStatus::ManualDrive:
+        return 1;
+    case AEgoVehicle::VehicleStatus::Autopilot:
+        return 2;
+    case AEgoVehicle::VehicleStatus::PreAlertAutopilot:
+        return 3;
+    case AEgoVehicle::VehicleStatus::TakeOver:
+        return 4;
+    case AEgoVehicle::VehicleStatus::TakeOverManual:
+        return 5;
+    case AEgoVehicle::VehicleStatus::ResumedAutopilot:
+        return 6;
+    case AEgoVehicle::VehicleStatus::TrialOver:
+        return 7;
+    default:
+        return 0;
+    }
+}
+
+AEgoVehicle::VehicleStatus VehicleStatusCodec::FromWireCode(uint64 Code)
+{
+    static const AEgoVehicle::VehicleStatus Statuses[] = {
+        AEgoVehicle::VehicleStatus::Unknown,        AEgoVehicle::VehicleStatus::ManualDrive,
+        AEgoVehicle::VehicleStatus::Autopilot,      AEgoVehicle::VehicleStatus::PreAlertAutopilot,
+        AEgoVehicle::VehicleStatus::TakeOver,       AEgoVehicle::VehicleStatus::TakeOverManual,
+        AEgoVehicle::VehicleStatus::ResumedAutopilot, AEgoVehicle::VehicleStatus::TrialOver};
+    return Code < NumWireCodes ? Statuses[Code] : AEgoVehicle::VehicleStatus::Unknown;
+}
+
+const char *VehicleStatusCodec::StatusName(AEgoVehicle::VehicleStatus Status)
+{
+    return WireOrder[ToWireCode(Status)];
+}
+
+bool VehicleStatusCodec::FromName(const char *Name, size_t Length, AEgoVehicle::VehicleStatus &OutStatus)
+{
+    for (uint64 Code = 0; Code < NumWireCodes; Code++)
+    {
+        if (strlen(WireOrder[Code]) == Length && memcmp(WireOrder[Code], Name, Length) == 0)
+        {
+            OutStatus = FromWireCode(Code);
+            return true;
+        }
+    }
+    // unrecognized names map to Unknown (same as the previous string comparison chain)
+    OutStatus = AEgoVehicle::VehicleStatus::Unknown;
+    return true;
+}
+
+VehicleStatusCodec::EWireFormat VehicleStatusCodec::ParseWireFormat(const FString &Name)
+{
+    return Name.Equals(TEXT("Compact"), ESearchCase::IgnoreCase) ? EWireFormat::Compact : EWireFormat::Compat;
+}
+
+/// ========================================== ///
+/// ----------------:DECODE:------------------ ///
+/// ========================================== ///
+
+bool VehicleStatusCodec::Decode(const void *Data, size_t Size, AEgoVehicle::VehicleStatus &OutStatus) const
+{
+    if (Data == nullptr || Size == 0)
+        return false;
+    const uint8 First = *static_cast<const uint8 *>(Data);
+    if (First == '{')
+        return DecodeJson(static_cast<const char *>(Data), Size, OutStatus);
+    return DecodeMsgPack(static_cast<const uint8 *>(Data), Size, OutStatus);
+}
+
+bool VehicleStatusCodec::DecodeMsgPack(const uint8 *Data, size_t Size, AEgoVehicle::VehicleStatus &OutStatus) const
+{
+    FMsgPackCursor Cursor{Data, Data + Size};
+    const uint8 Tag = *Data;
+    uint64 N;
+    if ((Tag & 0xf0) == 0x90 || Tag == 0xdc || Tag == 0xdd)
+    {
+        // compact: [status_code, unix_time_ms]
+        uint64 Code;
+        if (!Cursor.ReadContainerSize(0x90, 0xdc, 0xdd, N) || N < 1 || !Cursor.ReadUInt(Code))
+            return false;
+        OutStatus = FromWireCode(Code);
+        return true;
+    }
+    // compat: {"from": ..., "timestamp": ..., "vehicle_status": ...}
+    if (!Cursor.ReadContainerSize(0x80, 0xde, 0xdf, N))
+        return false;
+    for (uint64 i = 0; i < N; i++)
+    {
+        const char *Key;
+        size_t KeyLength;
+        if (!Cursor.ReadStr(Key, KeyLength))
+            return false;
+        if (KeyLength != StatusKeyLength || memcmp(Key, StatusKey, KeyLength) != 0)
+        {
+            if (!Cursor.SkipValue())
+                return false;
+            continue;
+        }
+        const char *Value;
+        size_t ValueLength;
+        if (Cursor.ReadStr(Value, ValueLength))
+            return FromName(Value, ValueLength, OutStatus);
+        return false;
+    }
+    return false; // no vehicle_status entry
+}
+
+bool VehicleStatusCodec::DecodeJson(const char *Data, size_t Size, AEgoVehicle::VehicleStatus &OutStatus) const
+{
+    // only looks for "vehicle_status": "<name>", the other entries are ignored
+    const char *End = Data + Size;
+    for (const char *Ptr = Data; Ptr + StatusKeyLength + 2 <= End; Ptr++)
+    {
+        if (*Ptr != '"' || memcmp(Ptr + 1, StatusKey, StatusKeyLength) != 0 || Ptr[StatusKeyLength + 1] != '"')
+            continue;
+        Ptr += StatusKeyLength + 2;
+        while (Ptr < End && (*Ptr == ' ' || *Ptr == ':'))
+            Ptr++;
+        if (Ptr >= End || *Ptr != '"')
+            return false;
+        const char *Value = ++Ptr;
+        while (Ptr < End && *Ptr != '"')
+            Ptr++;
+        if (Ptr >= End)
+            return false;
+        return FromName(Value, Ptr - Value, OutStatus);
+    }
+    return false;
+}
+
+/// ========================================== ///
+/// ----------------:ENCODE:------------------ ///
+/// ========================================== ///
+
+VehicleStatusCodec::FEncoded VehicleStatusCodec::Encode(AEgoVehicle::VehicleStatus Status, const FDateTime &Timestamp)
+{
+    if (SendFormat == EWireFormat::Compact)
+    {
+        // [status_code (positive fixint), unix_time_ms (uint64)], Timestamp is UTC
+        const uint64 UnixMs =
+            static_cast<uint64>(Timestamp.ToUnixTimestamp()) * 1000 + static_cast<uint64>(Timestamp.GetMillisecond());
+        uint8 *Out = reinterpret_cast<uint8 *>(SendBuffer);
+        Out[0] = 0x92;
+        Out[1] = ToWireCode(Status);
+        Out[2] = 0xcf;
+        for (int32 i = 0; i < 8; i++)
+            Out[3 + i] = static_cast<uint8>(UnixMs >> (8 * (7 - i)));
+        return {SendBuffer, 11};
+    }
+
+    // Same layout as before: { "from": "carla", "timestamp": "%d/%m/%Y %H:%M:%S.ms", "vehicle_status": "<name>" }
+    const int Length = snprintf(SendBuffer, sizeof(SendBuffer),
+                                "{ \"from\": \"carla\", \"timestamp\": \"%02d/%02d/%04d %02d:%02d:%02d.%03d\", "
+                                "\"vehicle_status\": \"%s\" }",
+                                Timestamp.GetDay(), Timestamp.GetMonth(), Timestamp.GetYear(), Timestamp.GetHour(),
+                                Timestamp.GetMinute(), Timestamp.GetSecond(), Timestamp.GetMillisecond(),
+                                StatusName(Status));
+    check(Length > 0 && Length < static_cast<int>(sizeof(SendBuffer)));
+    return {SendBuffer, static_cast<size_t>(Length)};
+}
+
+/// ========================================== ///
+/// ---------------:BENCHMARK:---------------- ///
+/// ========================================== ///
+
+void VehicleStatusCodec::RunBenchmark(int32 Iterations)
+{
+    // the message the python client sends today (msgpack map with three str entries)
+    const char *Keys[] = {"from", "timestamp", "vehicle_status"};
+    const char *Values[] = {"client", "16/10/2026 12:34:56.789", "PreAlertAutopilot"};
+    TArray<uint8> Message;
+    Message.Add(0x83);
+    for (int32 i = 0; i < 3; i++)
+    {
+        for (const char *Str : {Keys[i], Values[i]})
+        {
+            Message.Add(0xa0 | static_cast<uint8>(strlen(Str)));
+            Message.Append(reinterpret_cast<const uint8 *>(Str), strlen(Str));
+        }
+    }
+
+    volatile int32 Sink = 0; // keeps the loops from being optimized out
+    const FDateTime Now = FDateTime::Now();
+
+    // Baseline decode: copy, per-message DataConfig deserializer, FString comparison
+    double Start = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        FVehicleStatusData Data;
+        TArray<uint8> DataArray;
+        DataArray.Append(Message.GetData(), Message.Num());
+        FDcDeserializer Deserializer;
+        DcSetupMsgPackDeserializeHandlers(Deserializer, EDcMsgPackDeserializeType::Default);
+        FDcPropertyDatum Datum(&Data);
+        FDcMsgPackReader Reader(FDcBlobViewData::From(DataArray));
+        FDcPropertyWriter Writer(Datum);
+        FDcDeserializeContext Ctx;
+        Ctx.Reader = &Reader;
+        Ctx.Writer = &Writer;
+        Ctx.Deserializer = &Deserializer;
+        if (Ctx.Prepare().Ok() && Deserializer.Deserialize(Ctx).Ok())
+        {
+            Sink += Data.vehicle_status == "PreAlertAutopilot" ? 1 : 0;
+        }
+    }
+    const double BaselineDecode = FPlatformTime::Seconds() - Start;
+
+    // Baseline encode: FDateTime::ToString + FString::Printf + UTF-8 conversion
+    Start = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Iterations; i++)
+    {
+        const FString TimestampWithoutMilliseconds = Now.ToString(TEXT("%d/%m/%Y %H:%M:%S"));
+        const FString Timestamp = FString::Printf(TEXT("%s.%03d"), *TimestampWithoutMilliseconds, Now.GetMillisecond());
+        const FString DictFString =
+            FString::Printf(TEXT("{ \"from\": \"%s\", \"timestamp\": \"%s\", \"vehicle_status\": \"%s\" }"),
+                            TEXT("carla"), *Timestamp, TEXT("PreAlertAutopilot"));
+        const std::string DictStdString(TCHAR_TO_UTF8(*DictFString));
+        Sink += static_cast<int32>(DictStdString.size());
+    }
+    const double BaselineEncode = FPlatformTime::Seconds() - Start;
+
+    // Codec
+    VehicleStatusCodec CompatCodec(EWireFormat::Compat);
+    VehicleStatusCodec CompactCodec(EWireFormat::Compact);
+    const FEncoded Compact = CompactCodec.Encode(AEgoVehicle::VehicleStatus::PreAlertAutopilot, Now);
+    TArray<uint8> CompactMessage;
+    CompactMessage.Append(static_cast<const uint8 *>(Compact.Data), Compact.Size);
+    AEgoVehicle::VehicleStatus Status;
+
+    auto Time = [&](TFunctionRef<void()> Fn) {
+        const double T0 = FPlatformTime::Seconds();
+        for (int32 i = 0; i < Iterations; i++)
+            Fn();
+        return FPlatformTime::Seconds() - T0;
+    };
+    const double CodecDecode = Time([&] { Sink += CompatCodec.Decode(Message.GetData(), Message.Num(), Status); });
+    const double CodecDecodeCompact =
+        Time([&] { Sink += CompatCodec.Decode(CompactMessage.GetData(), CompactMessage.Num(), Status); });
+    const double CodecEncode =
+        Time([&] { Sink += CompatCodec.Encode(AEgoVehicle::VehicleStatus::PreAlertAutopilot, Now).Size; });
+    const double CodecEncodeCompact =
+        Time([&] { Sink += CompactCodec.Encode(AEgoVehicle::VehicleStatus::PreAlertAutopilot, Now).Size; });
+
+    const double ToNs = 1e9 / FMath::Max(Iterations, 1);
+    LOG("VehicleStatusCodec benchmark (%d iterations, ns/msg):", Iterations);
+    LOG("  decode: DataConfig %.1f | codec (dict) %.1f | codec (compact) %.1f", BaselineDecode * ToNs,
+        CodecDecode * ToNs, CodecDecodeCompact * ToNs);
+    LOG("  encode: FString %.1f | codec (compat) %.1f | codec (compact) %.1f", BaselineEncode * ToNs,
+        CodecEncode * ToNs, CodecEncodeCompact * ToNs);
+}
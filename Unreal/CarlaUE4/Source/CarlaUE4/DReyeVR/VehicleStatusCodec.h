@@ -0,0 +1,63 @@
+// Copyright (c) 2023 Okanagan Visualization & Interaction (OVI) Lab at the University of British Columbia. This work is licensed under the terms of the MIT license. For a copy, see <https://opensource.org/lic
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EgoVehicle.h" // AEgoVehicle::VehicleStatus
+
+/**
+ * Encoder/decoder for the vehicle status ZeroMQ channel (created once and reused by the hardware I/O thread).
+ *
+ * Decoding works in place on the received buffer (no copies, no FString) and accepts every format the python client
+ * may send:
+ *  - Compact: msgpack array [status_code, unix_time_ms] where status_code indexes WireOrder
+ *  - Compat:  msgpack map {"from": ..., "timestamp": ..., "vehicle_status": "<name>"} (what the client sends today)
+ *  - JSON:    {"from": ..., "timestamp": ..., "vehicle_status": "<name>"}
+ *
+ * Encoding writes into a fixed send buffer owned by the codec, either as the compact array or in the JSON layout the
+ * python client currently expects (EWireFormat::Compat, the default).
+ */
+class CARLAUE4_API VehicleStatusCodec
+{
+public:
+    enum class EWireFormat : uint8 { Compat, Compact };
+
+    VehicleStatusCodec(EWireFormat InSendFormat = EWireFormat::Compat) : SendFormat(InSendFormat)
+    {
+    }
+
+    // Decode a received message, returns false if the message is malformed (OutStatus is then left untouched)
+    bool Decode(const void *Data, size_t Size, AEgoVehicle::VehicleStatus &OutStatus) const;
+
+    // Encode into the internal send buffer, the returned view stays valid until the next call to Encode. Timestamp
+    // is UTC for Compact (sent as Unix time) and local time for Compat (sent as the wall clock string)
+    struct FEncoded
+    {
+        const void *Data;
+        size_t Size;
+    };
+    FEncoded Encode(AEgoVehicle::VehicleStatus Status, const FDateTime &Timestamp);
+
+    EWireFormat GetSendFormat() const
+    {
+        return SendFormat;
+    }
+
+    static EWireFormat ParseWireFormat(const FString &Name); // "Compact" or anything else (Compat)
+    static const char *StatusName(AEgoVehicle::VehicleStatus Status);
+
+    // Wire codes follow the python client's ordered_vehicle_status list (Unknown is 0)
+    static uint8 ToWireCode(AEgoVehicle::VehicleStatus Status);
+    static AEgoVehicle::VehicleStatus FromWireCode(uint64 Code);
+
+    // Log the per-message encode/decode cost of this codec against the DataConfig/FString path it replaces
+    static void RunBenchmark(int32 Iterations = 100000);
+
+private:
+    bool DecodeMsgPack(const uint8 *Data, size_t Size, AEgoVehicle::VehicleStatus &OutStatus) const;
+    bool DecodeJson(const char *Data, size_t Size, AEgoVehicle::VehicleStatus &OutStatus) const;
+    static bool FromName(const char *Name, size_t Length, AEgoVehicle::VehicleStatus &OutStatus);
+
+    const EWireFormat SendFormat;
+    char SendBuffer[128]; // large enough for the JSON layout with the longest status name
+};
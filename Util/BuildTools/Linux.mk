@@ -15,6 +15,9 @@ import: CarlaUE4Editor PythonAPI
 package: CarlaUE4Editor PythonAPI
 	@${CARLA_BUILD_TOOLS_FOLDER}/Package.sh $(ARGS)
 
+tm-cache: PythonAPI
+	@cd ${CARLA_PYTHONAPI_ROOT_FOLDER}/util && /usr/bin/env python3 build_tm_cache.py $(ARGS)
+
 package.rss: CarlaUE4Editor PythonAPI.rss.rebuild
 	@${CARLA_BUILD_TOOLS_FOLDER}/Package.sh $(ARGS)
 